@@ -33,8 +33,12 @@
 #include "celluloid-application.h"
 #include "celluloid-controller.h"
 #include "celluloid-file.h"
+#include "celluloid-metadata-cache.h"
+#include "celluloid-resume-store.h"
+#include "celluloid-settings-snapshot.h"
 #include "celluloid-mpv.h"
 #include "celluloid-common.h"
+#include "celluloid-trace.h"
 #include "celluloid-def.h"
 
 struct _CelluloidApplication
@@ -43,9 +47,14 @@ struct _CelluloidApplication
 	GSList *controllers;
 	gboolean enqueue;
 	gboolean new_window;
+	gboolean headless;
 	gchar *mpv_options;
 	gchar *role;
 	guint inhibit_cookie;
+	GSettings *settings;
+	CelluloidMetadataCache *metadata_cache;
+	GQueue *standby_models;
+	guint standby_fill_id;
 };
 
 struct _CelluloidApplicationClass
@@ -68,6 +77,21 @@ set_lua_path(void);
 static gboolean
 shutdown_signal_handler(gpointer data);
 
+static gboolean
+fill_standby_pool(gpointer data);
+
+static void
+schedule_standby_fill(CelluloidApplication *app);
+
+static void
+clear_standby_pool(CelluloidApplication *app, guint size);
+
+static void
+standby_pool_size_handler(GSettings *settings, gchar *key, gpointer data);
+
+static void
+controller_ready_handler(GObject *object, GParamSpec *pspec, gpointer data);
+
 static void
 new_window_handler(GSimpleAction *simple, GVariant *parameter, gpointer data);
 
@@ -98,6 +122,9 @@ startup_handler(GApplication *gapp, gpointer data);
 static void
 shutdown_handler(CelluloidController *controller, gpointer data);
 
+static void
+dispose(GObject *object);
+
 static void
 celluloid_application_class_init(CelluloidApplicationClass *klass);
 
@@ -154,26 +181,51 @@ initialize_gui(CelluloidApplication *app)
 {
 	CelluloidController *controller;
 	CelluloidView *view;
-	CelluloidMainWindow *window;
 	GSettings *settings;
+	gint64 trace_span = celluloid_trace_begin();
 
 	migrate_config();
 
-	controller = celluloid_controller_new(app);
+	controller =	app->headless ?
+			celluloid_controller_new_headless(app) :
+			celluloid_controller_new(app);
 	view = celluloid_controller_get_view(controller);
-	window = celluloid_view_get_main_window(view);
 	settings = g_settings_new(CONFIG_ROOT);
 	app->controllers = g_slist_prepend(app->controllers, controller);
 
+	if(view)
+	{
 	#ifdef GDK_WINDOWING_X11
-	GdkSurface *surface = gtk_widget_get_surface(window);
-	GdkDisplay *display = gdk_surface_get_display(surface);
+		CelluloidMainWindow *window =
+			celluloid_view_get_main_window(view);
+		GdkSurface *surface = gtk_widget_get_surface(window);
+		GdkDisplay *display = gdk_surface_get_display(surface);
+
+		if(app->role && GDK_IS_X11_DISPLAY(display))
+		{
+			gdk_x11_surface_set_utf8_property
+				(surface, "WM_ROLE", app->role);
+		}
+	#endif
 
-	if(app->role && GDK_IS_X11_DISPLAY(display))
+		g_settings_bind(	settings,
+					"use-skip-buttons-for-playlist",
+					controller,
+					"use-skip-buttons-for-playlist",
+					G_SETTINGS_BIND_GET );
+		g_settings_bind(	settings,
+					"always-use-floating-controls",
+					celluloid_view_get_main_window(view),
+					"always-use-floating-controls",
+					G_SETTINGS_BIND_GET );
+	}
+	else
 	{
-		gdk_x11_surface_set_utf8_property(surface, "WM_ROLE", app->role);
+		// There is no window to keep the application running. The
+		// hold is released when the controller shuts down.
+		g_application_hold(G_APPLICATION(app));
 	}
-	#endif
+
 #ifdef G_OS_UNIX
 	g_unix_signal_add(SIGHUP, shutdown_signal_handler, app);
 	g_unix_signal_add(SIGINT, shutdown_signal_handler, app);
@@ -184,17 +236,11 @@ initialize_gui(CelluloidApplication *app)
 				"shutdown",
 				G_CALLBACK(shutdown_handler),
 				app );
+	g_signal_connect(	controller,
+				"notify::ready",
+				G_CALLBACK(controller_ready_handler),
+				app );
 
-	g_settings_bind(	settings,
-				"use-skip-buttons-for-playlist",
-				controller,
-				"use-skip-buttons-for-playlist",
-				G_SETTINGS_BIND_GET );
-	g_settings_bind(	settings,
-				"always-use-floating-controls",
-				celluloid_view_get_main_window(view),
-				"always-use-floating-controls",
-				G_SETTINGS_BIND_GET );
 	g_settings_bind(	settings,
 				"dark-theme-enable",
 				controller,
@@ -203,6 +249,8 @@ initialize_gui(CelluloidApplication *app)
 
 	g_object_unref(settings);
 	adw_init();
+
+	celluloid_trace_end("initialize-gui", trace_span);
 }
 
 static void
@@ -254,6 +302,101 @@ shutdown_signal_handler(gpointer data)
 	return FALSE;
 }
 
+static gboolean
+fill_standby_pool(gpointer data)
+{
+	CelluloidApplication *app = data;
+	const guint pool_size =
+		(guint)g_settings_get_int(app->settings, "standby-pool-size");
+	gboolean done = g_queue_get_length(app->standby_models) >= pool_size;
+
+	// Only one core is initialized per iteration so that the main loop
+	// gets a chance to handle input in between.
+	if(!done)
+	{
+		gint64 trace_span = celluloid_trace_begin();
+		CelluloidModel *model = celluloid_model_new(-1);
+		gchar *pref_options =
+			g_settings_get_string(app->settings, "mpv-options");
+		gchar *options =
+			g_strjoin(" ", pref_options, app->mpv_options, NULL);
+
+		g_object_set(	model,
+				"extra-options", options,
+				"metadata-cache", app->metadata_cache,
+				NULL );
+		celluloid_model_initialize(model);
+		g_queue_push_tail(app->standby_models, model);
+
+		g_info(	"Initialized standby player core (%u/%u)",
+			g_queue_get_length(app->standby_models),
+			pool_size );
+		celluloid_trace_end("initialize-standby-model", trace_span);
+
+		done = g_queue_get_length(app->standby_models) >= pool_size;
+
+		g_free(options);
+		g_free(pref_options);
+	}
+
+	if(done)
+	{
+		app->standby_fill_id = 0;
+	}
+
+	return done?G_SOURCE_REMOVE:G_SOURCE_CONTINUE;
+}
+
+static void
+schedule_standby_fill(CelluloidApplication *app)
+{
+	if(app->standby_fill_id == 0)
+	{
+		app->standby_fill_id =
+			g_idle_add_full(	G_PRIORITY_LOW,
+						fill_standby_pool,
+						app,
+						NULL );
+	}
+}
+
+static void
+clear_standby_pool(CelluloidApplication *app, guint size)
+{
+	while(g_queue_get_length(app->standby_models) > size)
+	{
+		g_object_unref(g_queue_pop_tail(app->standby_models));
+	}
+}
+
+static void
+standby_pool_size_handler(GSettings *settings, gchar *key, gpointer data)
+{
+	CelluloidApplication *app = data;
+
+	clear_standby_pool(app, (guint)g_settings_get_int(settings, key));
+
+	if(app->controllers)
+	{
+		schedule_standby_fill(app);
+	}
+}
+
+static void
+controller_ready_handler(GObject *object, GParamSpec *pspec, gpointer data)
+{
+	gboolean ready = FALSE;
+
+	g_object_get(object, "ready", &ready, NULL);
+
+	// Wait until a window has its own core up and running so that
+	// standby cores don't compete with startup.
+	if(ready)
+	{
+		schedule_standby_fill(data);
+	}
+}
+
 static void
 new_window_handler(GSimpleAction *simple, GVariant *parameter, gpointer data)
 {
@@ -273,7 +416,11 @@ activate_handler(GApplication *gapp, gpointer data)
 	{
 		GtkApplication *gtkapp = GTK_APPLICATION(app);
 		GtkWindow *window = gtk_application_get_active_window(gtkapp);
-		gtk_window_present(window);
+
+		if(window)
+		{
+			gtk_window_present(window);
+		}
 	}
 }
 
@@ -281,13 +428,12 @@ static void
 open_files(CelluloidApplication *app, CelluloidFile **files, gint n_files)
 {
 	GApplication *gapp = G_APPLICATION(app);
-	GSettings *settings = g_settings_new(CONFIG_ROOT);
 
 	/* Only activate new-window if always-open-new-window is set. It is not
 	 * necessary to handle --new-window here since options_handler() would
 	 * have activated new-window already if it were set.
 	 */
-	if(g_settings_get_boolean(settings, "always-open-new-window"))
+	if(celluloid_settings_snapshot_get()->always_open_new_window)
 	{
 		activate_action_string(G_ACTION_MAP(gapp), "new-window");
 	}
@@ -298,18 +444,26 @@ open_files(CelluloidApplication *app, CelluloidFile **files, gint n_files)
 	{
 		GtkApplication *gtkapp = GTK_APPLICATION(gapp);
 		GtkWindow *window = gtk_application_get_active_window(gtkapp);
-		GActionMap *map = G_ACTION_MAP(window);
 		gchar *uri = celluloid_file_get_uri(files[i]);
 		gboolean append = i != 0 || app->enqueue;
-		GVariant *param = g_variant_new("(sb)", uri, append);
-		GAction *action = g_action_map_lookup_action(map, "open");
 
-		g_action_activate(action, param);
+		if(window)
+		{
+			GActionMap *map = G_ACTION_MAP(window);
+			GVariant *param = g_variant_new("(sb)", uri, append);
+			GAction *action = g_action_map_lookup_action(map, "open");
+
+			g_action_activate(action, param);
+		}
+		else if(app->controllers)
+		{
+			// Headless controllers don't have a window to route
+			// the open action through.
+			celluloid_controller_open(app->controllers->data, uri, append);
+		}
 
 		g_free(uri);
 	}
-
-	g_object_unref(settings);
 }
 
 static void
@@ -342,14 +496,21 @@ options_handler(GApplication *gapp, GVariantDict *options, gpointer data)
 	}
 	else
 	{
+		CelluloidApplication *app = data;
 		gboolean no_existing_session = FALSE;
 
 		g_variant_dict_lookup(	options,
 					"no-existing-session",
 					"b",
 					&no_existing_session );
+		g_variant_dict_lookup(	options,
+					"headless",
+					"b",
+					&app->headless );
 
-		if(no_existing_session)
+		// A headless instance is meant to be driven on its own over
+		// MPRIS, so it must not hand its files to a regular instance.
+		if(no_existing_session || app->headless)
 		{
 			GApplicationFlags flags = g_application_get_flags(gapp);
 
@@ -499,6 +660,8 @@ command_line_handler(	GApplication *gapp,
 static void
 startup_handler(GApplication *gapp, gpointer data)
 {
+	gint64 trace_span = celluloid_trace_begin();
+
 	g_set_application_name(_("Celluloid"));
 	gtk_window_set_default_icon_name(ICON_NAME);
 
@@ -510,6 +673,8 @@ startup_handler(GApplication *gapp, gpointer data)
 
 
 	g_info("Starting Celluloid " VERSION);
+
+	celluloid_trace_end("startup", trace_span);
 }
 
 static void
@@ -518,19 +683,49 @@ shutdown_handler(CelluloidController *controller, gpointer data)
 	CelluloidApplication *app = data;
 
 	app->controllers = g_slist_remove(app->controllers, controller);
+
+	if(!celluloid_controller_get_view(controller))
+	{
+		g_application_release(G_APPLICATION(app));
+	}
+
 	g_object_unref(controller);
-	g_free(app->mpv_options);
-	g_free(app->role);
+	g_clear_pointer(&app->mpv_options, g_free);
+	g_clear_pointer(&app->role, g_free);
 
 	if(!app->controllers)
 	{
+		g_source_clear(&app->standby_fill_id);
+		clear_standby_pool(app, 0);
 		celluloid_application_quit(data);
 	}
 }
 
+static void
+dispose(GObject *object)
+{
+	CelluloidApplication *app = CELLULOID_APPLICATION(object);
+
+	g_source_clear(&app->standby_fill_id);
+
+	if(app->standby_models)
+	{
+		clear_standby_pool(app, 0);
+		g_clear_pointer(&app->standby_models, g_queue_free);
+	}
+
+	g_clear_object(&app->metadata_cache);
+	g_clear_object(&app->settings);
+
+	celluloid_resume_store_save(celluloid_resume_store_get_default());
+
+	G_OBJECT_CLASS(celluloid_application_parent_class)->dispose(object);
+}
+
 static void
 celluloid_application_class_init(CelluloidApplicationClass *klass)
 {
+	G_OBJECT_CLASS(klass)->dispose = dispose;
 	G_APPLICATION_CLASS(klass)->local_command_line = local_command_line;
 }
 
@@ -542,8 +737,13 @@ celluloid_application_init(CelluloidApplication *app)
 	app->controllers = NULL;
 	app->enqueue = FALSE;
 	app->new_window = FALSE;
+	app->headless = FALSE;
 	app->mpv_options = NULL;
 	app->role = NULL;
+	app->settings = g_settings_new(CONFIG_ROOT);
+	app->metadata_cache = celluloid_metadata_cache_new();
+	app->standby_models = g_queue_new();
+	app->standby_fill_id = 0;
 
 	g_set_prgname(APP_ID);
 	g_action_map_add_action(G_ACTION_MAP(app), G_ACTION(new_window));
@@ -588,6 +788,14 @@ celluloid_application_init(CelluloidApplication *app)
 			G_OPTION_ARG_STRING,
 			_("Set the window role"),
 			NULL );
+	g_application_add_main_option
+		(	G_APPLICATION(app),
+			"headless",
+			'\0',
+			G_OPTION_FLAG_NONE,
+			G_OPTION_ARG_NONE,
+			_("Run without a window and accept commands over MPRIS"),
+			NULL );
 	g_application_add_main_option
 		(	G_APPLICATION(app),
 			"no-existing-session",
@@ -620,6 +828,11 @@ celluloid_application_init(CelluloidApplication *app)
 		(app, "activate", G_CALLBACK(activate_handler), app);
 	g_signal_connect
 		(app, "open", G_CALLBACK(open_handler), app);
+	g_signal_connect
+		(	app->settings,
+			"changed::standby-pool-size",
+			G_CALLBACK(standby_pool_size_handler),
+			app );
 }
 
 CelluloidApplication *
@@ -644,3 +857,23 @@ celluloid_application_get_mpv_options(CelluloidApplication *app)
 {
 	return app->mpv_options;
 }
+
+CelluloidMetadataCache *
+celluloid_application_get_metadata_cache(CelluloidApplication *app)
+{
+	return app->metadata_cache;
+}
+
+CelluloidModel *
+celluloid_application_take_standby_model(CelluloidApplication *app)
+{
+	CelluloidModel *model = g_queue_pop_head(app->standby_models);
+
+	if(model)
+	{
+		g_info("Using standby player core");
+		schedule_standby_fill(app);
+	}
+
+	return model;
+}
@@ -23,6 +23,8 @@
 #include <gtk/gtk.h>
 
 #include "celluloid-main-window.h"
+#include "celluloid-metadata-cache.h"
+#include "celluloid-model.h"
 #include "celluloid-mpv.h"
 
 G_BEGIN_DECLS
@@ -40,6 +42,12 @@ celluloid_application_quit(CelluloidApplication *app);
 const gchar *
 celluloid_application_get_mpv_options(CelluloidApplication *app);
 
+CelluloidMetadataCache *
+celluloid_application_get_metadata_cache(CelluloidApplication *app);
+
+CelluloidModel *
+celluloid_application_take_standby_model(CelluloidApplication *app);
+
 G_END_DECLS
 
 #endif
@@ -30,13 +30,34 @@
 #include "celluloid-main-window.h"
 #include "celluloid-control-box.h"
 
+gchar *
+celluloid_intern_string(const gchar *str)
+{
+	return str ? g_ref_string_new_intern(str) : NULL;
+}
+
+gchar *
+celluloid_acquire_string(gchar *str)
+{
+	return str ? g_ref_string_acquire(str) : NULL;
+}
+
+void
+celluloid_release_string(gchar *str)
+{
+	if(str)
+	{
+		g_ref_string_release(str);
+	}
+}
+
 CelluloidPlaylistEntry *
 celluloid_playlist_entry_new(const gchar *filename, const gchar *title)
 {
 	CelluloidPlaylistEntry *entry = g_malloc(sizeof(CelluloidPlaylistEntry));
 
-	entry->filename =	g_strdup(filename);
-	entry->title =		g_strdup(title);
+	entry->filename =	celluloid_intern_string(filename);
+	entry->title =		celluloid_intern_string(title);
 	entry->duration =	-1.0;
 	entry->metadata =	g_ptr_array_new_with_free_func
 				((GDestroyNotify)celluloid_metadata_entry_free);
@@ -49,8 +70,8 @@ celluloid_playlist_entry_free(CelluloidPlaylistEntry *entry)
 {
 	if(entry)
 	{
-		g_free(entry->filename);
-		g_free(entry->title);
+		celluloid_release_string(entry->filename);
+		celluloid_release_string(entry->title);
 		g_ptr_array_free(entry->metadata, TRUE);
 		g_free(entry);
 	}
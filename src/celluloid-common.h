@@ -35,6 +35,7 @@ typedef struct _CelluloidMetadataEntry CelluloidMetadataEntry;
 typedef struct CelluloidChapter CelluloidChapter;
 typedef struct CelluloidTrack CelluloidTrack;
 typedef struct CelluloidDisc CelluloidDisc;
+typedef struct CelluloidTimeRange CelluloidTimeRange;
 
 enum TrackType
 {
@@ -45,6 +46,10 @@ enum TrackType
 	TRACK_TYPE_N
 };
 
+/* filename and title are interned with celluloid_intern_string() so that the
+ * same URI or title is stored only once no matter how many playlists, items
+ * and cache entries refer to it. Use celluloid_release_string() to free them.
+ */
 struct _CelluloidPlaylistEntry
 {
 	gchar *filename;
@@ -79,6 +84,21 @@ struct CelluloidDisc
 	gchar *label;
 };
 
+struct CelluloidTimeRange
+{
+	gdouble start;
+	gdouble end;
+};
+
+gchar *
+celluloid_intern_string(const gchar *str);
+
+gchar *
+celluloid_acquire_string(gchar *str);
+
+void
+celluloid_release_string(gchar *str);
+
 CelluloidPlaylistEntry *
 celluloid_playlist_entry_new(const gchar *filename, const gchar *title);
 
@@ -24,6 +24,7 @@
 
 #include "celluloid-control-box.h"
 #include "celluloid-seek-bar.h"
+#include "celluloid-thumbnailer.h"
 
 enum
 {
@@ -40,8 +41,10 @@ enum
 	PROP_VOLUME_MAX,
 	PROP_VOLUME_POPUP_VISIBLE,
 	PROP_CHAPTER_LIST,
+	PROP_BUFFERED_RANGES,
 	PROP_CONTENT_TITLE,
 	PROP_NARROW,
+	PROP_THUMBNAILER,
 	N_PROPERTIES
 };
 
@@ -78,6 +81,8 @@ struct _CelluloidControlBox
 	gdouble volume_max;
 	gboolean volume_popup_visible;
 	GPtrArray *chapter_list;
+	GArray *buffered_ranges;
+	CelluloidThumbnailer *thumbnailer;
 };
 
 struct _CelluloidControlBoxClass
@@ -112,6 +117,9 @@ mpv_to_gtk_volume(	GBinding *binding,
 static void
 seek_handler(CelluloidSeekBar *seek_bar, gdouble value, gpointer data);
 
+static void
+scrub_handler(CelluloidSeekBar *seek_bar, gdouble value, gpointer data);
+
 static void
 notify_popover_visible_handler(GObject *self, GParamSpec *pspec, gpointer data);
 
@@ -237,10 +245,18 @@ set_property(	GObject *object,
 		self->chapter_list = g_value_get_pointer(value);
 		break;
 
+		case PROP_BUFFERED_RANGES:
+		self->buffered_ranges = g_value_get_pointer(value);
+		break;
+
 		case PROP_CONTENT_TITLE:
 		self->content_title = g_value_get_string(value);
 		break;
 
+		case PROP_THUMBNAILER:
+		self->thumbnailer = g_value_get_object(value);
+		break;
+
 		default:
 		G_OBJECT_WARN_INVALID_PROPERTY_ID(object, property_id, pspec);
 		break;
@@ -309,10 +325,18 @@ get_property(	GObject *object,
 		g_value_set_pointer(value, self->chapter_list);
 		break;
 
+		case PROP_BUFFERED_RANGES:
+		g_value_set_pointer(value, self->buffered_ranges);
+		break;
+
 		case PROP_CONTENT_TITLE:
 		g_value_set_string(value, self->content_title);
 		break;
 
+		case PROP_THUMBNAILER:
+		g_value_set_object(value, self->thumbnailer);
+		break;
+
 		default:
 		G_OBJECT_WARN_INVALID_PROPERTY_ID(object, property_id, pspec);
 		break;
@@ -349,6 +373,12 @@ seek_handler(CelluloidSeekBar *seek_bar, gdouble value, gpointer data)
 	g_signal_emit_by_name(data, "seek", value);
 }
 
+static void
+scrub_handler(CelluloidSeekBar *seek_bar, gdouble value, gpointer data)
+{
+	g_signal_emit_by_name(data, "scrub", value);
+}
+
 static void
 notify_popover_visible_handler(GObject *self, GParamSpec *pspec, gpointer data)
 {
@@ -637,6 +667,14 @@ celluloid_control_box_class_init(CelluloidControlBoxClass *klass)
 	g_object_class_install_property
 		(object_class, PROP_CHAPTER_LIST, pspec);
 
+	pspec = g_param_spec_pointer
+		(	"buffered-ranges",
+			"Buffered ranges",
+			"Time ranges of the current file that are cached",
+			G_PARAM_READWRITE );
+	g_object_class_install_property
+		(object_class, PROP_BUFFERED_RANGES, pspec);
+
 	pspec = g_param_spec_boolean
 		(	"narrow",
 			"Narrow",
@@ -645,6 +683,14 @@ celluloid_control_box_class_init(CelluloidControlBoxClass *klass)
 			G_PARAM_READWRITE );
 	g_object_class_install_property(object_class, PROP_NARROW, pspec);
 
+	pspec = g_param_spec_object
+		(	"thumbnailer",
+			"Thumbnailer",
+			"Source of the thumbnails shown over the seek bar",
+			CELLULOID_TYPE_THUMBNAILER,
+			G_PARAM_READWRITE );
+	g_object_class_install_property(object_class, PROP_THUMBNAILER, pspec);
+
 	g_signal_new(	"button-clicked",
 			G_TYPE_FROM_CLASS(klass),
 			G_SIGNAL_RUN_FIRST,
@@ -665,6 +711,16 @@ celluloid_control_box_class_init(CelluloidControlBoxClass *klass)
 			G_TYPE_NONE,
 			1,
 			G_TYPE_DOUBLE );
+	g_signal_new(	"scrub",
+			G_TYPE_FROM_CLASS(klass),
+			G_SIGNAL_RUN_FIRST,
+			0,
+			NULL,
+			NULL,
+			g_cclosure_marshal_VOID__DOUBLE,
+			G_TYPE_NONE,
+			1,
+			G_TYPE_DOUBLE );
 	g_signal_new(	"volume-changed",
 			G_TYPE_FROM_CLASS(klass),
 			G_SIGNAL_RUN_FIRST,
@@ -719,6 +775,8 @@ celluloid_control_box_init(CelluloidControlBox *box)
 	box->volume_max = 100.0;
 	box->volume_popup_visible = FALSE;
 	box->chapter_list = NULL;
+	box->buffered_ranges = NULL;
+	box->thumbnailer = NULL;
 
 	init_button(	box->play_button,
 			"media-playback-start-symbolic",
@@ -803,15 +861,24 @@ celluloid_control_box_init(CelluloidControlBox *box)
 	g_object_bind_property(	box, "chapter-list",
 				box->seek_bar, "chapter-list",
 				G_BINDING_DEFAULT );
+	g_object_bind_property(	box, "buffered-ranges",
+				box->seek_bar, "buffered-ranges",
+				G_BINDING_DEFAULT );
 	g_object_bind_property(	box, "pause",
 				box->seek_bar, "pause",
 				G_BINDING_DEFAULT );
 	g_object_bind_property(	box, "enabled",
 				box->seek_bar, "enabled",
 				G_BINDING_DEFAULT );
+	g_object_bind_property(	box, "thumbnailer",
+				box->seek_bar, "thumbnailer",
+				G_BINDING_DEFAULT );
 	g_object_bind_property(	box, "chapter-list",
 				box->secondary_seek_bar, "chapter-list",
 				G_BINDING_DEFAULT );
+	g_object_bind_property(	box, "buffered-ranges",
+				box->secondary_seek_bar, "buffered-ranges",
+				G_BINDING_DEFAULT );
 	g_object_bind_property(	box, "duration",
 				box->secondary_seek_bar, "duration",
 				G_BINDING_DEFAULT );
@@ -824,6 +891,9 @@ celluloid_control_box_init(CelluloidControlBox *box)
 	g_object_bind_property(	box, "enabled",
 				box->secondary_seek_bar, "enabled",
 				G_BINDING_DEFAULT );
+	g_object_bind_property(	box, "thumbnailer",
+				box->secondary_seek_bar, "thumbnailer",
+				G_BINDING_DEFAULT );
 	g_object_bind_property(	box, "content-title",
 				box->title_widget, "label",
 				G_BINDING_BIDIRECTIONAL );
@@ -858,6 +928,10 @@ celluloid_control_box_init(CelluloidControlBox *box)
 				"seek",
 				G_CALLBACK(seek_handler),
 				box );
+	g_signal_connect(	box->seek_bar,
+				"scrub",
+				G_CALLBACK(scrub_handler),
+				box );
 	g_signal_connect(	box->seek_bar,
 				"notify::popover-visible",
 				G_CALLBACK(notify_popover_visible_handler),
@@ -866,6 +940,10 @@ celluloid_control_box_init(CelluloidControlBox *box)
 				"seek",
 				G_CALLBACK(seek_handler),
 				box );
+	g_signal_connect(	box->secondary_seek_bar,
+				"scrub",
+				G_CALLBACK(scrub_handler),
+				box );
 	g_signal_connect(	box->forward_button,
 				"clicked",
 				G_CALLBACK(simple_signal_handler),
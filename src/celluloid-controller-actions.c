@@ -22,6 +22,8 @@
 #include "celluloid-controller-actions.h"
 #include "celluloid-controller-private.h"
 #include "celluloid-common.h"
+#include "celluloid-job-scheduler.h"
+#include "celluloid-def.h"
 
 static gboolean
 boolean_to_state(	GBinding *binding,
@@ -81,6 +83,11 @@ show_shortcuts_dialog_handler(	GSimpleAction *action,
 				GVariant *param,
 				gpointer data );
 
+static void
+show_log_window_handler(	GSimpleAction *action,
+				GVariant *param,
+				gpointer data );
+
 static void
 toggle_controls_handler(	GSimpleAction *action,
 				GVariant *param,
@@ -158,6 +165,18 @@ leave_fullscreen_handler(GSimpleAction *action, GVariant *param, gpointer data);
 static void
 set_video_size_handler(GSimpleAction *action, GVariant *param, gpointer data);
 
+static gchar *
+format_stats(const CelluloidStats *stats);
+
+static gboolean
+update_stats(gpointer data);
+
+static void
+toggle_stats_handler(GSimpleAction *action, GVariant *param, gpointer data);
+
+static void
+dump_stats_handler(GSimpleAction *action, GVariant *param, gpointer data);
+
 static void
 show_about_dialog_handler(	GSimpleAction *action,
 				GVariant *param,
@@ -368,6 +387,18 @@ show_shortcuts_dialog_handler(	GSimpleAction *action,
 	celluloid_view_show_shortcuts_dialog(celluloid_controller_get_view(data));
 }
 
+static void
+show_log_window_handler(	GSimpleAction *action,
+				GVariant *param,
+				gpointer data )
+{
+	CelluloidController *controller = data;
+	CelluloidLogBuffer *buffer =	celluloid_player_get_log_buffer
+					(CELLULOID_PLAYER(controller->model));
+
+	celluloid_view_show_log_window(controller->view, buffer);
+}
+
 static void
 toggle_controls_handler(GSimpleAction *action, GVariant *param, gpointer data)
 {
@@ -577,6 +608,79 @@ set_video_size_handler(GSimpleAction *action, GVariant *param, gpointer data)
 	g_object_set(controller->model, "window-scale", value, NULL);
 }
 
+static gchar *
+format_stats(const CelluloidStats *stats)
+{
+	gchar *player_text = celluloid_stats_format(stats);
+	gchar *jobs_text =	celluloid_job_scheduler_format_stats
+				(celluloid_job_scheduler_get_default());
+	gchar *text = g_strjoin("\n", player_text, jobs_text, NULL);
+
+	g_free(player_text);
+	g_free(jobs_text);
+
+	return text;
+}
+
+static gboolean
+update_stats(gpointer data)
+{
+	CelluloidController *controller = data;
+	CelluloidMainWindow *wnd = celluloid_view_get_main_window(controller->view);
+	CelluloidVideoArea *area = celluloid_main_window_get_video_area(wnd);
+	CelluloidStats *stats = celluloid_mpv_get_stats(CELLULOID_MPV(controller->model));
+	gchar *text = format_stats(stats);
+
+	celluloid_video_area_set_stats_text(area, text);
+	g_free(text);
+
+	return G_SOURCE_CONTINUE;
+}
+
+static void
+toggle_stats_handler(GSimpleAction *action, GVariant *param, gpointer data)
+{
+	CelluloidController *controller = data;
+	CelluloidMainWindow *wnd = celluloid_view_get_main_window(controller->view);
+	CelluloidVideoArea *area = celluloid_main_window_get_video_area(wnd);
+	const gboolean visible = !celluloid_video_area_get_stats_visible(area);
+
+	/* The panel is only refreshed while it is visible, and the properties
+	 * that only it needs are only observed during that time.
+	 */
+	g_source_clear(&controller->update_stats_id);
+	celluloid_player_set_stats_observed
+		(CELLULOID_PLAYER(controller->model), visible);
+
+	if(visible)
+	{
+		update_stats(controller);
+
+		controller->update_stats_id
+			= g_timeout_add(	STATS_UPDATE_INTERVAL,
+						update_stats,
+						controller );
+	}
+
+	celluloid_video_area_set_stats_visible(area, visible);
+}
+
+static void
+dump_stats_handler(GSimpleAction *action, GVariant *param, gpointer data)
+{
+	CelluloidController *controller = data;
+	CelluloidStats *stats = NULL;
+	gchar *text = NULL;
+
+	celluloid_player_read_stats(CELLULOID_PLAYER(controller->model));
+
+	stats = celluloid_mpv_get_stats(CELLULOID_MPV(controller->model));
+	text = format_stats(stats);
+
+	g_message("Statistics:\n%s", text);
+	g_free(text);
+}
+
 static void
 show_about_dialog_handler(GSimpleAction *action, GVariant *param, gpointer data)
 {
@@ -610,6 +714,8 @@ celluloid_controller_action_register_actions(CelluloidController *controller)
 			.change_state = toggle_loop_handler},
 			{.name = "show-shortcuts-dialog",
 			.activate = show_shortcuts_dialog_handler},
+			{.name = "show-log-window",
+			.activate = show_log_window_handler},
 			{.name = "toggle-controls",
 			.activate = toggle_controls_handler},
 			{.name = "set-controls-visible",
@@ -660,7 +766,11 @@ celluloid_controller_action_register_actions(CelluloidController *controller)
 			.activate = leave_fullscreen_handler},
 			{.name = "set-video-size",
 			.activate = set_video_size_handler,
-			.parameter_type = "d"} };
+			.parameter_type = "d"},
+			{.name = "toggle-stats",
+			.activate = toggle_stats_handler},
+			{.name = "dump-stats",
+			.activate = dump_stats_handler} };
 
 	CelluloidMainWindow *window =	celluloid_view_get_main_window
 					(controller->view);
@@ -43,6 +43,23 @@ get_full_keystr(guint keyval, GdkModifierType state);
 static void
 mouse_up(CelluloidController *controller, const guint button);
 
+static guint
+send_scroll(	CelluloidModel *model,
+		gdouble delta,
+		const gchar *negative_button,
+		const gchar *positive_button );
+
+static void
+flush_input(CelluloidController *controller);
+
+static gboolean
+input_tick_handler(	GtkWidget *widget,
+			GdkFrameClock *frame_clock,
+			gpointer data );
+
+static void
+queue_input(CelluloidController *controller);
+
 static gboolean
 key_pressed_handler(	GtkEventControllerKey *key_controller,
 			guint keyval,
@@ -163,6 +180,114 @@ mouse_up(CelluloidController *controller, const guint button)
 	g_free(name);
 }
 
+static guint
+send_scroll(	CelluloidModel *model,
+		gdouble delta,
+		const gchar *negative_button,
+		const gchar *positive_button )
+{
+	const gchar *button_name = delta < 0 ? negative_button : positive_button;
+	const guint count = (guint)ABS(delta);
+
+	for(guint i = 0; i < count; i++)
+	{
+		celluloid_model_key_press(model, button_name);
+	}
+
+	return count;
+}
+
+static void
+flush_input(CelluloidController *controller)
+{
+	if(!controller->model)
+	{
+		controller->pointer_pending = FALSE;
+	}
+
+	// The pointer goes first so that scrolling and clicks that were queued
+	// after it happen at the right position.
+	if(controller->pointer_pending)
+	{
+		celluloid_model_mouse
+			(	controller->model,
+				controller->pointer_x,
+				controller->pointer_y );
+		celluloid_stats_add_input_events
+			(	celluloid_mpv_get_stats
+				(CELLULOID_MPV(controller->model)),
+				CELLULOID_STATS_INPUT_POINTER,
+				controller->pointer_events,
+				1 );
+	}
+
+	// Deltas in opposite directions cancel out. Only one of them can be
+	// non-zero unless the direction changed within a single frame.
+	if(controller->model && controller->scroll_events > 0)
+	{
+		guint sent = 0;
+
+		sent +=	send_scroll(	controller->model,
+					controller->scroll_dx,
+					"MOUSE_BTN5",
+					"MOUSE_BTN6" );
+		sent +=	send_scroll(	controller->model,
+					controller->scroll_dy,
+					"MOUSE_BTN3",
+					"MOUSE_BTN4" );
+
+		celluloid_stats_add_input_events
+			(	celluloid_mpv_get_stats
+				(CELLULOID_MPV(controller->model)),
+				CELLULOID_STATS_INPUT_SCROLL,
+				controller->scroll_events,
+				sent );
+	}
+
+	controller->pointer_pending = FALSE;
+	controller->pointer_events = 0;
+	controller->scroll_dx = 0;
+	controller->scroll_dy = 0;
+	controller->scroll_events = 0;
+}
+
+static gboolean
+input_tick_handler(	GtkWidget *widget,
+			GdkFrameClock *frame_clock,
+			gpointer data )
+{
+	CelluloidController *controller = data;
+
+	controller->input_tick_id = 0;
+	flush_input(controller);
+
+	return G_SOURCE_REMOVE;
+}
+
+static void
+queue_input(CelluloidController *controller)
+{
+	/* Pointers and wheels may report events several times per frame.
+	 * mpv can't do anything with them until the next frame is drawn, so
+	 * they are collected and sent once per frame clock tick.
+	 */
+	if(controller->input_tick_id == 0)
+	{
+		CelluloidMainWindow *wnd =
+			celluloid_view_get_main_window(controller->view);
+		CelluloidVideoArea *video_area =
+			celluloid_main_window_get_video_area(wnd);
+		GtkStack *stack =
+			celluloid_video_area_get_stack(video_area);
+
+		controller->input_tick_id =
+			gtk_widget_add_tick_callback(	GTK_WIDGET(stack),
+							input_tick_handler,
+							controller,
+							NULL );
+	}
+}
+
 static gboolean
 key_pressed_handler(	GtkEventControllerKey *key_controller,
 			guint keyval,
@@ -180,13 +305,37 @@ key_pressed_handler(	GtkEventControllerKey *key_controller,
 	const gboolean in_mpv_keymap =
 		celluloid_model_input_binding_exists(controller->model, keystr);
 
+	const gboolean handled =
+		keystr && !playlist_visible && in_mpv_keymap;
+
 	if(keystr && !playlist_visible)
 	{
-		celluloid_model_key_down(controller->model, keystr);
-		g_free(keystr);
+		// mpv repeats held keys by itself and ignores keydown for a
+		// key that is already down, so the repeats that GTK reports
+		// don't need to be sent.
+		const gboolean repeat =
+			g_strcmp0(keystr, controller->held_key) == 0;
+
+		celluloid_stats_add_input_events
+			(	celluloid_mpv_get_stats
+				(CELLULOID_MPV(controller->model)),
+				CELLULOID_STATS_INPUT_KEY,
+				1,
+				!repeat );
+
+		if(!repeat)
+		{
+			flush_input(controller);
+			celluloid_model_key_down(controller->model, keystr);
+
+			g_free(controller->held_key);
+			controller->held_key = g_strdup(keystr);
+		}
 	}
 
-	return keystr && !playlist_visible && in_mpv_keymap;
+	g_free(keystr);
+
+	return handled;
 }
 
 static void
@@ -205,9 +354,12 @@ key_released_handler(	GtkEventControllerKey *key_controller,
 
 	if(keystr && !playlist_visible)
 	{
+		flush_input(controller);
 		celluloid_model_key_up(controller->model, keystr);
 		g_free(keystr);
 	}
+
+	g_clear_pointer(&controller->held_key, g_free);
 }
 
 static void
@@ -227,6 +379,7 @@ button_pressed_handler(	GtkGestureSingle *gesture,
 		gchar *button_name =
 			g_strdup_printf("MOUSE_BTN%u", button_number - 1);
 
+		flush_input(controller);
 		celluloid_model_key_down(controller->model, button_name);
 		g_free(button_name);
 
@@ -271,7 +424,12 @@ mouse_move_handler(	GtkEventControllerMotion *motion_controller,
 
 	if(controller->model)
 	{
-		celluloid_model_mouse(controller->model, (gint)x, (gint)y);
+		controller->pointer_pending = TRUE;
+		controller->pointer_x = (gint)x;
+		controller->pointer_y = (gint)y;
+		controller->pointer_events++;
+
+		queue_input(controller);
 	}
 
 	return FALSE;
@@ -283,51 +441,22 @@ scroll_handler(	GtkEventControllerScroll *scroll_controller,
 		gdouble dy,
 		gpointer data )
 {
-	guint button = 0;
-	gint count = 0;
+	CelluloidController *controller = data;
 
 	/* Only one axis will be used at a time to prevent accidental activation
 	 * of commands bound to buttons associated with the other axis.
 	 */
 	if(ABS(dx) > ABS(dy))
 	{
-		count = (gint)ABS(dx);
-
-		if(dx <= -1)
-		{
-			button = 6;
-		}
-		else if(dx >= 1)
-		{
-			button = 7;
-		}
+		controller->scroll_dx += dx;
 	}
 	else
 	{
-		count = (gint)ABS(dy);
-
-		if(dy <= -1)
-		{
-			button = 4;
-		}
-		else if(dy >= 1)
-		{
-			button = 5;
-		}
+		controller->scroll_dy += dy;
 	}
 
-	if(button > 0)
-	{
-		gchar *button_name = g_strdup_printf("MOUSE_BTN%u", button - 1);
-		CelluloidModel *model = CELLULOID_CONTROLLER(data)->model;
-
-		while(count-- > 0)
-		{
-			celluloid_model_key_press(model, button_name);
-		}
-
-		g_free(button_name);
-	}
+	controller->scroll_events++;
+	queue_input(controller);
 
 	return TRUE;
 }
@@ -402,6 +531,13 @@ celluloid_controller_input_disconnect_signals(CelluloidController *controller)
 	GtkStack *stack =
 		celluloid_video_area_get_stack(video_area);
 
+	if(controller->input_tick_id != 0)
+	{
+		gtk_widget_remove_tick_callback
+			(GTK_WIDGET(stack), controller->input_tick_id);
+		controller->input_tick_id = 0;
+	}
+
 	gtk_widget_remove_controller
 		(GTK_WIDGET(stack), controller->motion_controller);
 	gtk_widget_remove_controller
@@ -30,6 +30,7 @@ enum
 {
 	PROP_0,
 	PROP_APP,
+	PROP_HEADLESS,
 	PROP_READY,
 	PROP_IDLE,
 	PROP_USE_SKIP_BUTTONS_FOR_PLAYLIST,
@@ -49,13 +50,27 @@ struct _CelluloidController
 	CelluloidApplication *app;
 	CelluloidModel *model;
 	CelluloidView *view;
+	gboolean headless;
 	gboolean ready;
 	gboolean idle;
 	gboolean use_skip_buttons_for_playlist;
 	gboolean dark_theme_enable;
+	gboolean first_frame_rendered;
+	gboolean standby;
+	gint64 open_time;
 	gint64 target_playlist_pos;
 	guint update_seekbar_id;
+	guint update_stats_id;
 	guint resize_timeout_tag;
+	guint input_tick_id;
+	gboolean pointer_pending;
+	gint pointer_x;
+	gint pointer_y;
+	guint pointer_events;
+	gdouble scroll_dx;
+	gdouble scroll_dy;
+	guint scroll_events;
+	gchar *held_key;
 	GBinding *skip_buttons_binding;
 	GSettings *settings;
 	CelluloidMpris *mpris;
@@ -32,6 +32,8 @@
 #include "celluloid-controller-input.h"
 #include "celluloid-file.h"
 #include "celluloid-player-options.h"
+#include "celluloid-settings-snapshot.h"
+#include "celluloid-trace.h"
 #include "celluloid-def.h"
 
 static void
@@ -132,6 +134,9 @@ set_dark_theme_enable(CelluloidController *controller, gboolean value);
 static void
 connect_signals(CelluloidController *controller);
 
+static void
+connect_view_signals(CelluloidController *controller);
+
 static gboolean
 update_seek_bar(gpointer data);
 
@@ -230,6 +235,9 @@ fullscreen_button_handler(GtkButton *button, gpointer data);
 static void
 seek_handler(GtkButton *button, gdouble value, gpointer data);
 
+static void
+scrub_handler(GtkButton *button, gdouble value, gpointer data);
+
 static void
 celluloid_controller_class_init(CelluloidControllerClass *klass);
 
@@ -254,6 +262,41 @@ constructed(GObject *object)
 	gint64 wid;
 
 	controller = CELLULOID_CONTROLLER(object);
+	controller->open_time = g_get_monotonic_time();
+
+	g_signal_connect(	controller->settings,
+				"changed::mpris-enable",
+				G_CALLBACK(mpris_enable_handler),
+				controller );
+
+	// Without a view there is no video area to embed into and no GL
+	// context, so the model gets a core with vo=null and is initialized
+	// right away instead of waiting for the view to become ready.
+	if(controller->headless)
+	{
+		controller->model = celluloid_model_new(0);
+
+		g_object_set(	controller->model,
+				"metadata-cache",
+				celluloid_application_get_metadata_cache
+				(controller->app),
+				NULL );
+
+		connect_signals(controller);
+		update_extra_mpv_options(controller);
+		g_idle_add(initialize_model, controller);
+
+		if(g_settings_get_boolean(controller->settings, "mpris-enable"))
+		{
+			controller->mpris = celluloid_mpris_new(controller);
+		}
+
+		G_OBJECT_CLASS(celluloid_controller_parent_class)
+			->constructed(object);
+
+		return;
+	}
+
 	always_floating =	g_settings_get_boolean
 				(	controller->settings,
 					"always-use-floating-controls" );
@@ -262,7 +305,19 @@ constructed(GObject *object)
 	window = CELLULOID_MAIN_WINDOW(controller->view);
 	video_area = celluloid_main_window_get_video_area(window);
 	wid = celluloid_video_area_get_xid(video_area);
-	controller->model = celluloid_model_new(wid);
+	controller->model =	celluloid_application_take_standby_model
+				(controller->app);
+	controller->standby = !!controller->model;
+
+	if(!controller->model)
+	{
+		controller->model = celluloid_model_new(wid);
+	}
+
+	g_object_set(	controller->model,
+			"metadata-cache",
+			celluloid_application_get_metadata_cache(controller->app),
+			NULL );
 
 	connect_signals(controller);
 	celluloid_controller_action_register_actions(controller);
@@ -272,11 +327,6 @@ constructed(GObject *object)
 	gtk_widget_add_controller(GTK_WIDGET(window), controller->key_controller);
 	gtk_widget_set_visible(GTK_WIDGET(window), TRUE);
 
-	g_signal_connect(	controller->settings,
-				"changed::mpris-enable",
-				G_CALLBACK(mpris_enable_handler),
-				controller );
-
 	if(g_settings_get_boolean(controller->settings, "mpris-enable"))
 	{
 		controller->mpris = celluloid_mpris_new(controller);
@@ -299,6 +349,10 @@ set_property(	GObject *object,
 		self->app = g_value_get_pointer(value);
 		break;
 
+		case PROP_HEADLESS:
+		self->headless = g_value_get_boolean(value);
+		break;
+
 		case PROP_READY:
 		self->ready = g_value_get_boolean(value);
 		break;
@@ -346,6 +400,10 @@ get_property(	GObject *object,
 		g_value_set_pointer(value, self->app);
 		break;
 
+		case PROP_HEADLESS:
+		g_value_set_boolean(value, self->headless);
+		break;
+
 		case PROP_READY:
 		g_value_set_boolean(value, self->ready);
 		break;
@@ -377,17 +435,22 @@ dispose(GObject *object)
 	g_clear_object(&controller->mpris);
 
 	g_source_clear(&controller->update_seekbar_id);
+	g_source_clear(&controller->update_stats_id);
 	g_source_clear(&controller->resize_timeout_tag);
 
-	if(controller->view)
+	if(controller->model)
 	{
 		inhibit_idle(controller, FALSE);
+	}
 
+	if(controller->view)
+	{
 		gtk_widget_remove_controller
 			(	GTK_WIDGET(controller->view),
 				controller->key_controller );
 
 		celluloid_controller_input_disconnect_signals(controller);
+		g_clear_pointer(&controller->held_key, g_free);
 
 		celluloid_view_make_gl_context_current(controller->view);
 		g_clear_object(&controller->model);
@@ -400,6 +463,8 @@ dispose(GObject *object)
 		controller->view = NULL;
 	}
 
+	g_clear_object(&controller->model);
+
 	G_OBJECT_CLASS(celluloid_controller_parent_class)->dispose(object);
 }
 
@@ -436,10 +501,16 @@ set_video_area_status(	CelluloidController *controller,
 			CelluloidVideoAreaStatus status )
 {
 	CelluloidView *view = controller->view;
-	CelluloidMainWindow *window = celluloid_view_get_main_window(view);
-	CelluloidVideoArea *area = celluloid_main_window_get_video_area(window);
 
-	celluloid_video_area_set_status(area, status);
+	if(view)
+	{
+		CelluloidMainWindow *window =
+			celluloid_view_get_main_window(view);
+		CelluloidVideoArea *area =
+			celluloid_main_window_get_video_area(window);
+
+		celluloid_video_area_set_status(area, status);
+	}
 }
 
 static void
@@ -466,12 +537,34 @@ initialize_model(gpointer data)
 	CelluloidMpv *mpv = CELLULOID_MPV(model);
 	CelluloidView *view = controller->view;
 	gboolean maximized = FALSE;
+	gboolean ready = FALSE;
+	gint64 trace_span = celluloid_trace_begin();
+
+	if(view)
+	{
+		celluloid_player_options_init
+			(player, CELLULOID_MAIN_WINDOW(view));
+		celluloid_view_make_gl_context_current(view);
+	}
 
-	celluloid_player_options_init(player, CELLULOID_MAIN_WINDOW(view));
 	celluloid_model_initialize(model);
+	g_object_get(model, "ready", &ready, NULL);
 
-	g_object_get(view, "maximized", &maximized, NULL);
-	celluloid_mpv_set_property_flag(mpv, "window-maximized", maximized);
+	// Standby models are ready before the controller gets connected, so
+	// the usual notify::ready never arrives unless they had to be reset.
+	if(ready && !controller->ready)
+	{
+		model_ready_handler(G_OBJECT(model), NULL, controller);
+	}
+
+	if(view)
+	{
+		g_object_get(view, "maximized", &maximized, NULL);
+		celluloid_mpv_set_property_flag
+			(mpv, "window-maximized", maximized);
+	}
+
+	celluloid_trace_end("initialize-model", trace_span);
 
 	return G_SOURCE_REMOVE;
 }
@@ -479,6 +572,7 @@ initialize_model(gpointer data)
 static void
 view_ready_handler(CelluloidView *view, gpointer data)
 {
+	celluloid_trace_mark("view-ready");
 	g_idle_add(initialize_model, data);
 }
 
@@ -496,6 +590,20 @@ render_handler(CelluloidView *view, gpointer data)
 		(controller->view, &width, &height);
 	celluloid_model_render_frame
 		(controller->model, scale*width, scale*height);
+
+	if(!controller->first_frame_rendered && !controller->idle)
+	{
+		const gint64 latency =
+			g_get_monotonic_time() - controller->open_time;
+
+		controller->first_frame_rendered = TRUE;
+		celluloid_trace_mark("first-frame");
+
+		g_info(	"First frame rendered %.1f ms after opening window "
+			"(standby core: %s)",
+			(gdouble)latency/1000.0,
+			controller->standby?"yes":"no" );
+	}
 }
 
 static void
@@ -504,8 +612,11 @@ mpv_reset_request_handler(CelluloidView *view, gpointer data)
 	CelluloidController *controller = data;
 
 	update_extra_mpv_options(controller);
+
+	// Most option changes can be applied to the running core. The GL
+	// context only needs to be current if it has to be recreated.
 	celluloid_view_make_gl_context_current(controller->view);
-	celluloid_model_reset(controller->model);
+	celluloid_model_apply_options(controller->model);
 }
 
 static void
@@ -665,6 +776,12 @@ set_use_skip_button_for_playlist(	CelluloidController *controller,
 	if(controller->skip_buttons_binding)
 	{
 		g_binding_unbind(controller->skip_buttons_binding);
+		controller->skip_buttons_binding = NULL;
+	}
+
+	if(!controller->view)
+	{
+		return;
 	}
 
 	controller->skip_buttons_binding
@@ -704,6 +821,37 @@ connect_signals(CelluloidController *controller)
 	g_object_bind_property(	controller->model, "core-idle",
 				controller, "idle",
 				G_BINDING_DEFAULT );
+
+	g_signal_connect(	controller->model,
+				"notify::ready",
+				G_CALLBACK(model_ready_handler),
+				controller );
+	g_signal_connect(	controller->model,
+				"notify::idle-active",
+				G_CALLBACK(idle_active_handler),
+				controller );
+	g_signal_connect(	controller->model,
+				"message",
+				G_CALLBACK(message_handler),
+				controller );
+	g_signal_connect(	controller->model,
+				"error",
+				G_CALLBACK(error_handler),
+				controller );
+	g_signal_connect(	controller->model,
+				"shutdown",
+				G_CALLBACK(shutdown_handler),
+				controller );
+
+	if(controller->view)
+	{
+		connect_view_signals(controller);
+	}
+}
+
+static void
+connect_view_signals(CelluloidController *controller)
+{
 	g_object_bind_property(	controller->model, "fullscreen",
 				controller->view, "fullscreened",
 				G_BINDING_BIDIRECTIONAL );
@@ -728,12 +876,18 @@ connect_signals(CelluloidController *controller)
 	g_object_bind_property(	controller->model, "duration",
 				controller->view, "duration",
 				G_BINDING_DEFAULT );
+	g_object_bind_property(	controller->model, "path",
+				controller->view, "path",
+				G_BINDING_DEFAULT );
 	g_object_bind_property(	controller->model, "playlist-pos",
 				controller->view, "playlist-pos",
 				G_BINDING_DEFAULT );
 	g_object_bind_property(	controller->model, "chapter-list",
 				controller->view, "chapter-list",
 				G_BINDING_DEFAULT );
+	g_object_bind_property(	controller->model, "buffered-ranges",
+				controller->view, "buffered-ranges",
+				G_BINDING_DEFAULT );
 	g_object_bind_property(	controller->model, "track-list",
 				controller->view, "track-list",
 				G_BINDING_DEFAULT );
@@ -760,14 +914,6 @@ connect_signals(CelluloidController *controller)
 				controller->model, "shuffle",
 				G_BINDING_BIDIRECTIONAL|G_BINDING_SYNC_CREATE );
 
-	g_signal_connect(	controller->model,
-				"notify::ready",
-				G_CALLBACK(model_ready_handler),
-				controller );
-	g_signal_connect(	controller->model,
-				"notify::idle-active",
-				G_CALLBACK(idle_active_handler),
-				controller );
 	g_signal_connect(	controller->model,
 				"notify::playlist",
 				G_CALLBACK(playlist_handler),
@@ -800,18 +946,6 @@ connect_signals(CelluloidController *controller)
 				"window-move",
 				G_CALLBACK(window_move_handler),
 				controller );
-	g_signal_connect(	controller->model,
-				"message",
-				G_CALLBACK(message_handler),
-				controller );
-	g_signal_connect(	controller->model,
-				"error",
-				G_CALLBACK(error_handler),
-				controller );
-	g_signal_connect(	controller->model,
-				"shutdown",
-				G_CALLBACK(shutdown_handler),
-				controller );
 
 	g_signal_connect(	controller->view,
 				"video-area-resize",
@@ -861,6 +995,10 @@ connect_signals(CelluloidController *controller)
 				"seek",
 				G_CALLBACK(seek_handler),
 				controller );
+	g_signal_connect(	controller->view,
+				"scrub",
+				G_CALLBACK(scrub_handler),
+				controller );
 
 	g_signal_connect(	controller->view,
 				"ready",
@@ -958,7 +1096,10 @@ idle_active_handler(GObject *object, GParamSpec *pspec, gpointer data)
 		// point, so we need to use "playlist" directly.
 		g_object_get(model, "playlist", &playlist, NULL);
 
-		celluloid_view_reset(view);
+		if(view)
+		{
+			celluloid_view_reset(view);
+		}
 
 		if(playlist->len <= 0)
 		{
@@ -1061,10 +1202,14 @@ model_ready_handler(GObject *object, GParamSpec *pspec, gpointer data)
 	}
 
 	g_source_clear(&controller->update_seekbar_id);
-	controller->update_seekbar_id
-		= g_timeout_add(	SEEK_BAR_UPDATE_INTERVAL,
-					(GSourceFunc)update_seek_bar,
-					controller );
+
+	if(controller->view)
+	{
+		controller->update_seekbar_id
+			= g_timeout_add(	SEEK_BAR_UPDATE_INTERVAL,
+						(GSourceFunc)update_seek_bar,
+						controller );
+	}
 
 	controller->ready = ready;
 	g_object_notify(data, "ready");
@@ -1073,14 +1218,10 @@ model_ready_handler(GObject *object, GParamSpec *pspec, gpointer data)
 static void
 playlist_replaced_handler(CelluloidModel *model, gpointer data)
 {
-	GSettings *settings = g_settings_new(CONFIG_ROOT);
-
-	if(g_settings_get_boolean(settings, "present-window-on-file-open"))
+	if(celluloid_settings_snapshot_get()->present_window_on_file_open)
 	{
 		celluloid_view_present(CELLULOID_CONTROLLER(data)->view);
 	}
-
-	g_object_unref(settings);
 }
 
 static void
@@ -1135,7 +1276,7 @@ message_handler(CelluloidMpv *mpv, const gchar *message, gpointer data)
 		CelluloidView *view = controller->view;
 		GActionMap *map = NULL;
 
-		if(g_str_has_prefix(action, "win."))
+		if(view && g_str_has_prefix(action, "win."))
 		{
 			map = G_ACTION_MAP(celluloid_view_get_main_window(view));
 		}
@@ -1163,8 +1304,16 @@ error_handler(CelluloidMpv *mpv, const gchar *message, gpointer data)
 {
 	CelluloidController *controller = CELLULOID_CONTROLLER(data);
 
-	celluloid_view_show_message_toast(controller->view, message);
-	set_video_area_status(controller, CELLULOID_VIDEO_AREA_STATUS_IDLE);
+	if(controller->view)
+	{
+		celluloid_view_show_message_toast(controller->view, message);
+		set_video_area_status
+			(controller, CELLULOID_VIDEO_AREA_STATUS_IDLE);
+	}
+	else
+	{
+		g_warning("%s", message);
+	}
 }
 
 static void
@@ -1351,6 +1500,12 @@ seek_handler(GtkButton *button, gdouble value, gpointer data)
 	celluloid_model_seek(CELLULOID_CONTROLLER(data)->model, value);
 }
 
+static void
+scrub_handler(GtkButton *button, gdouble value, gpointer data)
+{
+	celluloid_model_scrub(CELLULOID_CONTROLLER(data)->model, value);
+}
+
 static void
 inhibit_idle(CelluloidController *controller, gboolean inhibit)
 {
@@ -1359,7 +1514,9 @@ inhibit_idle(CelluloidController *controller, gboolean inhibit)
 	GtkApplication *app =
 		GTK_APPLICATION(controller->app);
 	GtkWindow *main_window =
-		GTK_WINDOW(celluloid_view_get_main_window(controller->view));
+		controller->view ?
+		GTK_WINDOW(celluloid_view_get_main_window(controller->view)) :
+		NULL;
 
 	if (	inhibit &&
 		controller->inhibit_cookie == 0 &&
@@ -1400,6 +1557,14 @@ celluloid_controller_class_init(CelluloidControllerClass *klass)
 			G_PARAM_CONSTRUCT_ONLY|G_PARAM_READWRITE );
 	g_object_class_install_property(obj_class, PROP_APP, pspec);
 
+	pspec = g_param_spec_boolean
+		(	"headless",
+			"Headless",
+			"Whether to run without a view",
+			FALSE,
+			G_PARAM_CONSTRUCT_ONLY|G_PARAM_READWRITE );
+	g_object_class_install_property(obj_class, PROP_HEADLESS, pspec);
+
 	pspec = g_param_spec_boolean
 		(	"ready",
 			"Ready",
@@ -1465,11 +1630,25 @@ celluloid_controller_init(CelluloidController *controller)
 	controller->app = NULL;
 	controller->model = NULL;
 	controller->view = NULL;
+	controller->headless = FALSE;
 	controller->ready = FALSE;
 	controller->idle = TRUE;
 	controller->target_playlist_pos = -1;
 	controller->update_seekbar_id = 0;
+	controller->update_stats_id = 0;
+	controller->first_frame_rendered = FALSE;
+	controller->standby = FALSE;
+	controller->open_time = 0;
 	controller->resize_timeout_tag = 0;
+	controller->input_tick_id = 0;
+	controller->pointer_pending = FALSE;
+	controller->pointer_x = 0;
+	controller->pointer_y = 0;
+	controller->pointer_events = 0;
+	controller->scroll_dx = 0;
+	controller->scroll_dy = 0;
+	controller->scroll_events = 0;
+	controller->held_key = NULL;
 	controller->skip_buttons_binding = NULL;
 	controller->settings = g_settings_new(CONFIG_ROOT);
 	controller->mpris = NULL;
@@ -1501,10 +1680,28 @@ celluloid_controller_new(CelluloidApplication *app)
 	return CELLULOID_CONTROLLER(g_object_new(type, "app", app, NULL));
 }
 
+CelluloidController *
+celluloid_controller_new_headless(CelluloidApplication *app)
+{
+	const GType type = celluloid_controller_get_type();
+
+	return CELLULOID_CONTROLLER(g_object_new(	type,
+							"app", app,
+							"headless", TRUE,
+							NULL ));
+}
+
 void
 celluloid_controller_quit(CelluloidController *controller)
 {
-	celluloid_view_quit(controller->view);
+	if(controller->view)
+	{
+		celluloid_view_quit(controller->view);
+	}
+	else
+	{
+		g_signal_emit_by_name(controller, "shutdown");
+	}
 }
 
 void
@@ -1518,7 +1715,11 @@ celluloid_controller_autofit(	CelluloidController *controller,
 	g_object_get(G_OBJECT(controller->model), "vid", &vid, NULL);
 	celluloid_model_get_video_geometry(controller->model, &width, &height);
 
-	if(vid && strncmp(vid, "no", 3) != 0 && width >= 0 && width >= 0)
+	if(	controller->view &&
+		vid &&
+		strncmp(vid, "no", 3) != 0 &&
+		width >= 0 &&
+		width >= 0 )
 	{
 		gint new_width = (gint)(multiplier*(gdouble)width);
 		gint new_height = (gint)(multiplier*(gdouble)height);
@@ -1536,7 +1737,10 @@ celluloid_controller_autofit(	CelluloidController *controller,
 void
 celluloid_controller_present(CelluloidController *controller)
 {
-	celluloid_view_present(controller->view);
+	if(controller->view)
+	{
+		celluloid_view_present(controller->view);
+	}
 }
 
 void
@@ -34,6 +34,9 @@ G_DECLARE_FINAL_TYPE(CelluloidController, celluloid_controller, CELLULOID, CONTR
 CelluloidController *
 celluloid_controller_new(CelluloidApplication *app);
 
+CelluloidController *
+celluloid_controller_new_headless(CelluloidApplication *app);
+
 void
 celluloid_controller_quit(CelluloidController *controller);
 
@@ -28,6 +28,8 @@
 #define CONFIG_WIN_STATE CONFIG_ROOT".window-state"
 #define ACTION_PREFIX "celluloid-action"
 #define DEFAULT_LOG_LEVEL MPV_LOG_LEVEL_ERROR
+#define LOG_BUFFER_SIZE 4096
+#define LOG_WINDOW_UPDATE_INTERVAL 250
 #define MPRIS_TRACK_LIST_BEFORE 10
 #define MPRIS_TRACK_LIST_AFTER 10
 #define MPRIS_TRACK_ID_NO_TRACK "/org/mpris/MediaPlayer2/TrackList/NoTrack"
@@ -43,8 +45,27 @@
 #define MAIN_WINDOW_DEFAULT_WIDTH 625
 #define MAIN_WINDOW_DEFAULT_HEIGHT 400
 #define SEEK_BAR_UPDATE_INTERVAL 250
+#define STATS_UPDATE_INTERVAL 500
+#define BUFFERED_RANGES_UPDATE_INTERVAL 500
 #define FS_CONTROL_HIDE_DELAY 1
 #define KEYSTRING_MAX_LEN 16
+#define INPUT_SECTION_NAME "celluloid"
+#define PRELOAD_LEAD_TIME 10
+#define PRELOAD_CHECK_INTERVAL 2
+#define PRELOAD_READAHEAD_SIZE (8*1024*1024)
+#define PRELOAD_CHUNK_SIZE (256*1024)
+#define RESUME_STORE_SAVE_DELAY 5
+#define RESUME_STORE_MAX_ENTRIES 50000
+#define RESUME_STORE_PLAYED_FRACTION 0.9
+#define THUMBNAIL_WIDTH 160
+#define THUMBNAIL_BUCKETS 256
+#define THUMBNAIL_MIN_INTERVAL 2.0
+#define THUMBNAIL_CACHE_SIZE (32*1024*1024)
+#define THUMBNAIL_DISK_CACHE_SIZE (128*1024*1024)
+#define JOB_SCHEDULER_MAX_WORKERS 2
+#define JOB_SCHEDULER_THROTTLE_TIME 2000
+#define JOB_WORKER_IDLE_TIMEOUT 10
+#define JOB_RUN_TIME_LIMIT 60
 #define MIN_MPV_MAJOR 0
 #define MIN_MPV_MINOR 29
 #define MIN_MPV_PATCH 0
@@ -103,6 +124,7 @@
 		"Ctrl+? script-message celluloid-action win.show-shortcuts-dialog",\
 		"Ctrl+, script-message celluloid-action win.show-preferences-dialog",\
 		"F9 script-message celluloid-action win.toggle-playlist",\
+		"Ctrl+i script-message celluloid-action win.toggle-stats",\
 		"DEL script-message celluloid-action win.remove-selected-playlist-item",\
 		"U stop",\
 		"STOP stop",\
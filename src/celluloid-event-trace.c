@@ -0,0 +1,982 @@
+/*
+ * Copyright (c) 2025 gnome-mpv
+ *
+ * This file is part of Celluloid.
+ *
+ * Celluloid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Celluloid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Celluloid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gio/gio.h>
+#include <glib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "celluloid-event-trace.h"
+
+/* Event tracing is enabled by setting this environment variable to a
+ * directory. Every CelluloidMpv instance then writes the events it
+ * dispatches to its own file in that directory.
+ *
+ * A trace starts with EVENT_TRACE_MAGIC followed by the format version, and
+ * is followed by one record per event. All integers are little-endian.
+ * Each record contains the time in microseconds since the trace was
+ * created, the event ID, the error code, and the reply userdata, followed
+ * by a payload that depends on the event ID. Events whose data Celluloid
+ * doesn't use have no payload.
+ */
+#define EVENT_TRACE_DIR_ENV_VAR "CELLULOID_EVENT_TRACE_DIR"
+#define EVENT_TRACE_MAGIC "CLDEVTRC"
+#define EVENT_TRACE_MAGIC_LENGTH 8
+#define EVENT_TRACE_VERSION 1
+
+/* Strings are stored with their length first. This length marks a NULL
+ * string.
+ */
+#define EVENT_TRACE_NULL_STRING G_MAXUINT32
+
+/* Upper bounds used to reject corrupted traces before allocating memory
+ * for them.
+ */
+#define EVENT_TRACE_MAX_STRING_LENGTH (64*1024*1024)
+#define EVENT_TRACE_MAX_LIST_LENGTH (16*1024*1024)
+#define EVENT_TRACE_MAX_NODE_DEPTH 64
+
+struct _CelluloidEventTraceWriter
+{
+	GDataOutputStream *stream;
+	gchar *path;
+	gint64 origin;
+	GError *error;
+};
+
+struct _CelluloidEventTraceReader
+{
+	GDataInputStream *stream;
+	mpv_event event;
+	GError *error;
+};
+
+static void
+write_uint32(CelluloidEventTraceWriter *writer, guint32 value);
+
+static void
+write_int32(CelluloidEventTraceWriter *writer, gint32 value);
+
+static void
+write_int64(CelluloidEventTraceWriter *writer, gint64 value);
+
+static void
+write_uint64(CelluloidEventTraceWriter *writer, guint64 value);
+
+static void
+write_double(CelluloidEventTraceWriter *writer, gdouble value);
+
+static void
+write_string(CelluloidEventTraceWriter *writer, const gchar *value);
+
+static void
+write_node(CelluloidEventTraceWriter *writer, const mpv_node *node);
+
+static void
+write_value(	CelluloidEventTraceWriter *writer,
+		mpv_format format,
+		const void *data );
+
+static guint32
+read_uint32(CelluloidEventTraceReader *reader);
+
+static gint32
+read_int32(CelluloidEventTraceReader *reader);
+
+static gint64
+read_int64(CelluloidEventTraceReader *reader);
+
+static guint64
+read_uint64(CelluloidEventTraceReader *reader);
+
+static gdouble
+read_double(CelluloidEventTraceReader *reader);
+
+static gchar *
+read_string(CelluloidEventTraceReader *reader);
+
+static void
+read_node(CelluloidEventTraceReader *reader, mpv_node *node, guint depth);
+
+static void *
+read_value(CelluloidEventTraceReader *reader, mpv_format format);
+
+static void
+clear_node(mpv_node *node);
+
+static void
+free_value(mpv_format format, void *data);
+
+static void
+clear_event(mpv_event *event);
+
+static void
+write_uint32(CelluloidEventTraceWriter *writer, guint32 value)
+{
+	if(!writer->error)
+	{
+		g_data_output_stream_put_uint32
+			(writer->stream, value, NULL, &writer->error);
+	}
+}
+
+static void
+write_int32(CelluloidEventTraceWriter *writer, gint32 value)
+{
+	if(!writer->error)
+	{
+		g_data_output_stream_put_int32
+			(writer->stream, value, NULL, &writer->error);
+	}
+}
+
+static void
+write_int64(CelluloidEventTraceWriter *writer, gint64 value)
+{
+	if(!writer->error)
+	{
+		g_data_output_stream_put_int64
+			(writer->stream, value, NULL, &writer->error);
+	}
+}
+
+static void
+write_uint64(CelluloidEventTraceWriter *writer, guint64 value)
+{
+	if(!writer->error)
+	{
+		g_data_output_stream_put_uint64
+			(writer->stream, value, NULL, &writer->error);
+	}
+}
+
+static void
+write_double(CelluloidEventTraceWriter *writer, gdouble value)
+{
+	union {gdouble d; guint64 u;} bits = {.d = value};
+
+	write_uint64(writer, bits.u);
+}
+
+static void
+write_string(CelluloidEventTraceWriter *writer, const gchar *value)
+{
+	const gsize length = value?strlen(value):0;
+
+	write_uint32(	writer,
+			value?(guint32)length:EVENT_TRACE_NULL_STRING );
+
+	if(value && length > 0 && !writer->error)
+	{
+		g_output_stream_write_all
+			(	G_OUTPUT_STREAM(writer->stream),
+				value,
+				length,
+				NULL,
+				NULL,
+				&writer->error );
+	}
+}
+
+static void
+write_node(CelluloidEventTraceWriter *writer, const mpv_node *node)
+{
+	write_uint32(writer, (guint32)node->format);
+
+	switch(node->format)
+	{
+		case MPV_FORMAT_STRING:
+		case MPV_FORMAT_OSD_STRING:
+		write_string(writer, node->u.string);
+		break;
+
+		case MPV_FORMAT_FLAG:
+		write_int32(writer, node->u.flag);
+		break;
+
+		case MPV_FORMAT_INT64:
+		write_int64(writer, node->u.int64);
+		break;
+
+		case MPV_FORMAT_DOUBLE:
+		write_double(writer, node->u.double_);
+		break;
+
+		case MPV_FORMAT_NODE_ARRAY:
+		case MPV_FORMAT_NODE_MAP:
+		write_uint32(writer, (guint32)node->u.list->num);
+
+		for(gint i = 0; i < node->u.list->num; i++)
+		{
+			if(node->format == MPV_FORMAT_NODE_MAP)
+			{
+				write_string(writer, node->u.list->keys[i]);
+			}
+
+			write_node(writer, &node->u.list->values[i]);
+		}
+		break;
+
+		default:
+		break;
+	}
+}
+
+static void
+write_value(	CelluloidEventTraceWriter *writer,
+		mpv_format format,
+		const void *data )
+{
+	write_uint32(writer, (guint32)format);
+
+	switch(format)
+	{
+		case MPV_FORMAT_STRING:
+		case MPV_FORMAT_OSD_STRING:
+		write_string(writer, *((const char * const *)data));
+		break;
+
+		case MPV_FORMAT_FLAG:
+		write_int32(writer, *((const int *)data));
+		break;
+
+		case MPV_FORMAT_INT64:
+		write_int64(writer, *((const int64_t *)data));
+		break;
+
+		case MPV_FORMAT_DOUBLE:
+		write_double(writer, *((const double *)data));
+		break;
+
+		case MPV_FORMAT_NODE:
+		write_node(writer, data);
+		break;
+
+		default:
+		break;
+	}
+}
+
+static guint32
+read_uint32(CelluloidEventTraceReader *reader)
+{
+	guint32 result = 0;
+
+	if(!reader->error)
+	{
+		result = g_data_input_stream_read_uint32
+			(reader->stream, NULL, &reader->error);
+	}
+
+	return result;
+}
+
+static gint32
+read_int32(CelluloidEventTraceReader *reader)
+{
+	gint32 result = 0;
+
+	if(!reader->error)
+	{
+		result = g_data_input_stream_read_int32
+			(reader->stream, NULL, &reader->error);
+	}
+
+	return result;
+}
+
+static gint64
+read_int64(CelluloidEventTraceReader *reader)
+{
+	gint64 result = 0;
+
+	if(!reader->error)
+	{
+		result = g_data_input_stream_read_int64
+			(reader->stream, NULL, &reader->error);
+	}
+
+	return result;
+}
+
+static guint64
+read_uint64(CelluloidEventTraceReader *reader)
+{
+	guint64 result = 0;
+
+	if(!reader->error)
+	{
+		result = g_data_input_stream_read_uint64
+			(reader->stream, NULL, &reader->error);
+	}
+
+	return result;
+}
+
+static gdouble
+read_double(CelluloidEventTraceReader *reader)
+{
+	union {gdouble d; guint64 u;} bits = {.u = read_uint64(reader)};
+
+	return bits.d;
+}
+
+static gchar *
+read_string(CelluloidEventTraceReader *reader)
+{
+	const guint32 length = read_uint32(reader);
+	gchar *result = NULL;
+
+	if(reader->error || length == EVENT_TRACE_NULL_STRING)
+	{
+		return NULL;
+	}
+
+	if(length > EVENT_TRACE_MAX_STRING_LENGTH)
+	{
+		g_set_error(	&reader->error,
+				G_IO_ERROR,
+				G_IO_ERROR_INVALID_DATA,
+				"String of length %u is too long",
+				length );
+	}
+	else
+	{
+		gsize bytes_read = 0;
+
+		result = g_malloc((gsize)length + 1);
+		result[length] = '\0';
+
+		g_input_stream_read_all(	G_INPUT_STREAM(reader->stream),
+						result,
+						length,
+						&bytes_read,
+						NULL,
+						&reader->error );
+
+		if(!reader->error && bytes_read != length)
+		{
+			g_set_error_literal(	&reader->error,
+						G_IO_ERROR,
+						G_IO_ERROR_PARTIAL_INPUT,
+						"Unexpected end of trace" );
+		}
+	}
+
+	return result;
+}
+
+static void
+read_node(CelluloidEventTraceReader *reader, mpv_node *node, guint depth)
+{
+	memset(node, 0, sizeof(mpv_node));
+	node->format = (mpv_format)read_uint32(reader);
+
+	switch(node->format)
+	{
+		case MPV_FORMAT_NONE:
+		break;
+
+		case MPV_FORMAT_STRING:
+		case MPV_FORMAT_OSD_STRING:
+		node->u.string = read_string(reader);
+		break;
+
+		case MPV_FORMAT_FLAG:
+		node->u.flag = read_int32(reader);
+		break;
+
+		case MPV_FORMAT_INT64:
+		node->u.int64 = read_int64(reader);
+		break;
+
+		case MPV_FORMAT_DOUBLE:
+		node->u.double_ = read_double(reader);
+		break;
+
+		case MPV_FORMAT_NODE_ARRAY:
+		case MPV_FORMAT_NODE_MAP:
+		{
+			const guint32 num = read_uint32(reader);
+			const gboolean map = node->format == MPV_FORMAT_NODE_MAP;
+			mpv_node_list *list = g_new0(mpv_node_list, 1);
+
+			node->u.list = list;
+
+			if(	num > EVENT_TRACE_MAX_LIST_LENGTH ||
+				depth >= EVENT_TRACE_MAX_NODE_DEPTH )
+			{
+				g_set_error_literal(	&reader->error,
+							G_IO_ERROR,
+							G_IO_ERROR_INVALID_DATA,
+							"Node is too large" );
+			}
+
+			if(reader->error)
+			{
+				break;
+			}
+
+			list->values = g_new0(mpv_node, num);
+			list->keys = map?g_new0(char *, num):NULL;
+
+			for(guint32 i = 0; i < num && !reader->error; i++)
+			{
+				if(map)
+				{
+					list->keys[i] = read_string(reader);
+				}
+
+				read_node(reader, &list->values[i], depth + 1);
+
+				// Only count entries that were read, so that
+				// clear_node() doesn't touch the rest.
+				list->num = (int)i + 1;
+			}
+		}
+		break;
+
+		default:
+		node->format = MPV_FORMAT_NONE;
+
+		if(!reader->error)
+		{
+			g_set_error_literal(	&reader->error,
+						G_IO_ERROR,
+						G_IO_ERROR_INVALID_DATA,
+						"Unknown node format" );
+		}
+		break;
+	}
+}
+
+static void *
+read_value(CelluloidEventTraceReader *reader, mpv_format format)
+{
+	void *data = NULL;
+
+	switch(format)
+	{
+		case MPV_FORMAT_STRING:
+		case MPV_FORMAT_OSD_STRING:
+		data = g_new0(char *, 1);
+		*((char **)data) = read_string(reader);
+		break;
+
+		case MPV_FORMAT_FLAG:
+		data = g_new0(int, 1);
+		*((int *)data) = read_int32(reader);
+		break;
+
+		case MPV_FORMAT_INT64:
+		data = g_new0(int64_t, 1);
+		*((int64_t *)data) = read_int64(reader);
+		break;
+
+		case MPV_FORMAT_DOUBLE:
+		data = g_new0(double, 1);
+		*((double *)data) = read_double(reader);
+		break;
+
+		case MPV_FORMAT_NODE:
+		data = g_new0(mpv_node, 1);
+		read_node(reader, data, 0);
+		break;
+
+		default:
+		break;
+	}
+
+	return data;
+}
+
+static void
+clear_node(mpv_node *node)
+{
+	if(	node->format == MPV_FORMAT_STRING ||
+		node->format == MPV_FORMAT_OSD_STRING )
+	{
+		g_free(node->u.string);
+	}
+	else if(	node->format == MPV_FORMAT_NODE_ARRAY ||
+			node->format == MPV_FORMAT_NODE_MAP )
+	{
+		mpv_node_list *list = node->u.list;
+
+		for(gint i = 0; list && i < list->num; i++)
+		{
+			clear_node(&list->values[i]);
+
+			if(list->keys)
+			{
+				g_free(list->keys[i]);
+			}
+		}
+
+		if(list)
+		{
+			g_free(list->values);
+			g_free(list->keys);
+			g_free(list);
+		}
+	}
+
+	node->format = MPV_FORMAT_NONE;
+}
+
+static void
+free_value(mpv_format format, void *data)
+{
+	if(!data)
+	{
+		return;
+	}
+
+	if(format == MPV_FORMAT_STRING || format == MPV_FORMAT_OSD_STRING)
+	{
+		g_free(*((char **)data));
+	}
+	else if(format == MPV_FORMAT_NODE)
+	{
+		clear_node(data);
+	}
+
+	g_free(data);
+}
+
+static void
+clear_event(mpv_event *event)
+{
+	if(!event->data)
+	{
+		return;
+	}
+
+	if(	event->event_id == MPV_EVENT_PROPERTY_CHANGE ||
+		event->event_id == MPV_EVENT_GET_PROPERTY_REPLY )
+	{
+		mpv_event_property *prop = event->data;
+
+		free_value(prop->format, prop->data);
+		g_free((gchar *)prop->name);
+	}
+	else if(event->event_id == MPV_EVENT_LOG_MESSAGE)
+	{
+		mpv_event_log_message *msg = event->data;
+
+		g_free((gchar *)msg->prefix);
+		g_free((gchar *)msg->level);
+		g_free((gchar *)msg->text);
+	}
+	else if(event->event_id == MPV_EVENT_CLIENT_MESSAGE)
+	{
+		mpv_event_client_message *msg = event->data;
+
+		g_strfreev((gchar **)msg->args);
+	}
+
+	g_clear_pointer(&event->data, g_free);
+}
+
+CelluloidEventTraceWriter *
+celluloid_event_trace_writer_new(const gchar *path, GError **error)
+{
+	CelluloidEventTraceWriter *writer = NULL;
+	GFile *file = g_file_new_for_path(path);
+	GFileOutputStream *file_stream = NULL;
+
+	file_stream =	g_file_replace
+			(	file,
+				NULL,
+				FALSE,
+				G_FILE_CREATE_PRIVATE,
+				NULL,
+				error );
+
+	if(file_stream)
+	{
+		GOutputStream *buffered_stream =
+			g_buffered_output_stream_new
+			(G_OUTPUT_STREAM(file_stream));
+
+		writer = g_new0(CelluloidEventTraceWriter, 1);
+		writer->stream = g_data_output_stream_new(buffered_stream);
+		writer->path = g_strdup(path);
+		writer->origin = g_get_monotonic_time();
+		writer->error = NULL;
+
+		g_data_output_stream_set_byte_order
+			(writer->stream, G_DATA_STREAM_BYTE_ORDER_LITTLE_ENDIAN);
+
+		g_output_stream_write_all
+			(	G_OUTPUT_STREAM(writer->stream),
+				EVENT_TRACE_MAGIC,
+				EVENT_TRACE_MAGIC_LENGTH,
+				NULL,
+				NULL,
+				&writer->error );
+		write_uint32(writer, EVENT_TRACE_VERSION);
+
+		g_object_unref(buffered_stream);
+		g_object_unref(file_stream);
+	}
+
+	g_object_unref(file);
+
+	return writer;
+}
+
+CelluloidEventTraceWriter *
+celluloid_event_trace_writer_new_default(void)
+{
+	static gint serial = 0;
+	CelluloidEventTraceWriter *writer = NULL;
+	const gchar *dir = g_getenv(EVENT_TRACE_DIR_ENV_VAR);
+
+	if(dir && *dir)
+	{
+		GError *error = NULL;
+		gchar *filename =	g_strdup_printf
+					(	"celluloid-%d-%d.trace",
+						(gint)getpid(),
+						g_atomic_int_add(&serial, 1) );
+		gchar *path = g_build_filename(dir, filename, NULL);
+
+		writer = celluloid_event_trace_writer_new(path, &error);
+
+		if(writer)
+		{
+			g_message("Recording mpv events to %s", path);
+		}
+		else
+		{
+			g_warning(	"Failed to create event trace %s: %s",
+					path,
+					error->message );
+			g_error_free(error);
+		}
+
+		g_free(path);
+		g_free(filename);
+	}
+
+	return writer;
+}
+
+void
+celluloid_event_trace_writer_free(CelluloidEventTraceWriter *writer)
+{
+	if(writer)
+	{
+		celluloid_event_trace_writer_flush(writer);
+		g_output_stream_close(G_OUTPUT_STREAM(writer->stream), NULL, NULL);
+
+		g_object_unref(writer->stream);
+		g_clear_error(&writer->error);
+		g_free(writer->path);
+		g_free(writer);
+	}
+}
+
+void
+celluloid_event_trace_writer_add(	CelluloidEventTraceWriter *writer,
+					const mpv_event *event )
+{
+	const gboolean failed = !!writer->error;
+
+	if(failed)
+	{
+		return;
+	}
+
+	write_int64(writer, g_get_monotonic_time() - writer->origin);
+	write_uint32(writer, (guint32)event->event_id);
+	write_int32(writer, event->error);
+	write_uint64(writer, event->reply_userdata);
+
+	if(!event->data)
+	{
+		write_uint32(writer, FALSE);
+	}
+	else if(	event->event_id == MPV_EVENT_PROPERTY_CHANGE ||
+			event->event_id == MPV_EVENT_GET_PROPERTY_REPLY )
+	{
+		const mpv_event_property *prop = event->data;
+
+		write_uint32(writer, TRUE);
+		write_string(writer, prop->name);
+		write_value(writer, prop->format, prop->data);
+	}
+	else if(event->event_id == MPV_EVENT_LOG_MESSAGE)
+	{
+		const mpv_event_log_message *msg = event->data;
+
+		write_uint32(writer, TRUE);
+		write_string(writer, msg->prefix);
+		write_string(writer, msg->level);
+		write_string(writer, msg->text);
+		write_uint32(writer, (guint32)msg->log_level);
+	}
+	else if(event->event_id == MPV_EVENT_CLIENT_MESSAGE)
+	{
+		const mpv_event_client_message *msg = event->data;
+
+		write_uint32(writer, TRUE);
+		write_uint32(writer, (guint32)msg->num_args);
+
+		for(gint i = 0; i < msg->num_args; i++)
+		{
+			write_string(writer, msg->args[i]);
+		}
+	}
+	else if(event->event_id == MPV_EVENT_END_FILE)
+	{
+		const mpv_event_end_file *end_file = event->data;
+
+		write_uint32(writer, TRUE);
+		write_int32(writer, (gint32)end_file->reason);
+		write_int32(writer, end_file->error);
+	}
+	else
+	{
+		write_uint32(writer, FALSE);
+	}
+
+	// Make sure that the end of the trace is on disk when the player goes
+	// away, whichever way that happens.
+	if(event->event_id == MPV_EVENT_SHUTDOWN)
+	{
+		celluloid_event_trace_writer_flush(writer);
+	}
+
+	if(writer->error)
+	{
+		g_warning(	"Stopped recording events to %s: %s",
+				writer->path,
+				writer->error->message );
+	}
+}
+
+void
+celluloid_event_trace_writer_flush(CelluloidEventTraceWriter *writer)
+{
+	if(!writer->error)
+	{
+		g_output_stream_flush
+			(G_OUTPUT_STREAM(writer->stream), NULL, &writer->error);
+	}
+}
+
+CelluloidEventTraceReader *
+celluloid_event_trace_reader_new(const gchar *path, GError **error)
+{
+	CelluloidEventTraceReader *reader = NULL;
+	GFile *file = g_file_new_for_path(path);
+	GFileInputStream *file_stream = g_file_read(file, NULL, error);
+
+	if(file_stream)
+	{
+		gchar magic[EVENT_TRACE_MAGIC_LENGTH] = {0};
+		gsize bytes_read = 0;
+		guint32 version = 0;
+
+		reader = g_new0(CelluloidEventTraceReader, 1);
+		reader->stream =	g_data_input_stream_new
+					(G_INPUT_STREAM(file_stream));
+		reader->error = NULL;
+
+		g_data_input_stream_set_byte_order
+			(reader->stream, G_DATA_STREAM_BYTE_ORDER_LITTLE_ENDIAN);
+
+		g_input_stream_read_all(	G_INPUT_STREAM(reader->stream),
+						magic,
+						sizeof(magic),
+						&bytes_read,
+						NULL,
+						&reader->error );
+		version = read_uint32(reader);
+
+		if(	!reader->error &&
+			(	bytes_read != sizeof(magic) ||
+				memcmp(magic, EVENT_TRACE_MAGIC, sizeof(magic)) != 0 ) )
+		{
+			g_set_error(	&reader->error,
+					G_IO_ERROR,
+					G_IO_ERROR_INVALID_DATA,
+					"%s is not an event trace",
+					path );
+		}
+		else if(!reader->error && version != EVENT_TRACE_VERSION)
+		{
+			g_set_error(	&reader->error,
+					G_IO_ERROR,
+					G_IO_ERROR_NOT_SUPPORTED,
+					"Unsupported event trace version %u",
+					version );
+		}
+
+		if(reader->error)
+		{
+			g_propagate_error(error, reader->error);
+			reader->error = NULL;
+			g_clear_pointer(&reader, celluloid_event_trace_reader_free);
+		}
+
+		g_object_unref(file_stream);
+	}
+
+	g_object_unref(file);
+
+	return reader;
+}
+
+void
+celluloid_event_trace_reader_free(CelluloidEventTraceReader *reader)
+{
+	if(reader)
+	{
+		clear_event(&reader->event);
+		g_object_unref(reader->stream);
+		g_clear_error(&reader->error);
+		g_free(reader);
+	}
+}
+
+const mpv_event *
+celluloid_event_trace_reader_next(	CelluloidEventTraceReader *reader,
+					gint64 *timestamp,
+					GError **error )
+{
+	GBufferedInputStream *buffered = G_BUFFERED_INPUT_STREAM(reader->stream);
+	mpv_event *event = &reader->event;
+	gint64 time = 0;
+	gboolean has_data = FALSE;
+
+	// The previous event stays valid until the next call, like the events
+	// returned by mpv_wait_event().
+	clear_event(event);
+	memset(event, 0, sizeof(mpv_event));
+
+	if(reader->error)
+	{
+		return NULL;
+	}
+
+	// A clean end of the trace is the only place where no data is left
+	if(	g_buffered_input_stream_get_available(buffered) == 0 &&
+		g_buffered_input_stream_fill
+		(buffered, -1, NULL, &reader->error) <= 0 )
+	{
+		g_propagate_error(error, reader->error);
+		reader->error = NULL;
+
+		return NULL;
+	}
+
+	time = read_int64(reader);
+	event->event_id = (mpv_event_id)read_uint32(reader);
+	event->error = read_int32(reader);
+	event->reply_userdata = read_uint64(reader);
+	has_data = !!read_uint32(reader);
+
+	if(!has_data)
+	{
+		// No payload
+	}
+	else if(	event->event_id == MPV_EVENT_PROPERTY_CHANGE ||
+			event->event_id == MPV_EVENT_GET_PROPERTY_REPLY )
+	{
+		mpv_event_property *prop = g_new0(mpv_event_property, 1);
+
+		event->data = prop;
+		prop->name = read_string(reader);
+		prop->format = (mpv_format)read_uint32(reader);
+		prop->data = read_value(reader, prop->format);
+	}
+	else if(event->event_id == MPV_EVENT_LOG_MESSAGE)
+	{
+		mpv_event_log_message *msg = g_new0(mpv_event_log_message, 1);
+
+		event->data = msg;
+		msg->prefix = read_string(reader);
+		msg->level = read_string(reader);
+		msg->text = read_string(reader);
+		msg->log_level = (mpv_log_level)read_uint32(reader);
+	}
+	else if(event->event_id == MPV_EVENT_CLIENT_MESSAGE)
+	{
+		mpv_event_client_message *msg =
+			g_new0(mpv_event_client_message, 1);
+		const guint32 num_args = read_uint32(reader);
+		gchar **args = NULL;
+
+		event->data = msg;
+
+		if(num_args > EVENT_TRACE_MAX_LIST_LENGTH)
+		{
+			g_set_error_literal(	&reader->error,
+						G_IO_ERROR,
+						G_IO_ERROR_INVALID_DATA,
+						"Client message is too large" );
+		}
+		else
+		{
+			args = g_new0(gchar *, (gsize)num_args + 1);
+
+			for(guint32 i = 0; i < num_args && !reader->error; i++)
+			{
+				args[i] = read_string(reader);
+				msg->num_args = (int)i + 1;
+			}
+		}
+
+		msg->args = (const char **)args;
+	}
+	else if(event->event_id == MPV_EVENT_END_FILE)
+	{
+		mpv_event_end_file *end_file = g_new0(mpv_event_end_file, 1);
+
+		event->data = end_file;
+		end_file->reason = (mpv_end_file_reason)read_int32(reader);
+		end_file->error = read_int32(reader);
+	}
+	else
+	{
+		g_set_error(	&reader->error,
+				G_IO_ERROR,
+				G_IO_ERROR_INVALID_DATA,
+				"Unexpected payload for event %d",
+				event->event_id );
+	}
+
+	if(reader->error)
+	{
+		g_propagate_error(error, g_error_copy(reader->error));
+		clear_event(event);
+
+		return NULL;
+	}
+
+	if(timestamp)
+	{
+		*timestamp = time;
+	}
+
+	return event;
+}
@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2025 gnome-mpv
+ *
+ * This file is part of Celluloid.
+ *
+ * Celluloid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Celluloid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Celluloid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EVENT_TRACE_H
+#define EVENT_TRACE_H
+
+#include <glib.h>
+#include <mpv/client.h>
+
+G_BEGIN_DECLS
+
+typedef struct _CelluloidEventTraceWriter CelluloidEventTraceWriter;
+typedef struct _CelluloidEventTraceReader CelluloidEventTraceReader;
+
+CelluloidEventTraceWriter *
+celluloid_event_trace_writer_new(const gchar *path, GError **error);
+
+CelluloidEventTraceWriter *
+celluloid_event_trace_writer_new_default(void);
+
+void
+celluloid_event_trace_writer_free(CelluloidEventTraceWriter *writer);
+
+void
+celluloid_event_trace_writer_add(	CelluloidEventTraceWriter *writer,
+					const mpv_event *event );
+
+void
+celluloid_event_trace_writer_flush(CelluloidEventTraceWriter *writer);
+
+CelluloidEventTraceReader *
+celluloid_event_trace_reader_new(const gchar *path, GError **error);
+
+void
+celluloid_event_trace_reader_free(CelluloidEventTraceReader *reader);
+
+const mpv_event *
+celluloid_event_trace_reader_next(	CelluloidEventTraceReader *reader,
+					gint64 *timestamp,
+					GError **error );
+
+G_END_DECLS
+
+#endif
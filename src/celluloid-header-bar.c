@@ -46,6 +46,10 @@ struct _CelluloidHeaderBar
 	gboolean fullscreened;
 	gboolean open_popover_visible;
 	gboolean menu_popover_visible;
+
+	CelluloidTrackMenus track_menus;
+	const GPtrArray *track_list;
+	gboolean track_list_changed;
 };
 
 struct _CelluloidHeaderBarClass
@@ -55,6 +59,9 @@ struct _CelluloidHeaderBarClass
 
 G_DEFINE_TYPE(CelluloidHeaderBar, celluloid_header_bar, GTK_TYPE_BOX)
 
+static void
+finalize(GObject *object);
+
 static void
 set_property(	GObject *object,
 		guint property_id,
@@ -70,9 +77,25 @@ get_property(	GObject *object,
 static void
 create_popup(GtkMenuButton *menu_button, gpointer data);
 
+static void
+menu_button_active_handler(GObject *object, GParamSpec *pspec, gpointer data);
+
+static void
+update_track_menus(CelluloidHeaderBar *hdr);
+
 static void
 set_fullscreen_state(CelluloidHeaderBar *hdr, gboolean fullscreen);
 
+static void
+finalize(GObject *object)
+{
+	CelluloidHeaderBar *hdr = CELLULOID_HEADER_BAR(object);
+
+	celluloid_menu_track_menus_clear(&hdr->track_menus);
+
+	G_OBJECT_CLASS(celluloid_header_bar_parent_class)->finalize(object);
+}
+
 static void
 set_property(	GObject *object,
 		guint property_id,
@@ -147,6 +170,27 @@ create_popup(GtkMenuButton *menu_button, gpointer data)
 	gtk_menu_button_set_create_popup_func(menu_button, NULL, NULL, NULL);
 }
 
+static void
+menu_button_active_handler(GObject *object, GParamSpec *pspec, gpointer data)
+{
+	if(gtk_menu_button_get_active(GTK_MENU_BUTTON(object)))
+	{
+		update_track_menus(data);
+	}
+}
+
+static void
+update_track_menus(CelluloidHeaderBar *hdr)
+{
+	if(hdr->track_list_changed)
+	{
+		celluloid_menu_track_menus_update
+			(&hdr->track_menus, hdr->track_list);
+
+		hdr->track_list_changed = FALSE;
+	}
+}
+
 static void
 set_fullscreen_state(CelluloidHeaderBar *hdr, gboolean fullscreen)
 {
@@ -176,6 +220,7 @@ celluloid_header_bar_class_init(CelluloidHeaderBarClass *klass)
 	GObjectClass *object_class = G_OBJECT_CLASS(klass);
 	GParamSpec *pspec = NULL;
 
+	object_class->finalize = finalize;
 	object_class->set_property = set_property;
 	object_class->get_property = get_property;
 
@@ -229,11 +274,15 @@ celluloid_header_bar_init(CelluloidHeaderBar *hdr)
 	hdr->fullscreened = FALSE;
 	hdr->open_popover_visible = FALSE;
 	hdr->menu_popover_visible = FALSE;
+	hdr->track_list = NULL;
+	hdr->track_list_changed = FALSE;
+
+	celluloid_menu_track_menus_init(&hdr->track_menus);
 
 	ghdr = ADW_HEADER_BAR(hdr->header_bar);
 
 	celluloid_menu_build_open_btn(open_btn_menu, NULL);
-	celluloid_menu_build_menu_btn(menu_btn_menu, NULL);
+	celluloid_menu_build_menu_btn(menu_btn_menu, &hdr->track_menus);
 
 	gtk_menu_button_set_label
 		(GTK_MENU_BUTTON(hdr->open_btn), _("Open"));
@@ -280,6 +329,11 @@ celluloid_header_bar_init(CelluloidHeaderBar *hdr)
 
 	gtk_menu_button_set_primary(GTK_MENU_BUTTON(hdr->menu_btn), TRUE);
 
+	g_signal_connect(	hdr->menu_btn,
+				"notify::active",
+				G_CALLBACK(menu_button_active_handler),
+				hdr );
+
 	gchar css_data[] =
 		".top-bar .floating-header button"
 		"{"
@@ -415,14 +469,15 @@ void
 celluloid_header_bar_update_track_list(	CelluloidHeaderBar *hdr,
 					const GPtrArray *track_list )
 {
-	GMenu *menu = g_menu_new();
+	// The track menus are only brought up to date when they are about to
+	// be shown, since the track list can change many times in between.
+	hdr->track_list = track_list;
+	hdr->track_list_changed = TRUE;
 
-	celluloid_menu_build_menu_btn(menu, track_list);
-
-	gtk_menu_button_set_menu_model
-		(GTK_MENU_BUTTON(hdr->menu_btn), G_MENU_MODEL(menu));
-	gtk_menu_button_set_create_popup_func
-		(GTK_MENU_BUTTON(hdr->menu_btn), create_popup, hdr, NULL);
+	if(hdr->menu_popover_visible)
+	{
+		update_track_menus(hdr);
+	}
 }
 
 void
@@ -0,0 +1,822 @@
+/*
+ * Copyright (c) 2025 gnome-mpv
+ *
+ * This file is part of Celluloid.
+ *
+ * Celluloid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Celluloid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Celluloid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <glib/gi18n.h>
+
+#include "celluloid-job-scheduler.h"
+#include "celluloid-def.h"
+
+typedef struct _Job Job;
+typedef struct _Worker Worker;
+
+typedef enum
+{
+	JOB_COMPLETED,
+	JOB_FAILED,
+	JOB_CANCELLED,
+	JOB_EXPIRED
+}
+JobStatus;
+
+struct _Job
+{
+	guint id;
+	CelluloidJobPriority priority;
+	gchar *uri;
+	gint64 deadline;
+	gint64 submit_time;
+	gint64 start_time;
+	CelluloidJobFunc func;
+	gpointer data;
+	GDestroyNotify destroy;
+	Worker *worker;
+	gboolean loaded;
+	gboolean ended;
+};
+
+struct _Worker
+{
+	CelluloidJobScheduler *scheduler;
+	CelluloidMpv *mpv;
+	Job *job;
+};
+
+struct _CelluloidJobScheduler
+{
+	GObject parent;
+	guint max_workers;
+	GQueue queues[CELLULOID_JOB_N_PRIORITIES];
+	GHashTable *jobs;
+	GPtrArray *workers;
+	guint next_id;
+	gint64 hold_until;
+	gint64 next_deadline;
+	guint dispatch_id;
+	guint deadline_id;
+	guint reap_id;
+	CelluloidJobQueueStats stats[CELLULOID_JOB_N_PRIORITIES];
+	gint64 first_submit[CELLULOID_JOB_N_PRIORITIES];
+};
+
+struct _CelluloidJobSchedulerClass
+{
+	GObjectClass parent_class;
+};
+
+static const gchar *const priority_names[] =
+	{N_("high"), N_("normal"), N_("low")};
+
+static void
+dispose(GObject *object);
+
+static void
+finalize(GObject *object);
+
+static void
+job_free(Job *job);
+
+static Worker *
+worker_new(CelluloidJobScheduler *scheduler);
+
+static void
+worker_free(Worker *worker);
+
+static gboolean
+worker_free_handler(gpointer data);
+
+static void
+retire_worker(CelluloidJobScheduler *scheduler, Worker *worker);
+
+static void
+worker_event_handler(	CelluloidMpv *mpv,
+			gint event_id,
+			gpointer event_data,
+			gpointer data );
+
+static void
+worker_shutdown_handler(CelluloidMpv *mpv, gpointer data);
+
+static Worker *
+get_idle_worker(CelluloidJobScheduler *scheduler);
+
+static Job *
+pop_job(CelluloidJobScheduler *scheduler);
+
+static void
+start_job(CelluloidJobScheduler *scheduler, Job *job, Worker *worker);
+
+static void
+finish_job(CelluloidJobScheduler *scheduler, Job *job, JobStatus status);
+
+static void
+queue_dispatch(CelluloidJobScheduler *scheduler);
+
+static gboolean
+dispatch_handler(gpointer data);
+
+static void
+update_deadline_timer(CelluloidJobScheduler *scheduler, gint64 deadline);
+
+static gboolean
+deadline_handler(gpointer data);
+
+static void
+update_reap_timer(CelluloidJobScheduler *scheduler);
+
+static gboolean
+reap_handler(gpointer data);
+
+G_DEFINE_TYPE(CelluloidJobScheduler, celluloid_job_scheduler, G_TYPE_OBJECT)
+
+static void
+dispose(GObject *object)
+{
+	CelluloidJobScheduler *scheduler = CELLULOID_JOB_SCHEDULER(object);
+	GHashTableIter iter;
+	gpointer job = NULL;
+
+	g_source_clear(&scheduler->dispatch_id);
+	g_source_clear(&scheduler->deadline_id);
+	g_source_clear(&scheduler->reap_id);
+
+	g_hash_table_iter_init(&iter, scheduler->jobs);
+
+	while(g_hash_table_iter_next(&iter, NULL, &job))
+	{
+		g_hash_table_iter_steal(&iter);
+		job_free(job);
+	}
+
+	for(gint i = 0; i < CELLULOID_JOB_N_PRIORITIES; i++)
+	{
+		g_queue_clear(&scheduler->queues[i]);
+	}
+
+	for(guint i = 0; i < scheduler->workers->len; i++)
+	{
+		worker_free(g_ptr_array_index(scheduler->workers, i));
+	}
+
+	g_ptr_array_set_size(scheduler->workers, 0);
+
+	G_OBJECT_CLASS(celluloid_job_scheduler_parent_class)->dispose(object);
+}
+
+static void
+finalize(GObject *object)
+{
+	CelluloidJobScheduler *scheduler = CELLULOID_JOB_SCHEDULER(object);
+
+	g_hash_table_unref(scheduler->jobs);
+	g_ptr_array_free(scheduler->workers, TRUE);
+
+	G_OBJECT_CLASS(celluloid_job_scheduler_parent_class)->finalize(object);
+}
+
+static void
+job_free(Job *job)
+{
+	if(job->destroy)
+	{
+		job->destroy(job->data);
+	}
+
+	g_free(job->uri);
+	g_free(job);
+}
+
+static Worker *
+worker_new(CelluloidJobScheduler *scheduler)
+{
+	Worker *worker = g_new0(Worker, 1);
+
+	worker->scheduler = scheduler;
+	worker->mpv = celluloid_mpv_new(0);
+	worker->job = NULL;
+
+	g_signal_connect(	worker->mpv,
+				"mpv-event-notify",
+				G_CALLBACK(worker_event_handler),
+				worker );
+	g_signal_connect(	worker->mpv,
+				"shutdown",
+				G_CALLBACK(worker_shutdown_handler),
+				worker );
+
+	// Files stay paused once loaded so that a worker doesn't use any CPU
+	// time between jobs.
+	celluloid_mpv_set_option_string(worker->mpv, "ao", "null");
+	celluloid_mpv_set_option_string(worker->mpv, "vo", "null");
+	celluloid_mpv_set_option_string(worker->mpv, "idle", "yes");
+	celluloid_mpv_set_option_string(worker->mpv, "pause", "yes");
+	celluloid_mpv_set_option_string(worker->mpv, "ytdl", "yes");
+	celluloid_mpv_initialize(worker->mpv);
+
+	g_debug("Started job worker %p", (gpointer)worker);
+
+	return worker;
+}
+
+static void
+worker_free(Worker *worker)
+{
+	g_debug("Stopping job worker %p", (gpointer)worker);
+
+	g_signal_handlers_disconnect_by_data(worker->mpv, worker);
+	g_object_unref(worker->mpv);
+	g_free(worker);
+}
+
+static gboolean
+worker_free_handler(gpointer data)
+{
+	worker_free(data);
+
+	return G_SOURCE_REMOVE;
+}
+
+static void
+retire_worker(CelluloidJobScheduler *scheduler, Worker *worker)
+{
+	// This may run from one of the worker's own signal handlers, so it is
+	// only destroyed once control returns to the main loop.
+	g_signal_handlers_disconnect_by_data(worker->mpv, worker);
+	g_ptr_array_remove_fast(scheduler->workers, worker);
+	g_idle_add(worker_free_handler, worker);
+}
+
+static void
+worker_event_handler(	CelluloidMpv *mpv,
+			gint event_id,
+			gpointer event_data,
+			gpointer data )
+{
+	Worker *worker = data;
+	Job *job = worker->job;
+
+	if(!job)
+	{
+		return;
+	}
+
+	if(event_id == MPV_EVENT_END_FILE)
+	{
+		const mpv_event_end_file *event = event_data;
+
+		// Files of earlier jobs end this way when they're stopped
+		if(	event->reason == MPV_END_FILE_REASON_STOP ||
+			event->reason == MPV_END_FILE_REASON_REDIRECT )
+		{
+			return;
+		}
+
+		job->ended = TRUE;
+	}
+	else if(event_id == MPV_EVENT_FILE_LOADED)
+	{
+		job->loaded = TRUE;
+	}
+
+	if(job->func(mpv, event_id, event_data, job->data) == G_SOURCE_REMOVE)
+	{
+		finish_job(worker->scheduler, job, JOB_COMPLETED);
+	}
+	else if(job->ended)
+	{
+		g_debug("Job %u failed to load %s", job->id, job->uri);
+		finish_job(worker->scheduler, job, JOB_FAILED);
+	}
+}
+
+static void
+worker_shutdown_handler(CelluloidMpv *mpv, gpointer data)
+{
+	Worker *worker = data;
+	CelluloidJobScheduler *scheduler = worker->scheduler;
+
+	g_warning("Job worker %p quit unexpectedly", (gpointer)worker);
+
+	if(worker->job)
+	{
+		worker->job->ended = TRUE;
+		finish_job(scheduler, worker->job, JOB_FAILED);
+	}
+
+	retire_worker(scheduler, worker);
+}
+
+static Worker *
+get_idle_worker(CelluloidJobScheduler *scheduler)
+{
+	Worker *worker = NULL;
+
+	for(guint i = 0; i < scheduler->workers->len && !worker; i++)
+	{
+		Worker *candidate = g_ptr_array_index(scheduler->workers, i);
+
+		if(!candidate->job)
+		{
+			worker = candidate;
+		}
+	}
+
+	if(!worker && scheduler->workers->len < scheduler->max_workers)
+	{
+		worker = worker_new(scheduler);
+		g_ptr_array_add(scheduler->workers, worker);
+	}
+
+	return worker;
+}
+
+static Job *
+pop_job(CelluloidJobScheduler *scheduler)
+{
+	Job *job = NULL;
+
+	for(gint i = 0; i < CELLULOID_JOB_N_PRIORITIES && !job; i++)
+	{
+		job = g_queue_pop_head(&scheduler->queues[i]);
+	}
+
+	return job;
+}
+
+static void
+start_job(CelluloidJobScheduler *scheduler, Job *job, Worker *worker)
+{
+	CelluloidJobQueueStats *stats = &scheduler->stats[job->priority];
+	const gint64 now = g_get_monotonic_time();
+	const gint64 wait = now - job->submit_time;
+	const gint64 budget = now + JOB_RUN_TIME_LIMIT * G_TIME_SPAN_SECOND;
+
+	stats->queued--;
+	stats->running++;
+	stats->started++;
+	stats->total_wait += wait;
+	stats->max_wait = MAX(stats->max_wait, wait);
+
+	job->start_time = now;
+	job->worker = worker;
+	worker->job = job;
+
+	// Jobs without a deadline still only get a limited amount of worker
+	// time so that a file that never loads can't hold on to a worker.
+	job->deadline = job->deadline > 0 ? MIN(job->deadline, budget) : budget;
+	update_deadline_timer(scheduler, job->deadline);
+
+	g_debug("Starting job %u for %s", job->id, job->uri);
+	celluloid_mpv_load_file(worker->mpv, job->uri, TRUE);
+}
+
+static void
+finish_job(CelluloidJobScheduler *scheduler, Job *job, JobStatus status)
+{
+	CelluloidJobQueueStats *stats = &scheduler->stats[job->priority];
+	Worker *worker = job->worker;
+
+	g_hash_table_steal(scheduler->jobs, GUINT_TO_POINTER(job->id));
+
+	if(worker)
+	{
+		const gint64 run = g_get_monotonic_time() - job->start_time;
+
+		stats->running--;
+		stats->total_run += run;
+		stats->max_run = MAX(stats->max_run, run);
+
+		worker->job = NULL;
+
+		// Stopping also clears the playlist so that the next job
+		// starts with an empty one.
+		if(job->loaded || job->ended)
+		{
+			const gchar *cmd[] = {"stop", NULL};
+
+			celluloid_mpv_command_async(worker->mpv, cmd);
+		}
+		else
+		{
+			// The file may still finish loading, and its events
+			// would end up at the next job.
+			retire_worker(scheduler, worker);
+		}
+	}
+	else
+	{
+		stats->queued--;
+		g_queue_remove(&scheduler->queues[job->priority], job);
+	}
+
+	switch(status)
+	{
+		case JOB_COMPLETED:
+		stats->completed++;
+		break;
+
+		case JOB_FAILED:
+		stats->failed++;
+		break;
+
+		case JOB_CANCELLED:
+		stats->cancelled++;
+		break;
+
+		case JOB_EXPIRED:
+		stats->expired++;
+		break;
+	}
+
+	job_free(job);
+	queue_dispatch(scheduler);
+}
+
+static void
+queue_dispatch(CelluloidJobScheduler *scheduler)
+{
+	if(scheduler->dispatch_id == 0)
+	{
+		scheduler->dispatch_id =
+			g_idle_add_full(	G_PRIORITY_LOW,
+						dispatch_handler,
+						scheduler,
+						NULL );
+	}
+}
+
+static gboolean
+dispatch_handler(gpointer data)
+{
+	CelluloidJobScheduler *scheduler = data;
+	const gint64 now = g_get_monotonic_time();
+	gboolean queued = TRUE;
+
+	scheduler->dispatch_id = 0;
+
+	if(now < scheduler->hold_until)
+	{
+		const gint64 delay = scheduler->hold_until - now;
+
+		scheduler->dispatch_id =
+			g_timeout_add(	(guint)(delay / 1000 + 1),
+					dispatch_handler,
+					scheduler );
+
+		return G_SOURCE_REMOVE;
+	}
+
+	while(queued)
+	{
+		Worker *worker = NULL;
+		Job *job = NULL;
+
+		queued = FALSE;
+
+		for(gint i = 0; i < CELLULOID_JOB_N_PRIORITIES; i++)
+		{
+			queued |= !g_queue_is_empty(&scheduler->queues[i]);
+		}
+
+		worker = queued ? get_idle_worker(scheduler) : NULL;
+		job = worker ? pop_job(scheduler) : NULL;
+
+		if(!job)
+		{
+			queued = FALSE;
+		}
+		else if(job->deadline > 0 && job->deadline <= now)
+		{
+			finish_job(scheduler, job, JOB_EXPIRED);
+		}
+		else
+		{
+			start_job(scheduler, job, worker);
+		}
+	}
+
+	update_reap_timer(scheduler);
+
+	return G_SOURCE_REMOVE;
+}
+
+static void
+update_deadline_timer(CelluloidJobScheduler *scheduler, gint64 deadline)
+{
+	// Only the earliest deadline is timed. Later ones are picked up when
+	// the timer fires.
+	if(	deadline > 0 &&
+		(scheduler->deadline_id == 0 || deadline < scheduler->next_deadline) )
+	{
+		const gint64 delay = MAX(0, deadline - g_get_monotonic_time());
+
+		g_source_clear(&scheduler->deadline_id);
+
+		scheduler->next_deadline = deadline;
+		scheduler->deadline_id =
+			g_timeout_add(	(guint)MIN(delay / 1000 + 1, G_MAXUINT),
+					deadline_handler,
+					scheduler );
+	}
+}
+
+static gboolean
+deadline_handler(gpointer data)
+{
+	CelluloidJobScheduler *scheduler = data;
+	const gint64 now = g_get_monotonic_time();
+	GPtrArray *expired = g_ptr_array_new();
+	gint64 next_deadline = 0;
+	GHashTableIter iter;
+	gpointer value = NULL;
+
+	scheduler->deadline_id = 0;
+
+	g_hash_table_iter_init(&iter, scheduler->jobs);
+
+	while(g_hash_table_iter_next(&iter, NULL, &value))
+	{
+		Job *job = value;
+
+		if(job->deadline > 0 && job->deadline <= now)
+		{
+			g_ptr_array_add(expired, job);
+		}
+		else if(	job->deadline > 0 &&
+				(next_deadline == 0 || job->deadline < next_deadline) )
+		{
+			next_deadline = job->deadline;
+		}
+	}
+
+	for(guint i = 0; i < expired->len; i++)
+	{
+		Job *job = g_ptr_array_index(expired, i);
+
+		g_debug("Job %u for %s expired", job->id, job->uri);
+		finish_job(scheduler, job, JOB_EXPIRED);
+	}
+
+	update_deadline_timer(scheduler, next_deadline);
+	g_ptr_array_free(expired, TRUE);
+
+	return G_SOURCE_REMOVE;
+}
+
+static void
+update_reap_timer(CelluloidJobScheduler *scheduler)
+{
+	g_source_clear(&scheduler->reap_id);
+
+	if(	g_hash_table_size(scheduler->jobs) == 0 &&
+		scheduler->workers->len > 0 )
+	{
+		scheduler->reap_id =
+			g_timeout_add_seconds(	JOB_WORKER_IDLE_TIMEOUT,
+						reap_handler,
+						scheduler );
+	}
+}
+
+static gboolean
+reap_handler(gpointer data)
+{
+	CelluloidJobScheduler *scheduler = data;
+
+	scheduler->reap_id = 0;
+
+	for(guint i = scheduler->workers->len; i > 0; i--)
+	{
+		Worker *worker = g_ptr_array_index(scheduler->workers, i - 1);
+
+		if(!worker->job)
+		{
+			g_ptr_array_remove_index_fast(scheduler->workers, i - 1);
+			worker_free(worker);
+		}
+	}
+
+	return G_SOURCE_REMOVE;
+}
+
+static void
+celluloid_job_scheduler_class_init(CelluloidJobSchedulerClass *klass)
+{
+	GObjectClass *object_class = G_OBJECT_CLASS(klass);
+
+	object_class->dispose = dispose;
+	object_class->finalize = finalize;
+}
+
+static void
+celluloid_job_scheduler_init(CelluloidJobScheduler *scheduler)
+{
+	scheduler->max_workers = 1;
+	scheduler->jobs = g_hash_table_new(g_direct_hash, g_direct_equal);
+	scheduler->workers = g_ptr_array_new();
+	scheduler->next_id = 0;
+	scheduler->hold_until = 0;
+	scheduler->next_deadline = 0;
+	scheduler->dispatch_id = 0;
+	scheduler->deadline_id = 0;
+	scheduler->reap_id = 0;
+
+	for(gint i = 0; i < CELLULOID_JOB_N_PRIORITIES; i++)
+	{
+		g_queue_init(&scheduler->queues[i]);
+		scheduler->stats[i] = (CelluloidJobQueueStats){0};
+		scheduler->first_submit[i] = 0;
+	}
+}
+
+CelluloidJobScheduler *
+celluloid_job_scheduler_new(guint max_workers)
+{
+	CelluloidJobScheduler *scheduler =
+		g_object_new(celluloid_job_scheduler_get_type(), NULL);
+
+	scheduler->max_workers = MAX(max_workers, 1);
+
+	return scheduler;
+}
+
+CelluloidJobScheduler *
+celluloid_job_scheduler_get_default(void)
+{
+	static CelluloidJobScheduler *scheduler = NULL;
+
+	/* The scheduler lives for the rest of the process. Workers deliver
+	 * their events to the thread that gets here first, which must be the
+	 * one running the main loop.
+	 */
+	if(g_once_init_enter(&scheduler))
+	{
+		const guint max_workers =
+			CLAMP(	g_get_num_processors() / 2,
+				1,
+				JOB_SCHEDULER_MAX_WORKERS );
+
+		g_once_init_leave
+			(&scheduler, celluloid_job_scheduler_new(max_workers));
+	}
+
+	return scheduler;
+}
+
+guint
+celluloid_job_scheduler_submit(	CelluloidJobScheduler *scheduler,
+				CelluloidJobPriority priority,
+				const gchar *uri,
+				gint64 deadline,
+				CelluloidJobFunc func,
+				gpointer data,
+				GDestroyNotify destroy )
+{
+	Job *job = g_new0(Job, 1);
+
+	g_return_val_if_fail(priority < CELLULOID_JOB_N_PRIORITIES, 0);
+
+	// 0 is reserved for invalid ids
+	if(++scheduler->next_id == 0)
+	{
+		scheduler->next_id++;
+	}
+
+	job->id = scheduler->next_id;
+	job->priority = priority;
+	job->uri = g_strdup(uri);
+	job->deadline = deadline;
+	job->submit_time = g_get_monotonic_time();
+	job->func = func;
+	job->data = data;
+	job->destroy = destroy;
+
+	g_queue_push_tail(&scheduler->queues[priority], job);
+	g_hash_table_insert(scheduler->jobs, GUINT_TO_POINTER(job->id), job);
+
+	if(scheduler->first_submit[priority] == 0)
+	{
+		scheduler->first_submit[priority] = job->submit_time;
+	}
+
+	scheduler->stats[priority].queued++;
+
+	update_deadline_timer(scheduler, deadline);
+	queue_dispatch(scheduler);
+
+	return job->id;
+}
+
+gboolean
+celluloid_job_scheduler_cancel(CelluloidJobScheduler *scheduler, guint id)
+{
+	Job *job = g_hash_table_lookup(scheduler->jobs, GUINT_TO_POINTER(id));
+
+	if(job)
+	{
+		g_debug("Cancelling job %u for %s", job->id, job->uri);
+		finish_job(scheduler, job, JOB_CANCELLED);
+	}
+
+	return !!job;
+}
+
+void
+celluloid_job_scheduler_throttle(	CelluloidJobScheduler *scheduler,
+					guint duration )
+{
+	const gint64 hold_until =
+		g_get_monotonic_time() + duration * G_TIME_SPAN_MILLISECOND;
+
+	scheduler->hold_until = MAX(scheduler->hold_until, hold_until);
+}
+
+void
+celluloid_job_scheduler_get_queue_stats(	CelluloidJobScheduler *scheduler,
+						CelluloidJobPriority priority,
+						CelluloidJobQueueStats *stats )
+{
+	const gint64 first_submit = scheduler->first_submit[priority];
+	const gint64 elapsed = g_get_monotonic_time() - first_submit;
+
+	*stats = scheduler->stats[priority];
+
+	if(first_submit > 0 && elapsed > 0)
+	{
+		const guint64 finished =
+			stats->completed + stats->failed + stats->expired;
+
+		stats->throughput =	(gdouble)finished *
+					(gdouble)G_TIME_SPAN_SECOND /
+					(gdouble)elapsed;
+	}
+}
+
+gchar *
+celluloid_job_scheduler_format_stats(CelluloidJobScheduler *scheduler)
+{
+	GString *buf = g_string_new(_("Background jobs"));
+
+	for(gint i = 0; i < CELLULOID_JOB_N_PRIORITIES; i++)
+	{
+		CelluloidJobQueueStats stats;
+		gdouble mean_wait = 0;
+		gdouble mean_run = 0;
+
+		celluloid_job_scheduler_get_queue_stats(scheduler, i, &stats);
+
+		if(stats.started > 0)
+		{
+			mean_wait =	(gdouble)stats.total_wait /
+					(gdouble)stats.started;
+		}
+
+		if(stats.started > stats.running)
+		{
+			mean_run =	(gdouble)stats.total_run /
+					(gdouble)(stats.started - stats.running);
+		}
+
+		g_string_append_printf
+			(	buf,
+				_(	"\n  %s: %u queued, %u running, "
+					"%" G_GUINT64_FORMAT " done, "
+					"%" G_GUINT64_FORMAT " failed, "
+					"%" G_GUINT64_FORMAT " cancelled, "
+					"%" G_GUINT64_FORMAT " expired" ),
+				_(priority_names[i]),
+				stats.queued,
+				stats.running,
+				stats.completed,
+				stats.failed,
+				stats.cancelled,
+				stats.expired );
+		g_string_append_printf
+			(	buf,
+				_(	"\n    wait mean %.1f ms, max %.1f ms; "
+					"run mean %.1f ms, max %.1f ms; "
+					"%.2f jobs/s" ),
+				mean_wait / 1000.0,
+				(gdouble)stats.max_wait / 1000.0,
+				mean_run / 1000.0,
+				(gdouble)stats.max_run / 1000.0,
+				stats.throughput );
+	}
+
+	return g_string_free(buf, FALSE);
+}
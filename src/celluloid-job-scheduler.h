@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2025 gnome-mpv
+ *
+ * This file is part of Celluloid.
+ *
+ * Celluloid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Celluloid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Celluloid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef JOB_SCHEDULER_H
+#define JOB_SCHEDULER_H
+
+#include <glib-object.h>
+
+#include "celluloid-mpv.h"
+
+G_BEGIN_DECLS
+
+typedef enum
+{
+	CELLULOID_JOB_PRIORITY_HIGH,
+	CELLULOID_JOB_PRIORITY_NORMAL,
+	CELLULOID_JOB_PRIORITY_LOW,
+	CELLULOID_JOB_N_PRIORITIES
+}
+CelluloidJobPriority;
+
+typedef struct _CelluloidJobQueueStats CelluloidJobQueueStats;
+
+struct _CelluloidJobQueueStats
+{
+	guint queued;
+	guint running;
+	guint64 started;
+	guint64 completed;
+	guint64 failed;
+	guint64 cancelled;
+	guint64 expired;
+	gint64 total_wait;
+	gint64 max_wait;
+	gint64 total_run;
+	gint64 max_run;
+	gdouble throughput;
+};
+
+/* Receives the events of the worker that loaded the file of the job. The job
+ * is finished once this returns G_SOURCE_REMOVE or the file ends. It must not
+ * cancel its own job.
+ */
+typedef gboolean (*CelluloidJobFunc)(	CelluloidMpv *worker,
+					gint event_id,
+					gpointer event_data,
+					gpointer data );
+
+#define CELLULOID_TYPE_JOB_SCHEDULER (celluloid_job_scheduler_get_type())
+
+G_DECLARE_FINAL_TYPE(CelluloidJobScheduler, celluloid_job_scheduler, CELLULOID, JOB_SCHEDULER, GObject)
+
+CelluloidJobScheduler *
+celluloid_job_scheduler_new(guint max_workers);
+
+CelluloidJobScheduler *
+celluloid_job_scheduler_get_default(void);
+
+/* Queues a job that loads uri into a headless worker. The job expires if it
+ * isn't finished by deadline, in monotonic time, unless deadline is 0. data is
+ * freed with destroy once the job is finished, cancelled or expired. Returns
+ * an id for celluloid_job_scheduler_cancel().
+ */
+guint
+celluloid_job_scheduler_submit(	CelluloidJobScheduler *scheduler,
+				CelluloidJobPriority priority,
+				const gchar *uri,
+				gint64 deadline,
+				CelluloidJobFunc func,
+				gpointer data,
+				GDestroyNotify destroy );
+
+gboolean
+celluloid_job_scheduler_cancel(CelluloidJobScheduler *scheduler, guint id);
+
+/* Holds back jobs that haven't started yet for duration milliseconds */
+void
+celluloid_job_scheduler_throttle(	CelluloidJobScheduler *scheduler,
+					guint duration );
+
+void
+celluloid_job_scheduler_get_queue_stats(	CelluloidJobScheduler *scheduler,
+						CelluloidJobPriority priority,
+						CelluloidJobQueueStats *stats );
+
+gchar *
+celluloid_job_scheduler_format_stats(CelluloidJobScheduler *scheduler);
+
+G_END_DECLS
+
+#endif
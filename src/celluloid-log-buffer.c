@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) 2025 gnome-mpv
+ *
+ * This file is part of Celluloid.
+ *
+ * Celluloid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Celluloid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Celluloid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <glib.h>
+#include <string.h>
+
+#include "celluloid-log-buffer.h"
+
+#define READ_ATTEMPTS 4
+
+typedef struct _LogSlot LogSlot;
+
+/* Each slot is guarded by a sequence counter that is odd while the slot is
+ * being written. Readers copy the line and retry if the counter changed in
+ * the meantime, so neither side ever blocks. There must only be one writer.
+ */
+struct _LogSlot
+{
+	gint sequence;
+	CelluloidLogLine line;
+};
+
+struct _CelluloidLogBuffer
+{
+	gatomicrefcount refcount;
+	LogSlot *slots;
+	guint64 mask;
+	gsize end;
+};
+
+static void
+copy_truncated(gchar *dest, gsize dest_size, const gchar *src, gsize len);
+
+static void
+copy_truncated(gchar *dest, gsize dest_size, const gchar *src, gsize len)
+{
+	if(len >= dest_size)
+	{
+		len = dest_size - 1;
+
+		// Don't leave half of a multi-byte character behind
+		while(len > 0 && (src[len] & 0xc0) == 0x80)
+		{
+			len--;
+		}
+	}
+
+	memcpy(dest, src, len);
+	dest[len] = '\0';
+}
+
+CelluloidLogBuffer *
+celluloid_log_buffer_new(guint size)
+{
+	CelluloidLogBuffer *buffer = g_new0(CelluloidLogBuffer, 1);
+	guint capacity = 1;
+
+	// Round up to a power of two so that indices can be masked
+	while(capacity < size)
+	{
+		capacity <<= 1;
+	}
+
+	g_atomic_ref_count_init(&buffer->refcount);
+
+	buffer->slots = g_new0(LogSlot, capacity);
+	buffer->mask = capacity - 1;
+	buffer->end = 0;
+
+	return buffer;
+}
+
+CelluloidLogBuffer *
+celluloid_log_buffer_ref(CelluloidLogBuffer *buffer)
+{
+	g_atomic_ref_count_inc(&buffer->refcount);
+
+	return buffer;
+}
+
+void
+celluloid_log_buffer_unref(CelluloidLogBuffer *buffer)
+{
+	if(buffer && g_atomic_ref_count_dec(&buffer->refcount))
+	{
+		g_free(buffer->slots);
+		g_free(buffer);
+	}
+}
+
+void
+celluloid_log_buffer_append(	CelluloidLogBuffer *buffer,
+				mpv_log_level level,
+				const gchar *prefix,
+				const gchar *text )
+{
+	const gsize index = buffer->end;
+	LogSlot *slot = &buffer->slots[index & buffer->mask];
+	gsize text_len = strlen(text);
+
+	// Messages from mpv are terminated with a newline
+	if(text_len > 0 && text[text_len - 1] == '\n')
+	{
+		text_len--;
+	}
+
+	g_atomic_int_inc(&slot->sequence);
+
+	slot->line.index = index;
+	slot->line.time = g_get_real_time();
+	slot->line.level = level;
+
+	copy_truncated(	slot->line.prefix,
+			CELLULOID_LOG_PREFIX_SIZE,
+			prefix,
+			strlen(prefix) );
+	copy_truncated(	slot->line.text,
+			CELLULOID_LOG_TEXT_SIZE,
+			text,
+			text_len );
+
+	g_atomic_int_inc(&slot->sequence);
+
+	g_atomic_pointer_set(&buffer->end, index + 1);
+}
+
+void
+celluloid_log_buffer_get_range(	const CelluloidLogBuffer *buffer,
+				guint64 *first,
+				guint64 *end )
+{
+	const guint64 capacity = buffer->mask + 1;
+	const guint64 current_end =
+		(guint64)g_atomic_pointer_get((gsize *)&buffer->end);
+
+	*end = current_end;
+	*first = current_end > capacity ? current_end - capacity : 0;
+}
+
+gboolean
+celluloid_log_buffer_read(	const CelluloidLogBuffer *buffer,
+				guint64 index,
+				CelluloidLogLine *line )
+{
+	const LogSlot *slot = &buffer->slots[index & buffer->mask];
+	gboolean done = FALSE;
+	gboolean result = FALSE;
+
+	if(index >= (guint64)g_atomic_pointer_get((gsize *)&buffer->end))
+	{
+		return FALSE;
+	}
+
+	for(gint i = 0; i < READ_ATTEMPTS && !done; i++)
+	{
+		const gint sequence = g_atomic_int_get(&slot->sequence);
+
+		if(sequence % 2 == 0)
+		{
+			memcpy(line, &slot->line, sizeof(CelluloidLogLine));
+
+			done = g_atomic_int_get(&slot->sequence) == sequence;
+
+			// The slot may already hold a newer line
+			result = done && line->index == index;
+		}
+	}
+
+	return result;
+}
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2025 gnome-mpv
+ *
+ * This file is part of Celluloid.
+ *
+ * Celluloid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Celluloid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Celluloid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LOG_BUFFER_H
+#define LOG_BUFFER_H
+
+#include <glib.h>
+#include <mpv/client.h>
+
+#define CELLULOID_LOG_PREFIX_SIZE 32
+#define CELLULOID_LOG_TEXT_SIZE 224
+
+G_BEGIN_DECLS
+
+typedef struct _CelluloidLogBuffer CelluloidLogBuffer;
+typedef struct _CelluloidLogLine CelluloidLogLine;
+
+/* Lines are stored in place, so overlong prefixes and texts are truncated.
+ */
+struct _CelluloidLogLine
+{
+	guint64 index;
+	gint64 time;
+	mpv_log_level level;
+	gchar prefix[CELLULOID_LOG_PREFIX_SIZE];
+	gchar text[CELLULOID_LOG_TEXT_SIZE];
+};
+
+CelluloidLogBuffer *
+celluloid_log_buffer_new(guint size);
+
+CelluloidLogBuffer *
+celluloid_log_buffer_ref(CelluloidLogBuffer *buffer);
+
+void
+celluloid_log_buffer_unref(CelluloidLogBuffer *buffer);
+
+void
+celluloid_log_buffer_append(	CelluloidLogBuffer *buffer,
+				mpv_log_level level,
+				const gchar *prefix,
+				const gchar *text );
+
+void
+celluloid_log_buffer_get_range(	const CelluloidLogBuffer *buffer,
+				guint64 *first,
+				guint64 *end );
+
+gboolean
+celluloid_log_buffer_read(	const CelluloidLogBuffer *buffer,
+				guint64 index,
+				CelluloidLogLine *line );
+
+G_END_DECLS
+
+#endif
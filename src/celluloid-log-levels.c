@@ -0,0 +1,193 @@
+/*
+ * Copyright (c) 2025 gnome-mpv
+ *
+ * This file is part of Celluloid.
+ *
+ * Celluloid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Celluloid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Celluloid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <glib.h>
+#include <string.h>
+
+#include "celluloid-log-levels.h"
+
+typedef struct _LogLevelEntry LogLevelEntry;
+
+struct _LogLevelEntry
+{
+	gchar *prefix;
+	mpv_log_level level;
+};
+
+/* Levels are kept in an array sorted by prefix so that a lookup is a few
+ * binary searches without any allocation, one for each component of the
+ * prefix of the message.
+ */
+struct _CelluloidLogLevels
+{
+	GArray *entries;
+};
+
+static gint
+compare_prefix(const LogLevelEntry *entry, const gchar *prefix, gsize len);
+
+static gboolean
+find_entry(	const CelluloidLogLevels *levels,
+		const gchar *prefix,
+		gsize len,
+		guint *index );
+
+static void
+clear_entry(gpointer data);
+
+static gint
+compare_prefix(const LogLevelEntry *entry, const gchar *prefix, gsize len)
+{
+	gint result = strncmp(entry->prefix, prefix, len);
+
+	// Compare as if prefix were terminated after len characters
+	if(result == 0)
+	{
+		result = entry->prefix[len] != '\0';
+	}
+
+	return result;
+}
+
+static gboolean
+find_entry(	const CelluloidLogLevels *levels,
+		const gchar *prefix,
+		gsize len,
+		guint *index )
+{
+	guint low = 0;
+	guint high = levels->entries->len;
+	gboolean found = FALSE;
+
+	while(low < high && !found)
+	{
+		const guint mid = low + (high - low) / 2;
+		const LogLevelEntry *entry =
+			&g_array_index(levels->entries, LogLevelEntry, mid);
+		const gint cmp = compare_prefix(entry, prefix, len);
+
+		if(cmp < 0)
+		{
+			low = mid + 1;
+		}
+		else if(cmp > 0)
+		{
+			high = mid;
+		}
+		else
+		{
+			low = mid;
+			found = TRUE;
+		}
+	}
+
+	*index = low;
+
+	return found;
+}
+
+static void
+clear_entry(gpointer data)
+{
+	g_free(((LogLevelEntry *)data)->prefix);
+}
+
+CelluloidLogLevels *
+celluloid_log_levels_new(void)
+{
+	CelluloidLogLevels *levels = g_new0(CelluloidLogLevels, 1);
+
+	levels->entries = g_array_new(FALSE, FALSE, sizeof(LogLevelEntry));
+	g_array_set_clear_func(levels->entries, clear_entry);
+
+	return levels;
+}
+
+void
+celluloid_log_levels_free(CelluloidLogLevels *levels)
+{
+	if(levels)
+	{
+		g_array_free(levels->entries, TRUE);
+		g_free(levels);
+	}
+}
+
+void
+celluloid_log_levels_set(	CelluloidLogLevels *levels,
+				const gchar *prefix,
+				mpv_log_level level )
+{
+	guint index = 0;
+
+	if(find_entry(levels, prefix, strlen(prefix), &index))
+	{
+		g_array_index(levels->entries, LogLevelEntry, index).level =
+			level;
+	}
+	else
+	{
+		LogLevelEntry entry = {g_strdup(prefix), level};
+
+		g_array_insert_val(levels->entries, index, entry);
+	}
+}
+
+gboolean
+celluloid_log_levels_lookup(	const CelluloidLogLevels *levels,
+				const gchar *prefix,
+				mpv_log_level *level )
+{
+	gsize len = strlen(prefix);
+	guint index = 0;
+	gboolean found = FALSE;
+
+	// Try the whole prefix first, then drop one component at a time so
+	// that the most specific level wins.
+	while(!found && len > 0)
+	{
+		found = find_entry(levels, prefix, len, &index);
+
+		while(!found && len > 0 && prefix[--len] != '/');
+	}
+
+	if(found)
+	{
+		*level = g_array_index(levels->entries, LogLevelEntry, index).level;
+	}
+
+	return found;
+}
+
+mpv_log_level
+celluloid_log_levels_get_max(	const CelluloidLogLevels *levels,
+				mpv_log_level min_level )
+{
+	mpv_log_level max_level = min_level;
+
+	for(guint i = 0; i < levels->entries->len; i++)
+	{
+		const LogLevelEntry *entry =
+			&g_array_index(levels->entries, LogLevelEntry, i);
+
+		max_level = MAX(max_level, entry->level);
+	}
+
+	return max_level;
+}
@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2025 gnome-mpv
+ *
+ * This file is part of Celluloid.
+ *
+ * Celluloid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Celluloid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Celluloid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LOG_LEVELS_H
+#define LOG_LEVELS_H
+
+#include <glib.h>
+#include <mpv/client.h>
+
+G_BEGIN_DECLS
+
+typedef struct _CelluloidLogLevels CelluloidLogLevels;
+
+CelluloidLogLevels *
+celluloid_log_levels_new(void);
+
+void
+celluloid_log_levels_free(CelluloidLogLevels *levels);
+
+void
+celluloid_log_levels_set(	CelluloidLogLevels *levels,
+				const gchar *prefix,
+				mpv_log_level level );
+
+gboolean
+celluloid_log_levels_lookup(	const CelluloidLogLevels *levels,
+				const gchar *prefix,
+				mpv_log_level *level );
+
+mpv_log_level
+celluloid_log_levels_get_max(	const CelluloidLogLevels *levels,
+				mpv_log_level min_level );
+
+G_END_DECLS
+
+#endif
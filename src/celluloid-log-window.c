@@ -0,0 +1,490 @@
+/*
+ * Copyright (c) 2025 gnome-mpv
+ *
+ * This file is part of Celluloid.
+ *
+ * Celluloid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Celluloid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Celluloid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <glib/gi18n.h>
+#include <gtk/gtk.h>
+
+#include "celluloid-log-window.h"
+#include "celluloid-common.h"
+#include "celluloid-def.h"
+
+#define CELLULOID_TYPE_LOG_MODEL (celluloid_log_model_get_type())
+
+G_DECLARE_FINAL_TYPE(CelluloidLogModel, celluloid_log_model, CELLULOID, LOG_MODEL, GObject)
+
+/* Exposes the lines of a log buffer as a list without copying them. Items
+ * are only formatted when the list view asks for them, which is usually
+ * just for the rows on screen.
+ */
+struct _CelluloidLogModel
+{
+	GObject parent_instance;
+	CelluloidLogBuffer *buffer;
+	guint64 first;
+	guint64 end;
+};
+
+struct _CelluloidLogModelClass
+{
+	GObjectClass parent_class;
+};
+
+struct _CelluloidLogWindow
+{
+	GtkWindow parent_instance;
+	CelluloidLogModel *model;
+	GtkStringFilter *filter;
+	GtkWidget *search_entry;
+	GtkWidget *scrolled_window;
+	GtkWidget *list_view;
+	guint update_id;
+};
+
+struct _CelluloidLogWindowClass
+{
+	GtkWindowClass parent_class;
+};
+
+static void
+celluloid_log_model_list_model_init(GListModelInterface *iface);
+
+static void
+model_finalize(GObject *object);
+
+static void *
+get_item(GListModel *list, guint position);
+
+static GType
+get_item_type(GListModel *list);
+
+static guint
+get_n_items(GListModel *list);
+
+static const gchar *
+get_level_name(mpv_log_level level);
+
+static gchar *
+format_line(const CelluloidLogLine *line);
+
+static CelluloidLogModel *
+celluloid_log_model_new(CelluloidLogBuffer *buffer);
+
+static void
+celluloid_log_model_update(CelluloidLogModel *model);
+
+static void
+dispose(GObject *object);
+
+static gboolean
+update_handler(gpointer data);
+
+static void
+search_changed_handler(GtkSearchEntry *entry, gpointer data);
+
+static void
+stop_search_handler(GtkSearchEntry *entry, gpointer data);
+
+static void
+setup_handler(	GtkSignalListItemFactory *factory,
+		GtkListItem *item,
+		gpointer data );
+
+static void
+bind_handler(	GtkSignalListItemFactory *factory,
+		GtkListItem *item,
+		gpointer data );
+
+G_DEFINE_TYPE_WITH_CODE
+(	CelluloidLogModel,
+	celluloid_log_model,
+	G_TYPE_OBJECT,
+	G_IMPLEMENT_INTERFACE
+	(	G_TYPE_LIST_MODEL,
+		celluloid_log_model_list_model_init ))
+
+G_DEFINE_TYPE(CelluloidLogWindow, celluloid_log_window, GTK_TYPE_WINDOW)
+
+static void
+model_finalize(GObject *object)
+{
+	celluloid_log_buffer_unref(CELLULOID_LOG_MODEL(object)->buffer);
+
+	G_OBJECT_CLASS(celluloid_log_model_parent_class)->finalize(object);
+}
+
+static void *
+get_item(GListModel *list, guint position)
+{
+	CelluloidLogModel *model = CELLULOID_LOG_MODEL(list);
+	CelluloidLogLine line;
+	gchar *str = NULL;
+	GtkStringObject *item = NULL;
+
+	if(position >= get_n_items(list))
+	{
+		return NULL;
+	}
+
+	// The line may have been overwritten since the last update, in which
+	// case the row is left empty until it scrolls out on the next one.
+	if(celluloid_log_buffer_read(model->buffer, model->first + position, &line))
+	{
+		str = format_line(&line);
+	}
+
+	item = gtk_string_object_new(str ? str : "");
+	g_free(str);
+
+	return item;
+}
+
+static GType
+get_item_type(GListModel *list)
+{
+	return GTK_TYPE_STRING_OBJECT;
+}
+
+static guint
+get_n_items(GListModel *list)
+{
+	CelluloidLogModel *model = CELLULOID_LOG_MODEL(list);
+
+	return (guint)(model->end - model->first);
+}
+
+static const gchar *
+get_level_name(mpv_log_level level)
+{
+	const gchar *result = "";
+
+	switch(level)
+	{
+		case MPV_LOG_LEVEL_FATAL:
+		result = "fatal";
+		break;
+
+		case MPV_LOG_LEVEL_ERROR:
+		result = "error";
+		break;
+
+		case MPV_LOG_LEVEL_WARN:
+		result = "warn";
+		break;
+
+		case MPV_LOG_LEVEL_INFO:
+		result = "info";
+		break;
+
+		case MPV_LOG_LEVEL_V:
+		result = "v";
+		break;
+
+		case MPV_LOG_LEVEL_DEBUG:
+		result = "debug";
+		break;
+
+		case MPV_LOG_LEVEL_TRACE:
+		result = "trace";
+		break;
+
+		default:
+		break;
+	}
+
+	return result;
+}
+
+static gchar *
+format_line(const CelluloidLogLine *line)
+{
+	GDateTime *time =	g_date_time_new_from_unix_local
+				(line->time / G_USEC_PER_SEC);
+	gchar *time_str = time ? g_date_time_format(time, "%H:%M:%S") : NULL;
+	gchar *result =	g_strdup_printf
+			(	"%s.%03d [%s] %s: %s",
+				time_str ? time_str : "",
+				(gint)(line->time % G_USEC_PER_SEC / 1000),
+				line->prefix,
+				get_level_name(line->level),
+				line->text );
+
+	g_clear_pointer(&time, g_date_time_unref);
+	g_free(time_str);
+
+	return result;
+}
+
+static void
+celluloid_log_model_list_model_init(GListModelInterface *iface)
+{
+	iface->get_item = get_item;
+	iface->get_item_type = get_item_type;
+	iface->get_n_items = get_n_items;
+}
+
+static void
+celluloid_log_model_class_init(CelluloidLogModelClass *klass)
+{
+	G_OBJECT_CLASS(klass)->finalize = model_finalize;
+}
+
+static void
+celluloid_log_model_init(CelluloidLogModel *model)
+{
+	model->buffer = NULL;
+	model->first = 0;
+	model->end = 0;
+}
+
+static CelluloidLogModel *
+celluloid_log_model_new(CelluloidLogBuffer *buffer)
+{
+	CelluloidLogModel *model = g_object_new(CELLULOID_TYPE_LOG_MODEL, NULL);
+
+	model->buffer = celluloid_log_buffer_ref(buffer);
+	celluloid_log_buffer_get_range(buffer, &model->first, &model->end);
+
+	return model;
+}
+
+static void
+celluloid_log_model_update(CelluloidLogModel *model)
+{
+	const guint64 old_first = model->first;
+	const guint64 old_end = model->end;
+	guint64 first = 0;
+	guint64 end = 0;
+
+	celluloid_log_buffer_get_range(model->buffer, &first, &end);
+
+	if(first >= old_end)
+	{
+		// Nothing that was shown is left
+		model->first = first;
+		model->end = end;
+
+		g_list_model_items_changed
+			(	G_LIST_MODEL(model),
+				0,
+				(guint)(old_end - old_first),
+				(guint)(end - first) );
+	}
+	else
+	{
+		if(first > old_first)
+		{
+			model->first = first;
+
+			g_list_model_items_changed
+				(	G_LIST_MODEL(model),
+					0,
+					(guint)(first - old_first),
+					0 );
+		}
+
+		if(end > old_end)
+		{
+			model->end = end;
+
+			g_list_model_items_changed
+				(	G_LIST_MODEL(model),
+					(guint)(old_end - first),
+					0,
+					(guint)(end - old_end) );
+		}
+	}
+}
+
+static void
+dispose(GObject *object)
+{
+	CelluloidLogWindow *wnd = CELLULOID_LOG_WINDOW(object);
+
+	g_source_clear(&wnd->update_id);
+	g_clear_object(&wnd->model);
+
+	G_OBJECT_CLASS(celluloid_log_window_parent_class)->dispose(object);
+}
+
+static gboolean
+update_handler(gpointer data)
+{
+	CelluloidLogWindow *wnd = data;
+	GtkAdjustment *adj =	gtk_scrolled_window_get_vadjustment
+				(GTK_SCROLLED_WINDOW(wnd->scrolled_window));
+	const gdouble bottom =	gtk_adjustment_get_upper(adj) -
+				gtk_adjustment_get_page_size(adj);
+	const gboolean follow =	gtk_adjustment_get_value(adj) >= bottom - 1.0;
+	const guint64 old_end = wnd->model->end;
+
+	celluloid_log_model_update(wnd->model);
+
+	// Keep showing the newest lines unless the user scrolled up
+	if(follow && wnd->model->end != old_end)
+	{
+		GtkSelectionModel *selection =
+			gtk_list_view_get_model(GTK_LIST_VIEW(wnd->list_view));
+		const guint n_items =
+			g_list_model_get_n_items(G_LIST_MODEL(selection));
+
+		if(n_items > 0)
+		{
+			gtk_list_view_scroll_to(	GTK_LIST_VIEW(wnd->list_view),
+							n_items - 1,
+							GTK_LIST_SCROLL_NONE,
+							NULL );
+		}
+	}
+
+	return G_SOURCE_CONTINUE;
+}
+
+static void
+search_changed_handler(GtkSearchEntry *entry, gpointer data)
+{
+	CelluloidLogWindow *wnd = data;
+	const gchar *text = gtk_editable_get_text(GTK_EDITABLE(entry));
+
+	gtk_string_filter_set_search(wnd->filter, *text ? text : NULL);
+}
+
+static void
+stop_search_handler(GtkSearchEntry *entry, gpointer data)
+{
+	gtk_editable_set_text(GTK_EDITABLE(entry), "");
+}
+
+static void
+setup_handler(	GtkSignalListItemFactory *factory,
+		GtkListItem *item,
+		gpointer data )
+{
+	GtkWidget *label = gtk_label_new(NULL);
+
+	gtk_label_set_xalign(GTK_LABEL(label), 0.0f);
+	gtk_label_set_selectable(GTK_LABEL(label), TRUE);
+	gtk_widget_add_css_class(label, "monospace");
+
+	gtk_list_item_set_child(item, label);
+}
+
+static void
+bind_handler(	GtkSignalListItemFactory *factory,
+		GtkListItem *item,
+		gpointer data )
+{
+	GtkWidget *label = gtk_list_item_get_child(item);
+	GtkStringObject *line = gtk_list_item_get_item(item);
+
+	gtk_label_set_text(GTK_LABEL(label), gtk_string_object_get_string(line));
+}
+
+static void
+celluloid_log_window_class_init(CelluloidLogWindowClass *klass)
+{
+	G_OBJECT_CLASS(klass)->dispose = dispose;
+}
+
+static void
+celluloid_log_window_init(CelluloidLogWindow *wnd)
+{
+	GtkWidget *box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 6);
+
+	wnd->model = NULL;
+	wnd->filter = NULL;
+	wnd->search_entry = gtk_search_entry_new();
+	wnd->scrolled_window = gtk_scrolled_window_new();
+	wnd->list_view = gtk_list_view_new(NULL, NULL);
+	wnd->update_id = 0;
+
+	gtk_widget_set_margin_start(wnd->search_entry, 6);
+	gtk_widget_set_margin_end(wnd->search_entry, 6);
+	gtk_widget_set_margin_top(wnd->search_entry, 6);
+	gtk_widget_set_vexpand(wnd->scrolled_window, TRUE);
+
+	gtk_scrolled_window_set_child
+		(GTK_SCROLLED_WINDOW(wnd->scrolled_window), wnd->list_view);
+	gtk_box_append(GTK_BOX(box), wnd->search_entry);
+	gtk_box_append(GTK_BOX(box), wnd->scrolled_window);
+
+	gtk_window_set_title(GTK_WINDOW(wnd), _("Log"));
+	gtk_window_set_default_size(GTK_WINDOW(wnd), 800, 500);
+	gtk_window_set_child(GTK_WINDOW(wnd), box);
+
+	g_signal_connect(	wnd->search_entry,
+				"search-changed",
+				G_CALLBACK(search_changed_handler),
+				wnd );
+	g_signal_connect(	wnd->search_entry,
+				"stop-search",
+				G_CALLBACK(stop_search_handler),
+				wnd );
+}
+
+GtkWidget *
+celluloid_log_window_new(GtkWindow *parent, CelluloidLogBuffer *buffer)
+{
+	CelluloidLogWindow *wnd = NULL;
+	GtkListItemFactory *factory = NULL;
+	GtkFilterListModel *filter_model = NULL;
+	GtkNoSelection *selection = NULL;
+	GtkExpression *expression = NULL;
+
+	wnd = g_object_new(	celluloid_log_window_get_type(),
+				"transient-for", parent,
+				NULL );
+
+	expression =	gtk_property_expression_new
+			(GTK_TYPE_STRING_OBJECT, NULL, "string");
+	wnd->filter = gtk_string_filter_new(expression);
+	wnd->model = celluloid_log_model_new(buffer);
+
+	filter_model =	gtk_filter_list_model_new
+			(	G_LIST_MODEL(g_object_ref(wnd->model)),
+				GTK_FILTER(wnd->filter) );
+	selection = gtk_no_selection_new(G_LIST_MODEL(filter_model));
+	factory = gtk_signal_list_item_factory_new();
+
+	// Searching has to format every line, so it is done in chunks to
+	// keep the window responsive.
+	gtk_filter_list_model_set_incremental(filter_model, TRUE);
+
+	g_signal_connect(	factory,
+				"setup",
+				G_CALLBACK(setup_handler),
+				wnd );
+	g_signal_connect(	factory,
+				"bind",
+				G_CALLBACK(bind_handler),
+				wnd );
+
+	gtk_list_view_set_model
+		(GTK_LIST_VIEW(wnd->list_view), GTK_SELECTION_MODEL(selection));
+	gtk_list_view_set_factory(GTK_LIST_VIEW(wnd->list_view), factory);
+
+	wnd->update_id =	g_timeout_add
+				(	LOG_WINDOW_UPDATE_INTERVAL,
+					update_handler,
+					wnd );
+
+	g_object_unref(selection);
+	g_object_unref(factory);
+
+	return GTK_WIDGET(wnd);
+}
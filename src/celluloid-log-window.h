@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2025 gnome-mpv
+ *
+ * This file is part of Celluloid.
+ *
+ * Celluloid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Celluloid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Celluloid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LOG_WINDOW_H
+#define LOG_WINDOW_H
+
+#include <glib.h>
+#include <glib-object.h>
+#include <gtk/gtk.h>
+
+#include "celluloid-log-buffer.h"
+
+G_BEGIN_DECLS
+
+#define CELLULOID_TYPE_LOG_WINDOW (celluloid_log_window_get_type ())
+
+G_DECLARE_FINAL_TYPE(CelluloidLogWindow, celluloid_log_window, CELLULOID, LOG_WINDOW, GtkWindow)
+
+GtkWidget *
+celluloid_log_window_new(GtkWindow *parent, CelluloidLogBuffer *buffer);
+
+G_END_DECLS
+
+#endif
@@ -32,6 +32,8 @@
 #include "celluloid-control-box.h"
 #include "celluloid-video-area.h"
 
+#define MENUBAR_OWNER_KEY "celluloid-track-menus-owner"
+
 #define get_private(window) \
 	((CelluloidMainWindowPrivate *)celluloid_main_window_get_instance_private(CELLULOID_MAIN_WINDOW(window)))
 
@@ -61,6 +63,7 @@ struct _CelluloidMainWindowPrivate
 	GPtrArray *chapter_list;
 	const GPtrArray *track_list;
 	const GPtrArray *disc_list;
+	CelluloidTrackMenus track_menus;
 	GtkWidget *header_bar;
 	GtkWidget *main_box;
 	GtkWidget *video_split_view;
@@ -93,6 +96,9 @@ notify_fullscreened_handler(GObject *object, GParamSpec *pspec, gpointer data);
 static void
 seek_handler(GtkWidget *widget, gdouble value, gpointer data);
 
+static void
+scrub_handler(GtkWidget *widget, gdouble value, gpointer data);
+
 static void
 button_clicked_handler(	CelluloidControlBox *control_box,
 			const gchar *button,
@@ -167,6 +173,7 @@ static void
 dispose(GObject *object)
 {
 	g_source_clear(&get_private(object)->resize_tag);
+	celluloid_menu_track_menus_clear(&get_private(object)->track_menus);
 
 	G_OBJECT_CLASS(celluloid_main_window_parent_class)->dispose(object);
 }
@@ -251,6 +258,12 @@ seek_handler(GtkWidget *widget, gdouble value, gpointer data)
 	g_signal_emit_by_name(data, "seek", value);
 }
 
+static void
+scrub_handler(GtkWidget *widget, gdouble value, gpointer data)
+{
+	g_signal_emit_by_name(data, "scrub", value);
+}
+
 static void
 button_clicked_handler(	CelluloidControlBox *control_box,
 			const gchar *button,
@@ -432,6 +445,16 @@ celluloid_main_window_class_init(CelluloidMainWindowClass *klass)
 			G_TYPE_NONE,
 			1,
 			G_TYPE_DOUBLE );
+	g_signal_new(	"scrub",
+			G_TYPE_FROM_CLASS(klass),
+			G_SIGNAL_RUN_FIRST,
+			0,
+			NULL,
+			NULL,
+			g_cclosure_marshal_VOID__DOUBLE,
+			G_TYPE_NONE,
+			1,
+			G_TYPE_DOUBLE );
 }
 
 static void
@@ -457,6 +480,8 @@ celluloid_main_window_init(CelluloidMainWindow *wnd)
 	priv->video_area = celluloid_video_area_new();
 	priv->control_box = celluloid_control_box_new();
 
+	celluloid_menu_track_menus_init(&priv->track_menus);
+
 	priv->width_offset = 0;
 	priv->height_offset = 0;
 	priv->compact_threshold = -1;
@@ -486,9 +511,15 @@ celluloid_main_window_init(CelluloidMainWindow *wnd)
 	g_object_bind_property(	priv->control_box, "chapter-list",
 				video_area_control_box, "chapter-list",
 				G_BINDING_DEFAULT );
+	g_object_bind_property(	priv->control_box, "buffered-ranges",
+				video_area_control_box, "buffered-ranges",
+				G_BINDING_DEFAULT );
 	g_object_bind_property(	priv->control_box, "duration",
 				video_area_control_box, "duration",
 				G_BINDING_DEFAULT );
+	g_object_bind_property(	priv->control_box, "thumbnailer",
+				video_area_control_box, "thumbnailer",
+				G_BINDING_DEFAULT );
 	g_object_bind_property(	priv->control_box, "pause",
 				video_area_control_box, "pause",
 				G_BINDING_DEFAULT );
@@ -512,6 +543,10 @@ celluloid_main_window_init(CelluloidMainWindow *wnd)
 				"seek",
 				G_CALLBACK(seek_handler),
 				wnd );
+	g_signal_connect(	priv->control_box,
+				"scrub",
+				G_CALLBACK(scrub_handler),
+				wnd );
 	g_signal_connect(	priv->control_box,
 				"button-clicked",
 				G_CALLBACK(button_clicked_handler),
@@ -520,6 +555,10 @@ celluloid_main_window_init(CelluloidMainWindow *wnd)
 				"seek",
 				G_CALLBACK(seek_handler),
 				wnd );
+	g_signal_connect(	video_area_control_box,
+				"scrub",
+				G_CALLBACK(scrub_handler),
+				wnd );
 	g_signal_connect(	video_area_control_box,
 				"button-clicked",
 				G_CALLBACK(button_clicked_handler),
@@ -739,12 +778,20 @@ celluloid_main_window_update_track_list(	CelluloidMainWindow *wnd,
 		app = gtk_window_get_application(GTK_WINDOW(wnd));
 		menu = G_MENU(gtk_application_get_menubar(app));
 
-		if(menu)
+		celluloid_menu_track_menus_update
+			(&priv->track_menus, track_list);
+
+		// The menu bar is shared by every window of the application,
+		// so it has to be rebuilt if another window took it over.
+		if(	menu &&
+			g_object_get_data(G_OBJECT(menu), MENUBAR_OWNER_KEY) != wnd )
 		{
 			g_menu_remove_all(menu);
 
 			celluloid_menu_build_full
-				(menu, track_list, priv->disc_list);
+				(menu, &priv->track_menus, priv->disc_list);
+
+			g_object_set_data(G_OBJECT(menu), MENUBAR_OWNER_KEY, wnd);
 		}
 	}
 }
@@ -777,7 +824,9 @@ celluloid_main_window_update_disc_list(	CelluloidMainWindow *wnd,
 			g_menu_remove_all(menu);
 
 			celluloid_menu_build_full
-				(menu, priv->track_list, disc_list);
+				(menu, &priv->track_menus, disc_list);
+
+			g_object_set_data(G_OBJECT(menu), MENUBAR_OWNER_KEY, wnd);
 		}
 	}
 }
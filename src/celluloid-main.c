@@ -22,6 +22,7 @@
 #include <glib.h>
 
 #include "celluloid-application.h"
+#include "celluloid-trace.h"
 #include "celluloid-def.h"
 
 int
@@ -31,6 +32,8 @@ main(int argc, char **argv)
 	CelluloidApplication *app;
 	gint status;
 
+	celluloid_trace_init();
+
 	flags = G_APPLICATION_HANDLES_COMMAND_LINE|G_APPLICATION_HANDLES_OPEN;
 	app = celluloid_application_new(APP_ID, flags);
 	status = g_application_run(G_APPLICATION(app), argc, argv);
@@ -31,19 +31,16 @@ split_track_list(	const GPtrArray *track_list,
 			GPtrArray **video_tracks,
 			GPtrArray **subtitle_tracks );
 
-static GMenu *
-build_menu_from_track_list(	const GPtrArray *list,
-				const gchar *action,
-				const gchar *load_action );
-
-static GMenu *
-build_video_track_menu(const GPtrArray *list);
+static gchar *
+get_track_label(const CelluloidTrack *track);
 
 static GMenu *
-build_audio_track_menu(const GPtrArray *list);
+build_track_menu(const gchar *action, const gchar *load_action);
 
-static GMenu *
-build_subtitle_track_menu(const GPtrArray *list);
+static void
+update_track_menu(	GMenu *menu,
+			const GPtrArray *list,
+			const gchar *action );
 
 static GMenu *
 build_disc_menu(const GPtrArray *disc_list);
@@ -90,98 +87,156 @@ split_track_list(	const GPtrArray *track_list,
 	}
 }
 
-static GMenu *
-build_menu_from_track_list(	const GPtrArray *list,
-				const gchar *action,
-				const gchar *load_action )
+static gchar *
+get_track_label(const CelluloidTrack *track)
 {
-	GMenu *menu = g_menu_new();
 	const glong max_len = 32;
-	gchar *detailed_action;
+	glong title_len;
+	gchar *title;
+	gchar *label;
+
+	/* For simplicity, also dup the default string used when the track has
+	 * no title.
+	 */
+	title = g_strdup(track->title?:_("Unknown"));
+
+	/* Maximum number of bytes per UTF-8 character is 4 */
+	title_len = g_utf8_strlen(title, 4*(max_len+1));
+
+	if(title_len > max_len)
+	{
+		/* Truncate the string */
+		*(g_utf8_offset_to_pointer(title, max_len)) = '\0';
+	}
 
-	g_assert(list);
+	/* Ellipsize the title if it's longer than max_len */
+	label = g_strdup_printf(	track->lang?
+					"%s%s (%s)":"%s%s",
+					title,
+					(title_len > max_len)?"…":"",
+					track->lang );
 
-	detailed_action = g_strdup_printf("%s(@x 0)", action);
+	g_free(title);
+
+	return label;
+}
+
+static GMenu *
+build_track_menu(const gchar *action, const gchar *load_action)
+{
+	GMenu *menu = g_menu_new();
+	gchar *detailed_action = g_strdup_printf("%s(@x 0)", action);
 
 	g_menu_append(menu, _("None"), detailed_action);
+	g_menu_append(menu, _("_Load External…"), load_action);
+
 	g_free(detailed_action);
 
-	for(guint i = 0; i < list->len; i++)
-	{
-		CelluloidTrack *entry;
-		glong entry_title_len;
-		gchar *entry_title;
-		gchar *title;
+	return menu;
+}
+
+static void
+update_track_menu(	GMenu *menu,
+			const GPtrArray *list,
+			const gchar *action )
+{
+	/* Tracks are listed between the "None" item and the item for loading
+	 * external tracks. Items are matched to tracks by id so that only the
+	 * tracks that were added, removed, or renamed touch the menu.
+	 */
+	GMenuModel *model = G_MENU_MODEL(menu);
+	const gint first = 1;
+	const gint n_items = g_menu_model_get_n_items(model);
+	GArray *ids = g_array_new(FALSE, FALSE, sizeof(gint64));
+	GHashTable *wanted = g_hash_table_new(g_int64_hash, g_int64_equal);
 
-		entry = g_ptr_array_index(list, i);
+	for(gint i = first; i < n_items - 1; i++)
+	{
+		GVariant *target =	g_menu_model_get_item_attribute_value
+					(	model,
+						i,
+						G_MENU_ATTRIBUTE_TARGET,
+						G_VARIANT_TYPE_INT64 );
+		const gint64 id = target ? g_variant_get_int64(target) : -1;
+
+		g_array_append_val(ids, id);
+		g_clear_pointer(&target, g_variant_unref);
+	}
 
-		/* For simplicity, also dup the default string used when the
-		 * track has no title.
-		 */
-		entry_title = g_strdup(entry->title?:_("Unknown"));
+	for(guint i = 0; list && i < list->len; i++)
+	{
+		CelluloidTrack *track = g_ptr_array_index(list, i);
 
-		/* Maximum number of bytes per UTF-8 character is 4 */
-		entry_title_len = g_utf8_strlen(entry_title, 4*(max_len+1));
+		g_hash_table_add(wanted, &track->id);
+	}
 
-		if(entry_title_len > max_len)
+	for(guint i = ids->len; i > 0; i--)
+	{
+		if(!g_hash_table_contains(wanted, &g_array_index(ids, gint64, i - 1)))
 		{
-			/* Truncate the string */
-			*(g_utf8_offset_to_pointer(entry_title, max_len)) = '\0';
+			g_menu_remove(menu, first + (gint)i - 1);
+			g_array_remove_index(ids, i - 1);
 		}
+	}
 
-		detailed_action
-			= g_strdup_printf(	"%s(@x %" G_GINT64_FORMAT ")",
-						action,
-						entry->id );
+	for(guint i = 0; list && i < list->len; i++)
+	{
+		const CelluloidTrack *track = g_ptr_array_index(list, i);
+		gchar *label = get_track_label(track);
+		gboolean keep = FALSE;
 
-		/* Ellipsize the title if it's longer than max_len */
-		title = g_strdup_printf(	entry->lang?
-						"%s%s (%s)":"%s%s",
-						entry_title,
-						(entry_title_len > max_len)?
-						"…":"",
-						entry->lang );
+		if(i < ids->len && g_array_index(ids, gint64, i) == track->id)
+		{
+			gchar *old_label = NULL;
 
-		g_menu_append(menu, title, detailed_action);
+			g_menu_model_get_item_attribute
+				(	model,
+					first + (gint)i,
+					G_MENU_ATTRIBUTE_LABEL,
+					"s",
+					&old_label );
 
-		g_free(detailed_action);
-		g_free(entry_title);
-		g_free(title);
-	}
+			keep = g_strcmp0(label, old_label) == 0;
 
-	if(load_action)
-	{
-		g_menu_append(menu, _("_Load External…"), load_action);
-	}
+			if(!keep)
+			{
+				g_menu_remove(menu, first + (gint)i);
+				g_array_remove_index(ids, i);
+			}
 
-	return menu;
-}
+			g_free(old_label);
+		}
+		else
+		{
+			// The track moved, so its old item has to go
+			for(guint j = i + 1; j < ids->len; j++)
+			{
+				if(g_array_index(ids, gint64, j) == track->id)
+				{
+					g_menu_remove(menu, first + (gint)j);
+					g_array_remove_index(ids, j);
+					break;
+				}
+			}
+		}
 
-static GMenu *
-build_video_track_menu(const GPtrArray *list)
-{
-	return	build_menu_from_track_list
-		(	list,
-			"win.set-video-track",
-			"win.load-track('video-add')" );
-}
+		if(!keep)
+		{
+			GMenuItem *item = g_menu_item_new(label, NULL);
 
-static GMenu *
-build_audio_track_menu(const GPtrArray *list)
-{
-	return	build_menu_from_track_list
-		(	list,
-			"win.set-audio-track",
-			"win.load-track('audio-add')" );
-}
+			g_menu_item_set_action_and_target_value
+				(item, action, g_variant_new_int64(track->id));
+			g_menu_insert_item(menu, first + (gint)i, item);
+			g_array_insert_val(ids, i, track->id);
 
-static GMenu *
-build_subtitle_track_menu(const GPtrArray *list)
-{
-	return	build_menu_from_track_list
-		(	list,
-			"win.set-subtitle-track",
-			"win.load-track('sub-add')" );
+			g_object_unref(item);
+		}
+
+		g_free(label);
+	}
+
+	g_hash_table_unref(wanted);
+	g_array_free(ids, TRUE);
 }
 
 static GMenu *
@@ -211,24 +266,66 @@ build_disc_menu(const GPtrArray *disc_list)
 }
 
 void
-celluloid_menu_build_full(	GMenu *menu,
-				const GPtrArray *track_list,
-				const GPtrArray *disc_list )
+celluloid_menu_track_menus_init(CelluloidTrackMenus *track_menus)
+{
+	track_menus->video =	build_track_menu
+				(	"win.set-video-track",
+					"win.load-track('video-add')" );
+	track_menus->audio =	build_track_menu
+				(	"win.set-audio-track",
+					"win.load-track('audio-add')" );
+	track_menus->subtitle =	build_track_menu
+				(	"win.set-subtitle-track",
+					"win.load-track('sub-add')" );
+}
+
+void
+celluloid_menu_track_menus_clear(CelluloidTrackMenus *track_menus)
+{
+	g_clear_object(&track_menus->video);
+	g_clear_object(&track_menus->audio);
+	g_clear_object(&track_menus->subtitle);
+}
+
+void
+celluloid_menu_track_menus_update(	CelluloidTrackMenus *track_menus,
+					const GPtrArray *track_list )
 {
 	GPtrArray *audio_tracks = NULL;
 	GPtrArray *video_tracks = NULL;
 	GPtrArray *subtitle_tracks = NULL;
-	GMenu *video_menu = NULL;
-	GMenu *audio_menu = NULL;
-	GMenu *subtitle_menu = NULL;
-	GMenu *disc_menu = NULL;
 
 	split_track_list
 		(track_list, &audio_tracks, &video_tracks, &subtitle_tracks);
 
-	video_menu = build_video_track_menu(video_tracks);
-	audio_menu = build_audio_track_menu(audio_tracks);
-	subtitle_menu = build_subtitle_track_menu(subtitle_tracks);
+	update_track_menu
+		(track_menus->video, video_tracks, "win.set-video-track");
+	update_track_menu
+		(track_menus->audio, audio_tracks, "win.set-audio-track");
+	update_track_menu
+		(	track_menus->subtitle,
+			subtitle_tracks,
+			"win.set-subtitle-track" );
+
+	g_ptr_array_free(audio_tracks, FALSE);
+	g_ptr_array_free(video_tracks, FALSE);
+	g_ptr_array_free(subtitle_tracks, FALSE);
+}
+
+void
+celluloid_menu_build_full(	GMenu *menu,
+				const CelluloidTrackMenus *track_menus,
+				const GPtrArray *disc_list )
+{
+	CelluloidTrackMenus empty_menus = {NULL, NULL, NULL};
+	GMenu *disc_menu = NULL;
+
+	if(!track_menus)
+	{
+		celluloid_menu_track_menus_init(&empty_menus);
+		track_menus = &empty_menus;
+	}
+
 	disc_menu = build_disc_menu(disc_list);
 
 	const CelluloidMenuEntry entries[]
@@ -242,44 +339,35 @@ celluloid_menu_build_full(	GMenu *menu,
 			CELLULOID_MENU_ITEM(_("_Quit"), "win.quit"),
 			CELLULOID_MENU_SUBMENU(_("_Edit"), NULL),
 			CELLULOID_MENU_ITEM(_("_Preferences"), "win.show-preferences-dialog"),
-			CELLULOID_MENU_SUBMENU(_("_Video Track"), video_menu),
-			CELLULOID_MENU_SUBMENU(_("_Audio Track"), audio_menu),
-			CELLULOID_MENU_SUBMENU(_("S_ubtitle Track"), subtitle_menu),
+			CELLULOID_MENU_SUBMENU(_("_Video Track"), track_menus->video),
+			CELLULOID_MENU_SUBMENU(_("_Audio Track"), track_menus->audio),
+			CELLULOID_MENU_SUBMENU(_("S_ubtitle Track"), track_menus->subtitle),
 			CELLULOID_MENU_SUBMENU(_("_View"), NULL),
 			CELLULOID_MENU_ITEM(_("_Toggle Controls"), "win.toggle-controls"),
 			CELLULOID_MENU_ITEM(_("_Fullscreen"), "win.toggle-fullscreen"),
 			CELLULOID_MENU_SUBMENU(_("_Help"), NULL),
 			CELLULOID_MENU_ITEM(_("_Keyboard Shortcuts"), "win.show-shortcuts-dialog"),
+			CELLULOID_MENU_ITEM(_("_Log"), "win.show-log-window"),
 			CELLULOID_MENU_ITEM(_("_About Celluloid"), "win.show-about-dialog"),
 			CELLULOID_MENU_END };
 
 	celluloid_menu_build_menu(menu, entries, FALSE);
 
-	g_ptr_array_free(audio_tracks, FALSE);
-	g_ptr_array_free(video_tracks, FALSE);
-	g_ptr_array_free(subtitle_tracks, FALSE);
-	g_object_unref(video_menu);
-	g_object_unref(audio_menu);
-	g_object_unref(subtitle_menu);
+	celluloid_menu_track_menus_clear(&empty_menus);
 	g_object_unref(disc_menu);
 }
 
 void
-celluloid_menu_build_menu_btn(GMenu *menu, const GPtrArray *track_list)
+celluloid_menu_build_menu_btn(	GMenu *menu,
+				const CelluloidTrackMenus *track_menus )
 {
-	GPtrArray *audio_tracks = NULL;
-	GPtrArray *video_tracks = NULL;
-	GPtrArray *subtitle_tracks = NULL;
-	GMenu *video_menu = NULL;
-	GMenu *audio_menu = NULL;
-	GMenu *subtitle_menu = NULL;
-
-	split_track_list
-		(track_list, &audio_tracks, &video_tracks, &subtitle_tracks);
+	CelluloidTrackMenus empty_menus = {NULL, NULL, NULL};
 
-	video_menu = build_video_track_menu(video_tracks);
-	audio_menu = build_audio_track_menu(audio_tracks);
-	subtitle_menu = build_subtitle_track_menu(subtitle_tracks);
+	if(!track_menus)
+	{
+		celluloid_menu_track_menus_init(&empty_menus);
+		track_menus = &empty_menus;
+	}
 
 	const CelluloidMenuEntry entries[]
 		= {	CELLULOID_MENU_SEPARATOR,
@@ -287,23 +375,19 @@ celluloid_menu_build_menu_btn(GMenu *menu, const GPtrArray *track_list)
 			CELLULOID_MENU_SEPARATOR,
 			CELLULOID_MENU_ITEM(_("_Save Playlist"), "win.save-playlist"),
 			CELLULOID_MENU_SEPARATOR,
-			CELLULOID_MENU_SUBMENU(_("_Video Track"), video_menu),
-			CELLULOID_MENU_SUBMENU(_("_Audio Track"), audio_menu),
-			CELLULOID_MENU_SUBMENU(_("S_ubtitle Track"), subtitle_menu),
+			CELLULOID_MENU_SUBMENU(_("_Video Track"), track_menus->video),
+			CELLULOID_MENU_SUBMENU(_("_Audio Track"), track_menus->audio),
+			CELLULOID_MENU_SUBMENU(_("S_ubtitle Track"), track_menus->subtitle),
 			CELLULOID_MENU_SEPARATOR,
 			CELLULOID_MENU_ITEM(_("_Preferences"), "win.show-preferences-dialog"),
 			CELLULOID_MENU_ITEM(_("_Keyboard Shortcuts"), "win.show-shortcuts-dialog"),
+			CELLULOID_MENU_ITEM(_("_Log"), "win.show-log-window"),
 			CELLULOID_MENU_ITEM(_("_About Celluloid"), "win.show-about-dialog"),
 			CELLULOID_MENU_END };
 
 	celluloid_menu_build_menu(menu, entries, TRUE);
 
-	g_ptr_array_free(audio_tracks, FALSE);
-	g_ptr_array_free(video_tracks, FALSE);
-	g_ptr_array_free(subtitle_tracks, FALSE);
-	g_object_unref(video_menu);
-	g_object_unref(audio_menu);
-	g_object_unref(subtitle_menu);
+	celluloid_menu_track_menus_clear(&empty_menus);
 }
 
 void
@@ -39,13 +39,36 @@ struct CelluloidMenuEntry
 
 typedef struct CelluloidMenuEntry CelluloidMenuEntry;
 
+/* Track submenus that outlive the menus they are placed in, so that changes
+ * to the track list can be applied to them in place.
+ */
+struct CelluloidTrackMenus
+{
+	GMenu *video;
+	GMenu *audio;
+	GMenu *subtitle;
+};
+
+typedef struct CelluloidTrackMenus CelluloidTrackMenus;
+
+void
+celluloid_menu_track_menus_init(CelluloidTrackMenus *track_menus);
+
+void
+celluloid_menu_track_menus_clear(CelluloidTrackMenus *track_menus);
+
+void
+celluloid_menu_track_menus_update(	CelluloidTrackMenus *track_menus,
+					const GPtrArray *track_list );
+
 void
 celluloid_menu_build_full(	GMenu *celluloid_menu,
-				const GPtrArray *track_list,
+				const CelluloidTrackMenus *track_menus,
 				const GPtrArray *disc_list );
 
 void
-celluloid_menu_build_menu_btn(GMenu *celluloid_menu, const GPtrArray *track_list);
+celluloid_menu_build_menu_btn(	GMenu *celluloid_menu,
+				const CelluloidTrackMenus *track_menus );
 
 void
 celluloid_menu_build_open_btn(GMenu *celluloid_menu, const GPtrArray *disc_list);
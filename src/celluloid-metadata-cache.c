@@ -18,15 +18,22 @@
  */
 
 #include "celluloid-metadata-cache.h"
+#include "celluloid-job-scheduler.h"
 #include "celluloid-mpv.h"
 
+typedef struct _FetchData FetchData;
+
 struct _CelluloidMetadataCache
 {
 	GObject parent;
 	GHashTable *table;
-	CelluloidMpv *fetcher;
-	GQueue *fetch_queue;
-	guint fetch_timeout_id;
+	GHashTable *jobs;
+};
+
+struct _FetchData
+{
+	CelluloidMetadataCache *cache;
+	gchar *uri;
 };
 
 struct _CelluloidMetadataCacheClass
@@ -50,13 +57,25 @@ static void
 metadata_to_ptr_array(mpv_node metadata, GPtrArray *array);
 
 static void
-mpv_event_notify(	CelluloidMpv *mpv,
-			gint event_id,
-			gpointer event_data,
-			gpointer data );
+fetch_data_free(FetchData *data);
 
 static gboolean
-fetch_metadata(CelluloidMetadataCache *cache);
+fetch_handler(	CelluloidMpv *mpv,
+		gint event_id,
+		gpointer event_data,
+		gpointer data );
+
+static void
+fetch_metadata(CelluloidMetadataCache *cache, gchar *uri);
+
+static void
+cancel_fetch(CelluloidMetadataCache *cache, const gchar *uri);
+
+static void
+drop_owner(CelluloidMetadataCache *cache, gconstpointer owner);
+
+static void
+prune_entries(CelluloidMetadataCache *cache);
 
 G_DEFINE_TYPE(CelluloidMetadataCache, celluloid_metadata_cache, G_TYPE_OBJECT)
 
@@ -66,6 +85,7 @@ celluloid_metadata_cache_entry_new(void)
 	CelluloidMetadataCacheEntry *entry =
 		g_new0(CelluloidMetadataCacheEntry, 1);
 
+	entry->references = g_hash_table_new(g_direct_hash, g_direct_equal);
 	entry->tags =	g_ptr_array_new_with_free_func
 			((GDestroyNotify)celluloid_metadata_entry_free);
 
@@ -77,7 +97,8 @@ celluloid_metadata_cache_entry_free(CelluloidMetadataCacheEntry *entry)
 {
 	if(entry)
 	{
-		g_free(entry->title);
+		g_hash_table_unref(entry->references);
+		celluloid_release_string(entry->title);
 		g_ptr_array_free(entry->tags, TRUE);
 		g_free(entry);
 	}
@@ -87,9 +108,18 @@ static void
 dispose(GObject *object)
 {
 	CelluloidMetadataCache *cache = CELLULOID_METADATA_CACHE(object);
+	GList *ids = g_hash_table_get_values(cache->jobs);
 
-	g_source_clear(&cache->fetch_timeout_id);
-	g_clear_object(&CELLULOID_METADATA_CACHE(object)->fetcher);
+	for(GList *iter = ids; iter; iter = iter->next)
+	{
+		celluloid_job_scheduler_cancel
+			(	celluloid_job_scheduler_get_default(),
+				GPOINTER_TO_UINT(iter->data) );
+	}
+
+	g_list_free(ids);
+
+	G_OBJECT_CLASS(celluloid_metadata_cache_parent_class)->dispose(object);
 }
 
 static void
@@ -98,7 +128,9 @@ finalize(GObject *object)
 	CelluloidMetadataCache *cache = CELLULOID_METADATA_CACHE(object);
 
 	g_hash_table_unref(cache->table);
-	g_queue_free_full(cache->fetch_queue, g_free);
+	g_hash_table_unref(cache->jobs);
+
+	G_OBJECT_CLASS(celluloid_metadata_cache_parent_class)->finalize(object);
 }
 
 static void
@@ -136,117 +168,142 @@ metadata_to_ptr_array(mpv_node metadata, GPtrArray *array)
 }
 
 static void
-mpv_event_notify(	CelluloidMpv *mpv,
-			gint event_id,
-			gpointer event_data,
-			gpointer data )
+fetch_data_free(FetchData *data)
 {
-	if(event_id == MPV_EVENT_FILE_LOADED)
-	{
-		CelluloidMetadataCache *cache = data;
-		CelluloidMetadataCacheEntry *entry = NULL;
-		gchar *path = NULL;
+	g_hash_table_remove(data->cache->jobs, data->uri);
+	celluloid_release_string(data->uri);
+	g_free(data);
+}
 
-		celluloid_mpv_get_property
-			(mpv, "path", MPV_FORMAT_STRING, &path);
+static gboolean
+fetch_handler(	CelluloidMpv *mpv,
+		gint event_id,
+		gpointer event_data,
+		gpointer data )
+{
+	FetchData *fetch_data = data;
+	CelluloidMetadataCache *cache = fetch_data->cache;
+	CelluloidMetadataCacheEntry *entry = NULL;
+	const gchar *uri = fetch_data->uri;
 
-		if(path)
-		{
-			g_debug("Fetched metadata for %s", path);
+	if(event_id == MPV_EVENT_END_FILE)
+	{
+		g_debug("Failed to fetch metadata for %s", uri);
+	}
+	else if(event_id == MPV_EVENT_FILE_LOADED)
+	{
+		entry = g_hash_table_lookup(cache->table, uri);
+	}
 
-			entry =	g_hash_table_lookup(cache->table, path);
+	if(entry)
+	{
+		gchar *media_title = NULL;
+		mpv_node metadata;
+
+		g_debug("Fetched metadata for %s", uri);
+
+		celluloid_mpv_get_property(	mpv,
+						"duration",
+						MPV_FORMAT_DOUBLE,
+						&entry->duration );
+		celluloid_mpv_get_property(	mpv,
+						"media-title",
+						MPV_FORMAT_STRING,
+						&media_title );
+		celluloid_mpv_get_property(	mpv,
+						"metadata",
+						MPV_FORMAT_NODE,
+						&metadata );
+
+		if(!entry->title)
+		{
+			entry->title = celluloid_intern_string(media_title);
 		}
 
-		if(entry)
-		{
-			const gchar *cmd[] = {"playlist-next", "force", NULL};
-			gchar *media_title = NULL;
-			mpv_node metadata;
-
-			celluloid_mpv_get_property(	mpv,
-							"duration",
-							MPV_FORMAT_DOUBLE,
-							&entry->duration );
-			celluloid_mpv_get_property(	mpv,
-							"media-title",
-							MPV_FORMAT_STRING,
-							&media_title );
-			celluloid_mpv_get_property(	mpv,
-							"metadata",
-							MPV_FORMAT_NODE,
-							&metadata );
-
-			if(!entry->title)
-			{
-				entry->title = g_strdup(media_title);
-			}
+		metadata_to_ptr_array(metadata, entry->tags);
+		g_signal_emit_by_name(cache, "update", uri);
 
-			metadata_to_ptr_array(metadata, entry->tags);
-			celluloid_mpv_command(mpv, cmd);
+		mpv_free(media_title);
+		mpv_free_node_contents(&metadata);
+	}
 
-			g_signal_emit_by_name(cache, "update", path);
+	return	event_id == MPV_EVENT_FILE_LOADED ?
+		G_SOURCE_REMOVE :
+		G_SOURCE_CONTINUE;
+}
 
-			mpv_free(media_title);
-			mpv_free_node_contents(&metadata);
-		}
+static void
+fetch_metadata(CelluloidMetadataCache *cache, gchar *uri)
+{
+	FetchData *data = g_new0(FetchData, 1);
+	guint id = 0;
 
-		mpv_free(path);
-	}
-	else if(event_id == MPV_EVENT_END_FILE)
-	{
-		mpv_event_end_file *event = event_data;
+	data->cache = cache;
+	data->uri = celluloid_acquire_string(uri);
 
-		if(event->reason == MPV_END_FILE_REASON_ERROR)
-		{
-			g_debug("Failed to fetch metadata");
-		}
+	g_debug("Queuing %s for metadata fetch", uri);
+
+	id =	celluloid_job_scheduler_submit
+		(	celluloid_job_scheduler_get_default(),
+			CELLULOID_JOB_PRIORITY_NORMAL,
+			uri,
+			0,
+			fetch_handler,
+			data,
+			(GDestroyNotify)fetch_data_free );
+
+	g_hash_table_insert
+		(cache->jobs, celluloid_acquire_string(uri), GUINT_TO_POINTER(id));
+}
+
+static void
+cancel_fetch(CelluloidMetadataCache *cache, const gchar *uri)
+{
+	const guint id =
+		GPOINTER_TO_UINT(g_hash_table_lookup(cache->jobs, uri));
+
+	if(id != 0)
+	{
+		celluloid_job_scheduler_cancel
+			(celluloid_job_scheduler_get_default(), id);
 	}
 }
 
 static void
-shutdown_handler(CelluloidMpv *mpv, gpointer data)
+drop_owner(CelluloidMetadataCache *cache, gconstpointer owner)
 {
-	CelluloidMetadataCache *cache = data;
+	CelluloidMetadataCacheEntry *entry = NULL;
+	GHashTableIter iter;
 
-	g_clear_object(&cache->fetcher);
+	g_hash_table_iter_init(&iter, cache->table);
 
-	if(!g_queue_is_empty(cache->fetch_queue))
+	while(g_hash_table_iter_next(&iter, NULL, (gpointer)&entry))
 	{
-		g_source_clear(&cache->fetch_timeout_id);
-		cache->fetch_timeout_id
-			= g_idle_add((GSourceFunc)fetch_metadata, cache);
+		g_assert(entry);
+		g_hash_table_remove(entry->references, owner);
 	}
 }
 
-static gboolean
-fetch_metadata(CelluloidMetadataCache *cache)
+static void
+prune_entries(CelluloidMetadataCache *cache)
 {
-	g_assert(!cache->fetcher);
-	cache->fetcher = celluloid_mpv_new(0);
-
-	g_signal_connect(	cache->fetcher,
-				"mpv-event-notify",
-				G_CALLBACK(mpv_event_notify),
-				cache );
-	g_signal_connect(	cache->fetcher,
-				"shutdown",
-				G_CALLBACK(shutdown_handler),
-				cache );
-
-	celluloid_mpv_set_option_string(cache->fetcher, "ao", "null");
-	celluloid_mpv_set_option_string(cache->fetcher, "vo", "null");
-	celluloid_mpv_set_option_string(cache->fetcher, "idle", "once");
-	celluloid_mpv_set_option_string(cache->fetcher, "ytdl", "yes");
-	celluloid_mpv_initialize(cache->fetcher);
-
-	gchar *uri = g_queue_pop_tail(cache->fetch_queue);
-	g_debug("Queuing %s for metadata fetch", uri);
-	celluloid_mpv_load_file(cache->fetcher, uri, TRUE);
-	g_free(uri);
+	CelluloidMetadataCacheEntry *entry = NULL;
+	const gchar *uri = NULL;
+	GHashTableIter iter;
 
-	cache->fetch_timeout_id = 0;
+	g_hash_table_iter_init(&iter, cache->table);
 
-	return G_SOURCE_REMOVE;
+	while(g_hash_table_iter_next
+		(&iter, (gpointer)&uri, (gpointer)&entry))
+	{
+		g_assert(entry);
+
+		if(g_hash_table_size(entry->references) == 0)
+		{
+			cancel_fetch(cache, uri);
+			g_hash_table_iter_remove(&iter);
+		}
+	}
 }
 
 static void
@@ -275,12 +332,14 @@ celluloid_metadata_cache_init(CelluloidMetadataCache *cache)
 	cache->table =	g_hash_table_new_full
 			(	g_str_hash,
 				g_str_equal,
-				g_free,
+				(GDestroyNotify)celluloid_release_string,
 				(GDestroyNotify)
 				celluloid_metadata_cache_entry_free );
-	cache->fetcher = NULL;
-	cache->fetch_queue = g_queue_new();
-	cache->fetch_timeout_id = 0;
+	cache->jobs =	g_hash_table_new_full
+			(	g_str_hash,
+				g_str_equal,
+				(GDestroyNotify)celluloid_release_string,
+				NULL );
 }
 
 CelluloidMetadataCache *
@@ -291,63 +350,80 @@ celluloid_metadata_cache_new(void)
 
 void
 celluloid_metadata_cache_ref_entry(	CelluloidMetadataCache *cache,
+					gconstpointer owner,
 					const gchar *uri )
 {
-	celluloid_metadata_cache_lookup(cache, uri)->references++;
+	CelluloidMetadataCacheEntry *entry =
+		celluloid_metadata_cache_lookup(cache, uri);
+	gint count =
+		GPOINTER_TO_INT(g_hash_table_lookup(entry->references, owner));
+
+	g_hash_table_insert
+		(entry->references, (gpointer)owner, GINT_TO_POINTER(count + 1));
 }
 
 void
 celluloid_metadata_cache_unref_entry(	CelluloidMetadataCache *cache,
+					gconstpointer owner,
 					const gchar *uri )
 {
 	CelluloidMetadataCacheEntry *entry =
 		g_hash_table_lookup(cache->table, uri);
+	gint count =
+		entry ?
+		GPOINTER_TO_INT(g_hash_table_lookup(entry->references, owner)) :
+		0;
 
-	if(entry && --entry->references == 0)
+	if(count > 1)
 	{
-		g_hash_table_remove(cache->table, uri);
+		g_hash_table_insert
+			(	entry->references,
+				(gpointer)owner,
+				GINT_TO_POINTER(count - 1) );
+	}
+	else if(count == 1)
+	{
+		g_hash_table_remove(entry->references, owner);
+
+		if(g_hash_table_size(entry->references) == 0)
+		{
+			cancel_fetch(cache, uri);
+			g_hash_table_remove(cache->table, uri);
+		}
 	}
 }
 
 void
 celluloid_metadata_cache_load_playlist(	CelluloidMetadataCache *cache,
+					gconstpointer owner,
 					const GPtrArray *playlist )
 {
-	CelluloidMetadataCacheEntry *entry = NULL;
-	GHashTableIter iter;
-
-	g_hash_table_iter_init(&iter, cache->table);
-
-	/* First, set the refrence count for all entries to zero */
-	while(g_hash_table_iter_next(&iter, NULL, (gpointer)&entry))
-	{
-		g_assert(entry);
-		entry->references = 0;
-	}
+	/* First, drop all references held by the owner. Entries referenced by
+	 * other owners are left untouched.
+	 */
+	drop_owner(cache, owner);
 
-	/* Then ref all entries in the playlist. This sets the reference count
-	 * to the number of times the entry appears in the playlist.
+	/* Then ref all entries in the playlist. This sets the owner's reference
+	 * count to the number of times the entry appears in the playlist.
 	 */
 	for(guint i = 0; i < playlist->len; i++)
 	{
 		CelluloidPlaylistEntry *entry = g_ptr_array_index(playlist, i);
-		celluloid_metadata_cache_ref_entry(cache, entry->filename);
-	}
 
-	g_hash_table_iter_init(&iter, cache->table);
+		celluloid_metadata_cache_ref_entry
+			(cache, owner, entry->filename);
+	}
 
-	/* Remove all entries that with refrence count of zero, which means that
-	 * the entry no longer exists in the playlist.
-	 */
-	while(g_hash_table_iter_next(&iter, NULL, (gpointer)&entry))
-	{
-		g_assert(entry);
+	/* Remove all entries that no owner references anymore */
+	prune_entries(cache);
+}
 
-		if(entry->references == 0)
-		{
-			g_hash_table_iter_remove(&iter);
-		}
-	}
+void
+celluloid_metadata_cache_release(	CelluloidMetadataCache *cache,
+					gconstpointer owner )
+{
+	drop_owner(cache, owner);
+	prune_entries(cache);
 }
 
 CelluloidMetadataCacheEntry *
@@ -359,18 +435,17 @@ celluloid_metadata_cache_lookup(	CelluloidMetadataCache *cache,
 
 	if(!entry)
 	{
-		entry = celluloid_metadata_cache_entry_new();
+		// The key and the URI of the fetch job share the same
+		// interned string as the playlists that refer to it.
+		gchar *key = celluloid_intern_string(uri);
 
-		g_hash_table_insert(cache->table, g_strdup(uri), entry);
+		entry = celluloid_metadata_cache_entry_new();
 
-		if(!cache->fetcher && g_queue_is_empty(cache->fetch_queue))
-		{
-			g_source_clear(&cache->fetch_timeout_id);
-			cache->fetch_timeout_id
-				= g_idle_add((GSourceFunc)fetch_metadata, cache);
-		}
+		g_hash_table_insert(cache->table, key, entry);
 
-		g_queue_push_head(cache->fetch_queue, g_strdup(uri));
+		// Fetches are cancelled along with their entries, so there
+		// can't be one running for a new entry.
+		fetch_metadata(cache, key);
 	}
 
 	return entry;
@@ -28,7 +28,10 @@ typedef struct _CelluloidMetadataCacheEntry CelluloidMetadataCacheEntry;
 
 struct _CelluloidMetadataCacheEntry
 {
-	gint references;
+	/* Maps each owner to the number of times the entry appears in its
+	 * playlist. The entry is dropped once no owner references it.
+	 */
+	GHashTable *references;
 	gchar *title;
 	gdouble duration;
 	GPtrArray *tags;
@@ -43,16 +46,23 @@ celluloid_metadata_cache_new(void);
 
 void
 celluloid_metadata_cache_ref_entry(	CelluloidMetadataCache *cache,
+					gconstpointer owner,
 					const gchar *uri );
 
 void
 celluloid_metadata_cache_unref_entry(	CelluloidMetadataCache *cache,
+					gconstpointer owner,
 					const gchar *uri );
 
 void
 celluloid_metadata_cache_load_playlist(	CelluloidMetadataCache *cache,
+					gconstpointer owner,
 					const GPtrArray *playlist );
 
+void
+celluloid_metadata_cache_release(	CelluloidMetadataCache *cache,
+					gconstpointer owner );
+
 CelluloidMetadataCacheEntry *
 celluloid_metadata_cache_lookup(	CelluloidMetadataCache *cache,
 					const gchar *uri );
@@ -23,6 +23,7 @@
 #include "celluloid-marshal.h"
 #include "celluloid-mpv.h"
 #include "celluloid-option-parser.h"
+#include "celluloid-settings-snapshot.h"
 #include "celluloid-def.h"
 
 enum
@@ -41,6 +42,7 @@ enum
 	PROP_SHUFFLE,
 	PROP_DURATION,
 	PROP_MEDIA_TITLE,
+	PROP_PATH,
 	PROP_PLAYLIST_COUNT,
 	PROP_PLAYLIST_POS,
 	PROP_SPEED,
@@ -73,6 +75,7 @@ struct _CelluloidModel
 	gboolean shuffle;
 	gdouble duration;
 	gchar *media_title;
+	gchar *path;
 	gint64 playlist_count;
 	gint64 playlist_pos;
 	gdouble speed;
@@ -81,7 +84,9 @@ struct _CelluloidModel
 	gboolean window_maximized;
 	gdouble window_scale;
 	gdouble display_fps;
-	GStrv input_binding_list;
+	gboolean scrub_in_flight;
+	gboolean scrub_pending;
+	gdouble scrub_target;
 };
 
 struct _CelluloidModelClass
@@ -116,6 +121,15 @@ set_mpv_property(	GObject *object,
 			const GValue *value,
 			GParamSpec *pspec );
 
+static void
+set_mpv_property_async(	CelluloidMpv *mpv,
+			const gchar *name,
+			mpv_format format,
+			void *data );
+
+static void
+set_mpv_property_ready(GObject *source, GAsyncResult *result, gpointer data);
+
 static void
 g_value_set_by_type(GValue *gvalue, GType type, gpointer value);
 
@@ -138,6 +152,15 @@ mpv_prop_change_handler(	CelluloidMpv *mpv,
 				gpointer value,
 				gpointer data );
 
+static void
+send_scrub(CelluloidModel *model, gdouble value);
+
+static void
+scrub_ready(GObject *source, GAsyncResult *result, gpointer data);
+
+static void
+seek_ready(GObject *source, GAsyncResult *result, gpointer data);
+
 G_DEFINE_TYPE(CelluloidModel, celluloid_model, CELLULOID_TYPE_PLAYER)
 
 static gboolean
@@ -278,6 +301,11 @@ set_property(	GObject *object,
 		self->media_title = g_value_dup_string(value);
 		break;
 
+		case PROP_PATH:
+		g_free(self->path);
+		self->path = g_value_dup_string(value);
+		break;
+
 		case PROP_PLAYLIST_COUNT:
 		self->playlist_count = g_value_get_int64(value);
 		break;
@@ -384,6 +412,10 @@ get_property(	GObject *object,
 		g_value_set_string(value, self->media_title);
 		break;
 
+		case PROP_PATH:
+		g_value_set_string(value, self->path);
+		break;
+
 		case PROP_PLAYLIST_COUNT:
 		g_value_set_int64(value, self->playlist_count);
 		break;
@@ -454,6 +486,7 @@ static void finalize(GObject *object)
 	g_free(model->loop_file);
 	g_free(model->loop_playlist);
 	g_free(model->media_title);
+	g_free(model->path);
 
 	G_OBJECT_CLASS(celluloid_model_parent_class)->finalize(object);
 }
@@ -470,98 +503,98 @@ set_mpv_property(	GObject *object,
 	switch(property_id)
 	{
 		case PROP_AID:
-		celluloid_mpv_set_property(	mpv,
+		set_mpv_property_async(	mpv,
 						"aid",
 						MPV_FORMAT_STRING,
 						&self->aid );
 		break;
 
 		case PROP_VID:
-		celluloid_mpv_set_property(	mpv,
+		set_mpv_property_async(	mpv,
 						"vid",
 						MPV_FORMAT_STRING,
 						&self->vid );
 		break;
 
 		case PROP_SID:
-		celluloid_mpv_set_property(	mpv,
+		set_mpv_property_async(	mpv,
 						"sid",
 						MPV_FORMAT_STRING,
 						&self->sid );
 		break;
 
 		case PROP_FULLSCREEN:
-		celluloid_mpv_set_property(	mpv,
+		set_mpv_property_async(	mpv,
 						"fullscreen",
 						MPV_FORMAT_FLAG,
 						&self->fullscreen );
 		break;
 
 		case PROP_PAUSE:
-		celluloid_mpv_set_property(	mpv,
+		set_mpv_property_async(	mpv,
 						"pause",
 						MPV_FORMAT_FLAG,
 						&self->pause );
 		break;
 
 		case PROP_LOOP_FILE:
-		celluloid_mpv_set_property(	mpv,
+		set_mpv_property_async(	mpv,
 						"loop-file",
 						MPV_FORMAT_STRING,
 						&self->loop_file );
 		break;
 
 		case PROP_LOOP_PLAYLIST:
-		celluloid_mpv_set_property(	mpv,
+		set_mpv_property_async(	mpv,
 						"loop-playlist",
 						MPV_FORMAT_STRING,
 						&self->loop_playlist );
 		break;
 
 		case PROP_PLAYLIST_POS:
-		celluloid_mpv_set_property(	mpv,
+		set_mpv_property_async(	mpv,
 						"playlist-pos",
 						MPV_FORMAT_INT64,
 						&self->playlist_pos );
 		break;
 
 		case PROP_SPEED:
-		celluloid_mpv_set_property(	mpv,
+		set_mpv_property_async(	mpv,
 						"speed",
 						MPV_FORMAT_DOUBLE,
 						&self->speed );
 		break;
 
 		case PROP_VOLUME:
-		celluloid_mpv_set_property(	mpv,
+		set_mpv_property_async(	mpv,
 						"volume",
 						MPV_FORMAT_DOUBLE,
 						&self->volume );
 		break;
 
 		case PROP_VOLUME_MAX:
-		celluloid_mpv_set_property(	mpv,
+		set_mpv_property_async(	mpv,
 						"volume-max",
 						MPV_FORMAT_DOUBLE,
 						&self->volume_max );
 		break;
 
 		case PROP_WINDOW_MAXIMIZED:
-		celluloid_mpv_set_property(	mpv,
+		set_mpv_property_async(	mpv,
 						"window-maximized",
 						MPV_FORMAT_FLAG,
 						&self->window_maximized );
 		break;
 
 		case PROP_WINDOW_SCALE:
-		celluloid_mpv_set_property(	mpv,
+		set_mpv_property_async(	mpv,
 						"window-scale",
 						MPV_FORMAT_DOUBLE,
 						&self->window_scale );
 		break;
 
 		case PROP_DISPLAY_FPS:
-		celluloid_mpv_set_property(	mpv,
+		set_mpv_property_async(	mpv,
 						"display-fps",
 						MPV_FORMAT_DOUBLE,
 						&self->display_fps );
@@ -569,6 +602,37 @@ set_mpv_property(	GObject *object,
 	}
 }
 
+static void
+set_mpv_property_async(	CelluloidMpv *mpv,
+			const gchar *name,
+			mpv_format format,
+			void *data )
+{
+	celluloid_mpv_set_property_async
+		(	mpv,
+			name,
+			format,
+			data,
+			NULL,
+			set_mpv_property_ready,
+			(gpointer)g_intern_string(name) );
+}
+
+static void
+set_mpv_property_ready(GObject *source, GAsyncResult *result, gpointer data)
+{
+	GError *error = NULL;
+
+	if(!celluloid_mpv_set_property_finish
+		(CELLULOID_MPV(source), result, &error))
+	{
+		g_info(	"Failed to set property \"%s\". Reason: %s.",
+			(const gchar *)data,
+			error->message );
+		g_error_free(error);
+	}
+}
+
 static void
 g_value_set_by_type(GValue *gvalue, GType type, gpointer value)
 {
@@ -708,75 +772,6 @@ mpv_prop_change_handler(	CelluloidMpv *mpv,
 	}
 }
 
-static GStrv
-build_input_binding_list(CelluloidMpv *mpv)
-{
-	GStrvBuilder *builder = g_strv_builder_new();
-	mpv_node bindings_node = {0};
-	mpv_node_list *bindings_array = NULL;
-
-	const gint err =
-		celluloid_mpv_get_property
-		(	mpv,
-			"input-bindings",
-			MPV_FORMAT_NODE,
-			&bindings_node );
-
-	if(	err == MPV_ERROR_SUCCESS &&
-		bindings_node.format == MPV_FORMAT_NODE_ARRAY )
-	{
-		bindings_array = bindings_node.u.list;
-	}
-	else
-	{
-		g_warning(	"Failed to get property \"input-bindings\": %s (%d)",
-				mpv_error_string(err),
-				err );
-	}
-
-	for(int i = 0; bindings_array && i < bindings_array->num; i++)
-	{
-		mpv_node *binding_node = &bindings_array->values[i];
-		mpv_node_list *binding_map = NULL;
-
-		if(binding_node->format == MPV_FORMAT_NODE_MAP)
-		{
-			binding_map = binding_node->u.list;
-		}
-		else
-		{
-			g_warning("Input binding is not a map");
-		}
-
-		for(int j = 0; binding_map && j < binding_map->num; j++)
-		{
-			char *map_key = binding_map->keys[j];
-
-			if(g_strcmp0(map_key, "key") == 0)
-			{
-				mpv_node *key_node = &binding_map->values[j];
-
-				if(key_node->format == MPV_FORMAT_STRING)
-				{
-					g_strv_builder_add
-						(builder, key_node->u.string);
-				}
-				else
-				{
-					g_warning("Input binding key is not a string");
-				}
-			}
-		}
-	}
-
-	if(err == MPV_ERROR_SUCCESS)
-	{
-		mpv_free_node_contents(&bindings_node);
-	}
-
-	return g_strv_builder_end(builder);
-}
-
 static void
 celluloid_model_class_init(CelluloidModelClass *klass)
 {
@@ -802,6 +797,7 @@ celluloid_model_class_init(CelluloidModelClass *klass)
 			{"loop-playlist", PROP_LOOP_PLAYLIST, G_TYPE_STRING},
 			{"duration", PROP_DURATION, G_TYPE_DOUBLE},
 			{"media-title", PROP_MEDIA_TITLE, G_TYPE_STRING},
+			{"path", PROP_PATH, G_TYPE_STRING},
 			{"playlist-count", PROP_PLAYLIST_COUNT, G_TYPE_INT64},
 			{"playlist-pos", PROP_PLAYLIST_POS, G_TYPE_INT64},
 			{"speed", PROP_SPEED, G_TYPE_DOUBLE},
@@ -888,6 +884,7 @@ celluloid_model_init(CelluloidModel *model)
 	model->shuffle = FALSE;
 	model->duration = 0.0;
 	model->media_title = NULL;
+	model->path = NULL;
 	model->playlist_count = 0;
 	model->playlist_pos = 0;
 	model->speed = 1.0;
@@ -896,7 +893,59 @@ celluloid_model_init(CelluloidModel *model)
 	model->window_maximized = FALSE;
 	model->window_scale = 1.0;
 	model->display_fps = 0.0;
-	model->input_binding_list = NULL;
+	model->scrub_in_flight = FALSE;
+	model->scrub_pending = FALSE;
+	model->scrub_target = 0.0;
+}
+
+static void
+send_scrub(CelluloidModel *model, gdouble value)
+{
+	const gchar *cmd[] = {"seek", NULL, "absolute+keyframes", NULL};
+	gchar buf[G_ASCII_DTOSTR_BUF_SIZE];
+
+	g_ascii_dtostr(buf, G_ASCII_DTOSTR_BUF_SIZE, value);
+	cmd[1] = buf;
+
+	model->scrub_in_flight = TRUE;
+
+	celluloid_mpv_command_async_full
+		(CELLULOID_MPV(model), cmd, NULL, scrub_ready, model);
+}
+
+static void
+scrub_ready(GObject *source, GAsyncResult *result, gpointer data)
+{
+	CelluloidModel *model = data;
+	GError *error = NULL;
+
+	if(!celluloid_mpv_command_finish(CELLULOID_MPV(source), result, &error))
+	{
+		g_debug("Keyframe seek failed: %s", error->message);
+		g_error_free(error);
+	}
+
+	model->scrub_in_flight = FALSE;
+
+	// Only the latest position requested while the seek was running is
+	// worth seeking to.
+	if(model->scrub_pending)
+	{
+		model->scrub_pending = FALSE;
+		send_scrub(model, model->scrub_target);
+	}
+}
+
+static void
+seek_ready(GObject *source, GAsyncResult *result, gpointer data)
+{
+	GError *error = NULL;
+
+	if(!celluloid_mpv_command_finish(CELLULOID_MPV(source), result, &error))
+	{
+		g_debug("Seek failed: %s", error->message);
+		g_error_free(error);
+	}
 }
 
 CelluloidModel *
@@ -920,9 +969,21 @@ celluloid_model_initialize(CelluloidModel *model)
 {
 	CelluloidMpv *mpv = CELLULOID_MPV(model);
 	GSettings *win_settings = g_settings_new(CONFIG_WIN_STATE);
+	gboolean ready = FALSE;
+
+	g_object_get(model, "ready", &ready, NULL);
+
+	// Standby models were initialized ahead of time, possibly with
+	// options that have since changed, so they only need to catch up.
+	if(ready)
+	{
+		celluloid_model_apply_options(model);
+	}
+	else
+	{
+		celluloid_mpv_initialize(mpv);
+	}
 
-	celluloid_mpv_initialize
-		(mpv);
 	celluloid_mpv_set_render_update_callback
 		(mpv, render_update_callback, model);
 
@@ -966,8 +1027,6 @@ celluloid_model_initialize(CelluloidModel *model)
 		g_object_set(model, "loop-playlist", loop_playlist, NULL);
 	}
 
-	model->input_binding_list = build_input_binding_list(mpv);
-
 	g_object_unref(win_settings);
 }
 
@@ -979,6 +1038,20 @@ celluloid_model_reset(CelluloidModel *model)
 	celluloid_mpv_reset(CELLULOID_MPV(model));
 }
 
+gboolean
+celluloid_model_apply_options(CelluloidModel *model)
+{
+	gboolean applied =
+		celluloid_player_apply_options(CELLULOID_PLAYER(model));
+
+	if(!applied)
+	{
+		celluloid_model_reset(model);
+	}
+
+	return applied;
+}
+
 void
 celluloid_model_quit(CelluloidModel *model)
 {
@@ -988,15 +1061,16 @@ celluloid_model_quit(CelluloidModel *model)
 void
 celluloid_model_mouse(CelluloidModel *model, gint x, gint y)
 {
-	gchar *x_str = g_strdup_printf("%d", x);
-	gchar *y_str = g_strdup_printf("%d", y);
+	// mpv copies the arguments, so buffers on the stack are enough
+	gchar x_str[12] = {0}; // Fits any 32-bit integer and NULL terminator
+	gchar y_str[12] = {0};
 	const gchar *cmd[] = {"mouse", x_str, y_str, NULL};
 
+	g_snprintf(x_str, sizeof(x_str), "%d", x);
+	g_snprintf(y_str, sizeof(y_str), "%d", y);
+
 	g_debug("Set mouse location to (%s, %s)", x_str, y_str);
 	celluloid_mpv_command_async(CELLULOID_MPV(model), cmd);
-
-	g_free(x_str);
-	g_free(y_str);
 }
 
 void
@@ -1029,12 +1103,8 @@ celluloid_model_key_press(CelluloidModel *model, const gchar* keystr)
 gboolean
 celluloid_model_input_binding_exists(CelluloidModel *model, const gchar* keystr)
 {
-	const char * const *input_binding_list =
-		(const char * const *)model->input_binding_list;
-
-	return	input_binding_list &&
-		keystr &&
-		g_strv_contains(input_binding_list, keystr);
+	return	celluloid_player_lookup_input_binding
+		(CELLULOID_PLAYER(model), keystr) != NULL;
 }
 
 void
@@ -1135,7 +1205,35 @@ celluloid_model_unshuffle_playlist(CelluloidModel *model)
 void
 celluloid_model_seek(CelluloidModel *model, gdouble value)
 {
-	celluloid_mpv_set_property(CELLULOID_MPV(model), "time-pos", MPV_FORMAT_DOUBLE, &value);
+	const gchar *cmd[] = {"seek", NULL, "absolute+exact", NULL};
+	gchar buf[G_ASCII_DTOSTR_BUF_SIZE];
+
+	g_ascii_dtostr(buf, G_ASCII_DTOSTR_BUF_SIZE, value);
+	cmd[1] = buf;
+
+	// An exact seek supersedes any scrubbing position that hasn't been
+	// sent yet.
+	model->scrub_pending = FALSE;
+
+	celluloid_mpv_command_async_full
+		(CELLULOID_MPV(model), cmd, NULL, seek_ready, NULL);
+}
+
+void
+celluloid_model_scrub(CelluloidModel *model, gdouble value)
+{
+	// Keyframe seeks are fast but imprecise, so the caller is expected to
+	// finish with celluloid_model_seek(). Only one of them is sent to mpv
+	// at a time.
+	if(model->scrub_in_flight)
+	{
+		model->scrub_target = value;
+		model->scrub_pending = TRUE;
+	}
+	else
+	{
+		send_scrub(model, value);
+	}
 }
 
 void
@@ -1216,9 +1314,7 @@ celluloid_model_load_file(	CelluloidModel *model,
 				const gchar *uri,
 				gboolean append )
 {
-	GSettings *settings = g_settings_new(CONFIG_ROOT);
-
-	append |= g_settings_get_boolean(settings, "always-append-to-playlist");
+	append |= celluloid_settings_snapshot_get()->always_append_to_playlist;
 
 	celluloid_mpv_load(CELLULOID_MPV(model), uri, append);
 
@@ -1230,8 +1326,6 @@ celluloid_model_load_file(	CelluloidModel *model,
 		g_signal_emit_by_name(model, "playlist-replaced");
 		celluloid_model_play(model);
 	}
-
-	g_object_unref(settings);
 }
 
 gboolean
@@ -1255,6 +1349,7 @@ celluloid_model_render_frame(CelluloidModel *model, gint width, gint height)
 
 	if(render_ctx)
 	{
+		const gint64 start_time = g_get_monotonic_time();
 		gint fbo = -1;
 		glGetIntegerv(GL_FRAMEBUFFER_BINDING, &fbo);
 
@@ -1266,6 +1361,10 @@ celluloid_model_render_frame(CelluloidModel *model, gint width, gint height)
 				{0, NULL} };
 
 		mpv_render_context_render(render_ctx, params);
+
+		celluloid_stats_add_render_time
+			(	celluloid_mpv_get_stats(CELLULOID_MPV(model)),
+				g_get_monotonic_time() - start_time );
 	}
 }
 
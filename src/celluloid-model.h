@@ -40,6 +40,9 @@ celluloid_model_initialize(CelluloidModel *model);
 void
 celluloid_model_reset(CelluloidModel *model);
 
+gboolean
+celluloid_model_apply_options(CelluloidModel *model);
+
 void
 celluloid_model_quit(CelluloidModel *model);
 
@@ -97,6 +100,9 @@ celluloid_model_unshuffle_playlist(CelluloidModel *model);
 void
 celluloid_model_seek(CelluloidModel *model, gdouble value);
 
+void
+celluloid_model_scrub(CelluloidModel *model, gdouble value);
+
 void
 celluloid_model_seek_offset(CelluloidModel *model, gdouble offset);
 
@@ -50,11 +50,18 @@
 #include "celluloid-common.h"
 #include "celluloid-def.h"
 #include "celluloid-marshal.h"
+#include "celluloid-stats.h"
+#include "celluloid-event-trace.h"
+#include "celluloid-property-mirror.h"
+#include "celluloid-settings-snapshot.h"
+
+#define CHECK_MIRROR_ENV_VAR "CELLULOID_CHECK_PROPERTY_MIRROR"
 
 #define get_private(mpv) \
 	((CelluloidMpvPrivate *)celluloid_mpv_get_instance_private(mpv))
 
 typedef struct _CelluloidMpvPrivate CelluloidMpvPrivate;
+typedef struct _CelluloidMpvRequest CelluloidMpvRequest;
 
 enum
 {
@@ -77,6 +84,34 @@ struct _CelluloidMpvPrivate
 	gint64 wid;
 	void *render_update_callback_data;
 	void (*render_update_callback)(void *data);
+	CelluloidStats *stats;
+	CelluloidEventTraceWriter *event_trace;
+	CelluloidPropertyMirror *mirror;
+	gboolean check_mirror;
+	GMutex wakeup_lock;
+	gint64 wakeup_time;
+	GHashTable *requests;
+	guint64 next_request_id;
+	guint pending_loads;
+	gint64 playlist_count;
+};
+
+/* State of an asynchronous request sent to mpv. The reply_userdata of the
+ * request is its id, which maps back to the GTask waiting for the reply.
+ */
+struct _CelluloidMpvRequest
+{
+	mpv_handle *mpv_ctx;
+	guint64 id;
+	gulong cancelled_id;
+	mpv_format format;
+	union
+	{
+		gchar *string;
+		int flag;
+		gint64 int64;
+		gdouble double_value;
+	} value;
 };
 
 static void *
@@ -118,6 +153,45 @@ mpv_event_notify(CelluloidMpv *mpv, gint event_id, gpointer event_data);
 static gboolean
 process_mpv_events(gpointer data);
 
+static guint64
+add_request(CelluloidMpv *mpv, GTask *task, mpv_format format);
+
+static void
+request_free(CelluloidMpvRequest *request);
+
+static void
+return_mpv_error(GTask *task, gint error);
+
+static void
+store_reply_value(CelluloidMpvRequest *request, const mpv_event_property *prop);
+
+static void
+update_playlist_count(CelluloidMpv *mpv, const mpv_event_property *prop);
+
+static void
+track_command(CelluloidMpv *mpv, const gchar **cmd);
+
+static void
+load_file_ready(GObject *source, GAsyncResult *result, gpointer data);
+
+static GTask *
+take_request(CelluloidMpv *mpv, guint64 id);
+
+static GPtrArray *
+take_all_requests(CelluloidMpv *mpv);
+
+static void
+complete_request(CelluloidMpv *mpv, const mpv_event *event);
+
+static void
+request_cancelled_handler(GCancellable *cancellable, gpointer data);
+
+static gint
+get_mirrored(	CelluloidMpv *mpv,
+		const gchar *name,
+		mpv_format format,
+		void *data );
+
 static gboolean
 check_mpv_version(const gchar *version);
 
@@ -138,6 +212,8 @@ reset(CelluloidMpv *mpv);
 
 G_DEFINE_TYPE_WITH_PRIVATE(CelluloidMpv, celluloid_mpv, G_TYPE_OBJECT)
 
+G_DEFINE_QUARK(celluloid-mpv-error-quark, celluloid_mpv_error)
+
 static void *
 get_proc_address(void *fn_ctx, const gchar *name)
 {
@@ -225,12 +301,32 @@ dispose(GObject *object)
 static void
 finalize(GObject *object)
 {
+	CelluloidMpvPrivate *priv = get_private(CELLULOID_MPV(object));
+
+	celluloid_stats_free(priv->stats);
+	celluloid_event_trace_writer_free(priv->event_trace);
+	celluloid_property_mirror_free(priv->mirror);
+	g_hash_table_unref(priv->requests);
+	g_mutex_clear(&priv->wakeup_lock);
+
 	G_OBJECT_CLASS(celluloid_mpv_parent_class)->finalize(object);
 }
 
 static void
 wakeup_callback(void *data)
 {
+	CelluloidMpvPrivate *priv = get_private(CELLULOID_MPV(data));
+
+	/* Only the first wakeup before the events are processed is timestamped
+	 * so that the measured latency covers the whole wait.
+	 */
+	g_mutex_lock(&priv->wakeup_lock);
+	if(priv->wakeup_time == 0)
+	{
+		priv->wakeup_time = g_get_monotonic_time();
+	}
+	g_mutex_unlock(&priv->wakeup_lock);
+
 	g_idle_add_full(G_PRIORITY_HIGH_IDLE, process_mpv_events, data, NULL);
 }
 
@@ -258,12 +354,11 @@ mpv_event_notify(CelluloidMpv *mpv, gint event_id, gpointer event_data)
 	}
 	else if(event_id == MPV_EVENT_END_FILE)
 	{
-		GSettings *settings = g_settings_new(CONFIG_ROOT);
-		const gchar *ignore_key = "ignore-playback-errors";
-
+		const CelluloidSettingsSnapshot *settings =
+			celluloid_settings_snapshot_get();
 		mpv_event_end_file *ef_event = event_data;
 
-		if(	!g_settings_get_boolean(settings, ignore_key) &&
+		if(	!settings->ignore_playback_errors &&
 			ef_event->reason == MPV_END_FILE_REASON_ERROR )
 		{
 			const gchar *err;
@@ -280,8 +375,6 @@ mpv_event_notify(CelluloidMpv *mpv, gint event_id, gpointer event_data)
 
 			g_free(msg);
 		}
-
-		g_object_unref(settings);
 	}
 	else if(event_id == MPV_EVENT_LOG_MESSAGE)
 	{
@@ -315,6 +408,18 @@ process_mpv_events(gpointer data)
 	CelluloidMpv *mpv = data;
 	CelluloidMpvPrivate *priv = get_private(mpv);
 	gboolean done = !mpv;
+	gint64 wakeup_time = 0;
+
+	g_mutex_lock(&priv->wakeup_lock);
+	wakeup_time = priv->wakeup_time;
+	priv->wakeup_time = 0;
+	g_mutex_unlock(&priv->wakeup_lock);
+
+	if(wakeup_time > 0)
+	{
+		celluloid_stats_add_dispatch_latency
+			(priv->stats, g_get_monotonic_time() - wakeup_time);
+	}
 
 	while(!done)
 	{
@@ -324,6 +429,12 @@ process_mpv_events(gpointer data)
 
 		if(event)
 		{
+			if(priv->event_trace && event->event_id != MPV_EVENT_NONE)
+			{
+				celluloid_event_trace_writer_add
+					(priv->event_trace, event);
+			}
+
                        done = !priv->mpv_ctx ||
 				event->event_id == MPV_EVENT_SHUTDOWN ||
                                event->event_id == MPV_EVENT_NONE;
@@ -336,6 +447,22 @@ process_mpv_events(gpointer data)
                                        g_strcmp0(msg->args[0], ACTION_PREFIX) == 0 &&
                                        g_strcmp0(msg->args[1], "win.quit") == 0;
 			}
+			else if(	(	event->event_id ==
+						MPV_EVENT_COMMAND_REPLY ||
+						event->event_id ==
+						MPV_EVENT_SET_PROPERTY_REPLY ||
+						event->event_id ==
+						MPV_EVENT_GET_PROPERTY_REPLY ) &&
+					event->reply_userdata != 0 )
+			{
+				complete_request(mpv, event);
+			}
+			else if(event->event_id == MPV_EVENT_PROPERTY_CHANGE)
+			{
+				celluloid_property_mirror_update
+					(priv->mirror, event->data);
+				update_playlist_count(mpv, event->data);
+			}
 
 			g_signal_emit_by_name(	mpv,
 						"mpv-event-notify",
@@ -351,6 +478,196 @@ process_mpv_events(gpointer data)
 	return FALSE;
 }
 
+static guint64
+add_request(CelluloidMpv *mpv, GTask *task, mpv_format format)
+{
+	CelluloidMpvPrivate *priv = get_private(mpv);
+	CelluloidMpvRequest *request = g_new0(CelluloidMpvRequest, 1);
+	GCancellable *cancellable = g_task_get_cancellable(task);
+
+	request->mpv_ctx = priv->mpv_ctx;
+	request->id = ++priv->next_request_id;
+	request->format = format;
+
+	g_task_set_task_data(task, request, (GDestroyNotify)request_free);
+	g_hash_table_insert(priv->requests, &request->id, g_object_ref(task));
+
+	if(cancellable)
+	{
+		request->cancelled_id =
+			g_cancellable_connect
+			(	cancellable,
+				G_CALLBACK(request_cancelled_handler),
+				request,
+				NULL );
+	}
+
+	return request->id;
+}
+
+static GTask *
+take_request(CelluloidMpv *mpv, guint64 id)
+{
+	CelluloidMpvPrivate *priv = get_private(mpv);
+	GTask *task = NULL;
+
+	if(g_hash_table_steal_extended
+		(priv->requests, &id, NULL, (gpointer *)&task))
+	{
+		CelluloidMpvRequest *request = g_task_get_task_data(task);
+
+		g_cancellable_disconnect
+			(g_task_get_cancellable(task), request->cancelled_id);
+	}
+
+	return task;
+}
+
+static GPtrArray *
+take_all_requests(CelluloidMpv *mpv)
+{
+	CelluloidMpvPrivate *priv = get_private(mpv);
+	GPtrArray *tasks = g_ptr_array_new_with_free_func(g_object_unref);
+	GHashTableIter iter;
+	gpointer value = NULL;
+
+	g_hash_table_iter_init(&iter, priv->requests);
+
+	while(g_hash_table_iter_next(&iter, NULL, &value))
+	{
+		GTask *task = value;
+		CelluloidMpvRequest *request = g_task_get_task_data(task);
+
+		g_cancellable_disconnect
+			(g_task_get_cancellable(task), request->cancelled_id);
+		g_ptr_array_add(tasks, task);
+		g_hash_table_iter_steal(&iter);
+	}
+
+	return tasks;
+}
+
+static void
+complete_request(CelluloidMpv *mpv, const mpv_event *event)
+{
+	GTask *task = take_request(mpv, event->reply_userdata);
+
+	if(task)
+	{
+		if(event->error < 0)
+		{
+			return_mpv_error(task, event->error);
+		}
+		else
+		{
+			if(event->event_id == MPV_EVENT_GET_PROPERTY_REPLY)
+			{
+				store_reply_value
+					(g_task_get_task_data(task), event->data);
+			}
+
+			g_task_return_boolean(task, TRUE);
+		}
+
+		g_object_unref(task);
+	}
+}
+
+static void
+request_free(CelluloidMpvRequest *request)
+{
+	if(	request->format == MPV_FORMAT_STRING ||
+		request->format == MPV_FORMAT_OSD_STRING )
+	{
+		g_free(request->value.string);
+	}
+
+	g_free(request);
+}
+
+static void
+return_mpv_error(GTask *task, gint error)
+{
+	g_task_return_new_error(	task,
+					CELLULOID_MPV_ERROR,
+					error,
+					"%s",
+					mpv_error_string(error) );
+}
+
+static void
+store_reply_value(CelluloidMpvRequest *request, const mpv_event_property *prop)
+{
+	// mpv frees the reply along with the event, so the value is copied into
+	// the request until the caller collects it.
+	if(prop->format != request->format || !prop->data)
+	{
+		return;
+	}
+
+	switch(request->format)
+	{
+		case MPV_FORMAT_STRING:
+		case MPV_FORMAT_OSD_STRING:
+		request->value.string = g_strdup(*((char **)prop->data));
+		break;
+
+		case MPV_FORMAT_FLAG:
+		request->value.flag = *((int *)prop->data);
+		break;
+
+		case MPV_FORMAT_INT64:
+		request->value.int64 = *((int64_t *)prop->data);
+		break;
+
+		case MPV_FORMAT_DOUBLE:
+		request->value.double_value = *((double *)prop->data);
+		break;
+
+		default:
+		g_assert_not_reached();
+		break;
+	}
+}
+
+static void
+request_cancelled_handler(GCancellable *cancellable, gpointer data)
+{
+	CelluloidMpvRequest *request = data;
+
+	// mpv still sends a reply for aborted commands, which completes the
+	// task with a cancellation error. Property requests can't be aborted,
+	// so they only get the error once their reply arrives.
+	mpv_abort_async_command(request->mpv_ctx, request->id);
+}
+
+static gint
+get_mirrored(	CelluloidMpv *mpv,
+		const gchar *name,
+		mpv_format format,
+		void *data )
+{
+	CelluloidMpvPrivate *priv = get_private(mpv);
+	gint rc = MPV_ERROR_SUCCESS;
+
+	if(celluloid_property_mirror_get(priv->mirror, name, format, data))
+	{
+		if(priv->check_mirror && priv->mpv_ctx)
+		{
+			celluloid_property_mirror_check
+				(priv->mirror, priv->mpv_ctx, name);
+		}
+	}
+	else
+	{
+		// Either the property isn't observed or mpv hasn't reported
+		// it yet.
+		rc = celluloid_mpv_get_property(mpv, name, format, data);
+	}
+
+	return rc;
+}
+
 static gboolean
 check_mpv_version(const gchar *version)
 {
@@ -445,6 +762,10 @@ initialize(CelluloidMpv *mpv)
 		mpv_set_option_string(priv->mpv_ctx, "vo", "libmpv");
 	}
 
+	// load_file resyncs its expected playlist length from this, which
+	// has to work for cores that don't observe anything else too.
+	celluloid_mpv_observe_property(mpv, 0, "playlist-count", MPV_FORMAT_INT64);
+
 	mpv_set_wakeup_callback(priv->mpv_ctx, wakeup_callback, mpv);
 	mpv_initialize(priv->mpv_ctx);
 
@@ -475,31 +796,95 @@ load_file(CelluloidMpv *mpv, const gchar *uri, gboolean append)
 	CelluloidMpvPrivate *priv = get_private(mpv);
 	gchar *path = get_path_from_uri(uri);
 	const gchar *load_cmd[] = {"loadfile", path, NULL, NULL};
-	gint64 playlist_count = 0;
 
 	g_assert(uri);
 	g_info(	"Loading file (append=%s): %s", append?"TRUE":"FALSE", uri);
 
-	mpv_get_property(	priv->mpv_ctx,
-				"playlist-count",
-				MPV_FORMAT_INT64,
-				&playlist_count );
-
-	load_cmd[2] = (append && playlist_count > 0)?"append":"replace";
+	// The command is queued behind any other load that hasn't run yet, so
+	// mpv can't be asked for the playlist length here. Appending to a
+	// playlist that already has entries must not start playback, and
+	// append-play only does so when the playlist is empty.
+	if(!append)
+	{
+		load_cmd[2] = "replace";
+		priv->playlist_count = 1;
+	}
+	else
+	{
+		load_cmd[2] = priv->playlist_count > 0?"append":"append-play";
+		priv->playlist_count++;
+	}
 
 	if(!append)
 	{
-		celluloid_mpv_set_property_flag(mpv, "pause", FALSE);
+		int pause = FALSE;
+
+		celluloid_mpv_set_property_async
+			(mpv, "pause", MPV_FORMAT_FLAG, &pause, NULL, NULL, NULL);
 	}
 
 	g_assert(priv->mpv_ctx);
-	mpv_request_event(priv->mpv_ctx, MPV_EVENT_END_FILE, 0);
-	mpv_command(priv->mpv_ctx, load_cmd);
-	mpv_request_event(priv->mpv_ctx, MPV_EVENT_END_FILE, 1);
+
+	// END_FILE stays disabled until every queued load has run so that the
+	// files they replace don't get reported as ending.
+	if(priv->pending_loads++ == 0)
+	{
+		mpv_request_event(priv->mpv_ctx, MPV_EVENT_END_FILE, 0);
+	}
+
+	celluloid_mpv_command_async_full
+		(mpv, load_cmd, NULL, load_file_ready, NULL);
 
 	g_free(path);
 }
 
+static void
+update_playlist_count(CelluloidMpv *mpv, const mpv_event_property *prop)
+{
+	CelluloidMpvPrivate *priv = get_private(mpv);
+
+	// While loads are queued, the reported length lags behind the one
+	// expected from the loads sent so far.
+	if(	priv->pending_loads == 0 &&
+		prop->format == MPV_FORMAT_INT64 &&
+		g_strcmp0(prop->name, "playlist-count") == 0 )
+	{
+		priv->playlist_count = *((gint64 *)prop->data);
+	}
+}
+
+/* Keeps the playlist length expected by load_file in step with commands that
+ * empty the playlist. Waiting for playlist-count would leave a window in which
+ * a load sent right after the command still sees the old length.
+ */
+static void
+track_command(CelluloidMpv *mpv, const gchar **cmd)
+{
+	if(g_strcmp0(cmd[0], "stop") == 0)
+	{
+		get_private(mpv)->playlist_count = 0;
+	}
+}
+
+static void
+load_file_ready(GObject *source, GAsyncResult *result, gpointer data)
+{
+	CelluloidMpv *mpv = CELLULOID_MPV(source);
+	CelluloidMpvPrivate *priv = get_private(mpv);
+	GError *error = NULL;
+
+	if(!celluloid_mpv_command_finish(mpv, result, &error))
+	{
+		g_debug("Failed to load file: %s", error->message);
+		g_error_free(error);
+	}
+
+	if(--priv->pending_loads == 0 && priv->mpv_ctx)
+	{
+		mpv_request_event(priv->mpv_ctx, MPV_EVENT_END_FILE, 1);
+	}
+}
+
 static void
 reset(CelluloidMpv *mpv)
 {
@@ -509,15 +894,15 @@ reset(CelluloidMpv *mpv)
 	gboolean loop_file;
 	gboolean loop_playlist;
 
-	loop_file_str =		celluloid_mpv_get_property_string
+	loop_file_str =		celluloid_mpv_get_mirrored_string
 				(mpv, "loop-file");
-	loop_playlist_str =	celluloid_mpv_get_property_string
+	loop_playlist_str =	celluloid_mpv_get_mirrored_string
 				(mpv, "loop-playlist");
 	loop_file =		(g_strcmp0(loop_file_str, "inf") == 0);
 	loop_playlist =		(g_strcmp0(loop_playlist_str, "inf") == 0);
 
-	mpv_free(loop_file_str);
-	mpv_free(loop_playlist_str);
+	g_free(loop_file_str);
+	g_free(loop_playlist_str);
 
 	/* Reset priv->mpv_ctx */
 	priv->ready = FALSE;
@@ -527,6 +912,8 @@ reset(CelluloidMpv *mpv)
 	celluloid_mpv_quit(mpv);
 
 	priv->mpv_ctx = mpv_create();
+	priv->playlist_count = 0;
+	celluloid_stats_reset(priv->stats);
 	celluloid_mpv_initialize(mpv);
 
 	celluloid_mpv_set_render_update_callback
@@ -687,6 +1074,17 @@ celluloid_mpv_init(CelluloidMpv *mpv)
 	priv->wid = -1;
 	priv->render_update_callback_data = NULL;
 	priv->render_update_callback = NULL;
+	priv->stats = celluloid_stats_new();
+	priv->event_trace = celluloid_event_trace_writer_new_default();
+	priv->mirror = celluloid_property_mirror_new();
+	priv->check_mirror = !!g_getenv(CHECK_MIRROR_ENV_VAR);
+	priv->wakeup_time = 0;
+	priv->requests = g_hash_table_new(g_int64_hash, g_int64_equal);
+	priv->next_request_id = 0;
+	priv->pending_loads = 0;
+	priv->playlist_count = 0;
+
+	g_mutex_init(&priv->wakeup_lock);
 }
 
 CelluloidMpv *
@@ -707,6 +1105,18 @@ celluloid_mpv_get_use_opengl_cb(CelluloidMpv *mpv)
 	return get_private(mpv)->use_opengl;
 }
 
+CelluloidStats *
+celluloid_mpv_get_stats(CelluloidMpv *mpv)
+{
+	return get_private(mpv)->stats;
+}
+
+CelluloidPropertyMirror *
+celluloid_mpv_get_property_mirror(CelluloidMpv *mpv)
+{
+	return get_private(mpv)->mirror;
+}
+
 void
 celluloid_mpv_initialize(CelluloidMpv *mpv)
 {
@@ -749,6 +1159,7 @@ void
 celluloid_mpv_quit(CelluloidMpv *mpv)
 {
 	CelluloidMpvPrivate *priv = get_private(mpv);
+	GPtrArray *requests = take_all_requests(mpv);
 
 	g_info("Terminating mpv");
 	celluloid_mpv_command_string(mpv, "quit");
@@ -765,6 +1176,19 @@ celluloid_mpv_quit(CelluloidMpv *mpv)
 	mpv_terminate_destroy(priv->mpv_ctx);
 
 	priv->mpv_ctx = NULL;
+
+	celluloid_property_mirror_invalidate(priv->mirror);
+
+	// Requests that were still waiting for a reply won't get one anymore.
+	// They are only completed now so that their callbacks can't reach the
+	// old handle.
+	for(guint i = 0; i < requests->len; i++)
+	{
+		return_mpv_error
+			(g_ptr_array_index(requests, i), MPV_ERROR_UNINITIALIZED);
+	}
+
+	g_ptr_array_unref(requests);
 }
 
 void
@@ -832,6 +1256,11 @@ celluloid_mpv_command(CelluloidMpv *mpv, const gchar **cmd)
 		rc = mpv_command(priv->mpv_ctx, cmd);
 	}
 
+	if(rc >= 0)
+	{
+		track_command(mpv, cmd);
+	}
+
 	if(rc < 0)
 	{
 		gchar *cmd_str = g_strjoinv(" ", (gchar **)cmd);
@@ -857,6 +1286,11 @@ celluloid_mpv_command_async(CelluloidMpv *mpv, const gchar **cmd)
 		rc = mpv_command_async(priv->mpv_ctx, 0, cmd);
 	}
 
+	if(rc >= 0)
+	{
+		track_command(mpv, cmd);
+	}
+
 	if(rc < 0)
 	{
 		gchar *cmd_str = g_strjoinv(" ", (gchar **)cmd);
@@ -872,6 +1306,53 @@ celluloid_mpv_command_async(CelluloidMpv *mpv, const gchar **cmd)
 	return rc;
 }
 
+void
+celluloid_mpv_command_async_full(	CelluloidMpv *mpv,
+					const gchar **cmd,
+					GCancellable *cancellable,
+					GAsyncReadyCallback callback,
+					gpointer data )
+{
+	CelluloidMpvPrivate *priv = get_private(mpv);
+	GTask *task = g_task_new(mpv, cancellable, callback, data);
+	gint rc = MPV_ERROR_UNINITIALIZED;
+
+	g_task_set_source_tag(task, celluloid_mpv_command_async_full);
+
+	if(priv->mpv_ctx)
+	{
+		const guint64 id = add_request(mpv, task, MPV_FORMAT_NONE);
+
+		rc = mpv_command_async(priv->mpv_ctx, id, cmd);
+
+		if(rc < 0)
+		{
+			g_object_unref(take_request(mpv, id));
+		}
+		else
+		{
+			track_command(mpv, cmd);
+		}
+	}
+
+	if(rc < 0)
+	{
+		return_mpv_error(task, rc);
+	}
+
+	g_object_unref(task);
+}
+
+gboolean
+celluloid_mpv_command_finish(	CelluloidMpv *mpv,
+				GAsyncResult *result,
+				GError **error )
+{
+	g_return_val_if_fail(g_task_is_valid(result, mpv), FALSE);
+
+	return g_task_propagate_boolean(G_TASK(result), error);
+}
+
 gint
 celluloid_mpv_command_string(CelluloidMpv *mpv, const gchar *cmd)
 {
@@ -971,6 +1452,65 @@ celluloid_mpv_get_property_flag(CelluloidMpv *mpv, const gchar *name)
 	return value;
 }
 
+gboolean
+celluloid_mpv_get_mirrored_flag(CelluloidMpv *mpv, const gchar *name)
+{
+	int value = FALSE;
+
+	get_mirrored(mpv, name, MPV_FORMAT_FLAG, &value);
+
+	return value;
+}
+
+gint64
+celluloid_mpv_get_mirrored_int64(CelluloidMpv *mpv, const gchar *name)
+{
+	gint64 value = 0;
+
+	get_mirrored(mpv, name, MPV_FORMAT_INT64, &value);
+
+	return value;
+}
+
+gdouble
+celluloid_mpv_get_mirrored_double(CelluloidMpv *mpv, const gchar *name)
+{
+	gdouble value = 0;
+
+	get_mirrored(mpv, name, MPV_FORMAT_DOUBLE, &value);
+
+	return value;
+}
+
+gchar *
+celluloid_mpv_get_mirrored_string(CelluloidMpv *mpv, const gchar *name)
+{
+	CelluloidMpvPrivate *priv = get_private(mpv);
+	const gchar *mirrored = NULL;
+	gchar *value = NULL;
+
+	if(celluloid_property_mirror_get
+		(priv->mirror, name, MPV_FORMAT_STRING, &mirrored))
+	{
+		if(priv->check_mirror && priv->mpv_ctx)
+		{
+			celluloid_property_mirror_check
+				(priv->mirror, priv->mpv_ctx, name);
+		}
+
+		value = g_strdup(mirrored);
+	}
+	else
+	{
+		gchar *mpv_value = celluloid_mpv_get_property_string(mpv, name);
+
+		value = g_strdup(mpv_value);
+		mpv_free(mpv_value);
+	}
+
+	return value;
+}
+
 gint
 celluloid_mpv_set_property(	CelluloidMpv *mpv,
 				const gchar *name,
@@ -1044,6 +1584,138 @@ celluloid_mpv_set_property_flag(	CelluloidMpv *mpv,
 	return rc;
 }
 
+void
+celluloid_mpv_set_property_async(	CelluloidMpv *mpv,
+					const gchar *name,
+					mpv_format format,
+					void *data,
+					GCancellable *cancellable,
+					GAsyncReadyCallback callback,
+					gpointer user_data )
+{
+	CelluloidMpvPrivate *priv = get_private(mpv);
+	GTask *task = g_task_new(mpv, cancellable, callback, user_data);
+	gint rc = MPV_ERROR_UNINITIALIZED;
+
+	g_task_set_source_tag(task, celluloid_mpv_set_property_async);
+
+	if(priv->mpv_ctx)
+	{
+		const guint64 id = add_request(mpv, task, MPV_FORMAT_NONE);
+
+		// The value is copied before this returns
+		rc = mpv_set_property_async(priv->mpv_ctx, id, name, format, data);
+
+		if(rc < 0)
+		{
+			g_object_unref(take_request(mpv, id));
+		}
+	}
+
+	if(rc < 0)
+	{
+		return_mpv_error(task, rc);
+	}
+
+	g_object_unref(task);
+}
+
+gboolean
+celluloid_mpv_set_property_finish(	CelluloidMpv *mpv,
+					GAsyncResult *result,
+					GError **error )
+{
+	g_return_val_if_fail(g_task_is_valid(result, mpv), FALSE);
+
+	return g_task_propagate_boolean(G_TASK(result), error);
+}
+
+void
+celluloid_mpv_get_property_async(	CelluloidMpv *mpv,
+					const gchar *name,
+					mpv_format format,
+					GCancellable *cancellable,
+					GAsyncReadyCallback callback,
+					gpointer user_data )
+{
+	CelluloidMpvPrivate *priv = get_private(mpv);
+	GTask *task = g_task_new(mpv, cancellable, callback, user_data);
+	gint rc = MPV_ERROR_UNINITIALIZED;
+
+	g_task_set_source_tag(task, celluloid_mpv_get_property_async);
+
+	if(	format != MPV_FORMAT_STRING &&
+		format != MPV_FORMAT_OSD_STRING &&
+		format != MPV_FORMAT_FLAG &&
+		format != MPV_FORMAT_INT64 &&
+		format != MPV_FORMAT_DOUBLE )
+	{
+		rc = MPV_ERROR_PROPERTY_FORMAT;
+	}
+	else if(priv->mpv_ctx)
+	{
+		const guint64 id = add_request(mpv, task, format);
+
+		rc = mpv_get_property_async(priv->mpv_ctx, id, name, format);
+
+		if(rc < 0)
+		{
+			g_object_unref(take_request(mpv, id));
+		}
+	}
+
+	if(rc < 0)
+	{
+		return_mpv_error(task, rc);
+	}
+
+	g_object_unref(task);
+}
+
+gboolean
+celluloid_mpv_get_property_finish(	CelluloidMpv *mpv,
+					GAsyncResult *result,
+					void *data,
+					GError **error )
+{
+	CelluloidMpvRequest *request = NULL;
+	gboolean success = FALSE;
+
+	g_return_val_if_fail(g_task_is_valid(result, mpv), FALSE);
+
+	request = g_task_get_task_data(G_TASK(result));
+	success = g_task_propagate_boolean(G_TASK(result), error);
+
+	if(success)
+	{
+		switch(request->format)
+		{
+			case MPV_FORMAT_STRING:
+			case MPV_FORMAT_OSD_STRING:
+			*((gchar **)data) = g_steal_pointer(&request->value.string);
+			break;
+
+			case MPV_FORMAT_FLAG:
+			*((int *)data) = request->value.flag;
+			break;
+
+			case MPV_FORMAT_INT64:
+			*((gint64 *)data) = request->value.int64;
+			break;
+
+			case MPV_FORMAT_DOUBLE:
+			*((gdouble *)data) = request->value.double_value;
+			break;
+
+			default:
+			g_assert_not_reached();
+			break;
+		}
+	}
+
+	return success;
+}
+
 void
 celluloid_mpv_set_render_update_callback(	CelluloidMpv *mpv,
 						mpv_render_update_fn func,
@@ -1079,12 +1751,22 @@ celluloid_mpv_observe_property(	CelluloidMpv *mpv,
 				const gchar *name,
 				mpv_format format )
 {
-	return mpv_observe_property(	get_private(mpv)->mpv_ctx,
+	CelluloidMpvPrivate *priv = get_private(mpv);
+
+	celluloid_property_mirror_add(priv->mirror, name, format);
+
+	return mpv_observe_property(	priv->mpv_ctx,
 					reply_userdata,
 					name,
 					format );
 }
 
+gint
+celluloid_mpv_unobserve_property(CelluloidMpv *mpv, guint64 reply_userdata)
+{
+	return mpv_unobserve_property(get_private(mpv)->mpv_ctx, reply_userdata);
+}
+
 gint
 celluloid_mpv_request_log_messages(CelluloidMpv *mpv, const gchar *min_level)
 {
@@ -22,15 +22,23 @@
 
 #include <glib.h>
 #include <glib-object.h>
+#include <gio/gio.h>
 #include <mpv/client.h>
 #include <mpv/render_gl.h>
 
 #include "celluloid-common.h"
+#include "celluloid-stats.h"
+#include "celluloid-property-mirror.h"
 
 G_BEGIN_DECLS
 
 #define CELLULOID_TYPE_MPV (celluloid_mpv_get_type())
 
+/* Errors reported by the asynchronous API use the mpv_error value as the
+ * error code.
+ */
+#define CELLULOID_MPV_ERROR celluloid_mpv_error_quark()
+
 G_DECLARE_DERIVABLE_TYPE(CelluloidMpv, celluloid_mpv, CELLULOID, MPV, GObject)
 
 struct _CelluloidMpvClass
@@ -51,6 +59,9 @@ struct _CelluloidMpvClass
 	void (*reset)(CelluloidMpv *mpv);
 };
 
+GQuark
+celluloid_mpv_error_quark(void);
+
 CelluloidMpv *
 celluloid_mpv_new(gint64 wid);
 
@@ -60,6 +71,12 @@ celluloid_mpv_get_render_context(CelluloidMpv *mpv);
 gboolean
 celluloid_mpv_get_use_opengl_cb(CelluloidMpv *mpv);
 
+CelluloidStats *
+celluloid_mpv_get_stats(CelluloidMpv *mpv);
+
+CelluloidPropertyMirror *
+celluloid_mpv_get_property_mirror(CelluloidMpv *mpv);
+
 void
 celluloid_mpv_initialize(CelluloidMpv *mpv);
 
@@ -87,6 +104,18 @@ celluloid_mpv_command(CelluloidMpv *mpv, const gchar **cmd);
 gint
 celluloid_mpv_command_async(CelluloidMpv *mpv, const gchar **cmd);
 
+void
+celluloid_mpv_command_async_full(	CelluloidMpv *mpv,
+					const gchar **cmd,
+					GCancellable *cancellable,
+					GAsyncReadyCallback callback,
+					gpointer data );
+
+gboolean
+celluloid_mpv_command_finish(	CelluloidMpv *mpv,
+				GAsyncResult *result,
+				GError **error );
+
 gint
 celluloid_mpv_command_string(CelluloidMpv *mpv, const gchar *cmd);
 
@@ -107,6 +136,18 @@ celluloid_mpv_get_property_string(CelluloidMpv *mpv, const gchar *name);
 gboolean
 celluloid_mpv_get_property_flag(CelluloidMpv *mpv, const gchar *name);
 
+gboolean
+celluloid_mpv_get_mirrored_flag(CelluloidMpv *mpv, const gchar *name);
+
+gint64
+celluloid_mpv_get_mirrored_int64(CelluloidMpv *mpv, const gchar *name);
+
+gdouble
+celluloid_mpv_get_mirrored_double(CelluloidMpv *mpv, const gchar *name);
+
+gchar *
+celluloid_mpv_get_mirrored_string(CelluloidMpv *mpv, const gchar *name);
+
 gint
 celluloid_mpv_set_property(	CelluloidMpv *mpv,
 				const gchar *name,
@@ -123,6 +164,37 @@ celluloid_mpv_set_property_string(	CelluloidMpv *mpv,
 					const gchar *name,
 					const char *data );
 
+void
+celluloid_mpv_set_property_async(	CelluloidMpv *mpv,
+					const gchar *name,
+					mpv_format format,
+					void *data,
+					GCancellable *cancellable,
+					GAsyncReadyCallback callback,
+					gpointer user_data );
+
+gboolean
+celluloid_mpv_set_property_finish(	CelluloidMpv *mpv,
+					GAsyncResult *result,
+					GError **error );
+
+/* Only scalar formats are supported. Strings are returned in memory owned by
+ * the caller, which should be freed with g_free() rather than mpv_free().
+ */
+void
+celluloid_mpv_get_property_async(	CelluloidMpv *mpv,
+					const gchar *name,
+					mpv_format format,
+					GCancellable *cancellable,
+					GAsyncReadyCallback callback,
+					gpointer user_data );
+
+gboolean
+celluloid_mpv_get_property_finish(	CelluloidMpv *mpv,
+					GAsyncResult *result,
+					void *data,
+					GError **error );
+
 void
 celluloid_mpv_set_event_callback(	CelluloidMpv *mpv,
 					void (*func)(mpv_event *, void *),
@@ -145,6 +217,9 @@ celluloid_mpv_observe_property(	CelluloidMpv *mpv,
 				const gchar *name,
 				mpv_format format );
 
+gint
+celluloid_mpv_unobserve_property(CelluloidMpv *mpv, guint64 reply_userdata);
+
 gint
 celluloid_mpv_request_log_messages(CelluloidMpv *mpv, const gchar *min_level);
 
@@ -467,6 +467,8 @@ void
 celluloid_player_options_init(	CelluloidPlayer *player,
 				CelluloidMainWindow *window )
 {
+	gboolean ready = FALSE;
+
 	g_signal_connect(	player,
 				"notify::ready",
 				G_CALLBACK(ready_handler),
@@ -475,4 +477,12 @@ celluloid_player_options_init(	CelluloidPlayer *player,
 				"autofit",
 				G_CALLBACK(autofit_handler),
 				window );
+
+	// Players taken from the standby pool are already initialized
+	g_object_get(player, "ready", &ready, NULL);
+
+	if(ready)
+	{
+		ready_handler(G_OBJECT(player), NULL, window);
+	}
 }
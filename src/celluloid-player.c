@@ -18,21 +18,26 @@
  */
 
 #include <string.h>
-#include <glib/gstdio.h>
 #include <glib/gi18n.h>
 
 #include "celluloid-option-parser.h"
 #include "celluloid-player.h"
+#include "celluloid-log-levels.h"
 #include "celluloid-player-options.h"
 #include "celluloid-marshal.h"
 #include "celluloid-metadata-cache.h"
+#include "celluloid-job-scheduler.h"
 #include "celluloid-mpv.h"
+#include "celluloid-resume-store.h"
+#include "celluloid-settings-snapshot.h"
+#include "celluloid-trace.h"
 #include "celluloid-def.h"
 
 #define get_private(player) \
 	((CelluloidPlayerPrivate *)celluloid_player_get_instance_private(CELLULOID_PLAYER(player)))
 
 typedef struct _CelluloidPlayerPrivate CelluloidPlayerPrivate;
+typedef struct _PreloadData PreloadData;
 
 enum
 {
@@ -40,9 +45,11 @@ enum
 	PROP_PLAYLIST,
 	PROP_METADATA,
 	PROP_CHAPTER_LIST,
+	PROP_BUFFERED_RANGES,
 	PROP_TRACK_LIST,
 	PROP_DISC_LIST,
 	PROP_EXTRA_OPTIONS,
+	PROP_METADATA_CACHE,
 	N_PROPERTIES
 };
 
@@ -51,20 +58,82 @@ struct _CelluloidPlayerPrivate
 	CelluloidMpv parent;
 	CelluloidMetadataCache *cache;
 	GVolumeMonitor *monitor;
+	guint monitor_setup_id;
 	GPtrArray *playlist;
 	GPtrArray *metadata;
+	gboolean metadata_dirty;
+	guint metadata_update_id;
 	GPtrArray *chapter_list;
 	GPtrArray *track_list;
 	GPtrArray *disc_list;
-	GHashTable *log_levels;
+	CelluloidLogLevels *log_levels;
+	CelluloidLogBuffer *log_buffer;
 	GHashTable *script_options;
 	gboolean loaded;
 	gboolean new_file;
 	gboolean init_vo_config;
-	gchar *tmp_input_config;
+	GHashTable *input_bindings;
+	GFileMonitor *input_config_monitor;
+	gchar *input_config_uri;
 	gchar *extra_options;
+	gchar *applied_options;
+	gchar *applied_config_file;
+	gchar *applied_config_checksum;
+	GHashTable *loaded_scripts;
+	gboolean preload_enable;
+	gchar *saved_readahead;
+	GCancellable *preload_cancellable;
+	gint64 playlist_pos;
+	gint64 preload_pos;
+	gint64 transition_start;
+	gboolean transition_preloaded;
+	gchar *current_path;
+	gdouble duration;
+	gdouble time_remaining;
+	guint preload_check_id;
+	gint64 frame_drop_count;
+	gboolean stats_observed;
+	GArray *buffered_ranges;
+	gboolean buffered_ranges_dirty;
+	guint buffered_ranges_update_id;
+	gboolean cache_state_observed;
 };
 
+struct _PreloadData
+{
+	gchar *filename;
+	GCancellable *cancellable;
+	gsize remaining;
+};
+
+/* Options that mpv either refuses to change at runtime or only reads while
+ * starting up. Changing any of these requires the core to be recreated.
+ */
+static const gchar *const init_only_options[] =
+	{	"audio-client-name",
+		"config",
+		"config-dir",
+		"gpu-api",
+		"gpu-context",
+		"include",
+		"input-conf",
+		"input-default-bindings",
+		"load-scripts",
+		"log-file",
+		"profile",
+		"script",
+		"script-opts",
+		"scripts",
+		"vo",
+		NULL };
+
+/* demuxer-cache-state is observed with its own reply_userdata so that it can be
+ * unobserved without affecting any other property. The same goes for the
+ * properties that are only needed while the stats overlay is visible.
+ */
+#define CACHE_STATE_REPLY_USERDATA 1
+#define STATS_REPLY_USERDATA 2
+
 static void
 set_property(	GObject *object,
 		guint property_id,
@@ -104,9 +173,39 @@ mpv_property_changed(CelluloidMpv *mpv, const gchar *name, gpointer value);
 static void
 observe_properties(CelluloidMpv *mpv);
 
+static void
+observe_stats(CelluloidPlayer *player);
+
 static gchar *
 build_script_opts_string(CelluloidPlayer *player);
 
+static void
+apply_preload_options(CelluloidPlayer *player);
+
+static void
+preload_data_free(PreloadData *data);
+
+static void
+preload_read_handler(GObject *source, GAsyncResult *res, gpointer data);
+
+static void
+preload_open_handler(GObject *source, GAsyncResult *res, gpointer data);
+
+static void
+cancel_preload(CelluloidPlayer *player);
+
+static void
+preload_next_entry(CelluloidPlayer *player);
+
+static void
+update_preload_check(CelluloidPlayer *player);
+
+static gboolean
+preload_check_handler(gpointer data);
+
+static void
+record_resume_position(CelluloidPlayer *player, gboolean finished);
+
 static void
 apply_default_options(CelluloidPlayer *player);
 
@@ -119,15 +218,55 @@ apply_options_array_string(CelluloidMpv *mpv, const gchar *args);
 static void
 apply_extra_options(CelluloidPlayer *player);
 
+static GHashTable *
+parse_options_table(const gchar *options);
+
+static gboolean
+option_requires_reset(const gchar *name);
+
+static gboolean
+apply_changed_options(CelluloidPlayer *player);
+
+static gboolean
+scripts_removed(CelluloidPlayer *player);
+
 static void
 load_file(CelluloidMpv *mpv, const gchar *uri, gboolean append);
 
+static void
+playlist_command_ready(GObject *source, GAsyncResult *result, gpointer data);
+
+static void
+playlist_pos_ready(GObject *source, GAsyncResult *result, gpointer data);
+
 static void
 reset(CelluloidMpv *mpv);
 
+static gchar *
+normalize_keystr(const gchar *keystr);
+
 static void
 load_input_conf(CelluloidPlayer *player, const gchar *input_conf);
 
+static void
+monitor_input_conf(CelluloidPlayer *player, const gchar *input_conf);
+
+static void
+update_input_bindings(CelluloidPlayer *player);
+
+static void
+input_conf_changed_handler(	GFileMonitor *monitor,
+				GFile *file,
+				GFile *other_file,
+				GFileMonitorEvent event_type,
+				gpointer data );
+
+static gchar *
+get_config_file_path(void);
+
+static gchar *
+get_config_file_checksum(const gchar *path);
+
 static void
 load_config_file(CelluloidMpv *mpv);
 
@@ -164,7 +303,13 @@ static void
 update_playlist(CelluloidPlayer *player);
 
 static void
-update_metadata(CelluloidPlayer *player);
+update_metadata(CelluloidPlayer *player, const mpv_node *node);
+
+static void
+notify_metadata(CelluloidPlayer *player);
+
+static gboolean
+metadata_update_handler(gpointer data);
 
 static void
 update_chapter_list(CelluloidPlayer *player);
@@ -172,11 +317,26 @@ update_chapter_list(CelluloidPlayer *player);
 static void
 update_track_list(CelluloidPlayer *player);
 
+static void
+observe_cache_state(CelluloidPlayer *player);
+
+static void
+update_buffered_ranges(CelluloidPlayer *player, const mpv_node *node);
+
+static void
+notify_buffered_ranges(CelluloidPlayer *player);
+
+static gboolean
+buffered_ranges_update_handler(gpointer data);
+
 static void
 cache_update_handler(	CelluloidMetadataCache *cache,
 			const gchar *uri,
 			gpointer data );
 
+static void
+set_metadata_cache(CelluloidPlayer *player, CelluloidMetadataCache *cache);
+
 static void
 mount_added_handler(GVolumeMonitor *monitor, GMount *mount, gpointer data);
 
@@ -186,6 +346,9 @@ volume_removed_handler(GVolumeMonitor *monitor, GVolume *volume, gpointer data);
 static void
 guess_content_handler(GMount *mount, GAsyncResult *res, gpointer data);
 
+static gboolean
+setup_volume_monitor(gpointer data);
+
 G_DEFINE_TYPE_WITH_PRIVATE(CelluloidPlayer, celluloid_player, CELLULOID_TYPE_MPV)
 
 static void
@@ -201,6 +364,7 @@ set_property(	GObject *object,
 		case PROP_PLAYLIST:
 		case PROP_METADATA:
 		case PROP_CHAPTER_LIST:
+		case PROP_BUFFERED_RANGES:
 		case PROP_TRACK_LIST:
 		case PROP_DISC_LIST:
 		g_critical("Attempted to set read-only property");
@@ -211,6 +375,11 @@ set_property(	GObject *object,
 		priv->extra_options = g_value_dup_string(value);
 		break;
 
+		case PROP_METADATA_CACHE:
+		set_metadata_cache
+			(CELLULOID_PLAYER(object), g_value_get_object(value));
+		break;
+
 		default:
 		G_OBJECT_WARN_INVALID_PROPERTY_ID(object, property_id, pspec);
 		break;
@@ -239,6 +408,10 @@ get_property(	GObject *object,
 		g_value_set_pointer(value, priv->chapter_list);
 		break;
 
+		case PROP_BUFFERED_RANGES:
+		g_value_set_pointer(value, priv->buffered_ranges);
+		break;
+
 		case PROP_TRACK_LIST:
 		g_value_set_pointer(value, priv->track_list);
 		break;
@@ -251,6 +424,10 @@ get_property(	GObject *object,
 		g_value_set_string(value, priv->extra_options);
 		break;
 
+		case PROP_METADATA_CACHE:
+		g_value_set_object(value, priv->cache);
+		break;
+
 		default:
 		G_OBJECT_WARN_INVALID_PROPERTY_ID(object, property_id, pspec);
 		break;
@@ -262,9 +439,29 @@ dispose(GObject *object)
 {
 	CelluloidPlayerPrivate *priv = get_private(object);
 
-	g_signal_handlers_disconnect_by_data(priv->monitor, object);
+	g_source_clear(&priv->monitor_setup_id);
+	g_source_clear(&priv->buffered_ranges_update_id);
+	g_source_clear(&priv->metadata_update_id);
+	cancel_preload(CELLULOID_PLAYER(object));
 
-	g_clear_object(&priv->cache);
+	// mpv won't get to report END_FILE for the file that is still playing
+	g_source_clear(&priv->preload_check_id);
+	record_resume_position(CELLULOID_PLAYER(object), FALSE);
+
+	if(priv->monitor)
+	{
+		g_signal_handlers_disconnect_by_data(priv->monitor, object);
+	}
+
+	if(priv->input_config_monitor)
+	{
+		g_signal_handlers_disconnect_by_data
+			(priv->input_config_monitor, object);
+	}
+
+	g_clear_object(&priv->input_config_monitor);
+
+	set_metadata_cache(CELLULOID_PLAYER(object), NULL);
 	g_clear_object(&priv->monitor);
 
 	G_OBJECT_CLASS(celluloid_player_parent_class)->dispose(object);
@@ -275,18 +472,22 @@ finalize(GObject *object)
 {
 	CelluloidPlayerPrivate *priv = get_private(object);
 
-	if(priv->tmp_input_config)
-	{
-		g_unlink(priv->tmp_input_config);
-	}
-
-	g_free(priv->tmp_input_config);
+	g_hash_table_unref(priv->input_bindings);
+	g_free(priv->input_config_uri);
 	g_free(priv->extra_options);
+	g_free(priv->applied_options);
+	g_free(priv->applied_config_file);
+	g_free(priv->applied_config_checksum);
+	g_free(priv->saved_readahead);
+	g_hash_table_unref(priv->loaded_scripts);
 	g_ptr_array_free(priv->playlist, TRUE);
 	g_ptr_array_free(priv->metadata, TRUE);
 	g_ptr_array_free(priv->chapter_list, TRUE);
+	g_array_free(priv->buffered_ranges, TRUE);
 	g_ptr_array_free(priv->track_list, TRUE);
 	g_ptr_array_free(priv->disc_list, TRUE);
+	celluloid_log_levels_free(priv->log_levels);
+	celluloid_log_buffer_unref(priv->log_buffer);
 
 	G_OBJECT_CLASS(celluloid_player_parent_class)->finalize(object);
 }
@@ -310,10 +511,37 @@ mpv_event_notify(CelluloidMpv *mpv, gint event_id, gpointer event_data)
 	{
 		gboolean vo_configured = FALSE;
 
-		celluloid_mpv_get_property(	mpv,
-					"vo-configured",
-					MPV_FORMAT_FLAG,
-					&vo_configured );
+		// END_FILE is disabled while loads are pending, so the previous
+		// file may still be current here. Record it before its duration
+		// and position get reset.
+		g_source_clear(&priv->preload_check_id);
+		record_resume_position(CELLULOID_PLAYER(mpv), FALSE);
+
+		priv->duration = -1;
+		priv->time_remaining = -1;
+
+		g_array_set_size(priv->buffered_ranges, 0);
+		notify_buffered_ranges(CELLULOID_PLAYER(mpv));
+
+		// Deliver whatever is still held back from the previous file
+		// and let the first update for the new one through right away.
+		if(priv->metadata_dirty)
+		{
+			priv->metadata_dirty = FALSE;
+			g_object_notify(G_OBJECT(mpv), "metadata");
+		}
+
+		g_source_clear(&priv->metadata_update_id);
+
+		// The previous file may have been cached completely, in which
+		// case demuxer-cache-state is no longer being observed.
+		if(!priv->cache_state_observed)
+		{
+			observe_cache_state(CELLULOID_PLAYER(mpv));
+		}
+
+		vo_configured =	celluloid_mpv_get_mirrored_flag
+				(mpv, "vo-configured");
 
 		/* If the vo is not configured yet, save the content of mpv's
 		 * playlist. This will be loaded again when the vo is
@@ -326,18 +554,44 @@ mpv_event_notify(CelluloidMpv *mpv, gint event_id, gpointer event_data)
 	}
 	else if(event_id == MPV_EVENT_END_FILE)
 	{
+		mpv_event_end_file *event = event_data;
+
 		if(priv->loaded)
 		{
 			priv->new_file = FALSE;
 		}
+
+		if(event->reason == MPV_END_FILE_REASON_EOF)
+		{
+			priv->transition_start = g_get_monotonic_time();
+		}
+
+		g_source_clear(&priv->preload_check_id);
+
+		record_resume_position
+			(	CELLULOID_PLAYER(mpv),
+				event->reason == MPV_END_FILE_REASON_EOF );
 	}
 	else if(event_id == MPV_EVENT_IDLE)
 	{
 		priv->loaded = FALSE;
+
+		// Reaching the end of the playlist isn't a transition, so don't
+		// let the next PLAYBACK_RESTART, e.g. from a seek, report one.
+		priv->transition_start = 0;
 	}
 	else if(event_id == MPV_EVENT_FILE_LOADED)
 	{
+		gchar *path = celluloid_mpv_get_property_string(mpv, "path");
+
 		priv->loaded = TRUE;
+
+		g_free(priv->current_path);
+		priv->current_path = g_strdup(path);
+
+		update_preload_check(CELLULOID_PLAYER(mpv));
+
+		mpv_free(path);
 	}
 	else if(event_id == MPV_EVENT_VIDEO_RECONFIG)
 	{
@@ -346,6 +600,21 @@ mpv_event_notify(CelluloidMpv *mpv, gint event_id, gpointer event_data)
 			g_signal_emit_by_name(CELLULOID_PLAYER(mpv), "autofit");
 		}
 	}
+	else if(event_id == MPV_EVENT_PLAYBACK_RESTART)
+	{
+		if(priv->transition_start > 0)
+		{
+			const gint64 gap =
+				g_get_monotonic_time() - priv->transition_start;
+
+			g_info(	"Playlist transition took %.1f ms "
+				"(preloaded: %s)",
+				(gdouble)gap/1000.0,
+				priv->transition_preloaded?"yes":"no" );
+
+			priv->transition_start = 0;
+		}
+	}
 
 	CELLULOID_MPV_CLASS(celluloid_player_parent_class)
 		->mpv_event_notify(mpv, event_id, event_data);
@@ -358,39 +627,13 @@ mpv_log_message(	CelluloidMpv *mpv,
 			const gchar *text )
 {
 	CelluloidPlayerPrivate *priv = get_private(mpv);
-	gsize prefix_len = strlen(prefix);
-	gboolean found = FALSE;
-	const gchar *iter_prefix;
-	gpointer iter_level;
-	GHashTableIter iter;
-
-	g_hash_table_iter_init(&iter, priv->log_levels);
-
-	while(	!found &&
-		g_hash_table_iter_next(	&iter,
-					(gpointer *)&iter_prefix,
-					&iter_level) )
-	{
-		gsize iter_prefix_len = strlen(iter_prefix);
-		gint cmp = strncmp(	iter_prefix,
-					prefix,
-					(prefix_len < iter_prefix_len)?
-					prefix_len:iter_prefix_len );
-
-		/* Allow both exact match and prefix match */
-		if(cmp == 0
-		&& (iter_prefix_len == prefix_len
-		|| (iter_prefix_len < prefix_len
-		&& prefix[iter_prefix_len] == '/')))
-		{
-			found = TRUE;
-		}
-	}
+	mpv_log_level prefix_level = DEFAULT_LOG_LEVEL;
+	const gboolean found =	celluloid_log_levels_lookup
+				(priv->log_levels, prefix, &prefix_level);
 
-	if(!found || (gint)log_level <= GPOINTER_TO_INT(iter_level))
+	if(!found || log_level <= prefix_level)
 	{
-		gchar *buf = g_strdup(text);
-		gsize len = strlen(buf);
+		gsize len = strlen(text);
 
 		if(len > 1)
 		{
@@ -398,17 +641,17 @@ mpv_log_message(	CelluloidMpv *mpv,
 			 * character when using the default log handler,
 			 * but log messages from mpv already come
 			 * terminated with a newline character so we
-			 * need to take it out.
+			 * need to leave it out.
 			 */
-			if(buf[len-1] == '\n')
+			if(text[len-1] == '\n')
 			{
-				buf[len-1] = '\0';
+				len--;
 			}
 
-			g_message("[%s] %s", prefix, buf);
+			celluloid_log_buffer_append
+				(priv->log_buffer, log_level, prefix, text);
+			g_message("[%s] %.*s", prefix, (gint)len, text);
 		}
-
-		g_free(buf);
 	}
 
 	CELLULOID_MPV_CLASS(celluloid_player_parent_class)
@@ -423,12 +666,10 @@ mpv_property_changed(CelluloidMpv *mpv, const gchar *name, gpointer value)
 
 	if(g_strcmp0(name, "pause") == 0)
 	{
-		gboolean idle_active = FALSE;
+		gboolean idle_active =	celluloid_mpv_get_mirrored_flag
+					(mpv, "idle-active");
 		gboolean pause = value?*((int *)value):TRUE;
 
-		celluloid_mpv_get_property
-			(mpv, "idle-active", MPV_FORMAT_FLAG, &idle_active);
-
 		if(idle_active && !pause && !priv->init_vo_config)
 		{
 			load_from_playlist(player);
@@ -436,12 +677,10 @@ mpv_property_changed(CelluloidMpv *mpv, const gchar *name, gpointer value)
 	}
 	else if(g_strcmp0(name, "playlist") == 0)
 	{
-		gboolean idle_active = FALSE;
+		gboolean idle_active =	celluloid_mpv_get_mirrored_flag
+					(mpv, "idle-active");
 		gboolean was_empty = FALSE;
 
-		celluloid_mpv_get_property
-			(mpv, "idle-active", MPV_FORMAT_FLAG, &idle_active);
-
 		was_empty =	priv->init_vo_config ||
 				priv->playlist->len == 0;
 
@@ -460,7 +699,7 @@ mpv_property_changed(CelluloidMpv *mpv, const gchar *name, gpointer value)
 	}
 	else if(g_strcmp0(name, "metadata") == 0)
 	{
-		update_metadata(player);
+		update_metadata(player, value);
 	}
 	else if(g_strcmp0(name, "chapter-list") == 0)
 	{
@@ -470,6 +709,10 @@ mpv_property_changed(CelluloidMpv *mpv, const gchar *name, gpointer value)
 	{
 		update_track_list(player);
 	}
+	else if(g_strcmp0(name, "demuxer-cache-state") == 0)
+	{
+		update_buffered_ranges(player, value);
+	}
 	else if(g_strcmp0(name, "vo-configured") == 0)
 	{
 		if(priv->init_vo_config)
@@ -478,6 +721,74 @@ mpv_property_changed(CelluloidMpv *mpv, const gchar *name, gpointer value)
 			load_from_playlist(player);
 		}
 	}
+	else if(g_strcmp0(name, "playlist-pos") == 0)
+	{
+		priv->playlist_pos = value?*((gint64 *)value):-1;
+		priv->transition_preloaded =
+			priv->preload_pos >= 0 &&
+			priv->preload_pos == priv->playlist_pos;
+
+		cancel_preload(player);
+	}
+	else if(g_strcmp0(name, "duration") == 0)
+	{
+		// Keep the last known values around since they may become
+		// unavailable before END_FILE gets handled.
+		if(value)
+		{
+			priv->duration = *((gdouble *)value);
+		}
+	}
+	else if(g_strcmp0(name, "time-remaining") == 0)
+	{
+		// Only the latest value is kept here. Deciding whether to
+		// preload is left to preload_check_handler() so that it isn't
+		// done on every frame.
+		if(value)
+		{
+			priv->time_remaining = *((gdouble *)value);
+		}
+	}
+	else if(g_strcmp0(name, "frame-drop-count") == 0)
+	{
+		const gint64 count = value?*((gint64 *)value):-1;
+
+		// Leave the CPU to playback for a while when it falls behind
+		if(priv->frame_drop_count >= 0 && count > priv->frame_drop_count)
+		{
+			celluloid_job_scheduler_throttle
+				(	celluloid_job_scheduler_get_default(),
+					JOB_SCHEDULER_THROTTLE_TIME );
+		}
+
+		priv->frame_drop_count = count;
+		celluloid_stats_set_frame_drop_count
+			(celluloid_mpv_get_stats(mpv), count);
+	}
+	else if(g_strcmp0(name, "vo-delayed-frame-count") == 0)
+	{
+		celluloid_stats_set_delayed_frame_count
+			(	celluloid_mpv_get_stats(mpv),
+				value?*((gint64 *)value):-1 );
+	}
+	else if(g_strcmp0(name, "estimated-vf-fps") == 0)
+	{
+		celluloid_stats_set_estimated_vf_fps
+			(	celluloid_mpv_get_stats(mpv),
+				value?*((gdouble *)value):-1 );
+	}
+	else if(g_strcmp0(name, "demuxer-cache-duration") == 0)
+	{
+		celluloid_stats_set_cache_duration
+			(	celluloid_mpv_get_stats(mpv),
+				value?*((gdouble *)value):-1 );
+	}
+	else if(g_strcmp0(name, "cache-buffering-state") == 0)
+	{
+		celluloid_stats_set_cache_buffering
+			(	celluloid_mpv_get_stats(mpv),
+				value?*((gint64 *)value):-1 );
+	}
 
 	CELLULOID_MPV_CLASS(celluloid_player_parent_class)
 		->mpv_property_changed(mpv, name, value);
@@ -499,10 +810,11 @@ observe_properties(CelluloidMpv *mpv)
 	celluloid_mpv_observe_property(mpv, 0, "loop-file", MPV_FORMAT_STRING);
 	celluloid_mpv_observe_property(mpv, 0, "loop-playlist", MPV_FORMAT_STRING);
 	celluloid_mpv_observe_property(mpv, 0, "duration", MPV_FORMAT_DOUBLE);
+	celluloid_mpv_observe_property(mpv, 0, "time-remaining", MPV_FORMAT_DOUBLE);
 	celluloid_mpv_observe_property(mpv, 0, "media-title", MPV_FORMAT_STRING);
 	celluloid_mpv_observe_property(mpv, 0, "metadata", MPV_FORMAT_NODE);
+	celluloid_mpv_observe_property(mpv, 0, "path", MPV_FORMAT_STRING);
 	celluloid_mpv_observe_property(mpv, 0, "playlist", MPV_FORMAT_NODE);
-	celluloid_mpv_observe_property(mpv, 0, "playlist-count", MPV_FORMAT_INT64);
 	celluloid_mpv_observe_property(mpv, 0, "playlist-pos", MPV_FORMAT_INT64);
 	celluloid_mpv_observe_property(mpv, 0, "speed", MPV_FORMAT_DOUBLE);
 	celluloid_mpv_observe_property(mpv, 0, "track-list", MPV_FORMAT_NODE);
@@ -511,6 +823,28 @@ observe_properties(CelluloidMpv *mpv)
 	celluloid_mpv_observe_property(mpv, 0, "volume-max", MPV_FORMAT_DOUBLE);
 	celluloid_mpv_observe_property(mpv, 0, "window-maximized", MPV_FORMAT_FLAG);
 	celluloid_mpv_observe_property(mpv, 0, "window-scale", MPV_FORMAT_DOUBLE);
+	observe_cache_state(CELLULOID_PLAYER(mpv));
+
+	/* Statistics. The frame drop count is also used to throttle background
+	 * jobs, so it is observed even while the stats overlay is hidden.
+	 */
+	celluloid_mpv_observe_property(mpv, 0, "frame-drop-count", MPV_FORMAT_INT64);
+
+	if(get_private(mpv)->stats_observed)
+	{
+		observe_stats(CELLULOID_PLAYER(mpv));
+	}
+}
+
+static void
+observe_stats(CelluloidPlayer *player)
+{
+	CelluloidMpv *mpv = CELLULOID_MPV(player);
+
+	celluloid_mpv_observe_property(mpv, STATS_REPLY_USERDATA, "vo-delayed-frame-count", MPV_FORMAT_INT64);
+	celluloid_mpv_observe_property(mpv, STATS_REPLY_USERDATA, "estimated-vf-fps", MPV_FORMAT_DOUBLE);
+	celluloid_mpv_observe_property(mpv, STATS_REPLY_USERDATA, "demuxer-cache-duration", MPV_FORMAT_DOUBLE);
+	celluloid_mpv_observe_property(mpv, STATS_REPLY_USERDATA, "cache-buffering-state", MPV_FORMAT_INT64);
 }
 
 static gchar *
@@ -598,138 +932,594 @@ apply_default_options(CelluloidPlayer *player)
 }
 
 static void
-initialize(CelluloidMpv *mpv)
+apply_preload_options(CelluloidPlayer *player)
 {
-	CelluloidPlayer *player = CELLULOID_PLAYER(mpv);
-
-	load_script_opts(player);
-	apply_default_options(player);
-	load_config_file(mpv);
-	load_input_config_file(player);
-	apply_extra_options(player);
-	observe_properties(mpv);
-
-	CELLULOID_MPV_CLASS(celluloid_player_parent_class)->initialize(mpv);
+	CelluloidPlayerPrivate *priv = get_private(player);
+	GSettings *settings = g_settings_new(CONFIG_ROOT);
+	gchar *readahead = g_strdup_printf("%d", PRELOAD_LEAD_TIME);
 
-	load_scripts(player);
-}
+	priv->preload_enable =
+		g_settings_get_boolean(settings, "preload-next-enable");
 
-static gint
-apply_options_array_string(CelluloidMpv *mpv, const gchar *args)
-{
-	gint fail_count = 0;
+	// mpv only opens the next entry once the demuxer has read the current
+	// one to the end, so reading ahead by the lead time makes that happen
+	// about as early as Celluloid's own read-ahead. These are applied
+	// before the config file and extra options so that users can still
+	// override them.
+	celluloid_mpv_set_option_string
+		(	CELLULOID_MPV(player),
+			"prefetch-playlist",
+			priv->preload_enable?"yes":"no" );
 
-	while(args && *args)
+	if(priv->preload_enable)
 	{
-		gchar *key = NULL;
-		gchar *value = NULL;
-
-		args = parse_option(args, &key, &value);
-
-		if(key && *key)
+		// Remember the value in effect so that it can be put back if
+		// preloading gets disabled again.
+		if(!priv->saved_readahead)
 		{
-			g_debug("Applying option: --%s=%s", key, value);
-
-			if(celluloid_mpv_set_option_string(mpv, key, value) < 0)
-			{
-				fail_count++;
+			gchar *value =	celluloid_mpv_get_property_string
+					(	CELLULOID_MPV(player),
+						"demuxer-readahead-secs" );
 
-				g_warning(	"Failed to apply option: --%s=%s\n",
-						key,
-						value );
-			}
+			priv->saved_readahead = g_strdup(value);
+			mpv_free(value);
 		}
-		else
+
+		celluloid_mpv_set_option_string
+			(	CELLULOID_MPV(player),
+				"demuxer-readahead-secs",
+				readahead );
+	}
+	else
+	{
+		if(priv->saved_readahead)
 		{
-			g_warning("Failed to parse options");
+			celluloid_mpv_set_option_string
+				(	CELLULOID_MPV(player),
+					"demuxer-readahead-secs",
+					priv->saved_readahead );
 
-			args = NULL;
-			fail_count++;
+			g_clear_pointer(&priv->saved_readahead, g_free);
 		}
 
-		g_free(key);
-		g_free(value);
+		cancel_preload(player);
 	}
 
-	return fail_count*(-1);
+	update_preload_check(player);
+
+	g_free(readahead);
+	g_object_unref(settings);
 }
 
 static void
-apply_extra_options(CelluloidPlayer *player)
+preload_data_free(PreloadData *data)
 {
-	CelluloidPlayerPrivate *priv = get_private(player);
-	CelluloidMpv *mpv = CELLULOID_MPV(player);
-	gchar *extra_options = priv->extra_options;
-
-	g_debug("Applying extra mpv options: %s", extra_options);
-
-	/* Apply extra options */
-	if(extra_options && apply_options_array_string(mpv, extra_options) < 0)
-	{
-		const gchar *msg = _("Failed to apply one or more MPV options.");
-		g_signal_emit_by_name(mpv, "error", msg);
-	}
+	g_object_unref(data->cancellable);
+	g_free(data->filename);
+	g_free(data);
 }
 
 static void
-load_file(CelluloidMpv *mpv, const gchar *uri, gboolean append)
+preload_read_handler(GObject *source, GAsyncResult *res, gpointer data)
 {
-	CelluloidPlayer *player = CELLULOID_PLAYER(mpv);
-	CelluloidPlayerPrivate *priv = get_private(mpv);
-	gboolean ready = FALSE;
-	gboolean idle_active = FALSE;
-
-	g_object_get(mpv, "ready", &ready, NULL);
-
-	celluloid_mpv_get_property
-		(mpv, "idle-active", MPV_FORMAT_FLAG, &idle_active);
+	GInputStream *stream = G_INPUT_STREAM(source);
+	PreloadData *preload = data;
+	GError *error = NULL;
+	GBytes *bytes = g_input_stream_read_bytes_finish(stream, res, &error);
+	const gsize size = bytes ? g_bytes_get_size(bytes) : 0;
+	const gboolean failed = !!error;
 
-	if(idle_active || !ready)
+	if(error)
 	{
-		if(!append)
+		if(!g_error_matches(error, G_IO_ERROR, G_IO_ERROR_CANCELLED))
 		{
-			priv->new_file = TRUE;
-			g_ptr_array_set_size(priv->playlist, 0);
+			g_debug(	"Failed to preload %s: %s",
+					preload->filename,
+					error->message );
 		}
 
-		add_file_to_playlist(player, uri);
+		g_error_free(error);
+	}
+
+	if(size > 0 && size < preload->remaining)
+	{
+		preload->remaining -= size;
+
+		g_input_stream_read_bytes_async
+			(	stream,
+				MIN(PRELOAD_CHUNK_SIZE, preload->remaining),
+				G_PRIORITY_LOW,
+				preload->cancellable,
+				preload_read_handler,
+				preload );
 	}
 	else
 	{
-		if(!append)
+		if(!failed)
 		{
-			priv->new_file = TRUE;
-			priv->loaded = FALSE;
+			g_debug("Finished preloading %s", preload->filename);
 		}
 
-		CELLULOID_MPV_CLASS(celluloid_player_parent_class)
-			->load_file(mpv, uri, append);
+		g_input_stream_close(stream, NULL, NULL);
+		g_object_unref(stream);
+		preload_data_free(preload);
 	}
 
-	/* Playlist items added when mpv is idle doesn't get added directly to
-	 * its internal playlist, so the property change signal won't be fired.
-	 * We need to emit notify signal here manually to ensure that the
-	 * playlist widget gets updated.
-	 */
-	if(idle_active)
-	{
-		g_object_notify(G_OBJECT(player), "playlist");
-	}
+	g_clear_pointer(&bytes, g_bytes_unref);
 }
 
 static void
-reset(CelluloidMpv *mpv)
+preload_open_handler(GObject *source, GAsyncResult *res, gpointer data)
 {
-	gboolean idle_active = FALSE;
-	gint64 playlist_pos = 0;
-	gdouble volume = 0;
+	GFileInputStream *stream = NULL;
+	PreloadData *preload = data;
+	GError *error = NULL;
 
-	celluloid_mpv_get_property
-		(mpv, "idle-active", MPV_FORMAT_FLAG, &idle_active);
-	celluloid_mpv_get_property
-		(mpv, "playlist-pos", MPV_FORMAT_INT64, &playlist_pos);
-	celluloid_mpv_get_property
-		(mpv, "volume", MPV_FORMAT_DOUBLE, &volume);
+	stream = g_file_read_finish(G_FILE(source), res, &error);
+
+	if(stream)
+	{
+		g_input_stream_read_bytes_async
+			(	G_INPUT_STREAM(stream),
+				MIN(PRELOAD_CHUNK_SIZE, preload->remaining),
+				G_PRIORITY_LOW,
+				preload->cancellable,
+				preload_read_handler,
+				preload );
+	}
+	else
+	{
+		if(!g_error_matches(error, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+		{
+			g_debug(	"Failed to open %s for preloading: %s",
+					preload->filename,
+					error->message );
+		}
+
+		g_error_free(error);
+		preload_data_free(preload);
+	}
+}
+
+static void
+cancel_preload(CelluloidPlayer *player)
+{
+	CelluloidPlayerPrivate *priv = get_private(player);
+
+	if(priv->preload_cancellable)
+	{
+		g_cancellable_cancel(priv->preload_cancellable);
+		g_clear_object(&priv->preload_cancellable);
+	}
+
+	priv->preload_pos = -1;
+}
+
+static void
+preload_next_entry(CelluloidPlayer *player)
+{
+	CelluloidPlayerPrivate *priv = get_private(player);
+	const gint64 next_pos = priv->playlist_pos + 1;
+
+	if(	priv->playlist_pos >= 0 &&
+		next_pos < (gint64)priv->playlist->len &&
+		next_pos != priv->preload_pos )
+	{
+		CelluloidPlaylistEntry *entry =
+			g_ptr_array_index(priv->playlist, next_pos);
+		GFile *file =
+			g_file_new_for_commandline_arg(entry->filename);
+		gchar *path =
+			g_file_get_path(file);
+
+		cancel_preload(player);
+		priv->preload_pos = next_pos;
+
+		// Network streams are left to mpv's prefetch-playlist. Local
+		// files, including GVFS mounts, are read ahead here so that
+		// mpv finds them in the page cache when it opens them.
+		if(path)
+		{
+			PreloadData *preload = g_new0(PreloadData, 1);
+
+			preload->filename = g_strdup(entry->filename);
+			preload->remaining = PRELOAD_READAHEAD_SIZE;
+			priv->preload_cancellable = g_cancellable_new();
+			preload->cancellable =
+				g_object_ref(priv->preload_cancellable);
+
+			g_debug("Preloading %s", entry->filename);
+
+			g_file_read_async(	file,
+						G_PRIORITY_LOW,
+						priv->preload_cancellable,
+						preload_open_handler,
+						preload );
+		}
+
+		g_free(path);
+		g_object_unref(file);
+	}
+}
+
+static void
+update_preload_check(CelluloidPlayer *player)
+{
+	CelluloidPlayerPrivate *priv = get_private(player);
+
+	g_source_clear(&priv->preload_check_id);
+
+	// Checking every few seconds is accurate enough for the lead time
+	if(priv->preload_enable && priv->loaded)
+	{
+		priv->preload_check_id =
+			g_timeout_add_seconds(	PRELOAD_CHECK_INTERVAL,
+						preload_check_handler,
+						player );
+	}
+}
+
+static gboolean
+preload_check_handler(gpointer data)
+{
+	CelluloidPlayer *player = data;
+	CelluloidPlayerPrivate *priv = get_private(player);
+
+	if(	priv->time_remaining >= 0 &&
+		priv->time_remaining < PRELOAD_LEAD_TIME )
+	{
+		preload_next_entry(player);
+	}
+
+	return G_SOURCE_CONTINUE;
+}
+
+static void
+record_resume_position(CelluloidPlayer *player, gboolean finished)
+{
+	CelluloidPlayerPrivate *priv = get_private(player);
+
+	if(priv->current_path && priv->duration > 0)
+	{
+		gdouble position = 0;
+
+		if(finished)
+		{
+			position = priv->duration;
+		}
+		else if(priv->time_remaining >= 0)
+		{
+			position = priv->duration - priv->time_remaining;
+		}
+
+		celluloid_resume_store_update
+			(	celluloid_resume_store_get_default(),
+				priv->current_path,
+				position,
+				priv->duration,
+				finished );
+	}
+
+	g_clear_pointer(&priv->current_path, g_free);
+}
+
+static void
+initialize(CelluloidMpv *mpv)
+{
+	CelluloidPlayer *player = CELLULOID_PLAYER(mpv);
+	gint64 trace_span = 0;
+
+	// Scripts loaded into a previous core are gone after a reset
+	g_hash_table_remove_all(get_private(player)->loaded_scripts);
+
+	trace_span = celluloid_trace_begin();
+	load_script_opts(player);
+	celluloid_trace_end("load-script-opts", trace_span);
+
+	// A new core starts out with mpv's own defaults again
+	g_clear_pointer(&get_private(player)->saved_readahead, g_free);
+
+	trace_span = celluloid_trace_begin();
+	apply_default_options(player);
+	apply_preload_options(player);
+	celluloid_trace_end("apply-default-options", trace_span);
+
+	trace_span = celluloid_trace_begin();
+	load_config_file(mpv);
+	celluloid_trace_end("load-config-file", trace_span);
+
+	apply_extra_options(player);
+	observe_properties(mpv);
+
+	trace_span = celluloid_trace_begin();
+	CELLULOID_MPV_CLASS(celluloid_player_parent_class)->initialize(mpv);
+	celluloid_trace_end("mpv-initialize", trace_span);
+
+	// Input bindings are loaded with define-section, which can only be
+	// used once mpv is initialized.
+	trace_span = celluloid_trace_begin();
+	load_input_config_file(player);
+	celluloid_trace_end("load-input-config-file", trace_span);
+
+	trace_span = celluloid_trace_begin();
+	load_scripts(player);
+	celluloid_trace_end("load-scripts", trace_span);
+}
+
+static gint
+apply_options_array_string(CelluloidMpv *mpv, const gchar *args)
+{
+	gint fail_count = 0;
+
+	while(args && *args)
+	{
+		gchar *key = NULL;
+		gchar *value = NULL;
+
+		args = parse_option(args, &key, &value);
+
+		if(key && *key)
+		{
+			g_debug("Applying option: --%s=%s", key, value);
+
+			if(celluloid_mpv_set_option_string(mpv, key, value) < 0)
+			{
+				fail_count++;
+
+				g_warning(	"Failed to apply option: --%s=%s\n",
+						key,
+						value );
+			}
+		}
+		else
+		{
+			g_warning("Failed to parse options");
+
+			args = NULL;
+			fail_count++;
+		}
+
+		g_free(key);
+		g_free(value);
+	}
+
+	return fail_count*(-1);
+}
+
+static void
+apply_extra_options(CelluloidPlayer *player)
+{
+	CelluloidPlayerPrivate *priv = get_private(player);
+	CelluloidMpv *mpv = CELLULOID_MPV(player);
+	gchar *extra_options = priv->extra_options;
+
+	g_debug("Applying extra mpv options: %s", extra_options);
+
+	/* Apply extra options */
+	if(extra_options && apply_options_array_string(mpv, extra_options) < 0)
+	{
+		const gchar *msg = _("Failed to apply one or more MPV options.");
+		g_signal_emit_by_name(mpv, "error", msg);
+	}
+
+	g_free(priv->applied_options);
+	priv->applied_options = g_strdup(extra_options);
+}
+
+static GHashTable *
+parse_options_table(const gchar *options)
+{
+	GHashTable *table =	g_hash_table_new_full
+				(g_str_hash, g_str_equal, g_free, g_free);
+
+	while(table && options && *options)
+	{
+		gchar *key = NULL;
+		gchar *value = NULL;
+
+		options = parse_option(options, &key, &value);
+
+		if(key && *key)
+		{
+			g_hash_table_replace(table, key, value);
+		}
+		else
+		{
+			g_hash_table_unref(table);
+			g_free(key);
+			g_free(value);
+
+			table = NULL;
+		}
+	}
+
+	return table;
+}
+
+static gboolean
+option_requires_reset(const gchar *name)
+{
+	gboolean result = FALSE;
+
+	if(g_str_has_prefix(name, "no-"))
+	{
+		name += 3;
+	}
+
+	for(gint i = 0; !result && init_only_options[i]; i++)
+	{
+		result = g_strcmp0(name, init_only_options[i]) == 0;
+	}
+
+	return result;
+}
+
+static gboolean
+apply_changed_options(CelluloidPlayer *player)
+{
+	CelluloidPlayerPrivate *priv = get_private(player);
+	CelluloidMpv *mpv = CELLULOID_MPV(player);
+	GHashTable *old_options = parse_options_table(priv->applied_options);
+	GHashTable *new_options = parse_options_table(priv->extra_options);
+	GPtrArray *changed = g_ptr_array_new();
+	gboolean result = old_options && new_options;
+	GHashTableIter iter;
+	gpointer key = NULL;
+	gpointer value = NULL;
+
+	// Classify every change before touching the core so that an option
+	// that needs a reset doesn't leave it half updated.
+	if(result)
+	{
+		g_hash_table_iter_init(&iter, new_options);
+	}
+
+	while(result && g_hash_table_iter_next(&iter, &key, &value))
+	{
+		gpointer old_value = NULL;
+
+		if(!g_hash_table_lookup_extended
+			(old_options, key, NULL, &old_value)
+		|| g_strcmp0(old_value, value) != 0)
+		{
+			result = !option_requires_reset(key);
+
+			g_ptr_array_add(changed, key);
+		}
+	}
+
+	if(result)
+	{
+		g_hash_table_iter_init(&iter, old_options);
+	}
+
+	// mpv has no way to unset an option, and reverting to mpv's own default
+	// would drop the value set by apply_default_options() or the config
+	// file, so removing an option always takes a full reset.
+	while(result && g_hash_table_iter_next(&iter, &key, NULL))
+	{
+		result = g_hash_table_contains(new_options, key);
+	}
+
+	for(guint i = 0; result && i < changed->len; i++)
+	{
+		const gchar *name = g_ptr_array_index(changed, i);
+		const gchar *new_value = g_hash_table_lookup(new_options, name);
+
+		g_debug("Applying option at runtime: --%s=%s", name, new_value);
+
+		result =	celluloid_mpv_set_option_string
+				(mpv, name, new_value) >= 0;
+	}
+
+	g_ptr_array_free(changed, TRUE);
+
+	if(new_options)
+	{
+		g_hash_table_unref(new_options);
+	}
+
+	if(old_options)
+	{
+		g_hash_table_unref(old_options);
+	}
+
+	return result;
+}
+
+static gboolean
+scripts_removed(CelluloidPlayer *player)
+{
+	CelluloidPlayerPrivate *priv = get_private(player);
+	gchar *path = get_scripts_dir_path();
+	GDir *dir = g_dir_open(path, 0, NULL);
+	GHashTable *scripts =	g_hash_table_new_full
+				(g_str_hash, g_str_equal, g_free, NULL);
+	gboolean result = FALSE;
+	GHashTableIter iter;
+	gpointer key = NULL;
+
+	if(dir)
+	{
+		const gchar *name = g_dir_read_name(dir);
+
+		while(name)
+		{
+			g_hash_table_add
+				(scripts, g_build_filename(path, name, NULL));
+
+			name = g_dir_read_name(dir);
+		}
+
+		g_dir_close(dir);
+	}
+
+	g_hash_table_iter_init(&iter, priv->loaded_scripts);
+
+	while(!result && g_hash_table_iter_next(&iter, &key, NULL))
+	{
+		result = !g_hash_table_contains(scripts, key);
+	}
+
+	g_hash_table_unref(scripts);
+	g_free(path);
+
+	return result;
+}
+
+static void
+load_file(CelluloidMpv *mpv, const gchar *uri, gboolean append)
+{
+	CelluloidPlayer *player = CELLULOID_PLAYER(mpv);
+	CelluloidPlayerPrivate *priv = get_private(mpv);
+	gboolean ready = FALSE;
+	gboolean idle_active =	celluloid_mpv_get_mirrored_flag
+				(mpv, "idle-active");
+
+	g_object_get(mpv, "ready", &ready, NULL);
+
+	if(idle_active || !ready)
+	{
+		if(!append)
+		{
+			priv->new_file = TRUE;
+			g_ptr_array_set_size(priv->playlist, 0);
+		}
+
+		add_file_to_playlist(player, uri);
+	}
+	else
+	{
+		if(!append)
+		{
+			priv->new_file = TRUE;
+			priv->loaded = FALSE;
+		}
+
+		CELLULOID_MPV_CLASS(celluloid_player_parent_class)
+			->load_file(mpv, uri, append);
+	}
+
+	/* Playlist items added when mpv is idle doesn't get added directly to
+	 * its internal playlist, so the property change signal won't be fired.
+	 * We need to emit notify signal here manually to ensure that the
+	 * playlist widget gets updated.
+	 */
+	if(idle_active)
+	{
+		g_object_notify(G_OBJECT(player), "playlist");
+	}
+}
+
+static void
+reset(CelluloidMpv *mpv)
+{
+	gboolean idle_active =	celluloid_mpv_get_mirrored_flag
+				(mpv, "idle-active");
+	gint64 playlist_pos =	celluloid_mpv_get_mirrored_int64
+				(mpv, "playlist-pos");
+	gdouble volume =	celluloid_mpv_get_mirrored_double
+				(mpv, "volume");
 
 	CELLULOID_MPV_CLASS(celluloid_player_parent_class)->reset(mpv);
 
@@ -750,116 +1540,353 @@ reset(CelluloidMpv *mpv)
 	celluloid_mpv_set_property(mpv, "volume", MPV_FORMAT_DOUBLE, &volume);
 }
 
+static gchar *
+normalize_keystr(const gchar *keystr)
+{
+	// Modifiers are emitted in the same order mpv uses when it prints key
+	// names, so normalized strings from both sides compare equal.
+	const gchar *mod_map[] = {"Shift", "Ctrl", "Alt", "Meta", NULL};
+	const gchar *key = keystr;
+	const gchar *sep = NULL;
+	GString *buf = g_string_new(NULL);
+	guint mods = 0;
+	gboolean done = FALSE;
+
+	// The key itself may be '+', so a trailing '+' is never a separator.
+	while(!done && (sep = strchr(key, '+')) && sep[1])
+	{
+		const gsize len = (gsize)(sep - key);
+		gboolean found = FALSE;
+
+		for(guint i = 0; !found && mod_map[i]; i++)
+		{
+			found =	strlen(mod_map[i]) == len &&
+				g_ascii_strncasecmp(key, mod_map[i], len) == 0;
+
+			if(found)
+			{
+				mods |= 1u << i;
+			}
+		}
+
+		done = !found;
+		key = found ? sep + 1 : key;
+	}
+
+	for(guint i = 0; mod_map[i]; i++)
+	{
+		if(mods & (1u << i))
+		{
+			g_string_append(buf, mod_map[i]);
+			g_string_append_c(buf, '+');
+		}
+	}
+
+	// Single characters are case-sensitive, but named keys are not.
+	if(g_utf8_strlen(key, -1) > 1)
+	{
+		gchar *upper = g_ascii_strup(key, -1);
+
+		g_string_append(buf, upper);
+		g_free(upper);
+	}
+	else
+	{
+		g_string_append(buf, key);
+	}
+
+	return g_string_free(buf, FALSE);
+}
+
 static void
 load_input_conf(CelluloidPlayer *player, const gchar *input_conf)
 {
-	CelluloidPlayerPrivate *priv = get_private(player);
 	const gchar *default_keybinds[] = DEFAULT_KEYBINDS;
-	gchar *tmp_path;
-	FILE *tmp_file;
-	gint tmp_fd;
+	GString *contents = g_string_new(NULL);
 
-	if(priv->tmp_input_config)
+	for(gint i = 0; default_keybinds[i]; i++)
 	{
-		g_unlink(priv->tmp_input_config);
-		g_free(priv->tmp_input_config);
+		g_string_append(contents, default_keybinds[i]);
+		g_string_append_c(contents, '\n');
 	}
 
-	tmp_fd = g_file_open_tmp("."BIN_NAME"-XXXXXX", &tmp_path, NULL);
-	tmp_file = fdopen(tmp_fd, "w");
-	priv->tmp_input_config = tmp_path;
-
-	if(!tmp_file)
+	if(input_conf && *input_conf)
 	{
-		g_warning("Failed to open temporary input config file");
-		return;
+		GFile *file = g_file_new_for_uri(input_conf);
+		GError *error = NULL;
+		gchar *data = NULL;
+		gsize length = 0;
+
+		g_file_load_contents(file, NULL, &data, &length, NULL, &error);
+
+		if(error)
+		{
+			g_warning(	"Cannot open input config file %s: %s",
+					input_conf,
+					error->message );
+
+			g_error_free(error);
+		}
+		else
+		{
+			// Bindings defined later in the section take precedence,
+			// so the user's bindings override the default ones.
+			g_string_append_len(contents, data, (gssize)length);
+			g_string_append_c(contents, '\n');
+
+			g_info("Loaded input config file: %s", input_conf);
+		}
+
+		g_object_unref(file);
+		g_free(data);
 	}
 
-	for(gint i = 0; default_keybinds[i]; i++)
+	// mpv doesn't load an input.conf of its own here since config is off
+	// and config-dir points at Celluloid's directory. Forcing the section
+	// keeps these bindings above the default ones that scripts define.
+	const gchar *define_cmd[] =	{	"define-section",
+						INPUT_SECTION_NAME,
+						contents->str,
+						"force",
+						NULL };
+	const gchar *enable_cmd[] =	{	"enable-section",
+						INPUT_SECTION_NAME,
+						NULL };
+
+	celluloid_mpv_command(CELLULOID_MPV(player), define_cmd);
+	celluloid_mpv_command(CELLULOID_MPV(player), enable_cmd);
+
+	update_input_bindings(player);
+
+	g_string_free(contents, TRUE);
+}
+
+static void
+monitor_input_conf(CelluloidPlayer *player, const gchar *input_conf)
+{
+	CelluloidPlayerPrivate *priv = get_private(player);
+
+	if(g_strcmp0(input_conf, priv->input_config_uri) != 0)
 	{
-		const gsize len = strlen(default_keybinds[i]);
-		gsize write_size = fwrite(default_keybinds[i], len, 1, tmp_file);
-		gint rc = fputc('\n', tmp_file);
+		if(priv->input_config_monitor)
+		{
+			g_signal_handlers_disconnect_by_data
+				(priv->input_config_monitor, player);
+			g_clear_object(&priv->input_config_monitor);
+		}
 
-		if(write_size != 1 || rc != '\n')
+		g_free(priv->input_config_uri);
+		priv->input_config_uri = g_strdup(input_conf);
+
+		if(input_conf && *input_conf)
 		{
-			g_error(	"Error writing default keybindings to "
-					"temporary input config file" );
+			GFile *file = g_file_new_for_uri(input_conf);
+			GError *error = NULL;
+
+			priv->input_config_monitor =
+				g_file_monitor_file
+				(file, G_FILE_MONITOR_NONE, NULL, &error);
+
+			if(error)
+			{
+				g_warning(	"Failed to monitor input config "
+						"file %s: %s",
+						input_conf,
+						error->message );
+
+				g_error_free(error);
+			}
+			else
+			{
+				g_signal_connect
+					(	priv->input_config_monitor,
+						"changed",
+						G_CALLBACK(input_conf_changed_handler),
+						player );
+			}
+
+			g_object_unref(file);
 		}
 	}
+}
 
-	g_debug("Using temporary input config file: %s", tmp_path);
+static void
+update_input_bindings(CelluloidPlayer *player)
+{
+	GHashTable *input_bindings = get_private(player)->input_bindings;
+	mpv_node bindings_node = {0};
+	mpv_node_list *bindings_array = NULL;
 
-	celluloid_mpv_set_option_string
-		(CELLULOID_MPV(player), "input-conf", tmp_path);
+	const gint err =
+		celluloid_mpv_get_property
+		(	CELLULOID_MPV(player),
+			"input-bindings",
+			MPV_FORMAT_NODE,
+			&bindings_node );
 
-	if(input_conf && strlen(input_conf) > 0)
+	g_hash_table_remove_all(input_bindings);
+
+	if(	err == MPV_ERROR_SUCCESS &&
+		bindings_node.format == MPV_FORMAT_NODE_ARRAY )
+	{
+		bindings_array = bindings_node.u.list;
+	}
+	else
 	{
-		const gsize buf_size = 65536;
-		void *buf = g_malloc(buf_size);
-		GFile *src_file = g_file_new_for_uri(input_conf);
-		GFileInputStream *src_stream = g_file_read(src_file, NULL, NULL);
-		gsize read_size = buf_size;
+		g_warning(	"Failed to get property \"input-bindings\": %s (%d)",
+				mpv_error_string(err),
+				err );
+	}
+
+	for(int i = 0; bindings_array && i < bindings_array->num; i++)
+	{
+		mpv_node *binding_node = &bindings_array->values[i];
+		const gchar *key = NULL;
+		const gchar *cmd = NULL;
 
-		if(!src_stream)
+		if(binding_node->format != MPV_FORMAT_NODE_MAP)
 		{
-			g_warning(	"Cannot open input config file: %s",
-					input_conf );
+			g_warning("Input binding is not a map");
+			continue;
 		}
 
-		while(src_stream && read_size == buf_size)
+		mpv_node_list *binding_map = binding_node->u.list;
+
+		for(int j = 0; j < binding_map->num; j++)
 		{
-			read_size =
-				(gsize)
-				g_input_stream_read
-				(G_INPUT_STREAM(src_stream), buf, buf_size, NULL, NULL);
+			const gchar *map_key = binding_map->keys[j];
+			mpv_node *value_node = &binding_map->values[j];
 
-			if(read_size != fwrite(buf, 1, read_size, tmp_file))
+			if(value_node->format != MPV_FORMAT_STRING)
 			{
-				g_error(	"Error writing requested input "
-						"config file to temporary "
-						"input config file" );
+				continue;
 			}
+
+			if(g_strcmp0(map_key, "key") == 0)
+			{
+				key = value_node->u.string;
+			}
+			else if(g_strcmp0(map_key, "cmd") == 0)
+			{
+				cmd = value_node->u.string;
+			}
+		}
+
+		if(key)
+		{
+			g_hash_table_replace(	input_bindings,
+						normalize_keystr(key),
+						g_strdup(cmd ? cmd : "") );
+		}
+		else
+		{
+			g_warning("Input binding has no key");
 		}
+	}
+
+	g_debug("Loaded %u input bindings", g_hash_table_size(input_bindings));
+
+	if(err == MPV_ERROR_SUCCESS)
+	{
+		mpv_free_node_contents(&bindings_node);
+	}
+}
+
+static void
+input_conf_changed_handler(	GFileMonitor *monitor,
+				GFile *file,
+				GFile *other_file,
+				GFileMonitorEvent event_type,
+				gpointer data )
+{
+	CelluloidPlayerPrivate *priv = get_private(data);
+
+	if(	event_type == G_FILE_MONITOR_EVENT_CHANGES_DONE_HINT ||
+		event_type == G_FILE_MONITOR_EVENT_CREATED ||
+		event_type == G_FILE_MONITOR_EVENT_DELETED )
+	{
+		g_info(	"Input config file changed. Reloading %s",
+			priv->input_config_uri );
+
+		load_input_conf(data, priv->input_config_uri);
+	}
+}
+
+static gchar *
+get_config_file_path(void)
+{
+	GSettings *settings = g_settings_new(CONFIG_ROOT);
+	gchar *path = NULL;
+
+	if(g_settings_get_boolean(settings, "mpv-config-enable"))
+	{
+		gchar *mpv_conf =
+			g_settings_get_string(settings, "mpv-config-file");
+		GFile *file = g_file_new_for_uri(mpv_conf);
+
+		path = g_file_get_path(file);
 
-		g_info("Loaded input config file: %s", input_conf);
+		g_object_unref(file);
+		g_free(mpv_conf);
+	}
+
+	g_object_unref(settings);
+
+	return path;
+}
 
-		g_clear_object(&src_stream);
-		g_object_unref(src_file);
-		g_free(buf);
+static gchar *
+get_config_file_checksum(const gchar *path)
+{
+	gchar *contents = NULL;
+	gsize length = 0;
+	gchar *checksum = NULL;
+
+	if(path && g_file_get_contents(path, &contents, &length, NULL))
+	{
+		checksum =	g_compute_checksum_for_data
+				(G_CHECKSUM_SHA256, (guchar *)contents, length);
 	}
 
-	fclose(tmp_file);
+	g_free(contents);
+
+	return checksum;
 }
 
 static void
 load_config_file(CelluloidMpv *mpv)
 {
+	CelluloidPlayerPrivate *priv = get_private(mpv);
 	GSettings *settings = g_settings_new(CONFIG_ROOT);
 
+	g_clear_pointer(&priv->applied_config_file, g_free);
+	g_clear_pointer(&priv->applied_config_checksum, g_free);
+
 	if(g_settings_get_boolean(settings, "mpv-config-enable"))
 	{
 		gchar *mpv_conf =
 			g_settings_get_string(settings, "mpv-config-file");
 
-		GFile *file = g_file_new_for_uri(mpv_conf);
-		gchar *path = g_file_get_path(file);
-
 		g_info("Loading mpv config file: %s", mpv_conf);
 
-		if(path)
-		{
-			g_debug("mpv config file path: %s", path);
-			celluloid_mpv_load_config_file(mpv, path);
+		priv->applied_config_file = get_config_file_path();
 
-			g_free(path);
+		if(priv->applied_config_file)
+		{
+			priv->applied_config_checksum =
+				get_config_file_checksum
+				(priv->applied_config_file);
+
+			g_debug(	"mpv config file path: %s",
+					priv->applied_config_file );
+			celluloid_mpv_load_config_file
+				(mpv, priv->applied_config_file);
 		}
 		else
 		{
 			g_warning("Failed to load mpv config file");
 		}
 
-		g_object_unref(file);
 		g_free(mpv_conf);
 	}
 
@@ -881,6 +1908,7 @@ load_input_config_file(CelluloidPlayer *player)
 	}
 
 	load_input_conf(player, input_conf);
+	monitor_input_conf(player, input_conf);
 
 	g_free(input_conf);
 	g_object_unref(settings);
@@ -1004,6 +2032,7 @@ load_script_opts(CelluloidPlayer *player)
 static void
 load_scripts(CelluloidPlayer *player)
 {
+	CelluloidPlayerPrivate *priv = get_private(player);
 	gchar *path = get_scripts_dir_path();
 	GDir *dir = g_dir_open(path, 0, NULL);
 
@@ -1016,12 +2045,25 @@ load_scripts(CelluloidPlayer *player)
 			gchar *full_path = g_build_filename(path, name, NULL);
 			const gchar *cmd[] = {"load-script", full_path, NULL};
 
-			g_info("Loading script: %s", full_path);
-			celluloid_mpv_command(CELLULOID_MPV(player), cmd);
+			/* Scripts are loaded asynchronously so that mpv can
+			 * start playback without waiting for the main loop to
+			 * issue every load-script command.
+			 */
+			if(!g_hash_table_contains(priv->loaded_scripts, full_path))
+			{
+				g_info("Loading script: %s", full_path);
+				celluloid_mpv_command_async
+					(CELLULOID_MPV(player), cmd);
 
-			name = g_dir_read_name(dir);
+				g_hash_table_add
+					(priv->loaded_scripts, full_path);
+			}
+			else
+			{
+				g_free(full_path);
+			}
 
-			g_free(full_path);
+			name = g_dir_read_name(dir);
 		}
 
 		g_dir_close(dir);
@@ -1171,14 +2213,12 @@ static void
 update_playlist(CelluloidPlayer *player)
 {
 	CelluloidPlayerPrivate *priv;
-	GSettings *settings;
 	gboolean prefetch_metadata;
 	const mpv_node_list *org_list;
 	mpv_node playlist;
 
 	priv = get_private(player);
-	settings = g_settings_new(CONFIG_ROOT);
-	prefetch_metadata = g_settings_get_boolean(settings, "prefetch-metadata");
+	prefetch_metadata = celluloid_settings_snapshot_get()->prefetch_metadata;
 
 	g_ptr_array_set_size(priv->playlist, 0);
 
@@ -1202,72 +2242,157 @@ update_playlist(CelluloidPlayer *player)
 
 				cache_entry =	celluloid_metadata_cache_lookup
 						(priv->cache, entry->filename);
-				entry->title =	g_strdup(cache_entry->title);
+				entry->title =	celluloid_acquire_string
+						(cache_entry->title);
 				entry->duration = cache_entry->duration;
 			}
 
-			g_ptr_array_add(priv->playlist, entry);
+			g_ptr_array_add(priv->playlist, entry);
+		}
+
+		mpv_free_node_contents(&playlist);
+		g_object_notify(G_OBJECT(player), "playlist");
+	}
+
+
+	if(prefetch_metadata)
+	{
+		celluloid_metadata_cache_load_playlist
+			(priv->cache, player, priv->playlist);
+	}
+}
+
+static void
+update_metadata(CelluloidPlayer *player, const mpv_node *node)
+{
+	CelluloidPlayerPrivate *priv = get_private(player);
+	GPtrArray *metadata = priv->metadata;
+	const mpv_node_list *list = NULL;
+	gboolean changed = FALSE;
+	guint count = 0;
+
+	if(node && node->format == MPV_FORMAT_NODE_MAP)
+	{
+		list = node->u.list;
+	}
+
+	// Live streams change one or two tags at a time, so existing entries
+	// are kept and only the ones that differ are touched.
+	for(gint i = 0; list && i < list->num; i++)
+	{
+		const gchar *key = list->keys[i];
+		const mpv_node *value = &list->values[i];
+		CelluloidMetadataEntry *entry = NULL;
+
+		if(value->format != MPV_FORMAT_STRING)
+		{
+			g_warning(	"Ignored metadata field %s "
+					"with unexpected format %d",
+					key,
+					value->format );
+
+			continue;
+		}
+
+		if(count < metadata->len)
+		{
+			entry = g_ptr_array_index(metadata, count);
+		}
+
+		if(!entry || g_strcmp0(entry->key, key) != 0)
+		{
+			guint j = count + 1;
+
+			while(	j < metadata->len &&
+				g_strcmp0
+				(	((CelluloidMetadataEntry *)
+					g_ptr_array_index(metadata, j))->key,
+					key ) != 0 )
+			{
+				j++;
+			}
+
+			if(j < metadata->len)
+			{
+				entry = g_ptr_array_steal_index(metadata, j);
+			}
+			else
+			{
+				entry =	celluloid_metadata_entry_new
+					(key, value->u.string);
+			}
+
+			g_ptr_array_insert(metadata, (gint)count, entry);
+			changed = TRUE;
+		}
+
+		if(g_strcmp0(entry->value, value->u.string) != 0)
+		{
+			g_free(entry->value);
+			entry->value = g_strdup(value->u.string);
+			changed = TRUE;
 		}
 
-		mpv_free_node_contents(&playlist);
-		g_object_notify(G_OBJECT(player), "playlist");
+		count++;
 	}
 
-
-	if(prefetch_metadata)
+	if(metadata->len > count)
 	{
-		celluloid_metadata_cache_load_playlist
-			(priv->cache, priv->playlist);
+		g_ptr_array_set_size(metadata, (gint)count);
+		changed = TRUE;
 	}
 
-	g_object_unref(settings);
+	if(changed)
+	{
+		notify_metadata(player);
+	}
 }
 
 static void
-update_metadata(CelluloidPlayer *player)
+notify_metadata(CelluloidPlayer *player)
 {
 	CelluloidPlayerPrivate *priv = get_private(player);
-	mpv_node_list *org_list = NULL;
-	mpv_node metadata;
+	const gint interval =
+		celluloid_settings_snapshot_get()->metadata_update_interval;
 
-	g_ptr_array_set_size(priv->metadata, 0);
-
-	celluloid_mpv_get_property
-		(CELLULOID_MPV(player), "metadata", MPV_FORMAT_NODE, &metadata);
-
-	org_list = metadata.u.list;
+	// Every notification makes the view and MPRIS rebuild everything they
+	// show, so changes that arrive within the interval after the first one
+	// are combined.
+	if(interval <= 0)
+	{
+		g_object_notify(G_OBJECT(player), "metadata");
+	}
+	else if(priv->metadata_update_id == 0)
+	{
+		g_object_notify(G_OBJECT(player), "metadata");
 
-	if(metadata.format == MPV_FORMAT_NODE_MAP)
+		priv->metadata_update_id =
+			g_timeout_add(	(guint)interval,
+					metadata_update_handler,
+					player );
+	}
+	else
 	{
-		for(gint i = 0; i < org_list->num; i++)
-		{
-			const gchar *key;
-			mpv_node value;
+		priv->metadata_dirty = TRUE;
+	}
+}
 
-			key = org_list->keys[i];
-			value = org_list->values[i];
+static gboolean
+metadata_update_handler(gpointer data)
+{
+	CelluloidPlayerPrivate *priv = get_private(data);
 
-			if(value.format == MPV_FORMAT_STRING)
-			{
-				CelluloidMetadataEntry *entry;
+	if(priv->metadata_dirty)
+	{
+		priv->metadata_dirty = FALSE;
+		g_object_notify(G_OBJECT(data), "metadata");
 
-				entry =	celluloid_metadata_entry_new
-					(key, value.u.string);
+		return G_SOURCE_CONTINUE;
+	}
 
-				g_ptr_array_add(priv->metadata, entry);
-			}
-			else
-			{
-				g_warning(	"Ignored metadata field %s "
-						"with unexpected format %d",
-						key,
-						value.format );
-			}
-		}
+	priv->metadata_update_id = 0;
 
-		mpv_free_node_contents(&metadata);
-		g_object_notify(G_OBJECT(player), "metadata");
-	}
+	return G_SOURCE_REMOVE;
 }
 
 static void
@@ -1302,6 +2427,146 @@ update_chapter_list(CelluloidPlayer *player)
 	}
 }
 
+static void
+observe_cache_state(CelluloidPlayer *player)
+{
+	celluloid_mpv_observe_property(	CELLULOID_MPV(player),
+					CACHE_STATE_REPLY_USERDATA,
+					"demuxer-cache-state",
+					MPV_FORMAT_NODE );
+
+	get_private(player)->cache_state_observed = TRUE;
+}
+
+static void
+update_buffered_ranges(CelluloidPlayer *player, const mpv_node *node)
+{
+	CelluloidPlayerPrivate *priv = get_private(player);
+	const mpv_node_list *ranges = NULL;
+	gboolean bof_cached = FALSE;
+	gboolean eof_cached = FALSE;
+
+	g_array_set_size(priv->buffered_ranges, 0);
+
+	if(node && node->format == MPV_FORMAT_NODE_MAP)
+	{
+		const mpv_node_list *map = node->u.list;
+
+		for(gint i = 0; i < map->num; i++)
+		{
+			const gchar *key = map->keys[i];
+			const mpv_node *value = &map->values[i];
+
+			if(	g_strcmp0(key, "seekable-ranges") == 0 &&
+				value->format == MPV_FORMAT_NODE_ARRAY )
+			{
+				ranges = value->u.list;
+			}
+			else if(	g_strcmp0(key, "bof-cached") == 0 &&
+					value->format == MPV_FORMAT_FLAG )
+			{
+				bof_cached = value->u.flag;
+			}
+			else if(	g_strcmp0(key, "eof-cached") == 0 &&
+					value->format == MPV_FORMAT_FLAG )
+			{
+				eof_cached = value->u.flag;
+			}
+		}
+	}
+
+	for(gint i = 0; ranges && i < ranges->num; i++)
+	{
+		const mpv_node *range = &ranges->values[i];
+		CelluloidTimeRange time_range = {0, 0};
+
+		if(range->format != MPV_FORMAT_NODE_MAP)
+		{
+			continue;
+		}
+
+		for(gint j = 0; j < range->u.list->num; j++)
+		{
+			const gchar *key = range->u.list->keys[j];
+			const mpv_node *value = &range->u.list->values[j];
+
+			if(value->format != MPV_FORMAT_DOUBLE)
+			{
+				continue;
+			}
+
+			if(g_strcmp0(key, "start") == 0)
+			{
+				time_range.start = value->u.double_;
+			}
+			else if(g_strcmp0(key, "end") == 0)
+			{
+				time_range.end = value->u.double_;
+			}
+		}
+
+		if(time_range.end > time_range.start)
+		{
+			g_array_append_val(priv->buffered_ranges, time_range);
+		}
+	}
+
+	// Once the whole file is in the cache, the ranges can't change anymore
+	// so there's no point in having mpv send further updates until the
+	// next file starts.
+	if(bof_cached && eof_cached && priv->buffered_ranges->len == 1)
+	{
+		g_debug("File is fully cached; unobserving demuxer-cache-state");
+
+		celluloid_mpv_unobserve_property
+			(CELLULOID_MPV(player), CACHE_STATE_REPLY_USERDATA);
+		priv->cache_state_observed = FALSE;
+	}
+
+	notify_buffered_ranges(player);
+}
+
+static void
+notify_buffered_ranges(CelluloidPlayer *player)
+{
+	CelluloidPlayerPrivate *priv = get_private(player);
+
+	// mpv may update the cache state many times per second while
+	// buffering. Let the first update through immediately, then hold back
+	// the rest until the interval passes.
+	if(priv->buffered_ranges_update_id == 0)
+	{
+		g_object_notify(G_OBJECT(player), "buffered-ranges");
+
+		priv->buffered_ranges_update_id =
+			g_timeout_add(	BUFFERED_RANGES_UPDATE_INTERVAL,
+					buffered_ranges_update_handler,
+					player );
+	}
+	else
+	{
+		priv->buffered_ranges_dirty = TRUE;
+	}
+}
+
+static gboolean
+buffered_ranges_update_handler(gpointer data)
+{
+	CelluloidPlayerPrivate *priv = get_private(data);
+
+	if(priv->buffered_ranges_dirty)
+	{
+		priv->buffered_ranges_dirty = FALSE;
+		g_object_notify(G_OBJECT(data), "buffered-ranges");
+
+		return G_SOURCE_CONTINUE;
+	}
+
+	priv->buffered_ranges_update_id = 0;
+
+	return G_SOURCE_REMOVE;
+}
+
 static void
 update_track_list(CelluloidPlayer *player)
 {
@@ -1349,9 +2614,9 @@ cache_update_handler(	CelluloidMetadataCache *cache,
 			CelluloidMetadataCacheEntry *cache_entry =
 				celluloid_metadata_cache_lookup(cache, uri);
 
-			g_free(entry->title);
+			celluloid_release_string(entry->title);
 
-			entry->title = g_strdup(cache_entry->title);
+			entry->title = celluloid_acquire_string(cache_entry->title);
 			entry->duration = cache_entry->duration;
 
 			g_signal_emit_by_name
@@ -1360,6 +2625,34 @@ cache_update_handler(	CelluloidMetadataCache *cache,
 	}
 }
 
+static void
+set_metadata_cache(CelluloidPlayer *player, CelluloidMetadataCache *cache)
+{
+	CelluloidPlayerPrivate *priv = get_private(player);
+
+	if(priv->cache != cache)
+	{
+		// The cache may be shared with other players, so only the
+		// entries referenced by this one are released.
+		if(priv->cache)
+		{
+			g_signal_handlers_disconnect_by_data(priv->cache, player);
+			celluloid_metadata_cache_release(priv->cache, player);
+			g_clear_object(&priv->cache);
+		}
+
+		if(cache)
+		{
+			priv->cache = g_object_ref(cache);
+
+			g_signal_connect(	priv->cache,
+						"update",
+						G_CALLBACK(cache_update_handler),
+						player );
+		}
+	}
+}
+
 static void
 mount_added_handler(GVolumeMonitor *monitor, GMount *mount, gpointer data)
 {
@@ -1454,6 +2747,45 @@ guess_content_handler(GMount *mount, GAsyncResult *res, gpointer data)
 	g_strfreev(types);
 }
 
+static gboolean
+setup_volume_monitor(gpointer data)
+{
+	CelluloidPlayerPrivate *priv = get_private(data);
+	gint64 trace_span = celluloid_trace_begin();
+
+	priv->monitor_setup_id = 0;
+	priv->monitor = g_volume_monitor_get();
+
+	g_signal_connect(	priv->monitor,
+				"mount-added",
+				G_CALLBACK(mount_added_handler),
+				data );
+
+	// We need to connect to volume-removed instead of mount-removed because
+	// we need to use the path of the volume to figure out which entry in
+	// disc_list to remove. However, by the time mount-removed fires, the
+	// mount would no longer be associated with its volume. This works fine
+	// since we only add mounts with associated volumes to disc_list.
+	g_signal_connect(	priv->monitor,
+				"volume-removed",
+				G_CALLBACK(volume_removed_handler),
+				data );
+
+	// Emit mount-added to fill disc_list using mounts that already exist.
+	GList *mount_list = g_volume_monitor_get_mounts(priv->monitor);
+
+	for(GList *cur = mount_list; cur; cur = g_list_next(cur))
+	{
+		g_signal_emit_by_name(priv->monitor, "mount-added", cur->data);
+	}
+
+	g_list_free_full(mount_list, g_object_unref);
+
+	celluloid_trace_end("setup-volume-monitor", trace_span);
+
+	return G_SOURCE_REMOVE;
+}
+
 static void
 celluloid_player_class_init(CelluloidPlayerClass *klass)
 {
@@ -1495,6 +2827,13 @@ celluloid_player_class_init(CelluloidPlayerClass *klass)
 			G_PARAM_READABLE );
 	g_object_class_install_property(obj_class, PROP_CHAPTER_LIST, pspec);
 
+	pspec = g_param_spec_pointer
+		(	"buffered-ranges",
+			"Buffered ranges",
+			"Time ranges of the current file that are in the demuxer cache",
+			G_PARAM_READABLE );
+	g_object_class_install_property(obj_class, PROP_BUFFERED_RANGES, pspec);
+
 	pspec = g_param_spec_pointer
 		(	"track-list",
 			"Track list",
@@ -1517,6 +2856,15 @@ celluloid_player_class_init(CelluloidPlayerClass *klass)
 			G_PARAM_READWRITE );
 	g_object_class_install_property(obj_class, PROP_EXTRA_OPTIONS, pspec);
 
+	pspec = g_param_spec_object
+		(	"metadata-cache",
+			"Metadata cache",
+			"Cache of playlist entry metadata, possibly shared with "
+			"other players",
+			CELLULOID_TYPE_METADATA_CACHE,
+			G_PARAM_READWRITE );
+	g_object_class_install_property(obj_class, PROP_METADATA_CACHE, pspec);
+
 	g_signal_new(	"autofit",
 			G_TYPE_FROM_CLASS(klass),
 			G_SIGNAL_RUN_FIRST,
@@ -1542,9 +2890,10 @@ static void
 celluloid_player_init(CelluloidPlayer *player)
 {
 	CelluloidPlayerPrivate *priv = get_private(player);
+	CelluloidMetadataCache *cache = celluloid_metadata_cache_new();
 
-	priv->cache =		celluloid_metadata_cache_new();
-	priv->monitor =		g_volume_monitor_get();
+	priv->cache =		NULL;
+	priv->monitor =		NULL;
 	priv->playlist =	g_ptr_array_new_with_free_func
 				((GDestroyNotify)celluloid_playlist_entry_free);
 	priv->metadata =	g_ptr_array_new_with_free_func
@@ -1555,45 +2904,82 @@ celluloid_player_init(CelluloidPlayer *player)
 				((GDestroyNotify)celluloid_track_free);
 	priv->disc_list =	g_ptr_array_new_with_free_func
 				((GDestroyNotify)celluloid_disc_free);
-	priv->log_levels =	g_hash_table_new_full
-				(g_str_hash, g_str_equal, g_free, NULL);
+	priv->log_levels =	celluloid_log_levels_new();
+	priv->log_buffer =	celluloid_log_buffer_new(LOG_BUFFER_SIZE);
 	priv->script_options =	g_hash_table_new_full
 				(g_str_hash, g_str_equal, g_free, NULL);
 
 	priv->loaded = FALSE;
 	priv->new_file = TRUE;
 	priv->init_vo_config = TRUE;
-	priv->tmp_input_config = NULL;
+	priv->input_bindings =	g_hash_table_new_full
+				(g_str_hash, g_str_equal, g_free, g_free);
+	priv->input_config_monitor = NULL;
+	priv->input_config_uri = NULL;
 	priv->extra_options = NULL;
+	priv->applied_options = NULL;
+	priv->applied_config_file = NULL;
+	priv->applied_config_checksum = NULL;
+	priv->loaded_scripts =	g_hash_table_new_full
+				(g_str_hash, g_str_equal, g_free, NULL);
+	priv->preload_enable = FALSE;
+	priv->preload_cancellable = NULL;
+	priv->playlist_pos = -1;
+	priv->preload_pos = -1;
+	priv->transition_start = 0;
+	priv->transition_preloaded = FALSE;
+	priv->current_path = NULL;
+	priv->saved_readahead = NULL;
+	priv->duration = -1;
+	priv->time_remaining = -1;
+	priv->preload_check_id = 0;
+	priv->frame_drop_count = -1;
+	priv->stats_observed = FALSE;
+	priv->buffered_ranges =	g_array_new
+				(FALSE, FALSE, sizeof(CelluloidTimeRange));
+	priv->buffered_ranges_dirty = FALSE;
+	priv->buffered_ranges_update_id = 0;
+	priv->metadata_dirty = FALSE;
+	priv->metadata_update_id = 0;
+	priv->cache_state_observed = FALSE;
+
+	// Players get a private cache unless they're given a shared one
+	set_metadata_cache(player, cache);
+	g_object_unref(cache);
+
+	// Enumerating volumes may involve talking to the volume monitor
+	// service, and the disc list isn't needed until the user opens the
+	// menu, so defer it until the main loop has nothing better to do.
+	priv->monitor_setup_id =
+		g_idle_add_full(	G_PRIORITY_LOW,
+					setup_volume_monitor,
+					player,
+					NULL );
+}
 
-	g_signal_connect(	priv->cache,
-				"update",
-				G_CALLBACK(cache_update_handler),
-				player );
-	g_signal_connect(	priv->monitor,
-				"mount-added",
-				G_CALLBACK(mount_added_handler),
-				player );
+static void
+playlist_command_ready(GObject *source, GAsyncResult *result, gpointer data)
+{
+	GError *error = NULL;
 
-	// We need to connect to volume-removed instead of mount-removed because
-	// we need to use the path of the volume to figure out which entry in
-	// disc_list to remove. However, by the time mount-removed fires, the
-	// mount would no longer be associated with its volume. This works fine
-	// since we only add mounts with associated volumes to disc_list.
-	g_signal_connect(	priv->monitor,
-				"volume-removed",
-				G_CALLBACK(volume_removed_handler),
-				player );
+	if(!celluloid_mpv_command_finish(CELLULOID_MPV(source), result, &error))
+	{
+		g_warning("Failed to update playlist: %s", error->message);
+		g_error_free(error);
+	}
+}
 
-	// Emit mount-added to fill disc_list using mounts that already exist.
-	GList *mount_list = g_volume_monitor_get_mounts(priv->monitor);
+static void
+playlist_pos_ready(GObject *source, GAsyncResult *result, gpointer data)
+{
+	GError *error = NULL;
 
-	for(GList *cur = mount_list; cur; cur = g_list_next(cur))
+	if(!celluloid_mpv_set_property_finish
+		(CELLULOID_MPV(source), result, &error))
 	{
-		g_signal_emit_by_name(priv->monitor, "mount-added", cur->data);
+		g_info("Failed to set playlist position: %s", error->message);
+		g_error_free(error);
 	}
-
-	g_list_free_full(mount_list, g_object_unref);
 }
 
 CelluloidPlayer *
@@ -1608,15 +2994,19 @@ void
 celluloid_player_set_playlist_position(CelluloidPlayer *player, gint64 position)
 {
 	CelluloidMpv *mpv = CELLULOID_MPV(player);
-	gint64 playlist_pos = 0;
-
-	celluloid_mpv_get_property
-		(mpv, "playlist-pos", MPV_FORMAT_INT64, &playlist_pos);
+	gint64 playlist_pos =	celluloid_mpv_get_mirrored_int64
+				(mpv, "playlist-pos");
 
 	if(position != playlist_pos)
 	{
-		celluloid_mpv_set_property
-			(mpv, "playlist-pos", MPV_FORMAT_INT64, &position);
+		celluloid_mpv_set_property_async
+			(	mpv,
+				"playlist-pos",
+				MPV_FORMAT_INT64,
+				&position,
+				NULL,
+				playlist_pos_ready,
+				NULL );
 	}
 }
 
@@ -1624,7 +3014,7 @@ void
 celluloid_player_remove_playlist_entry(CelluloidPlayer *player, gint64 position)
 {
 	CelluloidMpv *mpv = CELLULOID_MPV(player);
-	gboolean idle_active =	celluloid_mpv_get_property_flag
+	gboolean idle_active =	celluloid_mpv_get_mirrored_flag
 				(mpv, "idle-active");
 
 	if(idle_active)
@@ -1636,13 +3026,14 @@ celluloid_player_remove_playlist_entry(CelluloidPlayer *player, gint64 position)
 	}
 	else
 	{
-		const gchar *cmd[] = {"playlist_remove", NULL, NULL};
+		const gchar *cmd[] = {"playlist-remove", NULL, NULL};
 		gchar *index_str =	g_strdup_printf
 					("%" G_GINT64_FORMAT, position);
 
 		cmd[1] = index_str;
 
-		celluloid_mpv_command(CELLULOID_MPV(player), cmd);
+		celluloid_mpv_command_async_full
+			(mpv, cmd, NULL, playlist_command_ready, NULL);
 		g_free(index_str);
 	}
 }
@@ -1653,7 +3044,7 @@ celluloid_player_move_playlist_entry(	CelluloidPlayer *player,
 					gint64 dst )
 {
 	CelluloidMpv *mpv = CELLULOID_MPV(player);
-	gboolean idle_active =	celluloid_mpv_get_property_flag
+	gboolean idle_active =	celluloid_mpv_get_mirrored_flag
 				(mpv, "idle-active");
 
 	if(idle_active)
@@ -1672,7 +3063,7 @@ celluloid_player_move_playlist_entry(	CelluloidPlayer *player,
 	}
 	else
 	{
-		const gchar *cmd[] =	{"playlist_move", NULL, NULL, NULL};
+		const gchar *cmd[] =	{"playlist-move", NULL, NULL, NULL};
 		gchar *src_str =	g_strdup_printf
 					("%" G_GINT64_FORMAT, (src > dst)?--src:src);
 		gchar *dst_str =	g_strdup_printf
@@ -1681,13 +3072,81 @@ celluloid_player_move_playlist_entry(	CelluloidPlayer *player,
 		cmd[1] = src_str;
 		cmd[2] = dst_str;
 
-		celluloid_mpv_command(CELLULOID_MPV(player), cmd);
+		celluloid_mpv_command_async_full
+			(mpv, cmd, NULL, playlist_command_ready, NULL);
 
 		g_free(src_str);
 		g_free(dst_str);
 	}
 }
 
+gboolean
+celluloid_player_apply_options(CelluloidPlayer *player)
+{
+	CelluloidPlayerPrivate *priv = get_private(player);
+	GSettings *settings = g_settings_new(CONFIG_ROOT);
+	gchar *config_file = get_config_file_path();
+	gchar *config_checksum = get_config_file_checksum(config_file);
+	gboolean preload_enable = FALSE;
+	gboolean ready = FALSE;
+	gboolean applied = FALSE;
+
+	preload_enable = g_settings_get_boolean(settings, "preload-next-enable");
+
+	g_object_get(player, "ready", &ready, NULL);
+
+	// The config file is compared by content as well as by path, since
+	// editing it in place doesn't change the setting.
+	applied =	ready &&
+			g_strcmp0(config_file, priv->applied_config_file) == 0 &&
+			g_strcmp0
+			(config_checksum, priv->applied_config_checksum) == 0 &&
+			!scripts_removed(player) &&
+			apply_changed_options(player);
+
+	if(applied)
+	{
+		g_info("Applied option changes without resetting mpv");
+
+		g_free(priv->applied_options);
+		priv->applied_options = g_strdup(priv->extra_options);
+
+		// Only touch the preload options if the setting itself was
+		// changed, so that values from the extra options are kept.
+		if(preload_enable != priv->preload_enable)
+		{
+			apply_preload_options(player);
+		}
+
+		load_input_config_file(player);
+		load_scripts(player);
+	}
+
+	g_object_unref(settings);
+	g_free(config_checksum);
+	g_free(config_file);
+
+	return applied;
+}
+
+const gchar *
+celluloid_player_lookup_input_binding(	CelluloidPlayer *player,
+					const gchar *keystr )
+{
+	GHashTable *input_bindings = get_private(player)->input_bindings;
+	const gchar *result = NULL;
+
+	if(keystr && g_hash_table_size(input_bindings) > 0)
+	{
+		gchar *normalized = normalize_keystr(keystr);
+
+		result = g_hash_table_lookup(input_bindings, normalized);
+		g_free(normalized);
+	}
+
+	return result;
+}
+
 void
 celluloid_player_set_log_level(	CelluloidPlayer *player,
 				const gchar *prefix,
@@ -1708,8 +3167,6 @@ celluloid_player_set_log_level(	CelluloidPlayer *player,
 			{"trace", MPV_LOG_LEVEL_TRACE},
 			{NULL, MPV_LOG_LEVEL_NONE} };
 
-	GHashTableIter iter;
-	gpointer iter_level = GINT_TO_POINTER(DEFAULT_LOG_LEVEL);
 	CelluloidPlayerPrivate *priv = get_private(player);
 	mpv_log_level max_level = DEFAULT_LOG_LEVEL;
 	gboolean found = FALSE;
@@ -1723,25 +3180,95 @@ celluloid_player_set_log_level(	CelluloidPlayer *player,
 
 	if(found && g_strcmp0(prefix, "all") != 0)
 	{
-		g_hash_table_replace(	priv->log_levels,
-					g_strdup(prefix),
-					GINT_TO_POINTER(level_map[i].level) );
+		celluloid_log_levels_set
+			(priv->log_levels, prefix, level_map[i].level);
 	}
 
-	max_level = level_map[i].level;
+	max_level =	celluloid_log_levels_get_max
+			(priv->log_levels, level_map[i].level);
 
-	g_hash_table_iter_init(&iter, priv->log_levels);
+	for(i = 0; level_map[i].level != max_level; i++);
+
+	celluloid_mpv_request_log_messages
+		(CELLULOID_MPV(player), level_map[i].name);
+}
+
+CelluloidLogBuffer *
+celluloid_player_get_log_buffer(CelluloidPlayer *player)
+{
+	return get_private(player)->log_buffer;
+}
 
-	while(g_hash_table_iter_next(&iter, NULL, &iter_level))
+void
+celluloid_player_set_stats_observed(CelluloidPlayer *player, gboolean observed)
+{
+	CelluloidPlayerPrivate *priv = get_private(player);
+
+	if(observed && !priv->stats_observed)
 	{
-		if(GPOINTER_TO_INT(iter_level) > (gint)max_level)
-		{
-			max_level = GPOINTER_TO_INT(iter_level);
-		}
+		observe_stats(player);
+	}
+	else if(!observed && priv->stats_observed)
+	{
+		CelluloidStats *stats =
+			celluloid_mpv_get_stats(CELLULOID_MPV(player));
+
+		celluloid_mpv_unobserve_property
+			(CELLULOID_MPV(player), STATS_REPLY_USERDATA);
+
+		// Don't leave stale values around for the next time the
+		// overlay is shown or the stats are dumped.
+		celluloid_stats_set_delayed_frame_count(stats, -1);
+		celluloid_stats_set_estimated_vf_fps(stats, -1);
+		celluloid_stats_set_cache_duration(stats, -1);
+		celluloid_stats_set_cache_buffering(stats, -1);
 	}
 
-	for(i = 0; level_map[i].level != max_level; i++);
+	priv->stats_observed = observed;
+}
 
-	celluloid_mpv_request_log_messages
-		(CELLULOID_MPV(player), level_map[i].name);
+/* Reads the properties that are only observed while the stats overlay is
+ * visible once, so that a dump taken while it is hidden is still complete.
+ */
+void
+celluloid_player_read_stats(CelluloidPlayer *player)
+{
+	CelluloidMpv *mpv = CELLULOID_MPV(player);
+	CelluloidStats *stats = celluloid_mpv_get_stats(mpv);
+	gint64 delayed_frame_count = -1;
+	gdouble estimated_vf_fps = -1;
+	gdouble cache_duration = -1;
+	gint64 cache_buffering = -1;
+
+	// The observed values are already current
+	if(get_private(player)->stats_observed)
+	{
+		return;
+	}
+
+	celluloid_mpv_get_property
+		(	mpv,
+			"vo-delayed-frame-count",
+			MPV_FORMAT_INT64,
+			&delayed_frame_count );
+	celluloid_mpv_get_property
+		(	mpv,
+			"estimated-vf-fps",
+			MPV_FORMAT_DOUBLE,
+			&estimated_vf_fps );
+	celluloid_mpv_get_property
+		(	mpv,
+			"demuxer-cache-duration",
+			MPV_FORMAT_DOUBLE,
+			&cache_duration );
+	celluloid_mpv_get_property
+		(	mpv,
+			"cache-buffering-state",
+			MPV_FORMAT_INT64,
+			&cache_buffering );
+
+	celluloid_stats_set_delayed_frame_count(stats, delayed_frame_count);
+	celluloid_stats_set_estimated_vf_fps(stats, estimated_vf_fps);
+	celluloid_stats_set_cache_duration(stats, cache_duration);
+	celluloid_stats_set_cache_buffering(stats, cache_buffering);
 }
@@ -23,6 +23,7 @@
 #include <glib-object.h>
 
 #include "celluloid-mpv.h"
+#include "celluloid-log-buffer.h"
 
 G_BEGIN_DECLS
 
@@ -51,11 +52,27 @@ celluloid_player_move_playlist_entry(	CelluloidPlayer *player,
 					gint64 src,
 					gint64 dst );
 
+gboolean
+celluloid_player_apply_options(CelluloidPlayer *player);
+
+const gchar *
+celluloid_player_lookup_input_binding(	CelluloidPlayer *player,
+					const gchar *keystr );
+
 void
 celluloid_player_set_log_level(	CelluloidPlayer *player,
 				const gchar *prefix,
 				const gchar *level );
 
+CelluloidLogBuffer *
+celluloid_player_get_log_buffer(CelluloidPlayer *player);
+
+void
+celluloid_player_set_stats_observed(CelluloidPlayer *player, gboolean observed);
+
+void
+celluloid_player_read_stats(CelluloidPlayer *player);
+
 G_END_DECLS
 
 #endif
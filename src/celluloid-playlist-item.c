@@ -42,8 +42,10 @@ finalize(GObject *gobject)
 {
 	CelluloidPlaylistItem *self = CELLULOID_PLAYLIST_ITEM(gobject);
 
-	g_free(self->title);
-	g_free(self->uri);
+	g_clear_pointer(&self->title, g_ref_string_release);
+	g_clear_pointer(&self->uri, g_ref_string_release);
+
+	G_OBJECT_CLASS(celluloid_playlist_item_parent_class)->finalize(gobject);
 }
 
 static void
@@ -71,11 +73,11 @@ celluloid_playlist_item_new_take(	gchar *title,
 {
 	CelluloidPlaylistItem *self;
 
-	self = g_object_new(CELLULOID_TYPE_PLAYLIST_ITEM, NULL);
-	self->title = title;
-	self->uri = uri;
-	self->duration = duration;
-	self->is_current = is_current;
+	self =	celluloid_playlist_item_new
+		(title, uri, duration, is_current);
+
+	g_free(title);
+	g_free(uri);
 
 	return self;
 }
@@ -86,8 +88,15 @@ celluloid_playlist_item_new(	const gchar *title,
 				gdouble duration,
 				gboolean is_current )
 {
-	return	celluloid_playlist_item_new_take
-		(g_strdup(title), g_strdup(uri), duration, is_current);
+	CelluloidPlaylistItem *self;
+
+	self = g_object_new(CELLULOID_TYPE_PLAYLIST_ITEM, NULL);
+	self->title = title ? g_ref_string_new_intern(title) : NULL;
+	self->uri = uri ? g_ref_string_new_intern(uri) : NULL;
+	self->duration = duration;
+	self->is_current = is_current;
+
+	return self;
 }
 
 CelluloidPlaylistItem *
@@ -96,8 +105,8 @@ celluloid_playlist_item_copy(CelluloidPlaylistItem *source)
 	CelluloidPlaylistItem *self;
 
 	self = g_object_new(CELLULOID_TYPE_PLAYLIST_ITEM, NULL);
-	self->title = source->title;
-	self->uri = source->uri;
+	self->title = source->title ? g_ref_string_acquire(source->title) : NULL;
+	self->uri = source->uri ? g_ref_string_acquire(source->uri) : NULL;
 	self->duration = source->duration;
 	self->is_current = source->is_current;
 
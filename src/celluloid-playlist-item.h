@@ -26,6 +26,9 @@
 
 G_DECLARE_FINAL_TYPE(CelluloidPlaylistItem, celluloid_playlist_item, CELLULOID, PLAYLIST_ITEM, GObject)
 
+/* Titles and URIs are interned, so items created from the same playlist entry
+ * share their strings with it and with each other.
+ */
 CelluloidPlaylistItem *
 celluloid_playlist_item_new_take(	gchar *title,
 					gchar *uri,
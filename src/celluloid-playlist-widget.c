@@ -30,6 +30,7 @@
 #include "celluloid-playlist-model.h"
 #include "celluloid-playlist-item.h"
 #include "celluloid-metadata-cache.h"
+#include "celluloid-resume-store.h"
 #include "celluloid-marshal.h"
 #include "celluloid-common.h"
 #include "celluloid-menu.h"
@@ -271,8 +272,12 @@ make_row(GObject *object, gpointer data)
 	GtkWidget *row_vbox = gtk_box_new(GTK_ORIENTATION_VERTICAL, 6);
 	GtkWidget *title_label = NULL;
 	GtkWidget *duration_label = NULL;
+	GtkWidget *progress_bar = NULL;
 	const gchar *title = celluloid_playlist_item_get_title(item);
 	const gchar *uri = celluloid_playlist_item_get_uri(item);
+	const CelluloidResumeEntry *resume =
+		celluloid_resume_store_lookup
+		(celluloid_resume_store_get_default(), uri);
 	const gint duration = (gint) celluloid_playlist_item_get_duration(item);
 	gchar *title_text = NULL;
 	gchar *duration_text = NULL;
@@ -329,6 +334,29 @@ make_row(GObject *object, gpointer data)
 
 	gtk_box_append(GTK_BOX(row_vbox), title_label);
 	gtk_box_append(GTK_BOX(row_vbox), duration_label);
+
+	if(resume && resume->duration > 0 && resume->position > 0)
+	{
+		gchar *tooltip =
+			g_strdup_printf
+			(	ngettext(	"Played %u time",
+						"Played %u times",
+						resume->play_count ),
+				resume->play_count );
+
+		progress_bar = gtk_progress_bar_new();
+
+		gtk_progress_bar_set_fraction
+			(	GTK_PROGRESS_BAR(progress_bar),
+				CLAMP(resume->position/resume->duration, 0, 1) );
+		gtk_widget_set_tooltip_text(progress_bar, tooltip);
+		gtk_widget_set_margin_bottom(progress_bar, 12);
+		gtk_widget_set_margin_bottom(duration_label, 0);
+		gtk_box_append(GTK_BOX(row_vbox), progress_bar);
+
+		g_free(tooltip);
+	}
+
 	gtk_list_box_row_set_child(GTK_LIST_BOX_ROW(row), row_vbox);
 
 	return row;
@@ -895,11 +923,11 @@ drop_handler(	GtkDropTarget *self,
 			slist = slist->next )
 		{
 			gchar *uri = g_file_get_uri(slist->data);
-			gchar *title = g_strdup(uri);
 
 			CelluloidPlaylistItem *item =
-				celluloid_playlist_item_new_take
-				(title, uri, 0, FALSE);
+				celluloid_playlist_item_new(uri, uri, 0, FALSE);
+
+			g_free(uri);
 
 			celluloid_playlist_model_append(wgt->model, item);
 			g_signal_emit_by_name(wgt, "row-inserted", position++);
@@ -1250,9 +1278,9 @@ celluloid_playlist_widget_update_contents(	CelluloidPlaylistWidget *wgt,
 		CelluloidPlaylistEntry *entry = g_ptr_array_index(playlist, i);
 
 		CelluloidPlaylistItem *item =
-			celluloid_playlist_item_new_take
-			(	g_strdup(entry->title),
-				g_strdup(entry->filename),
+			celluloid_playlist_item_new
+			(	entry->title,
+				entry->filename,
 				entry->duration,
 				(gint)i == current	);
 
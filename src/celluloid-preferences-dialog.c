@@ -173,6 +173,9 @@ constructed(GObject *object)
 			"show-durations-in-playlist",
 			ITEM_TYPE_SWITCH},
 			{NULL,
+			"seek-bar-thumbnails",
+			ITEM_TYPE_SWITCH},
+			{NULL,
 			"always-use-floating-controls",
 			ITEM_TYPE_SWITCH},
 			{NULL,
@@ -213,6 +216,12 @@ constructed(GObject *object)
 			"prefetch-metadata",
 			ITEM_TYPE_SWITCH},
 			{NULL,
+			"thumbnail-disk-cache",
+			ITEM_TYPE_SWITCH},
+			{NULL,
+			"preload-next-enable",
+			ITEM_TYPE_SWITCH},
+			{NULL,
 			"mpris-enable",
 			ITEM_TYPE_SWITCH},
 			{_("Extra mpv options"),
@@ -300,6 +309,7 @@ handle_changed(GSettings *settings, const gchar *key, gpointer data)
 	dlg->needs_mpv_reset |= g_strcmp0(key, "mpv-input-config-enable") == 0;
 	dlg->needs_mpv_reset |= g_strcmp0(key, "mpv-input-config-file") == 0;
 	dlg->needs_mpv_reset |= g_strcmp0(key, "mpv-options") == 0;
+	dlg->needs_mpv_reset |= g_strcmp0(key, "preload-next-enable") == 0;
 }
 
 static void
@@ -0,0 +1,349 @@
+/*
+ * Copyright (c) 2025 gnome-mpv
+ *
+ * This file is part of Celluloid.
+ *
+ * Celluloid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Celluloid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Celluloid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <glib.h>
+#include <string.h>
+
+#include "celluloid-property-mirror.h"
+
+typedef struct _MirrorEntry MirrorEntry;
+
+/* Entries are kept next to each other in an array so that a lookup only
+ * touches the hash table and a single small struct.
+ */
+struct _MirrorEntry
+{
+	const gchar *name;
+	mpv_format format;
+	gboolean available;
+	union
+	{
+		gchar *string;
+		int flag;
+		gint64 int64;
+		gdouble double_value;
+	} value;
+};
+
+struct _CelluloidPropertyMirror
+{
+	GArray *entries;
+	GHashTable *indices;
+};
+
+static MirrorEntry *
+lookup_entry(const CelluloidPropertyMirror *mirror, const gchar *name);
+
+static void
+clear_entry(MirrorEntry *entry);
+
+static gboolean
+is_supported_format(mpv_format format);
+
+static gchar *
+format_entry(const MirrorEntry *entry);
+
+static MirrorEntry *
+lookup_entry(const CelluloidPropertyMirror *mirror, const gchar *name)
+{
+	const guint index =
+		GPOINTER_TO_UINT(g_hash_table_lookup(mirror->indices, name));
+
+	// Indices are stored off by one so that a missing key can be told
+	// apart from the first entry.
+	return	index > 0 ?
+		&g_array_index(mirror->entries, MirrorEntry, index - 1) :
+		NULL;
+}
+
+static void
+clear_entry(MirrorEntry *entry)
+{
+	if(	entry->format == MPV_FORMAT_STRING ||
+		entry->format == MPV_FORMAT_OSD_STRING )
+	{
+		g_clear_pointer(&entry->value.string, g_free);
+	}
+
+	entry->available = FALSE;
+}
+
+static gboolean
+is_supported_format(mpv_format format)
+{
+	return	format == MPV_FORMAT_STRING ||
+		format == MPV_FORMAT_OSD_STRING ||
+		format == MPV_FORMAT_FLAG ||
+		format == MPV_FORMAT_INT64 ||
+		format == MPV_FORMAT_DOUBLE;
+}
+
+static gchar *
+format_entry(const MirrorEntry *entry)
+{
+	gchar *result = NULL;
+
+	if(!entry->available)
+	{
+		result = g_strdup("(unavailable)");
+	}
+	else if(	entry->format == MPV_FORMAT_STRING ||
+			entry->format == MPV_FORMAT_OSD_STRING )
+	{
+		result = g_strdup_printf("\"%s\"", entry->value.string);
+	}
+	else if(entry->format == MPV_FORMAT_FLAG)
+	{
+		result = g_strdup(entry->value.flag ? "yes" : "no");
+	}
+	else if(entry->format == MPV_FORMAT_INT64)
+	{
+		result = g_strdup_printf("%" G_GINT64_FORMAT, entry->value.int64);
+	}
+	else
+	{
+		result = g_strdup_printf("%g", entry->value.double_value);
+	}
+
+	return result;
+}
+
+CelluloidPropertyMirror *
+celluloid_property_mirror_new(void)
+{
+	CelluloidPropertyMirror *mirror = g_new0(CelluloidPropertyMirror, 1);
+
+	mirror->entries = g_array_new(FALSE, TRUE, sizeof(MirrorEntry));
+	mirror->indices = g_hash_table_new(g_str_hash, g_str_equal);
+
+	return mirror;
+}
+
+void
+celluloid_property_mirror_free(CelluloidPropertyMirror *mirror)
+{
+	if(mirror)
+	{
+		for(guint i = 0; i < mirror->entries->len; i++)
+		{
+			clear_entry
+				(&g_array_index(mirror->entries, MirrorEntry, i));
+		}
+
+		g_array_free(mirror->entries, TRUE);
+		g_hash_table_unref(mirror->indices);
+		g_free(mirror);
+	}
+}
+
+gboolean
+celluloid_property_mirror_add(	CelluloidPropertyMirror *mirror,
+				const gchar *name,
+				mpv_format format )
+{
+	const MirrorEntry *existing = lookup_entry(mirror, name);
+	gboolean result = FALSE;
+
+	// Node properties aren't mirrored. They are large, change as a whole,
+	// and their handlers parse them right away anyway.
+	if(existing)
+	{
+		result = existing->format == format;
+	}
+	else if(is_supported_format(format))
+	{
+		MirrorEntry entry = {0};
+
+		entry.name = g_intern_string(name);
+		entry.format = format;
+		entry.available = FALSE;
+
+		g_array_append_val(mirror->entries, entry);
+		g_hash_table_insert(	mirror->indices,
+					(gpointer)entry.name,
+					GUINT_TO_POINTER(mirror->entries->len) );
+
+		result = TRUE;
+	}
+
+	return result;
+}
+
+void
+celluloid_property_mirror_update(	CelluloidPropertyMirror *mirror,
+					const mpv_event_property *prop )
+{
+	MirrorEntry *entry = lookup_entry(mirror, prop->name);
+
+	if(!entry)
+	{
+		return;
+	}
+
+	if(prop->format == MPV_FORMAT_NONE || !prop->data)
+	{
+		clear_entry(entry);
+	}
+	else if(prop->format == entry->format)
+	{
+		switch(entry->format)
+		{
+			case MPV_FORMAT_STRING:
+			case MPV_FORMAT_OSD_STRING:
+			g_free(entry->value.string);
+			entry->value.string = g_strdup(*((char **)prop->data));
+			break;
+
+			case MPV_FORMAT_FLAG:
+			entry->value.flag = *((int *)prop->data);
+			break;
+
+			case MPV_FORMAT_INT64:
+			entry->value.int64 = *((int64_t *)prop->data);
+			break;
+
+			case MPV_FORMAT_DOUBLE:
+			entry->value.double_value = *((double *)prop->data);
+			break;
+
+			default:
+			g_assert_not_reached();
+			break;
+		}
+
+		entry->available = TRUE;
+	}
+}
+
+void
+celluloid_property_mirror_invalidate(CelluloidPropertyMirror *mirror)
+{
+	for(guint i = 0; i < mirror->entries->len; i++)
+	{
+		clear_entry(&g_array_index(mirror->entries, MirrorEntry, i));
+	}
+}
+
+gboolean
+celluloid_property_mirror_get(	const CelluloidPropertyMirror *mirror,
+				const gchar *name,
+				mpv_format format,
+				void *data )
+{
+	const MirrorEntry *entry = lookup_entry(mirror, name);
+	const gboolean found =	entry &&
+				entry->available &&
+				entry->format == format;
+
+	if(found)
+	{
+		switch(format)
+		{
+			// Strings are borrowed and stay valid until the next
+			// change of the property.
+			case MPV_FORMAT_STRING:
+			case MPV_FORMAT_OSD_STRING:
+			*((const gchar **)data) = entry->value.string;
+			break;
+
+			case MPV_FORMAT_FLAG:
+			*((int *)data) = entry->value.flag;
+			break;
+
+			case MPV_FORMAT_INT64:
+			*((gint64 *)data) = entry->value.int64;
+			break;
+
+			case MPV_FORMAT_DOUBLE:
+			*((gdouble *)data) = entry->value.double_value;
+			break;
+
+			default:
+			g_assert_not_reached();
+			break;
+		}
+	}
+
+	return found;
+}
+
+gboolean
+celluloid_property_mirror_check(	const CelluloidPropertyMirror *mirror,
+					mpv_handle *mpv_ctx,
+					const gchar *name )
+{
+	const MirrorEntry *entry = lookup_entry(mirror, name);
+	MirrorEntry actual = {0};
+	gboolean match = TRUE;
+	gint rc = 0;
+
+	if(!entry)
+	{
+		return TRUE;
+	}
+
+	actual.name = entry->name;
+	actual.format = entry->format;
+
+	rc = mpv_get_property(mpv_ctx, name, entry->format, &actual.value);
+	actual.available = rc >= 0;
+
+	if(actual.available != entry->available)
+	{
+		match = FALSE;
+	}
+	else if(	actual.available &&
+			(	entry->format == MPV_FORMAT_STRING ||
+				entry->format == MPV_FORMAT_OSD_STRING ) )
+	{
+		match =	g_strcmp0
+			(entry->value.string, actual.value.string) == 0;
+	}
+	else if(actual.available)
+	{
+		match =	memcmp
+			(&entry->value, &actual.value, sizeof(actual.value)) == 0;
+	}
+
+	// A mismatch can also mean that a change event is still queued, so
+	// this is only reported rather than asserted.
+	if(!match)
+	{
+		gchar *mirrored_str = format_entry(entry);
+		gchar *actual_str = format_entry(&actual);
+
+		g_warning(	"Mirrored value of property \"%s\" is %s, "
+				"but mpv reports %s",
+				name,
+				mirrored_str,
+				actual_str );
+
+		g_free(mirrored_str);
+		g_free(actual_str);
+	}
+
+	if(	actual.available &&
+		(	actual.format == MPV_FORMAT_STRING ||
+			actual.format == MPV_FORMAT_OSD_STRING ) )
+	{
+		mpv_free(actual.value.string);
+	}
+
+	return match;
+}
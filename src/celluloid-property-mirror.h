@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2025 gnome-mpv
+ *
+ * This file is part of Celluloid.
+ *
+ * Celluloid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Celluloid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Celluloid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PROPERTY_MIRROR_H
+#define PROPERTY_MIRROR_H
+
+#include <glib.h>
+#include <mpv/client.h>
+
+G_BEGIN_DECLS
+
+typedef struct _CelluloidPropertyMirror CelluloidPropertyMirror;
+
+CelluloidPropertyMirror *
+celluloid_property_mirror_new(void);
+
+void
+celluloid_property_mirror_free(CelluloidPropertyMirror *mirror);
+
+gboolean
+celluloid_property_mirror_add(	CelluloidPropertyMirror *mirror,
+				const gchar *name,
+				mpv_format format );
+
+void
+celluloid_property_mirror_update(	CelluloidPropertyMirror *mirror,
+					const mpv_event_property *prop );
+
+void
+celluloid_property_mirror_invalidate(CelluloidPropertyMirror *mirror);
+
+gboolean
+celluloid_property_mirror_get(	const CelluloidPropertyMirror *mirror,
+				const gchar *name,
+				mpv_format format,
+				void *data );
+
+gboolean
+celluloid_property_mirror_check(	const CelluloidPropertyMirror *mirror,
+					mpv_handle *mpv_ctx,
+					const gchar *name );
+
+G_END_DECLS
+
+#endif
@@ -0,0 +1,423 @@
+/*
+ * Copyright (c) 2025 gnome-mpv
+ *
+ * This file is part of Celluloid.
+ *
+ * Celluloid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Celluloid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Celluloid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdlib.h>
+#include <glib.h>
+
+#include "celluloid-resume-store.h"
+#include "celluloid-common.h"
+#include "celluloid-def.h"
+
+/* The index is a text file with one entry per line. Each line contains the
+ * position, duration, play count, and the time of the last update in seconds
+ * followed by the URI, separated by tabs. The URI comes last so that it may
+ * contain tabs itself. Entries are written from least to most recently used.
+ */
+#define RESUME_INDEX_FILENAME "resume-index"
+#define RESUME_INDEX_N_FIELDS 5
+
+typedef struct _StoreEntry StoreEntry;
+
+/* Besides the table, the store keeps the URIs in a queue ordered from least
+ * to most recently used. Each entry points to its link in the queue, so that
+ * both updating an entry and dropping the oldest one take constant time.
+ */
+struct _StoreEntry
+{
+	CelluloidResumeEntry entry;
+	GList *link;
+};
+
+struct _CelluloidResumeStore
+{
+	GObject parent;
+	GHashTable *table;
+	GQueue *lru;
+	gchar *path;
+	gboolean loaded;
+	gboolean dirty;
+	guint save_timeout_id;
+};
+
+struct _CelluloidResumeStoreClass
+{
+	GObjectClass parent_class;
+};
+
+static void
+dispose(GObject *object);
+
+static void
+finalize(GObject *object);
+
+static void
+load(CelluloidResumeStore *store);
+
+static gint
+compare_last_used(gconstpointer a, gconstpointer b, gpointer data);
+
+static void
+touch(CelluloidResumeStore *store, const gchar *uri, StoreEntry *entry);
+
+static void
+prune(CelluloidResumeStore *store, guint limit);
+
+static gboolean
+save_timeout_handler(gpointer data);
+
+G_DEFINE_TYPE(CelluloidResumeStore, celluloid_resume_store, G_TYPE_OBJECT)
+
+static void
+dispose(GObject *object)
+{
+	CelluloidResumeStore *store = CELLULOID_RESUME_STORE(object);
+
+	if(store->dirty)
+	{
+		celluloid_resume_store_save(store);
+	}
+
+	g_source_clear(&store->save_timeout_id);
+
+	G_OBJECT_CLASS(celluloid_resume_store_parent_class)->dispose(object);
+}
+
+static void
+finalize(GObject *object)
+{
+	CelluloidResumeStore *store = CELLULOID_RESUME_STORE(object);
+
+	g_queue_free(store->lru);
+	g_hash_table_unref(store->table);
+	g_free(store->path);
+
+	G_OBJECT_CLASS(celluloid_resume_store_parent_class)->finalize(object);
+}
+
+static void
+load(CelluloidResumeStore *store)
+{
+	GError *error = NULL;
+	gchar *contents = NULL;
+	gchar **lines = NULL;
+	GList *keys = NULL;
+
+	store->loaded = TRUE;
+
+	g_file_get_contents(store->path, &contents, NULL, &error);
+
+	if(error)
+	{
+		if(!g_error_matches(error, G_FILE_ERROR, G_FILE_ERROR_NOENT))
+		{
+			g_warning(	"Failed to load resume index %s: %s",
+					store->path,
+					error->message );
+		}
+
+		g_error_free(error);
+	}
+	else
+	{
+		lines = g_strsplit(contents, "\n", -1);
+	}
+
+	for(gint i = 0; lines && lines[i]; i++)
+	{
+		gchar **fields =
+			g_strsplit(lines[i], "\t", RESUME_INDEX_N_FIELDS);
+
+		if(	g_strv_length(fields) == RESUME_INDEX_N_FIELDS &&
+			*fields[RESUME_INDEX_N_FIELDS - 1] )
+		{
+			StoreEntry *entry = g_new0(StoreEntry, 1);
+
+			entry->entry.position = g_ascii_strtod(fields[0], NULL);
+			entry->entry.duration = g_ascii_strtod(fields[1], NULL);
+			entry->entry.play_count =
+				(guint)g_ascii_strtoull(fields[2], NULL, 10);
+			entry->entry.last_used =
+				g_ascii_strtoll(fields[3], NULL, 10);
+
+			g_hash_table_replace
+				(	store->table,
+					g_strdup(fields[RESUME_INDEX_N_FIELDS - 1]),
+					entry );
+		}
+		else if(*lines[i])
+		{
+			g_debug("Ignored malformed resume index line %d", i + 1);
+		}
+
+		g_strfreev(fields);
+	}
+
+	g_debug(	"Loaded %u entries from resume index",
+			g_hash_table_size(store->table) );
+
+	// Only loading needs to sort, the queue keeps the order from then on
+	keys = g_hash_table_get_keys(store->table);
+	keys = g_list_sort_with_data(keys, compare_last_used, store->table);
+
+	for(GList *cur = keys; cur; cur = g_list_next(cur))
+	{
+		StoreEntry *entry =
+			g_hash_table_lookup(store->table, cur->data);
+
+		g_queue_push_tail(store->lru, cur->data);
+		entry->link = g_queue_peek_tail_link(store->lru);
+	}
+
+	prune(store, RESUME_STORE_MAX_ENTRIES);
+
+	g_list_free(keys);
+	g_strfreev(lines);
+	g_free(contents);
+}
+
+static gint
+compare_last_used(gconstpointer a, gconstpointer b, gpointer data)
+{
+	GHashTable *table = data;
+	const StoreEntry *entry_a = g_hash_table_lookup(table, a);
+	const StoreEntry *entry_b = g_hash_table_lookup(table, b);
+
+	return	(entry_a->entry.last_used > entry_b->entry.last_used) -
+		(entry_a->entry.last_used < entry_b->entry.last_used);
+}
+
+/* Moves entry to the most recently used end of the queue, adding it if it
+ * isn't queued yet. uri must be the key that the table owns.
+ */
+static void
+touch(CelluloidResumeStore *store, const gchar *uri, StoreEntry *entry)
+{
+	if(entry->link)
+	{
+		g_queue_unlink(store->lru, entry->link);
+		g_queue_push_tail_link(store->lru, entry->link);
+	}
+	else
+	{
+		g_queue_push_tail(store->lru, (gpointer)uri);
+		entry->link = g_queue_peek_tail_link(store->lru);
+	}
+}
+
+/* Drops the least recently updated entries until at most limit remain */
+static void
+prune(CelluloidResumeStore *store, guint limit)
+{
+	while(g_queue_get_length(store->lru) > limit)
+	{
+		g_hash_table_remove(store->table, g_queue_pop_head(store->lru));
+
+		store->dirty = TRUE;
+	}
+}
+
+static gboolean
+save_timeout_handler(gpointer data)
+{
+	CelluloidResumeStore *store = data;
+
+	store->save_timeout_id = 0;
+	celluloid_resume_store_save(store);
+
+	return G_SOURCE_REMOVE;
+}
+
+static void
+celluloid_resume_store_class_init(CelluloidResumeStoreClass *klass)
+{
+	GObjectClass *object_class = G_OBJECT_CLASS(klass);
+
+	object_class->dispose = dispose;
+	object_class->finalize = finalize;
+}
+
+static void
+celluloid_resume_store_init(CelluloidResumeStore *store)
+{
+	gchar *config_dir = get_config_dir_path();
+
+	store->table =	g_hash_table_new_full
+			(g_str_hash, g_str_equal, g_free, g_free);
+	store->lru = g_queue_new();
+	store->path =	g_build_filename
+			(config_dir, RESUME_INDEX_FILENAME, NULL);
+	store->loaded = FALSE;
+	store->dirty = FALSE;
+	store->save_timeout_id = 0;
+
+	g_free(config_dir);
+}
+
+CelluloidResumeStore *
+celluloid_resume_store_new(const gchar *path)
+{
+	CelluloidResumeStore *store =
+		g_object_new(celluloid_resume_store_get_type(), NULL);
+
+	if(path)
+	{
+		g_free(store->path);
+		store->path = g_strdup(path);
+	}
+
+	return store;
+}
+
+CelluloidResumeStore *
+celluloid_resume_store_get_default(void)
+{
+	static CelluloidResumeStore *store = NULL;
+
+	if(!store)
+	{
+		store = celluloid_resume_store_new(NULL);
+	}
+
+	return store;
+}
+
+const CelluloidResumeEntry *
+celluloid_resume_store_lookup(	CelluloidResumeStore *store,
+				const gchar *uri )
+{
+	StoreEntry *entry = NULL;
+
+	if(!store->loaded)
+	{
+		load(store);
+	}
+
+	entry = uri ? g_hash_table_lookup(store->table, uri) : NULL;
+
+	return entry ? &entry->entry : NULL;
+}
+
+void
+celluloid_resume_store_update(	CelluloidResumeStore *store,
+				const gchar *uri,
+				gdouble position,
+				gdouble duration,
+				gboolean finished )
+{
+	gchar *key = NULL;
+	StoreEntry *entry = NULL;
+	gboolean played = FALSE;
+
+	if(!store->loaded)
+	{
+		load(store);
+	}
+
+	if(!g_hash_table_lookup_extended
+		(store->table, uri, (gpointer *)&key, (gpointer *)&entry))
+	{
+		// Make room first so that the new entry can't be the one that
+		// gets dropped.
+		prune(store, RESUME_STORE_MAX_ENTRIES - 1);
+
+		key = g_strdup(uri);
+		entry = g_new0(StoreEntry, 1);
+
+		g_hash_table_insert(store->table, key, entry);
+	}
+
+	touch(store, key, entry);
+
+	// Only count files that were played through or nearly so, not every
+	// time one was opened and skipped.
+	played =	finished ||
+			(	duration > 0 &&
+				position >=
+				duration*RESUME_STORE_PLAYED_FRACTION );
+
+	entry->entry.position = MAX(position, 0.0);
+	entry->entry.duration = MAX(duration, 0.0);
+	entry->entry.play_count += played ? 1 : 0;
+	entry->entry.last_used = g_get_real_time()/G_USEC_PER_SEC;
+
+	store->dirty = TRUE;
+
+	// Batch writes so that skipping through a playlist doesn't rewrite
+	// the whole index for every entry.
+	if(store->save_timeout_id == 0)
+	{
+		store->save_timeout_id =
+			g_timeout_add_seconds(	RESUME_STORE_SAVE_DELAY,
+						save_timeout_handler,
+						store );
+	}
+}
+
+void
+celluloid_resume_store_save(CelluloidResumeStore *store)
+{
+	GString *contents = NULL;
+	GError *error = NULL;
+
+	if(!store->dirty)
+	{
+		return;
+	}
+
+	contents = g_string_new(NULL);
+
+	for(GList *cur = store->lru->head; cur; cur = g_list_next(cur))
+	{
+		const gchar *uri = cur->data;
+		const StoreEntry *store_entry =
+			g_hash_table_lookup(store->table, uri);
+		const CelluloidResumeEntry *entry = &store_entry->entry;
+		gchar position[G_ASCII_DTOSTR_BUF_SIZE];
+		gchar duration[G_ASCII_DTOSTR_BUF_SIZE];
+
+		g_ascii_dtostr(position, sizeof(position), entry->position);
+		g_ascii_dtostr(duration, sizeof(duration), entry->duration);
+
+		g_string_append_printf(	contents,
+					"%s\t%s\t%u\t%"G_GINT64_FORMAT"\t%s\n",
+					position,
+					duration,
+					entry->play_count,
+					entry->last_used,
+					uri );
+	}
+
+	g_file_set_contents(store->path, contents->str, contents->len, &error);
+
+	if(error)
+	{
+		g_warning(	"Failed to save resume index %s: %s",
+				store->path,
+				error->message );
+
+		g_error_free(error);
+	}
+	else
+	{
+		store->dirty = FALSE;
+	}
+
+	g_source_clear(&store->save_timeout_id);
+	g_string_free(contents, TRUE);
+}
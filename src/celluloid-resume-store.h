@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2025 gnome-mpv
+ *
+ * This file is part of Celluloid.
+ *
+ * Celluloid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Celluloid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Celluloid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef RESUME_STORE_H
+#define RESUME_STORE_H
+
+#include <glib-object.h>
+
+G_BEGIN_DECLS
+
+typedef struct _CelluloidResumeEntry CelluloidResumeEntry;
+
+struct _CelluloidResumeEntry
+{
+	gdouble position;
+	gdouble duration;
+	guint play_count;
+	gint64 last_used;
+};
+
+#define CELLULOID_TYPE_RESUME_STORE (celluloid_resume_store_get_type())
+
+G_DECLARE_FINAL_TYPE(CelluloidResumeStore, celluloid_resume_store, CELLULOID, RESUME_STORE, GObject)
+
+CelluloidResumeStore *
+celluloid_resume_store_new(const gchar *path);
+
+CelluloidResumeStore *
+celluloid_resume_store_get_default(void);
+
+const CelluloidResumeEntry *
+celluloid_resume_store_lookup(	CelluloidResumeStore *store,
+				const gchar *uri );
+
+void
+celluloid_resume_store_update(	CelluloidResumeStore *store,
+				const gchar *uri,
+				gdouble position,
+				gdouble duration,
+				gboolean finished );
+
+void
+celluloid_resume_store_save(CelluloidResumeStore *store);
+
+G_END_DECLS
+
+#endif
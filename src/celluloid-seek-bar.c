@@ -23,18 +23,36 @@
 
 #include "celluloid-seek-bar.h"
 #include "celluloid-time-label.h"
+#include "celluloid-thumbnailer.h"
 #include "celluloid-common.h"
 
+#define BUFFERED_RANGE_HEIGHT 4
+#define BUFFERED_RANGE_ALPHA 0.3
+#define CHAPTER_MARK_WIDTH 2
+#define CHAPTER_MARK_HEIGHT 10
+#define CHAPTER_MARK_SPACING 6
+#define CHAPTER_MARK_ALPHA 0.6
+
+typedef struct _ChapterMark ChapterMark;
+
+struct _ChapterMark
+{
+	gdouble time;
+	const gchar *title;
+};
+
 enum
 {
 	PROP_0,
 	PROP_CHAPTER_LIST,
+	PROP_BUFFERED_RANGES,
 	PROP_DURATION,
 	PROP_PAUSE,
 	PROP_ENABLED,
 	PROP_SHOW_LABEL,
 	PROP_POPOVER_Y_OFFSET,
 	PROP_POPOVER_VISIBLE,
+	PROP_THUMBNAILER,
 	N_PROPERTIES
 };
 
@@ -45,7 +63,12 @@ struct _CelluloidSeekBar
 	GtkWidget *label;
 	GtkWidget *popover;
 	GtkWidget *popover_label;
+	GtkWidget *popover_thumbnail;
+	CelluloidThumbnailer *thumbnailer;
+	gdouble hover_time;
 	GPtrArray *chapter_list;
+	GArray *chapter_marks;
+	GArray *buffered_ranges;
 	gdouble pos;
 	gdouble duration;
 	gboolean pause;
@@ -54,6 +77,8 @@ struct _CelluloidSeekBar
 	gint popover_y_offset;
 	gboolean popover_visible;
 	guint popover_timeout_id;
+	gboolean scrubbing;
+	gboolean scrubbed;
 };
 
 struct _CelluloidSeekBarClass
@@ -64,6 +89,9 @@ struct _CelluloidSeekBarClass
 static void
 dispose(GObject *object);
 
+static void
+finalize(GObject *object);
+
 static void
 set_property(	GObject *object,
 		guint property_id,
@@ -76,12 +104,20 @@ get_property(	GObject *object,
 		GValue *value,
 		GParamSpec *pspec );
 
+static void
+snapshot(GtkWidget *widget, GtkSnapshot *gtk_snapshot);
+
 static void
 change_value_handler(	GtkWidget *widget,
 			GtkScrollType scroll,
 			gdouble value,
 			gpointer data );
 
+static gboolean
+pointer_event_handler(	GtkEventControllerLegacy *controller,
+			GdkEvent *event,
+			gpointer data );
+
 static gboolean
 enter_handler(	GtkEventControllerMotion *controller,
 		gdouble x,
@@ -97,9 +133,36 @@ motion_handler(	GtkEventControllerMotion *controller,
 		gdouble y,
 		gpointer data );
 
+static void
+thumbnail_ready_handler(CelluloidThumbnailer *thumbnailer, gpointer data);
+
+static void
+set_thumbnailer(CelluloidSeekBar *bar, CelluloidThumbnailer *thumbnailer);
+
+static void
+update_thumbnail(CelluloidSeekBar *bar);
+
+static gint
+compare_chapter_marks(gconstpointer a, gconstpointer b);
+
+static guint
+find_chapter_mark(CelluloidSeekBar *bar, guint start, gdouble time);
+
+static const gchar *
+get_chapter_title(CelluloidSeekBar *bar, gdouble time);
+
 static void
 update_chapter_list(CelluloidSeekBar *bar);
 
+static gboolean
+get_trough_area(CelluloidSeekBar *bar, graphene_rect_t *area);
+
+static void
+draw_chapter_marks(CelluloidSeekBar *bar, GtkSnapshot *gtk_snapshot);
+
+static void
+draw_buffered_ranges(CelluloidSeekBar *bar, GtkSnapshot *gtk_snapshot);
+
 static void
 update_label(CelluloidSeekBar *bar);
 
@@ -111,11 +174,20 @@ G_DEFINE_TYPE(CelluloidSeekBar, celluloid_seek_bar, GTK_TYPE_BOX)
 static void
 dispose(GObject *object)
 {
+	set_thumbnailer(CELLULOID_SEEK_BAR(object), NULL);
 	g_clear_object(&CELLULOID_SEEK_BAR(object)->popover);
 
 	G_OBJECT_CLASS(celluloid_seek_bar_parent_class)->dispose(object);
 }
 
+static void
+finalize(GObject *object)
+{
+	g_array_free(CELLULOID_SEEK_BAR(object)->chapter_marks, TRUE);
+
+	G_OBJECT_CLASS(celluloid_seek_bar_parent_class)->finalize(object);
+}
+
 static void
 set_property(	GObject *object,
 		guint property_id,
@@ -131,6 +203,11 @@ set_property(	GObject *object,
 		update_chapter_list(self);
 		break;
 
+		case PROP_BUFFERED_RANGES:
+		self->buffered_ranges = g_value_get_pointer(value);
+		gtk_widget_queue_draw(GTK_WIDGET(self));
+		break;
+
 		case PROP_DURATION:
 		self->duration = g_value_get_double(value);
 		update_label(self);
@@ -155,6 +232,10 @@ set_property(	GObject *object,
 		self->popover_y_offset = g_value_get_int(value);
 		break;
 
+		case PROP_THUMBNAILER:
+		set_thumbnailer(self, g_value_get_object(value));
+		break;
+
 		default:
 		G_OBJECT_WARN_INVALID_PROPERTY_ID(object, property_id, pspec);
 		break;
@@ -175,6 +256,10 @@ get_property(	GObject *object,
 		g_value_set_pointer(value, self->chapter_list);
 		break;
 
+		case PROP_BUFFERED_RANGES:
+		g_value_set_pointer(value, self->buffered_ranges);
+		break;
+
 		case PROP_DURATION:
 		g_value_set_double(value, self->duration);
 		break;
@@ -199,12 +284,28 @@ get_property(	GObject *object,
 		g_value_set_boolean(value, self->popover_visible);
 		break;
 
+		case PROP_THUMBNAILER:
+		g_value_set_object(value, self->thumbnailer);
+		break;
+
 		default:
 		G_OBJECT_WARN_INVALID_PROPERTY_ID(object, property_id, pspec);
 		break;
 	}
 }
 
+static void
+snapshot(GtkWidget *widget, GtkSnapshot *gtk_snapshot)
+{
+	// The ranges and chapter marks go in first so that the trough, its
+	// highlight, and the slider are all drawn on top of them.
+	draw_buffered_ranges(CELLULOID_SEEK_BAR(widget), gtk_snapshot);
+	draw_chapter_marks(CELLULOID_SEEK_BAR(widget), gtk_snapshot);
+
+	GTK_WIDGET_CLASS(celluloid_seek_bar_parent_class)
+		->snapshot(widget, gtk_snapshot);
+}
+
 static void
 change_value_handler(	GtkWidget *widget,
 			GtkScrollType scroll,
@@ -219,8 +320,51 @@ change_value_handler(	GtkWidget *widget,
 				"time", (gint)bar->pos,
 				"duration", (gint)bar->duration,
 				NULL );
-		g_signal_emit_by_name(data, "seek", value);
+
+		// While the slider is held, positions go out as cheap keyframe
+		// seeks. The exact seek is sent once it is released.
+		if(bar->scrubbing)
+		{
+			bar->scrubbed = TRUE;
+			g_signal_emit_by_name(data, "scrub", value);
+		}
+		else
+		{
+			g_signal_emit_by_name(data, "seek", value);
+		}
+	}
+}
+
+static gboolean
+pointer_event_handler(	GtkEventControllerLegacy *controller,
+			GdkEvent *event,
+			gpointer data )
+{
+	CelluloidSeekBar *bar = data;
+	const GdkEventType type = gdk_event_get_event_type(event);
+
+	if(type == GDK_BUTTON_PRESS || type == GDK_TOUCH_BEGIN)
+	{
+		bar->scrubbing = TRUE;
+		bar->scrubbed = FALSE;
 	}
+	else if(	bar->scrubbing &&
+			(	type == GDK_BUTTON_RELEASE ||
+				type == GDK_TOUCH_END ||
+				type == GDK_TOUCH_CANCEL ) )
+	{
+		bar->scrubbing = FALSE;
+
+		if(bar->scrubbed && bar->duration > 0)
+		{
+			const gdouble value =
+				gtk_range_get_value(GTK_RANGE(bar->seek_bar));
+
+			g_signal_emit_by_name(bar, "seek", value);
+		}
+	}
+
+	return GDK_EVENT_PROPAGATE;
 }
 
 static gboolean
@@ -264,6 +408,11 @@ leave_handler(GtkEventControllerMotion *widget, gpointer data)
 	bar->popover_visible = FALSE;
 	g_object_notify(G_OBJECT(bar), "popover-visible");
 
+	if(bar->thumbnailer)
+	{
+		celluloid_thumbnailer_cancel(bar->thumbnailer);
+	}
+
 	bar->popover_timeout_id =
 		g_timeout_add(100, (GSourceFunc)update_popover_visibility, bar);
 
@@ -326,34 +475,7 @@ motion_handler(	GtkEventControllerMotion *controller,
 	gchar *time_text =
 		format_time((gint)time, bar->duration >= 3600);
 
-	GPtrArray *chapter_list = bar->chapter_list;
-	const gchar *title_text = NULL;
-
-	if (chapter_list)
-	{
-		for(guint i = 0; !title_text && i < chapter_list->len; i++)
-		{
-			CelluloidChapter *chapter = g_ptr_array_index(chapter_list, i);
-
-			if(chapter->time > time)
-			{
-				// At this point, we should be looking at the chapter
-				// after the one we need. To get to the right chapter,
-				// subtract the index by one. If we're already at the
-				// first chapter, just pick that one.
-				chapter = g_ptr_array_index(chapter_list, MAX(1, i) - 1);
-				title_text = chapter->title;
-			}
-			else if(i == chapter_list->len - 1)
-			{
-				// The time should be beyond the last chapter's in this
-				// case, meaning the last chapter (the current index)
-				// is the one we need.
-				chapter = g_ptr_array_index(chapter_list, i);
-				title_text = chapter->title;
-			}
-		}
-	}
+	const gchar *title_text = get_chapter_title(bar, time);
 
 	GtkLabel *label = GTK_LABEL(bar->popover_label);
 
@@ -377,22 +499,267 @@ motion_handler(	GtkEventControllerMotion *controller,
 
 	g_free(time_text);
 
+	bar->hover_time = time;
+	update_thumbnail(bar);
+
+	if(bar->thumbnailer && !gtk_widget_get_visible(bar->popover_thumbnail))
+	{
+		celluloid_thumbnailer_request(bar->thumbnailer, time);
+	}
+
 	return FALSE;
 }
 
+static void
+thumbnail_ready_handler(CelluloidThumbnailer *thumbnailer, gpointer data)
+{
+	CelluloidSeekBar *bar = data;
+
+	if(bar->popover_visible)
+	{
+		update_thumbnail(bar);
+	}
+}
+
+static void
+set_thumbnailer(CelluloidSeekBar *bar, CelluloidThumbnailer *thumbnailer)
+{
+	if(bar->thumbnailer == thumbnailer)
+	{
+		return;
+	}
+
+	if(bar->thumbnailer)
+	{
+		g_signal_handlers_disconnect_by_data(bar->thumbnailer, bar);
+	}
+
+	g_set_object(&bar->thumbnailer, thumbnailer);
+
+	if(thumbnailer)
+	{
+		g_signal_connect(	thumbnailer,
+					"thumbnail-ready",
+					G_CALLBACK(thumbnail_ready_handler),
+					bar );
+	}
+}
+
+static void
+update_thumbnail(CelluloidSeekBar *bar)
+{
+	// Thumbnails are only ever looked up here. Generating them is left to
+	// the thumbnailer, which never blocks.
+	GdkTexture *texture =	bar->thumbnailer ?
+				celluloid_thumbnailer_lookup
+				(bar->thumbnailer, bar->hover_time) :
+				NULL;
+
+	gtk_picture_set_paintable
+		(GTK_PICTURE(bar->popover_thumbnail), GDK_PAINTABLE(texture));
+	gtk_widget_set_visible(bar->popover_thumbnail, !!texture);
+}
+
+static gint
+compare_chapter_marks(gconstpointer a, gconstpointer b)
+{
+	const gdouble time_a = ((const ChapterMark *)a)->time;
+	const gdouble time_b = ((const ChapterMark *)b)->time;
+
+	return (time_a > time_b) - (time_a < time_b);
+}
+
+static guint
+find_chapter_mark(CelluloidSeekBar *bar, guint start, gdouble time)
+{
+	guint low = start;
+	guint high = bar->chapter_marks->len;
+
+	// Returns the index of the first mark after time, or the number of
+	// marks if there is none.
+	while(low < high)
+	{
+		const guint mid = low + (high - low) / 2;
+		const ChapterMark *mark =
+			&g_array_index(bar->chapter_marks, ChapterMark, mid);
+
+		if(mark->time > time)
+		{
+			high = mid;
+		}
+		else
+		{
+			low = mid + 1;
+		}
+	}
+
+	return low;
+}
+
+static const gchar *
+get_chapter_title(CelluloidSeekBar *bar, gdouble time)
+{
+	const gchar *title = NULL;
+
+	if(bar->chapter_marks->len > 0)
+	{
+		// Times before the first chapter are shown as part of it.
+		const guint index = find_chapter_mark(bar, 0, time);
+		const ChapterMark *mark =
+			&g_array_index
+			(bar->chapter_marks, ChapterMark, MAX(1, index) - 1);
+
+		title = mark->title;
+	}
+
+	return title;
+}
+
 static void
 update_chapter_list(CelluloidSeekBar *bar)
 {
-	GtkScale *seek_bar = GTK_SCALE(bar->seek_bar);
 	GPtrArray *chapter_list = bar->chapter_list;
 
-	gtk_scale_clear_marks(seek_bar);
+	g_array_set_size(bar->chapter_marks, 0);
 
-	for(guint i = 0; i < chapter_list->len; i++)
+	for(guint i = 0; chapter_list && i < chapter_list->len; i++)
 	{
-		CelluloidChapter *chapter = g_ptr_array_index(chapter_list, i);
+		const CelluloidChapter *chapter =
+			g_ptr_array_index(chapter_list, i);
+		const ChapterMark mark = {chapter->time, chapter->title};
 
-		gtk_scale_add_mark(seek_bar, chapter->time, GTK_POS_TOP, NULL);
+		g_array_append_val(bar->chapter_marks, mark);
+	}
+
+	g_array_sort(bar->chapter_marks, compare_chapter_marks);
+	gtk_widget_queue_draw(GTK_WIDGET(bar));
+}
+
+static gboolean
+get_trough_area(CelluloidSeekBar *bar, graphene_rect_t *area)
+{
+	GdkRectangle range_rect = {0};
+	graphene_point_t origin = {0};
+
+	gtk_range_get_range_rect(GTK_RANGE(bar->seek_bar), &range_rect);
+
+	const gboolean origin_computed =
+		gtk_widget_compute_point
+		(	bar->seek_bar,
+			GTK_WIDGET(bar),
+			&GRAPHENE_POINT_INIT
+			((gfloat)range_rect.x, (gfloat)range_rect.y),
+			&origin );
+
+	if(origin_computed)
+	{
+		// Use the same trough margin as motion_handler()
+		const gint margin = 1;
+
+		graphene_rect_init
+			(	area,
+				origin.x + (gfloat)margin,
+				origin.y,
+				(gfloat)(range_rect.width - 2 * margin),
+				(gfloat)range_rect.height );
+	}
+
+	return origin_computed;
+}
+
+static void
+draw_chapter_marks(CelluloidSeekBar *bar, GtkSnapshot *gtk_snapshot)
+{
+	GArray *marks = bar->chapter_marks;
+	graphene_rect_t area = GRAPHENE_RECT_INIT_ZERO;
+	GdkRGBA color = {0};
+
+	if(	marks->len == 0 ||
+		!bar->enabled ||
+		bar->duration <= 0 ||
+		!get_trough_area(bar, &area) ||
+		area.size.width <= 0 )
+	{
+		return;
+	}
+
+	const gfloat y =
+		area.origin.y + (area.size.height - CHAPTER_MARK_HEIGHT) / 2;
+	const gdouble spacing =
+		CHAPTER_MARK_SPACING * bar->duration / area.size.width;
+
+	gtk_widget_get_color(GTK_WIDGET(bar), &color);
+	color.alpha *= (gfloat)CHAPTER_MARK_ALPHA;
+
+	/* A mark that would land within CHAPTER_MARK_SPACING pixels of the
+	 * previous one is skipped by searching for the first mark past that
+	 * point. This keeps the number of nodes proportional to the width of
+	 * the bar rather than to the number of chapters.
+	 */
+	for(guint i = 0; i < marks->len;)
+	{
+		const ChapterMark *mark = &g_array_index(marks, ChapterMark, i);
+		const gdouble position =
+			CLAMP(mark->time / bar->duration, 0.0, 1.0);
+
+		gtk_snapshot_append_color
+			(	gtk_snapshot,
+				&color,
+				&GRAPHENE_RECT_INIT
+				(	area.origin.x +
+					(gfloat)position * area.size.width -
+					CHAPTER_MARK_WIDTH / 2.0f,
+					y,
+					CHAPTER_MARK_WIDTH,
+					CHAPTER_MARK_HEIGHT ) );
+
+		i = find_chapter_mark(bar, i + 1, mark->time + spacing);
+	}
+}
+
+static void
+draw_buffered_ranges(CelluloidSeekBar *bar, GtkSnapshot *gtk_snapshot)
+{
+	GArray *ranges = bar->buffered_ranges;
+	graphene_rect_t area = GRAPHENE_RECT_INIT_ZERO;
+	GdkRGBA color = {0};
+
+	if(	!ranges ||
+		ranges->len == 0 ||
+		!bar->enabled ||
+		bar->duration <= 0 ||
+		!get_trough_area(bar, &area) )
+	{
+		return;
+	}
+
+	const gfloat y =
+		area.origin.y + (area.size.height - BUFFERED_RANGE_HEIGHT) / 2;
+
+	gtk_widget_get_color(GTK_WIDGET(bar), &color);
+	color.alpha *= (gfloat)BUFFERED_RANGE_ALPHA;
+
+	for(guint i = 0; i < ranges->len; i++)
+	{
+		const CelluloidTimeRange *range =
+			&g_array_index(ranges, CelluloidTimeRange, i);
+		const gdouble start =
+			CLAMP(range->start / bar->duration, 0.0, 1.0);
+		const gdouble end =
+			CLAMP(range->end / bar->duration, 0.0, 1.0);
+
+		if(end > start)
+		{
+			gtk_snapshot_append_color
+				(	gtk_snapshot,
+					&color,
+					&GRAPHENE_RECT_INIT
+					(	area.origin.x +
+						(gfloat)start * area.size.width,
+						y,
+						(gfloat)(end - start) * area.size.width,
+						BUFFERED_RANGE_HEIGHT ) );
+		}
 	}
 }
 
@@ -432,8 +799,10 @@ celluloid_seek_bar_class_init(CelluloidSeekBarClass *klass)
 	GParamSpec *pspec = NULL;
 
 	object_class->dispose = dispose;
+	object_class->finalize = finalize;
 	object_class->set_property = set_property;
 	object_class->get_property = get_property;
+	widget_class->snapshot = snapshot;
 
 	gtk_widget_class_set_css_name(widget_class, "celluloid-seek-bar");
 
@@ -444,6 +813,13 @@ celluloid_seek_bar_class_init(CelluloidSeekBarClass *klass)
 			G_PARAM_READWRITE );
 	g_object_class_install_property(object_class, PROP_CHAPTER_LIST, pspec);
 
+	pspec = g_param_spec_pointer
+		(	"buffered-ranges",
+			"Buffered ranges",
+			"Time ranges of the current file that are cached",
+			G_PARAM_READWRITE );
+	g_object_class_install_property(object_class, PROP_BUFFERED_RANGES, pspec);
+
 	pspec = g_param_spec_double
 		(	"duration",
 			"Duration",
@@ -496,6 +872,14 @@ celluloid_seek_bar_class_init(CelluloidSeekBarClass *klass)
 			G_PARAM_READABLE );
 	g_object_class_install_property(object_class, PROP_POPOVER_VISIBLE, pspec);
 
+	pspec = g_param_spec_object
+		(	"thumbnailer",
+			"Thumbnailer",
+			"Source of the thumbnails shown in the popover",
+			CELLULOID_TYPE_THUMBNAILER,
+			G_PARAM_READWRITE );
+	g_object_class_install_property(object_class, PROP_THUMBNAILER, pspec);
+
 	g_signal_new(	"seek",
 			G_TYPE_FROM_CLASS(klass),
 			G_SIGNAL_RUN_FIRST,
@@ -506,6 +890,16 @@ celluloid_seek_bar_class_init(CelluloidSeekBarClass *klass)
 			G_TYPE_NONE,
 			1,
 			G_TYPE_DOUBLE );
+	g_signal_new(	"scrub",
+			G_TYPE_FROM_CLASS(klass),
+			G_SIGNAL_RUN_FIRST,
+			0,
+			NULL,
+			NULL,
+			g_cclosure_marshal_VOID__DOUBLE,
+			G_TYPE_NONE,
+			1,
+			G_TYPE_DOUBLE );
 }
 
 static void
@@ -516,7 +910,12 @@ celluloid_seek_bar_init(CelluloidSeekBar *bar)
 	bar->label = celluloid_time_label_new();
 	bar->popover = g_object_ref_sink(gtk_popover_new());
 	bar->popover_label = gtk_label_new(NULL);
+	bar->popover_thumbnail = gtk_picture_new();
+	bar->thumbnailer = NULL;
+	bar->hover_time = 0;
 	bar->chapter_list = NULL;
+	bar->chapter_marks = g_array_new(FALSE, FALSE, sizeof(ChapterMark));
+	bar->buffered_ranges = NULL;
 	bar->duration = 0;
 	bar->pause = TRUE;
 	bar->enabled = TRUE;
@@ -525,6 +924,8 @@ celluloid_seek_bar_init(CelluloidSeekBar *bar)
 	bar->pos = 0;
 	bar->popover_visible = FALSE;
 	bar->popover_timeout_id = 0;
+	bar->scrubbing = FALSE;
+	bar->scrubbed = FALSE;
 
 	g_object_set(	bar->label,
 			"time", (gint)bar->pos,
@@ -537,7 +938,14 @@ celluloid_seek_bar_init(CelluloidSeekBar *bar)
 	gtk_widget_set_can_focus(bar->seek_bar, FALSE);
 
 	gtk_popover_set_position(GTK_POPOVER(bar->popover), GTK_POS_TOP);
-	gtk_popover_set_child(GTK_POPOVER(bar->popover), bar->popover_label);
+	GtkWidget *popover_box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 6);
+
+	gtk_picture_set_can_shrink(GTK_PICTURE(bar->popover_thumbnail), FALSE);
+	gtk_widget_set_visible(bar->popover_thumbnail, FALSE);
+	gtk_box_append(GTK_BOX(popover_box), bar->popover_thumbnail);
+	gtk_box_append(GTK_BOX(popover_box), bar->popover_label);
+
+	gtk_popover_set_child(GTK_POPOVER(bar->popover), popover_box);
 	gtk_widget_set_visible(bar->popover_label, TRUE);
 
 	g_signal_connect(	bar->seek_bar,
@@ -547,6 +955,19 @@ celluloid_seek_bar_init(CelluloidSeekBar *bar)
 
 	GtkEventController *motion_controller =
 		gtk_event_controller_motion_new();
+	GtkEventController *pointer_controller =
+		gtk_event_controller_legacy_new();
+
+	// The range's own drag gesture claims the pointer sequence, so the
+	// presses and releases are watched in the capture phase instead.
+	gtk_event_controller_set_propagation_phase
+		(pointer_controller, GTK_PHASE_CAPTURE);
+	gtk_widget_add_controller(GTK_WIDGET(bar->seek_bar), pointer_controller);
+
+	g_signal_connect(	pointer_controller,
+				"event",
+				G_CALLBACK(pointer_event_handler),
+				bar );
 
 	gtk_widget_add_controller(GTK_WIDGET(bar->seek_bar), motion_controller);
 
@@ -589,7 +1010,12 @@ celluloid_seek_bar_set_pos(CelluloidSeekBar *bar, gdouble pos)
 
 	bar->pos = pos;
 
-	gtk_range_set_value(GTK_RANGE(bar->seek_bar), pos);
+	// Keyframe seeks land away from the pointer, so the slider is left
+	// where the user put it until it is released.
+	if(!bar->scrubbing)
+	{
+		gtk_range_set_value(GTK_RANGE(bar->seek_bar), pos);
+	}
 
 	if((gint)old_pos != (gint)pos)
 	{
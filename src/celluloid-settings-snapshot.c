@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2025 gnome-mpv
+ *
+ * This file is part of Celluloid.
+ *
+ * Celluloid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Celluloid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Celluloid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gio/gio.h>
+
+#include "celluloid-settings-snapshot.h"
+#include "celluloid-def.h"
+
+typedef struct _SnapshotKey SnapshotKey;
+
+struct _SnapshotKey
+{
+	const gchar *name;
+	glong offset;
+};
+
+static const SnapshotKey snapshot_keys[] =
+	{	{	"always-append-to-playlist",
+			G_STRUCT_OFFSET
+			(CelluloidSettingsSnapshot, always_append_to_playlist) },
+		{	"always-open-new-window",
+			G_STRUCT_OFFSET
+			(CelluloidSettingsSnapshot, always_open_new_window) },
+		{	"ignore-playback-errors",
+			G_STRUCT_OFFSET
+			(CelluloidSettingsSnapshot, ignore_playback_errors) },
+		{	"prefetch-metadata",
+			G_STRUCT_OFFSET
+			(CelluloidSettingsSnapshot, prefetch_metadata) },
+		{	"present-window-on-file-open",
+			G_STRUCT_OFFSET
+			(CelluloidSettingsSnapshot, present_window_on_file_open) },
+		{	"seek-bar-thumbnails",
+			G_STRUCT_OFFSET
+			(CelluloidSettingsSnapshot, seek_bar_thumbnails) },
+		{	"thumbnail-disk-cache",
+			G_STRUCT_OFFSET
+			(CelluloidSettingsSnapshot, thumbnail_disk_cache) },
+		{	"metadata-update-interval",
+			G_STRUCT_OFFSET
+			(CelluloidSettingsSnapshot, metadata_update_interval) } };
+
+static CelluloidSettingsSnapshot snapshot;
+
+static void
+load_key(GSettings *settings, const SnapshotKey *key);
+
+static void
+changed_handler(GSettings *settings, const gchar *key, gpointer data);
+
+static void
+load_key(GSettings *settings, const SnapshotKey *key)
+{
+	GVariant *value = g_settings_get_value(settings, key->name);
+
+	if(g_variant_is_of_type(value, G_VARIANT_TYPE_BOOLEAN))
+	{
+		G_STRUCT_MEMBER(gboolean, &snapshot, key->offset) =
+			g_variant_get_boolean(value);
+	}
+	else if(g_variant_is_of_type(value, G_VARIANT_TYPE_INT32))
+	{
+		G_STRUCT_MEMBER(gint, &snapshot, key->offset) =
+			g_variant_get_int32(value);
+	}
+	else
+	{
+		g_assert_not_reached();
+	}
+
+	g_variant_unref(value);
+}
+
+static void
+changed_handler(GSettings *settings, const gchar *key, gpointer data)
+{
+	for(gsize i = 0; i < G_N_ELEMENTS(snapshot_keys); i++)
+	{
+		if(g_strcmp0(key, snapshot_keys[i].name) == 0)
+		{
+			load_key(settings, &snapshot_keys[i]);
+		}
+	}
+}
+
+const CelluloidSettingsSnapshot *
+celluloid_settings_snapshot_get(void)
+{
+	static GSettings *settings = NULL;
+
+	/* The settings object lives for the rest of the process. Change
+	 * notifications are delivered to the thread that gets here first,
+	 * which must be the one running the main loop.
+	 */
+	if(g_once_init_enter(&settings))
+	{
+		GSettings *new_settings = g_settings_new(CONFIG_ROOT);
+
+		for(gsize i = 0; i < G_N_ELEMENTS(snapshot_keys); i++)
+		{
+			load_key(new_settings, &snapshot_keys[i]);
+		}
+
+		g_signal_connect(	new_settings,
+					"changed",
+					G_CALLBACK(changed_handler),
+					NULL );
+
+		g_once_init_leave(&settings, new_settings);
+	}
+
+	return &snapshot;
+}
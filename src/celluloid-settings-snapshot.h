@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2025 gnome-mpv
+ *
+ * This file is part of Celluloid.
+ *
+ * Celluloid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Celluloid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Celluloid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SETTINGS_SNAPSHOT_H
+#define SETTINGS_SNAPSHOT_H
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+typedef struct _CelluloidSettingsSnapshot CelluloidSettingsSnapshot;
+
+/* Values of the settings that are read on hot paths such as event handlers
+ * and file loading. The snapshot is shared by the whole application and is
+ * kept up to date as the settings change.
+ */
+struct _CelluloidSettingsSnapshot
+{
+	gboolean always_append_to_playlist;
+	gboolean always_open_new_window;
+	gboolean ignore_playback_errors;
+	gboolean prefetch_metadata;
+	gboolean present_window_on_file_open;
+	gboolean seek_bar_thumbnails;
+	gboolean thumbnail_disk_cache;
+	gint metadata_update_interval;
+};
+
+const CelluloidSettingsSnapshot *
+celluloid_settings_snapshot_get(void);
+
+G_END_DECLS
+
+#endif
@@ -50,6 +50,7 @@ celluloid_shortcuts_dialog_init(CelluloidShortcutsDialog *wnd)
 			{"<Ctrl><Shift>l", _("Add location to playlist")},
 			{"<Ctrl>comma", _("Show preferences dialog")},
 			{"F9", _("Toggle playlist")},
+			{"<Ctrl>i", _("Toggle statistics")},
 			{"F10", _("Show main menu")},
 			{"F11 f", _("Toggle fullscreen mode")},
 			{"Escape", _("Leave fullscreen mode")},
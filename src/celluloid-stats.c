@@ -0,0 +1,331 @@
+/*
+ * Copyright (c) 2025 gnome-mpv
+ *
+ * This file is part of Celluloid.
+ *
+ * Celluloid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Celluloid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Celluloid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <glib.h>
+#include <glib/gi18n.h>
+
+#include "celluloid-stats.h"
+
+#define HISTOGRAM_BAR_WIDTH 24
+
+typedef struct _CelluloidStatsRing CelluloidStatsRing;
+
+struct _CelluloidStatsRing
+{
+	gint64 samples[CELLULOID_STATS_RING_SIZE];
+	guint head;
+	guint count;
+};
+
+struct _CelluloidStats
+{
+	CelluloidStatsRing render_time;
+	CelluloidStatsRing dispatch_latency;
+	gint64 frame_drop_count;
+	gint64 delayed_frame_count;
+	gdouble estimated_vf_fps;
+	gdouble cache_duration;
+	gint64 cache_buffering;
+	gint64 input_received[CELLULOID_STATS_N_INPUT_KINDS];
+	gint64 input_sent[CELLULOID_STATS_N_INPUT_KINDS];
+};
+
+/* Upper bounds of the render time histogram bins in microseconds. The last bin
+ * catches everything above the second last bound.
+ */
+static const gint64 histogram_bounds[] =
+	{1000, 2000, 4000, 8000, 16667, 33333, 50000, G_MAXINT64};
+
+static const gchar *const histogram_labels[] =
+	{"< 1 ms", "< 2 ms", "< 4 ms", "< 8 ms",
+	"< 17 ms", "< 33 ms", "< 50 ms", ">= 50 ms"};
+
+static void
+ring_push(CelluloidStatsRing *ring, gint64 value);
+
+static void
+ring_summarize(	const CelluloidStatsRing *ring,
+		gdouble *mean,
+		gint64 *max );
+
+static void
+format_histogram(const CelluloidStatsRing *ring, GString *buf);
+
+static void
+ring_push(CelluloidStatsRing *ring, gint64 value)
+{
+	ring->samples[ring->head] = value;
+	ring->head = (ring->head + 1) % CELLULOID_STATS_RING_SIZE;
+
+	if(ring->count < CELLULOID_STATS_RING_SIZE)
+	{
+		ring->count++;
+	}
+}
+
+static void
+ring_summarize(	const CelluloidStatsRing *ring,
+		gdouble *mean,
+		gint64 *max )
+{
+	gint64 sum = 0;
+
+	*mean = 0;
+	*max = 0;
+
+	for(guint i = 0; i < ring->count; i++)
+	{
+		sum += ring->samples[i];
+		*max = MAX(*max, ring->samples[i]);
+	}
+
+	if(ring->count > 0)
+	{
+		*mean = (gdouble)sum / ring->count;
+	}
+}
+
+static void
+format_histogram(const CelluloidStatsRing *ring, GString *buf)
+{
+	const guint n_bins = G_N_ELEMENTS(histogram_bounds);
+	guint bins[G_N_ELEMENTS(histogram_bounds)] = {0};
+	guint max_bin = 0;
+
+	for(guint i = 0; i < ring->count; i++)
+	{
+		guint bin = 0;
+
+		while(ring->samples[i] >= histogram_bounds[bin])
+		{
+			bin++;
+		}
+
+		bins[bin]++;
+		max_bin = MAX(max_bin, bins[bin]);
+	}
+
+	for(guint i = 0; i < n_bins; i++)
+	{
+		const guint width =
+			max_bin > 0 ?
+			(bins[i] * HISTOGRAM_BAR_WIDTH + max_bin - 1) / max_bin :
+			0;
+
+		g_string_append_printf(buf, "  %-9s ", histogram_labels[i]);
+
+		for(guint j = 0; j < width; j++)
+		{
+			g_string_append_c(buf, '#');
+		}
+
+		g_string_append_printf(buf, " %u\n", bins[i]);
+	}
+}
+
+CelluloidStats *
+celluloid_stats_new(void)
+{
+	CelluloidStats *stats = g_new0(CelluloidStats, 1);
+
+	celluloid_stats_reset(stats);
+
+	return stats;
+}
+
+void
+celluloid_stats_free(CelluloidStats *stats)
+{
+	g_free(stats);
+}
+
+void
+celluloid_stats_reset(CelluloidStats *stats)
+{
+	stats->render_time.head = 0;
+	stats->render_time.count = 0;
+	stats->dispatch_latency.head = 0;
+	stats->dispatch_latency.count = 0;
+	stats->frame_drop_count = -1;
+	stats->delayed_frame_count = -1;
+	stats->estimated_vf_fps = -1;
+	stats->cache_duration = -1;
+	stats->cache_buffering = -1;
+
+	for(gint i = 0; i < CELLULOID_STATS_N_INPUT_KINDS; i++)
+	{
+		stats->input_received[i] = 0;
+		stats->input_sent[i] = 0;
+	}
+}
+
+void
+celluloid_stats_add_render_time(CelluloidStats *stats, gint64 usec)
+{
+	ring_push(&stats->render_time, usec);
+}
+
+void
+celluloid_stats_add_dispatch_latency(CelluloidStats *stats, gint64 usec)
+{
+	ring_push(&stats->dispatch_latency, usec);
+}
+
+void
+celluloid_stats_set_frame_drop_count(CelluloidStats *stats, gint64 count)
+{
+	stats->frame_drop_count = count;
+}
+
+void
+celluloid_stats_set_delayed_frame_count(CelluloidStats *stats, gint64 count)
+{
+	stats->delayed_frame_count = count;
+}
+
+void
+celluloid_stats_set_estimated_vf_fps(CelluloidStats *stats, gdouble fps)
+{
+	stats->estimated_vf_fps = fps;
+}
+
+void
+celluloid_stats_set_cache_duration(CelluloidStats *stats, gdouble duration)
+{
+	stats->cache_duration = duration;
+}
+
+void
+celluloid_stats_set_cache_buffering(CelluloidStats *stats, gint64 percent)
+{
+	stats->cache_buffering = percent;
+}
+
+void
+celluloid_stats_add_input_events(	CelluloidStats *stats,
+					CelluloidStatsInputKind kind,
+					guint received,
+					guint sent )
+{
+	stats->input_received[kind] += received;
+	stats->input_sent[kind] += sent;
+}
+
+void
+celluloid_stats_get_dispatch_latency(	const CelluloidStats *stats,
+					gdouble *mean,
+					gint64 *max )
+{
+	ring_summarize(&stats->dispatch_latency, mean, max);
+}
+
+gchar *
+celluloid_stats_format(const CelluloidStats *stats)
+{
+	GString *buf = g_string_new(NULL);
+	gdouble mean = 0;
+	gint64 max = 0;
+
+	ring_summarize(&stats->render_time, &mean, &max);
+	g_string_append_printf
+		(	buf,
+			_("Render time (last %u frames)\n"),
+			stats->render_time.count );
+	g_string_append_printf
+		(	buf,
+			_("  mean %.2f ms, max %.2f ms\n"),
+			mean / 1000.0,
+			(gdouble)max / 1000.0 );
+	format_histogram(&stats->render_time, buf);
+
+	g_string_append(buf, _("Dropped frames: "));
+	if(stats->frame_drop_count >= 0)
+	{
+		g_string_append_printf
+			(buf, "%" G_GINT64_FORMAT "\n", stats->frame_drop_count);
+	}
+	else
+	{
+		g_string_append(buf, _("n/a\n"));
+	}
+
+	g_string_append(buf, _("Delayed frames: "));
+	if(stats->delayed_frame_count >= 0)
+	{
+		g_string_append_printf
+			(buf, "%" G_GINT64_FORMAT "\n", stats->delayed_frame_count);
+	}
+	else
+	{
+		g_string_append(buf, _("n/a\n"));
+	}
+
+	g_string_append(buf, _("Estimated VF FPS: "));
+	if(stats->estimated_vf_fps >= 0)
+	{
+		g_string_append_printf(buf, "%.3f\n", stats->estimated_vf_fps);
+	}
+	else
+	{
+		g_string_append(buf, _("n/a\n"));
+	}
+
+	g_string_append(buf, _("Demuxer cache: "));
+	if(stats->cache_duration >= 0)
+	{
+		g_string_append_printf(buf, "%.1f s", stats->cache_duration);
+
+		if(stats->cache_buffering >= 0)
+		{
+			g_string_append_printf
+				(	buf,
+					" (%" G_GINT64_FORMAT "%%)",
+					stats->cache_buffering );
+		}
+
+		g_string_append_c(buf, '\n');
+	}
+	else
+	{
+		g_string_append(buf, _("n/a\n"));
+	}
+
+	g_string_append_printf
+		(	buf,
+			_(	"Input events sent/received: "
+				"pointer %" G_GINT64_FORMAT "/%" G_GINT64_FORMAT ", "
+				"scroll %" G_GINT64_FORMAT "/%" G_GINT64_FORMAT ", "
+				"keys %" G_GINT64_FORMAT "/%" G_GINT64_FORMAT
+				"\n" ),
+			stats->input_sent[CELLULOID_STATS_INPUT_POINTER],
+			stats->input_received[CELLULOID_STATS_INPUT_POINTER],
+			stats->input_sent[CELLULOID_STATS_INPUT_SCROLL],
+			stats->input_received[CELLULOID_STATS_INPUT_SCROLL],
+			stats->input_sent[CELLULOID_STATS_INPUT_KEY],
+			stats->input_received[CELLULOID_STATS_INPUT_KEY] );
+
+	ring_summarize(&stats->dispatch_latency, &mean, &max);
+	g_string_append_printf
+		(	buf,
+			_("Event dispatch latency: mean %.2f ms, max %.2f ms"),
+			mean / 1000.0,
+			(gdouble)max / 1000.0 );
+
+	return g_string_free(buf, FALSE);
+}
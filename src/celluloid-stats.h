@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2025 gnome-mpv
+ *
+ * This file is part of Celluloid.
+ *
+ * Celluloid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Celluloid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Celluloid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef STATS_H
+#define STATS_H
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+#define CELLULOID_STATS_RING_SIZE 256
+
+typedef struct _CelluloidStats CelluloidStats;
+
+typedef enum
+{
+	CELLULOID_STATS_INPUT_POINTER,
+	CELLULOID_STATS_INPUT_SCROLL,
+	CELLULOID_STATS_INPUT_KEY,
+	CELLULOID_STATS_N_INPUT_KINDS
+}
+CelluloidStatsInputKind;
+
+CelluloidStats *
+celluloid_stats_new(void);
+
+void
+celluloid_stats_free(CelluloidStats *stats);
+
+void
+celluloid_stats_reset(CelluloidStats *stats);
+
+void
+celluloid_stats_add_render_time(CelluloidStats *stats, gint64 usec);
+
+void
+celluloid_stats_add_dispatch_latency(CelluloidStats *stats, gint64 usec);
+
+void
+celluloid_stats_set_frame_drop_count(CelluloidStats *stats, gint64 count);
+
+void
+celluloid_stats_set_delayed_frame_count(CelluloidStats *stats, gint64 count);
+
+void
+celluloid_stats_set_estimated_vf_fps(CelluloidStats *stats, gdouble fps);
+
+void
+celluloid_stats_set_cache_duration(CelluloidStats *stats, gdouble duration);
+
+void
+celluloid_stats_set_cache_buffering(CelluloidStats *stats, gint64 percent);
+
+void
+celluloid_stats_add_input_events(	CelluloidStats *stats,
+					CelluloidStatsInputKind kind,
+					guint received,
+					guint sent );
+
+void
+celluloid_stats_get_dispatch_latency(	const CelluloidStats *stats,
+					gdouble *mean,
+					gint64 *max );
+
+gchar *
+celluloid_stats_format(const CelluloidStats *stats);
+
+G_END_DECLS
+
+#endif
@@ -0,0 +1,1060 @@
+/*
+ * Copyright (c) 2025 gnome-mpv
+ *
+ * This file is part of Celluloid.
+ *
+ * Celluloid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Celluloid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Celluloid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gio/gio.h>
+#include <gtk/gtk.h>
+#include <mpv/client.h>
+#include <string.h>
+
+#include "celluloid-thumbnailer.h"
+#include "celluloid-settings-snapshot.h"
+#include "celluloid-def.h"
+
+typedef struct _CacheEntry CacheEntry;
+typedef struct _DiskJob DiskJob;
+
+enum
+{
+	PROP_0,
+	PROP_PATH,
+	N_PROPERTIES
+};
+
+/* Only one request is sent to the thumbnailing core at a time. Replies and
+ * events that belong to a file that has since been replaced are dropped. The
+ * reply userdata of each request is tagged with the current generation, and
+ * events are only accepted once START_FILE has been seen for the current
+ * generation.
+ */
+typedef enum
+{
+	STATE_IDLE,
+	STATE_LOADING,
+	STATE_READING,
+	STATE_SEEKING,
+	STATE_CAPTURING
+} ThumbnailerState;
+
+enum
+{
+	REPLY_LOAD = 1,
+	REPLY_SEEK,
+	REPLY_CAPTURE
+};
+
+#define REPLY_TYPE_BITS 2
+#define REPLY_TYPE_MASK ((1 << REPLY_TYPE_BITS) - 1)
+
+struct _CacheEntry
+{
+	gint64 bucket;
+	GdkTexture *texture;
+	gsize size;
+};
+
+struct _DiskJob
+{
+	gchar *filename;
+	guint generation;
+	GdkTexture *texture;
+	gboolean prune;
+};
+
+struct _CelluloidThumbnailer
+{
+	GObject parent;
+	mpv_handle *mpv_ctx;
+	gchar *path;
+	gchar *path_hash;
+	guint generation;
+	guint started_generation;
+	ThumbnailerState state;
+	gboolean loaded;
+	gboolean available;
+	gboolean disk_pruned;
+	gdouble interval;
+	gdouble pending_time;
+	gint64 current;
+	GHashTable *cache;
+	GQueue *lru;
+	gsize cache_size;
+};
+
+struct _CelluloidThumbnailerClass
+{
+	GObjectClass parent_class;
+};
+
+static void
+set_property(	GObject *object,
+		guint property_id,
+		const GValue *value,
+		GParamSpec *pspec );
+
+static void
+get_property(	GObject *object,
+		guint property_id,
+		GValue *value,
+		GParamSpec *pspec );
+
+static void
+dispose(GObject *object);
+
+static void
+finalize(GObject *object);
+
+static void
+cache_entry_free(CacheEntry *entry);
+
+static void
+disk_job_free(DiskJob *job);
+
+static gint64
+get_bucket(CelluloidThumbnailer *thumbnailer, gdouble time);
+
+static gchar *
+get_cache_filename(CelluloidThumbnailer *thumbnailer, gint64 bucket);
+
+static void
+cache_insert(	CelluloidThumbnailer *thumbnailer,
+		gint64 bucket,
+		GdkTexture *texture );
+
+static void
+cache_clear(CelluloidThumbnailer *thumbnailer);
+
+static void
+reset(CelluloidThumbnailer *thumbnailer);
+
+static void
+set_unavailable(CelluloidThumbnailer *thumbnailer);
+
+static void
+send_command(	CelluloidThumbnailer *thumbnailer,
+		gint reply,
+		const gchar **cmd );
+
+static gboolean
+create_mpv(CelluloidThumbnailer *thumbnailer);
+
+static void
+wakeup_callback(void *data);
+
+static gboolean
+process_mpv_events(gpointer data);
+
+static void
+handle_event(CelluloidThumbnailer *thumbnailer, const mpv_event *event);
+
+static void
+handle_command_reply(CelluloidThumbnailer *thumbnailer, const mpv_event *event);
+
+static GdkTexture *
+node_to_texture(const mpv_node *node);
+
+static void
+start_next(CelluloidThumbnailer *thumbnailer);
+
+static void
+read_current(CelluloidThumbnailer *thumbnailer);
+
+static void
+seek_current(CelluloidThumbnailer *thumbnailer);
+
+static void
+finish_current(CelluloidThumbnailer *thumbnailer, GdkTexture *texture);
+
+static void
+read_thread(	GTask *task,
+		gpointer source,
+		gpointer data,
+		GCancellable *cancellable );
+
+static void
+read_ready(GObject *source, GAsyncResult *result, gpointer data);
+
+static gint
+compare_mtime(gconstpointer a, gconstpointer b);
+
+static void
+prune_disk_cache(const gchar *dirname);
+
+static void
+write_thread(	GTask *task,
+		gpointer source,
+		gpointer data,
+		GCancellable *cancellable );
+
+G_DEFINE_TYPE(CelluloidThumbnailer, celluloid_thumbnailer, G_TYPE_OBJECT)
+
+static void
+set_property(	GObject *object,
+		guint property_id,
+		const GValue *value,
+		GParamSpec *pspec )
+{
+	CelluloidThumbnailer *self = CELLULOID_THUMBNAILER(object);
+
+	if(property_id == PROP_PATH)
+	{
+		const gchar *path = g_value_get_string(value);
+
+		if(g_strcmp0(path, self->path) != 0)
+		{
+			g_free(self->path);
+			g_free(self->path_hash);
+
+			self->path = g_strdup(path);
+			self->path_hash =	path ?
+						g_compute_checksum_for_string
+						(G_CHECKSUM_SHA1, path, -1) :
+						NULL;
+
+			reset(self);
+		}
+	}
+	else
+	{
+		G_OBJECT_WARN_INVALID_PROPERTY_ID(object, property_id, pspec);
+	}
+}
+
+static void
+get_property(	GObject *object,
+		guint property_id,
+		GValue *value,
+		GParamSpec *pspec )
+{
+	CelluloidThumbnailer *self = CELLULOID_THUMBNAILER(object);
+
+	if(property_id == PROP_PATH)
+	{
+		g_value_set_string(value, self->path);
+	}
+	else
+	{
+		G_OBJECT_WARN_INVALID_PROPERTY_ID(object, property_id, pspec);
+	}
+}
+
+static void
+dispose(GObject *object)
+{
+	CelluloidThumbnailer *self = CELLULOID_THUMBNAILER(object);
+
+	if(self->mpv_ctx)
+	{
+		mpv_set_wakeup_callback(self->mpv_ctx, NULL, NULL);
+		g_clear_pointer(&self->mpv_ctx, mpv_terminate_destroy);
+		while(g_source_remove_by_user_data(object));
+	}
+
+	cache_clear(self);
+
+	G_OBJECT_CLASS(celluloid_thumbnailer_parent_class)->dispose(object);
+}
+
+static void
+finalize(GObject *object)
+{
+	CelluloidThumbnailer *self = CELLULOID_THUMBNAILER(object);
+
+	g_free(self->path);
+	g_free(self->path_hash);
+	g_hash_table_unref(self->cache);
+	g_queue_free(self->lru);
+
+	G_OBJECT_CLASS(celluloid_thumbnailer_parent_class)->finalize(object);
+}
+
+static void
+cache_entry_free(CacheEntry *entry)
+{
+	g_object_unref(entry->texture);
+	g_free(entry);
+}
+
+static void
+disk_job_free(DiskJob *job)
+{
+	g_free(job->filename);
+	g_clear_object(&job->texture);
+	g_free(job);
+}
+
+static gint64
+get_bucket(CelluloidThumbnailer *thumbnailer, gdouble time)
+{
+	return (gint64)(MAX(time, 0.0)/thumbnailer->interval);
+}
+
+static gchar *
+get_cache_filename(CelluloidThumbnailer *thumbnailer, gint64 bucket)
+{
+	gchar *basename =	g_strdup_printf
+				(	"%s-%" G_GINT64_FORMAT ".png",
+					thumbnailer->path_hash,
+					bucket );
+	gchar *filename =	g_build_filename
+				(	g_get_user_cache_dir(),
+					"celluloid",
+					"thumbnails",
+					basename,
+					NULL );
+
+	g_free(basename);
+
+	return filename;
+}
+
+static void
+cache_insert(	CelluloidThumbnailer *thumbnailer,
+		gint64 bucket,
+		GdkTexture *texture )
+{
+	CacheEntry *entry = NULL;
+
+	if(g_hash_table_contains(thumbnailer->cache, &bucket))
+	{
+		return;
+	}
+
+	entry = g_new0(CacheEntry, 1);
+	entry->bucket = bucket;
+	entry->texture = g_object_ref(texture);
+	entry->size =	(gsize)gdk_texture_get_width(texture) *
+			(gsize)gdk_texture_get_height(texture) * 4;
+
+	g_queue_push_head(thumbnailer->lru, entry);
+	g_hash_table_insert
+		(thumbnailer->cache, &entry->bucket, thumbnailer->lru->head);
+	thumbnailer->cache_size += entry->size;
+
+	// The most recent thumbnail is always kept, even if it alone exceeds
+	// the limit.
+	while(	thumbnailer->cache_size > THUMBNAIL_CACHE_SIZE &&
+		thumbnailer->lru->length > 1 )
+	{
+		CacheEntry *last = g_queue_pop_tail(thumbnailer->lru);
+
+		g_hash_table_remove(thumbnailer->cache, &last->bucket);
+		thumbnailer->cache_size -= last->size;
+		cache_entry_free(last);
+	}
+}
+
+static void
+cache_clear(CelluloidThumbnailer *thumbnailer)
+{
+	g_hash_table_remove_all(thumbnailer->cache);
+	g_queue_clear_full(thumbnailer->lru, (GDestroyNotify)cache_entry_free);
+	thumbnailer->cache_size = 0;
+}
+
+static void
+reset(CelluloidThumbnailer *thumbnailer)
+{
+	cache_clear(thumbnailer);
+
+	thumbnailer->generation++;
+	thumbnailer->state = STATE_IDLE;
+	thumbnailer->loaded = FALSE;
+	thumbnailer->available = TRUE;
+	thumbnailer->disk_pruned = FALSE;
+	thumbnailer->interval = 0;
+	thumbnailer->pending_time = -1;
+	thumbnailer->current = -1;
+
+	if(thumbnailer->mpv_ctx && !thumbnailer->path)
+	{
+		const gchar *cmd[] = {"stop", NULL};
+
+		mpv_command_async(thumbnailer->mpv_ctx, 0, cmd);
+	}
+}
+
+static void
+set_unavailable(CelluloidThumbnailer *thumbnailer)
+{
+	const gchar *cmd[] = {"stop", NULL};
+
+	thumbnailer->available = FALSE;
+	thumbnailer->state = STATE_IDLE;
+
+	// Keep the paused core from buffering a file that won't be used
+	mpv_command_async(thumbnailer->mpv_ctx, 0, cmd);
+}
+
+static void
+send_command(	CelluloidThumbnailer *thumbnailer,
+		gint reply,
+		const gchar **cmd )
+{
+	const guint64 userdata =
+		((guint64)thumbnailer->generation << REPLY_TYPE_BITS) |
+		(guint64)reply;
+
+	mpv_command_async(thumbnailer->mpv_ctx, userdata, cmd);
+}
+
+static gboolean
+create_mpv(CelluloidThumbnailer *thumbnailer)
+{
+	/* Only keyframes are decoded, in software and at the size of the
+	 * thumbnail, and nothing is ever presented.
+	 */
+	const gchar *options[][2]
+		= {	{"config", "no"},
+			{"load-scripts", "no"},
+			{"ytdl", "no"},
+			{"terminal", "no"},
+			{"input-default-bindings", "no"},
+			{"resume-playback", "no"},
+			{"save-position-on-quit", "no"},
+			{"vo", "null"},
+			{"ao", "null"},
+			{"aid", "no"},
+			{"sid", "no"},
+			{"idle", "yes"},
+			{"pause", "yes"},
+			{"keep-open", "always"},
+			{"hwdec", "no"},
+			{"hr-seek", "no"},
+			{"vd-lavc-fast", "yes"},
+			{"vd-lavc-skiploopfilter", "all"} };
+	gchar *vf = g_strdup_printf("scale=w=%d:h=-2", THUMBNAIL_WIDTH);
+	gint rc = 0;
+
+	thumbnailer->mpv_ctx = mpv_create();
+
+	if(!thumbnailer->mpv_ctx)
+	{
+		g_warning("Failed to create thumbnailer mpv instance");
+		g_free(vf);
+
+		return FALSE;
+	}
+
+	for(gsize i = 0; i < G_N_ELEMENTS(options); i++)
+	{
+		mpv_set_option_string
+			(thumbnailer->mpv_ctx, options[i][0], options[i][1]);
+	}
+
+	mpv_set_option_string(thumbnailer->mpv_ctx, "vf", vf);
+	mpv_set_wakeup_callback(thumbnailer->mpv_ctx, wakeup_callback, thumbnailer);
+	rc = mpv_initialize(thumbnailer->mpv_ctx);
+
+	if(rc < 0)
+	{
+		g_warning(	"Failed to initialize thumbnailer: %s",
+				mpv_error_string(rc) );
+
+		mpv_set_wakeup_callback(thumbnailer->mpv_ctx, NULL, NULL);
+		g_clear_pointer(&thumbnailer->mpv_ctx, mpv_terminate_destroy);
+	}
+
+	g_free(vf);
+
+	return !!thumbnailer->mpv_ctx;
+}
+
+static void
+wakeup_callback(void *data)
+{
+	g_idle_add(process_mpv_events, data);
+}
+
+static gboolean
+process_mpv_events(gpointer data)
+{
+	CelluloidThumbnailer *thumbnailer = data;
+	gboolean done = FALSE;
+
+	while(!done && thumbnailer->mpv_ctx)
+	{
+		mpv_event *event = mpv_wait_event(thumbnailer->mpv_ctx, 0);
+
+		done = !event || event->event_id == MPV_EVENT_NONE;
+
+		if(!done)
+		{
+			handle_event(thumbnailer, event);
+		}
+	}
+
+	return G_SOURCE_REMOVE;
+}
+
+static void
+handle_event(CelluloidThumbnailer *thumbnailer, const mpv_event *event)
+{
+	const ThumbnailerState state = thumbnailer->state;
+	const gboolean started =
+		thumbnailer->started_generation == thumbnailer->generation;
+
+	if(event->event_id == MPV_EVENT_COMMAND_REPLY)
+	{
+		handle_command_reply(thumbnailer, event);
+	}
+	else if(	event->event_id == MPV_EVENT_START_FILE &&
+			state == STATE_LOADING )
+	{
+		gchar *path =	mpv_get_property_string
+				(thumbnailer->mpv_ctx, "path");
+
+		// Events carry no userdata, so the file is told apart from one
+		// that was replaced while loading by its path.
+		if(g_strcmp0(path, thumbnailer->path) == 0)
+		{
+			thumbnailer->started_generation =
+				thumbnailer->generation;
+		}
+
+		mpv_free(path);
+	}
+	else if(	event->event_id == MPV_EVENT_FILE_LOADED &&
+			state == STATE_LOADING &&
+			started )
+	{
+		gdouble duration = 0;
+
+		mpv_get_property(	thumbnailer->mpv_ctx,
+					"duration",
+					MPV_FORMAT_DOUBLE,
+					&duration );
+
+		if(duration > 0)
+		{
+			thumbnailer->interval =	MAX
+						(	THUMBNAIL_MIN_INTERVAL,
+							duration/THUMBNAIL_BUCKETS );
+		}
+		else
+		{
+			set_unavailable(thumbnailer);
+		}
+	}
+	else if(event->event_id == MPV_EVENT_PLAYBACK_RESTART)
+	{
+		// The first restart after loading the file comes before any
+		// seek was sent.
+		if(	state == STATE_LOADING &&
+			started &&
+			thumbnailer->interval > 0 )
+		{
+			thumbnailer->loaded = TRUE;
+			thumbnailer->state = STATE_IDLE;
+
+			start_next(thumbnailer);
+		}
+		else if(state == STATE_SEEKING)
+		{
+			const gchar *cmd[] = {"screenshot-raw", "video", NULL};
+
+			thumbnailer->state = STATE_CAPTURING;
+
+			send_command(thumbnailer, REPLY_CAPTURE, cmd);
+		}
+	}
+	else if(	event->event_id == MPV_EVENT_END_FILE &&
+			state == STATE_LOADING &&
+			started )
+	{
+		const mpv_event_end_file *end_file = event->data;
+
+		if(end_file->reason == MPV_END_FILE_REASON_ERROR)
+		{
+			g_debug(	"Thumbnailer failed to load file: %s",
+					mpv_error_string(end_file->error) );
+
+			set_unavailable(thumbnailer);
+		}
+	}
+}
+
+static void
+handle_command_reply(CelluloidThumbnailer *thumbnailer, const mpv_event *event)
+{
+	const ThumbnailerState state = thumbnailer->state;
+	const guint64 reply = event->reply_userdata & REPLY_TYPE_MASK;
+
+	if(event->reply_userdata >> REPLY_TYPE_BITS != thumbnailer->generation)
+	{
+		return;
+	}
+
+	if(reply == REPLY_LOAD && state == STATE_LOADING)
+	{
+		if(event->error < 0)
+		{
+			set_unavailable(thumbnailer);
+		}
+	}
+	else if(reply == REPLY_SEEK && state == STATE_SEEKING)
+	{
+		if(event->error < 0)
+		{
+			finish_current(thumbnailer, NULL);
+		}
+	}
+	else if(reply == REPLY_CAPTURE && state == STATE_CAPTURING)
+	{
+		const mpv_event_command *reply = event->data;
+		GdkTexture *texture =	event->error >= 0 ?
+					node_to_texture(&reply->result) :
+					NULL;
+
+		// Without a frame to capture, the file most likely has no
+		// video at all.
+		if(!texture)
+		{
+			set_unavailable(thumbnailer);
+		}
+		else if(celluloid_settings_snapshot_get()->thumbnail_disk_cache)
+		{
+			DiskJob *job = g_new0(DiskJob, 1);
+			GTask *task = g_task_new(thumbnailer, NULL, NULL, NULL);
+
+			job->filename =	get_cache_filename
+					(thumbnailer, thumbnailer->current);
+			job->generation = thumbnailer->generation;
+			job->texture = g_object_ref(texture);
+			job->prune = !thumbnailer->disk_pruned;
+
+			thumbnailer->disk_pruned = TRUE;
+
+			g_task_set_task_data
+				(task, job, (GDestroyNotify)disk_job_free);
+			g_task_run_in_thread(task, write_thread);
+			g_object_unref(task);
+		}
+
+		finish_current(thumbnailer, texture);
+		g_clear_object(&texture);
+	}
+}
+
+static GdkTexture *
+node_to_texture(const mpv_node *node)
+{
+	const struct mpv_byte_array *data = NULL;
+	const gchar *format = NULL;
+	gint64 width = 0;
+	gint64 height = 0;
+	gint64 stride = 0;
+	GdkMemoryFormat memory_format = GDK_MEMORY_B8G8R8X8;
+	GdkTexture *texture = NULL;
+
+	if(node->format != MPV_FORMAT_NODE_MAP)
+	{
+		return NULL;
+	}
+
+	for(gint i = 0; i < node->u.list->num; i++)
+	{
+		const gchar *key = node->u.list->keys[i];
+		const mpv_node *value = &node->u.list->values[i];
+
+		if(value->format == MPV_FORMAT_INT64)
+		{
+			if(g_strcmp0(key, "w") == 0)
+			{
+				width = value->u.int64;
+			}
+			else if(g_strcmp0(key, "h") == 0)
+			{
+				height = value->u.int64;
+			}
+			else if(g_strcmp0(key, "stride") == 0)
+			{
+				stride = value->u.int64;
+			}
+		}
+		else if(	value->format == MPV_FORMAT_STRING &&
+				g_strcmp0(key, "format") == 0 )
+		{
+			format = value->u.string;
+		}
+		else if(	value->format == MPV_FORMAT_BYTE_ARRAY &&
+				g_strcmp0(key, "data") == 0 )
+		{
+			data = value->u.ba;
+		}
+	}
+
+	if(g_strcmp0(format, "bgra") == 0)
+	{
+		memory_format = GDK_MEMORY_B8G8R8A8;
+	}
+	else if(g_strcmp0(format, "rgba") == 0)
+	{
+		memory_format = GDK_MEMORY_R8G8B8A8;
+	}
+	else if(g_strcmp0(format, "rgb0") == 0)
+	{
+		memory_format = GDK_MEMORY_R8G8B8X8;
+	}
+	else if(g_strcmp0(format, "bgr0") != 0)
+	{
+		format = NULL;
+	}
+
+	if(	format && data && width > 0 && height > 0 &&
+		stride >= width * 4 && data->size >= (gsize)(stride * height) )
+	{
+		GBytes *bytes = g_bytes_new(data->data, (gsize)(stride * height));
+
+		texture =	gdk_memory_texture_new
+				(	(gint)width,
+					(gint)height,
+					memory_format,
+					bytes,
+					(gsize)stride );
+
+		g_bytes_unref(bytes);
+	}
+
+	return texture;
+}
+
+static void
+start_next(CelluloidThumbnailer *thumbnailer)
+{
+	if(	thumbnailer->state != STATE_IDLE ||
+		thumbnailer->pending_time < 0 ||
+		!thumbnailer->available ||
+		!thumbnailer->path )
+	{
+		return;
+	}
+
+	if(!thumbnailer->mpv_ctx && !create_mpv(thumbnailer))
+	{
+		thumbnailer->available = FALSE;
+	}
+	else if(!thumbnailer->loaded)
+	{
+		const gchar *cmd[] = {"loadfile", thumbnailer->path, NULL};
+
+		thumbnailer->state = STATE_LOADING;
+
+		send_command(thumbnailer, REPLY_LOAD, cmd);
+	}
+	else
+	{
+		const gint64 bucket =
+			get_bucket(thumbnailer, thumbnailer->pending_time);
+
+		thumbnailer->pending_time = -1;
+
+		if(!g_hash_table_contains(thumbnailer->cache, &bucket))
+		{
+			thumbnailer->current = bucket;
+
+			if(celluloid_settings_snapshot_get()->thumbnail_disk_cache)
+			{
+				read_current(thumbnailer);
+			}
+			else
+			{
+				seek_current(thumbnailer);
+			}
+		}
+	}
+}
+
+static void
+read_current(CelluloidThumbnailer *thumbnailer)
+{
+	DiskJob *job = g_new0(DiskJob, 1);
+	GTask *task = g_task_new(thumbnailer, NULL, read_ready, NULL);
+
+	job->filename = get_cache_filename(thumbnailer, thumbnailer->current);
+	job->generation = thumbnailer->generation;
+
+	thumbnailer->state = STATE_READING;
+
+	g_task_set_task_data(task, job, (GDestroyNotify)disk_job_free);
+	g_task_run_in_thread(task, read_thread);
+	g_object_unref(task);
+}
+
+static void
+seek_current(CelluloidThumbnailer *thumbnailer)
+{
+	gchar time[G_ASCII_DTOSTR_BUF_SIZE];
+	const gchar *cmd[] = {"seek", time, "absolute+keyframes", NULL};
+
+	g_ascii_dtostr
+		(	time,
+			sizeof(time),
+			((gdouble)thumbnailer->current + 0.5) *
+			thumbnailer->interval );
+
+	thumbnailer->state = STATE_SEEKING;
+
+	send_command(thumbnailer, REPLY_SEEK, cmd);
+}
+
+static void
+finish_current(CelluloidThumbnailer *thumbnailer, GdkTexture *texture)
+{
+	thumbnailer->state = STATE_IDLE;
+
+	if(texture)
+	{
+		cache_insert(thumbnailer, thumbnailer->current, texture);
+		g_signal_emit_by_name(thumbnailer, "thumbnail-ready");
+	}
+
+	thumbnailer->current = -1;
+
+	start_next(thumbnailer);
+}
+
+static void
+read_thread(	GTask *task,
+		gpointer source,
+		gpointer data,
+		GCancellable *cancellable )
+{
+	const DiskJob *job = data;
+	GdkTexture *texture = NULL;
+
+	if(g_file_test(job->filename, G_FILE_TEST_EXISTS))
+	{
+		texture = gdk_texture_new_from_filename(job->filename, NULL);
+	}
+
+	g_task_return_pointer(task, texture, g_object_unref);
+}
+
+static void
+read_ready(GObject *source, GAsyncResult *result, gpointer data)
+{
+	CelluloidThumbnailer *thumbnailer = CELLULOID_THUMBNAILER(source);
+	const DiskJob *job = g_task_get_task_data(G_TASK(result));
+	GdkTexture *texture = g_task_propagate_pointer(G_TASK(result), NULL);
+
+	if(	job->generation == thumbnailer->generation &&
+		thumbnailer->state == STATE_READING )
+	{
+		if(texture)
+		{
+			finish_current(thumbnailer, texture);
+		}
+		else if(thumbnailer->mpv_ctx)
+		{
+			seek_current(thumbnailer);
+		}
+		else
+		{
+			finish_current(thumbnailer, NULL);
+		}
+	}
+
+	g_clear_object(&texture);
+}
+
+static gint
+compare_mtime(gconstpointer a, gconstpointer b)
+{
+	GFileInfo *info_a = *(GFileInfo **)a;
+	GFileInfo *info_b = *(GFileInfo **)b;
+	const guint64 mtime_a =	g_file_info_get_attribute_uint64
+				(info_a, G_FILE_ATTRIBUTE_TIME_MODIFIED);
+	const guint64 mtime_b =	g_file_info_get_attribute_uint64
+				(info_b, G_FILE_ATTRIBUTE_TIME_MODIFIED);
+
+	return (mtime_a > mtime_b) - (mtime_a < mtime_b);
+}
+
+/* Deletes the least recently written thumbnails until the cache directory
+ * fits in THUMBNAIL_DISK_CACHE_SIZE.
+ */
+static void
+prune_disk_cache(const gchar *dirname)
+{
+	GFile *dir = g_file_new_for_path(dirname);
+	GFileEnumerator *iter =	g_file_enumerate_children
+				(	dir,
+					G_FILE_ATTRIBUTE_STANDARD_NAME","
+					G_FILE_ATTRIBUTE_STANDARD_SIZE","
+					G_FILE_ATTRIBUTE_TIME_MODIFIED,
+					G_FILE_QUERY_INFO_NOFOLLOW_SYMLINKS,
+					NULL,
+					NULL );
+	GPtrArray *files = g_ptr_array_new_with_free_func(g_object_unref);
+	goffset total = 0;
+	GFileInfo *info = NULL;
+
+	while(iter && (info = g_file_enumerator_next_file(iter, NULL, NULL)))
+	{
+		total += g_file_info_get_size(info);
+		g_ptr_array_add(files, info);
+	}
+
+	g_ptr_array_sort(files, compare_mtime);
+
+	for(guint i = 0; total > THUMBNAIL_DISK_CACHE_SIZE && i < files->len; i++)
+	{
+		GFile *file;
+
+		info = g_ptr_array_index(files, i);
+		file = g_file_get_child(dir, g_file_info_get_name(info));
+
+		if(g_file_delete(file, NULL, NULL))
+		{
+			total -= g_file_info_get_size(info);
+		}
+
+		g_object_unref(file);
+	}
+
+	g_ptr_array_unref(files);
+	g_clear_object(&iter);
+	g_object_unref(dir);
+}
+
+static void
+write_thread(	GTask *task,
+		gpointer source,
+		gpointer data,
+		GCancellable *cancellable )
+{
+	const DiskJob *job = data;
+	gchar *dirname = g_path_get_dirname(job->filename);
+
+	if(	g_mkdir_with_parents(dirname, 0700) != 0 ||
+		!gdk_texture_save_to_png(job->texture, job->filename) )
+	{
+		g_debug("Failed to save thumbnail to %s", job->filename);
+	}
+	else if(job->prune)
+	{
+		prune_disk_cache(dirname);
+	}
+
+	g_free(dirname);
+}
+
+static void
+celluloid_thumbnailer_class_init(CelluloidThumbnailerClass *klass)
+{
+	GObjectClass *object_class = G_OBJECT_CLASS(klass);
+	GParamSpec *pspec = NULL;
+
+	object_class->set_property = set_property;
+	object_class->get_property = get_property;
+	object_class->dispose = dispose;
+	object_class->finalize = finalize;
+
+	pspec = g_param_spec_string
+		(	"path",
+			"Path",
+			"Path of the file to generate thumbnails for",
+			NULL,
+			G_PARAM_READWRITE );
+	g_object_class_install_property(object_class, PROP_PATH, pspec);
+
+	g_signal_new(	"thumbnail-ready",
+			G_TYPE_FROM_CLASS(klass),
+			G_SIGNAL_RUN_FIRST,
+			0,
+			NULL,
+			NULL,
+			g_cclosure_marshal_VOID__VOID,
+			G_TYPE_NONE,
+			0 );
+}
+
+static void
+celluloid_thumbnailer_init(CelluloidThumbnailer *thumbnailer)
+{
+	thumbnailer->mpv_ctx = NULL;
+	thumbnailer->path = NULL;
+	thumbnailer->path_hash = NULL;
+	thumbnailer->generation = 0;
+	thumbnailer->started_generation = 0;
+	thumbnailer->cache = g_hash_table_new(g_int64_hash, g_int64_equal);
+	thumbnailer->lru = g_queue_new();
+	thumbnailer->cache_size = 0;
+
+	reset(thumbnailer);
+}
+
+CelluloidThumbnailer *
+celluloid_thumbnailer_new(void)
+{
+	return g_object_new(celluloid_thumbnailer_get_type(), NULL);
+}
+
+GdkTexture *
+celluloid_thumbnailer_lookup(CelluloidThumbnailer *thumbnailer, gdouble time)
+{
+	GList *link = NULL;
+	gint64 bucket = 0;
+
+	if(thumbnailer->interval <= 0)
+	{
+		return NULL;
+	}
+
+	bucket = get_bucket(thumbnailer, time);
+	link = g_hash_table_lookup(thumbnailer->cache, &bucket);
+
+	if(link)
+	{
+		g_queue_unlink(thumbnailer->lru, link);
+		g_queue_push_head_link(thumbnailer->lru, link);
+	}
+
+	return link ? ((CacheEntry *)link->data)->texture : NULL;
+}
+
+void
+celluloid_thumbnailer_request(CelluloidThumbnailer *thumbnailer, gdouble time)
+{
+	const CelluloidSettingsSnapshot *settings =
+		celluloid_settings_snapshot_get();
+
+	if(	settings->seek_bar_thumbnails &&
+		thumbnailer->available &&
+		thumbnailer->path &&
+		time >= 0 )
+	{
+		// The thumbnail being generated will be ready soon enough, so
+		// asking for it again would only queue a duplicate.
+		const gboolean in_flight =
+			thumbnailer->current >= 0 &&
+			thumbnailer->interval > 0 &&
+			get_bucket(thumbnailer, time) == thumbnailer->current;
+
+		thumbnailer->pending_time = in_flight ? -1 : time;
+
+		start_next(thumbnailer);
+	}
+}
+
+void
+celluloid_thumbnailer_cancel(CelluloidThumbnailer *thumbnailer)
+{
+	thumbnailer->pending_time = -1;
+}
@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2025 gnome-mpv
+ *
+ * This file is part of Celluloid.
+ *
+ * Celluloid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Celluloid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Celluloid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef THUMBNAILER_H
+#define THUMBNAILER_H
+
+#include <glib-object.h>
+#include <gdk/gdk.h>
+
+G_BEGIN_DECLS
+
+#define CELLULOID_TYPE_THUMBNAILER (celluloid_thumbnailer_get_type())
+
+G_DECLARE_FINAL_TYPE(CelluloidThumbnailer, celluloid_thumbnailer, CELLULOID, THUMBNAILER, GObject)
+
+CelluloidThumbnailer *
+celluloid_thumbnailer_new(void);
+
+/* Returns the cached thumbnail closest to time, or NULL if it hasn't been
+ * generated yet. The texture is owned by the thumbnailer.
+ */
+GdkTexture *
+celluloid_thumbnailer_lookup(CelluloidThumbnailer *thumbnailer, gdouble time);
+
+/* Queues a thumbnail for time, replacing any request that hasn't started
+ * yet. The "thumbnail-ready" signal is emitted once it is in the cache.
+ */
+void
+celluloid_thumbnailer_request(CelluloidThumbnailer *thumbnailer, gdouble time);
+
+void
+celluloid_thumbnailer_cancel(CelluloidThumbnailer *thumbnailer);
+
+G_END_DECLS
+
+#endif
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2025 gnome-mpv
+ *
+ * This file is part of Celluloid.
+ *
+ * Celluloid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Celluloid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Celluloid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <glib.h>
+
+#include "celluloid-trace.h"
+
+/* Startup tracing is enabled by setting this environment variable to any
+ * value. Spans are written to the log as they end, with their start time
+ * relative to the call to celluloid_trace_init().
+ */
+#define TRACE_ENV_VAR "CELLULOID_TRACE_STARTUP"
+
+static gint64 trace_origin = 0;
+static gboolean trace_enabled = FALSE;
+
+void
+celluloid_trace_init(void)
+{
+	trace_origin = g_get_monotonic_time();
+	trace_enabled = !!g_getenv(TRACE_ENV_VAR);
+
+	if(trace_enabled)
+	{
+		g_message("trace: Startup tracing enabled");
+	}
+}
+
+gint64
+celluloid_trace_begin(void)
+{
+	return trace_enabled ? g_get_monotonic_time() : 0;
+}
+
+void
+celluloid_trace_end(const gchar *name, gint64 begin)
+{
+	if(trace_enabled && begin > 0)
+	{
+		const gint64 end = g_get_monotonic_time();
+
+		g_message(	"trace: span %-28s start %10.3f ms, "
+				"duration %10.3f ms",
+				name,
+				(gdouble)(begin - trace_origin) / 1000.0,
+				(gdouble)(end - begin) / 1000.0 );
+	}
+}
+
+void
+celluloid_trace_mark(const gchar *name)
+{
+	if(trace_enabled)
+	{
+		const gint64 now = g_get_monotonic_time();
+
+		g_message(	"trace: mark %-28s at    %10.3f ms",
+				name,
+				(gdouble)(now - trace_origin) / 1000.0 );
+	}
+}
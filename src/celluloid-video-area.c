@@ -45,6 +45,8 @@ struct _CelluloidVideoArea
 {
 	AdwBreakpointBin parent_instance;
 	GtkWidget *toast_overlay;
+	GtkWidget *overlay;
+	GtkWidget *stats_label;
 	GtkWidget *stack;
 	GtkWidget *gl_area;
 	GtkWidget *graphics_offload;
@@ -483,6 +485,8 @@ celluloid_video_area_init(CelluloidVideoArea *area)
 	GSettings *settings = g_settings_new(CONFIG_ROOT);
 
 	area->toast_overlay = adw_toast_overlay_new();
+	area->overlay = gtk_overlay_new();
+	area->stats_label = gtk_label_new(NULL);
 	area->stack = gtk_stack_new();
 	area->gl_area = gtk_gl_area_new();
 	area->graphics_offload = gtk_graphics_offload_new(area->gl_area);
@@ -626,8 +630,20 @@ celluloid_video_area_init(CelluloidVideoArea *area)
 
 	gtk_widget_set_hexpand(area->stack, TRUE);
 
+	gtk_widget_add_css_class(area->stats_label, "osd");
+	gtk_widget_add_css_class(area->stats_label, "monospace");
+	gtk_widget_add_css_class(area->stats_label, "stats");
+	gtk_widget_set_halign(area->stats_label, GTK_ALIGN_START);
+	gtk_widget_set_valign(area->stats_label, GTK_ALIGN_START);
+	gtk_widget_set_can_target(area->stats_label, FALSE);
+	gtk_widget_set_visible(area->stats_label, FALSE);
+	gtk_label_set_xalign(GTK_LABEL(area->stats_label), 0.0f);
+
+	gtk_overlay_set_child(GTK_OVERLAY(area->overlay), area->stack);
+	gtk_overlay_add_overlay(GTK_OVERLAY(area->overlay), area->stats_label);
+
 	adw_toast_overlay_set_child
-		(ADW_TOAST_OVERLAY(area->toast_overlay), area->stack);
+		(ADW_TOAST_OVERLAY(area->toast_overlay), area->overlay);
 
 	adw_toolbar_view_add_top_bar
 		(ADW_TOOLBAR_VIEW(area->toolbar_view), area->header_bar);
@@ -760,6 +776,26 @@ celluloid_video_area_get_control_box_visible(CelluloidVideoArea *area)
 	return gtk_widget_get_visible(area->control_box);
 }
 
+void
+celluloid_video_area_set_stats_visible(	CelluloidVideoArea *area,
+					gboolean visible )
+{
+	gtk_widget_set_visible(area->stats_label, visible);
+}
+
+gboolean
+celluloid_video_area_get_stats_visible(CelluloidVideoArea *area)
+{
+	return gtk_widget_get_visible(area->stats_label);
+}
+
+void
+celluloid_video_area_set_stats_text(	CelluloidVideoArea *area,
+					const gchar *text )
+{
+	gtk_label_set_text(GTK_LABEL(area->stats_label), text);
+}
+
 void
 celluloid_video_area_set_use_floating_header_bar(	CelluloidVideoArea *area,
 							gboolean floating )
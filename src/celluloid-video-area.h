@@ -70,6 +70,17 @@ celluloid_video_area_set_status(	CelluloidVideoArea *area,
 gboolean
 celluloid_video_area_get_control_box_visible(CelluloidVideoArea *area);
 
+void
+celluloid_video_area_set_stats_visible(	CelluloidVideoArea *area,
+					gboolean visible );
+
+gboolean
+celluloid_video_area_get_stats_visible(CelluloidVideoArea *area);
+
+void
+celluloid_video_area_set_stats_text(	CelluloidVideoArea *area,
+					const gchar *text );
+
 void
 celluloid_video_area_set_use_floating_header_bar(	CelluloidVideoArea *area,
 							gboolean floating );
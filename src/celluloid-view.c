@@ -30,6 +30,8 @@
 #include "celluloid-open-location-dialog.h"
 #include "celluloid-preferences-dialog.h"
 #include "celluloid-shortcuts-dialog.h"
+#include "celluloid-log-window.h"
+#include "celluloid-thumbnailer.h"
 #include "celluloid-authors.h"
 #include "celluloid-marshal.h"
 #include "celluloid-menu.h"
@@ -48,6 +50,7 @@ enum
 	PROP_DURATION,
 	PROP_PLAYLIST_POS,
 	PROP_CHAPTER_LIST,
+	PROP_BUFFERED_RANGES,
 	PROP_TRACK_LIST,
 	PROP_DISC_LIST,
 	PROP_SKIP_ENABLED,
@@ -55,6 +58,7 @@ enum
 	PROP_LOOP,
 	PROP_SHUFFLE,
 	PROP_MEDIA_TITLE,
+	PROP_PATH,
 	PROP_DISPLAY_FPS,
 	PROP_SEARCHING,
 	N_PROPERTIES
@@ -65,6 +69,7 @@ struct _CelluloidView
 	CelluloidMainWindow parent;
 	gboolean disposed;
 	gboolean has_dialog;
+	CelluloidThumbnailer *thumbnailer;
 
 	/* Properties */
 	gint playlist_count;
@@ -75,6 +80,7 @@ struct _CelluloidView
 	gdouble duration;
 	gint playlist_pos;
 	GPtrArray *chapter_list;
+	GArray *buffered_ranges;
 	GPtrArray *track_list;
 	GPtrArray *disc_list;
 	gboolean skip_enabled;
@@ -224,6 +230,9 @@ constructed(GObject *object)
 	g_object_bind_property(	view, "chapter-list",
 				control_box, "chapter-list",
 				G_BINDING_DEFAULT );
+	g_object_bind_property(	view, "buffered-ranges",
+				control_box, "buffered-ranges",
+				G_BINDING_DEFAULT );
 	g_object_bind_property(	view, "duration",
 				control_box, "duration",
 				G_BINDING_DEFAULT );
@@ -239,6 +248,7 @@ constructed(GObject *object)
 	g_object_bind_property(	view, "volume-max",
 				control_box, "volume-max",
 				G_BINDING_DEFAULT );
+	g_object_set(control_box, "thumbnailer", view->thumbnailer, NULL);
 	g_object_bind_property(	playlist, "playlist-count",
 				view, "playlist-count",
 				G_BINDING_DEFAULT | G_BINDING_SYNC_CREATE );
@@ -327,6 +337,8 @@ dispose(GObject *object)
 		view->disposed = TRUE;
 	}
 
+	g_clear_object(&view->thumbnailer);
+
 	G_OBJECT_CLASS(celluloid_view_parent_class)->dispose(object);
 }
 
@@ -397,6 +409,10 @@ set_property(	GObject *object,
 		// TODO: run updates
 		break;
 
+		case PROP_BUFFERED_RANGES:
+		self->buffered_ranges = g_value_get_pointer(value);
+		break;
+
 		case PROP_TRACK_LIST:
 		self->track_list = g_value_get_pointer(value);
 		celluloid_main_window_update_track_list(wnd, self->track_list);
@@ -429,6 +445,14 @@ set_property(	GObject *object,
 		update_title(self);
 		break;
 
+		case PROP_PATH:
+		if(self->thumbnailer)
+		{
+			g_object_set_property
+				(G_OBJECT(self->thumbnailer), "path", value);
+		}
+		break;
+
 		case PROP_DISPLAY_FPS:
 		self->display_fps = g_value_get_double(value);
 		break;
@@ -496,6 +520,10 @@ get_property(	GObject *object,
 		g_value_set_pointer(value, self->chapter_list);
 		break;
 
+		case PROP_BUFFERED_RANGES:
+		g_value_set_pointer(value, self->buffered_ranges);
+		break;
+
 		case PROP_TRACK_LIST:
 		g_value_set_pointer(value, self->track_list);
 		break;
@@ -524,6 +552,14 @@ get_property(	GObject *object,
 		g_value_set_static_string(value, self->media_title);
 		break;
 
+		case PROP_PATH:
+		if(self->thumbnailer)
+		{
+			g_object_get_property
+				(G_OBJECT(self->thumbnailer), "path", value);
+		}
+		break;
+
 		case PROP_DISPLAY_FPS:
 		g_value_set_double(value, self->display_fps);
 		break;
@@ -575,6 +611,12 @@ load_css(CelluloidView *view)
 		"{"
 		"	margin: 0px 0px 0px 0px;"
 		"}"
+		".stats"
+		"{"
+		"	margin: 12px;"
+		"	padding: 6px 12px;"
+		"	border-radius: 6px;"
+		"}"
 		".osd, .floating-header windowcontrols image"
 		"{"
 		"	border: 1px solid var(--border-color);"
@@ -1222,6 +1264,13 @@ celluloid_view_class_init(CelluloidViewClass *klass)
 			G_PARAM_READWRITE );
 	g_object_class_install_property(object_class, PROP_CHAPTER_LIST, pspec);
 
+	pspec = g_param_spec_pointer
+		(	"buffered-ranges",
+			"Buffered ranges",
+			"Time ranges of the playing file that are cached",
+			G_PARAM_READWRITE );
+	g_object_class_install_property(object_class, PROP_BUFFERED_RANGES, pspec);
+
 	pspec = g_param_spec_pointer
 		(	"track-list",
 			"Track list",
@@ -1276,6 +1325,14 @@ celluloid_view_class_init(CelluloidViewClass *klass)
 			G_PARAM_READWRITE );
 	g_object_class_install_property(object_class, PROP_MEDIA_TITLE, pspec);
 
+	pspec = g_param_spec_string
+		(	"path",
+			"Path",
+			"The path of the file being played",
+			NULL,
+			G_PARAM_READWRITE );
+	g_object_class_install_property(object_class, PROP_PATH, pspec);
+
 	pspec = g_param_spec_boolean
 		(	"searching",
 			"Searching",
@@ -1423,6 +1480,7 @@ celluloid_view_init(CelluloidView *view)
 {
 	view->disposed = FALSE;
 	view->has_dialog = FALSE;
+	view->thumbnailer = celluloid_thumbnailer_new();
 	view->playlist_count = 0;
 	view->pause = FALSE;
 	view->idle_active = FALSE;
@@ -1431,6 +1489,7 @@ celluloid_view_init(CelluloidView *view)
 	view->duration = 0.0;
 	view->playlist_pos = 0;
 	view->chapter_list = NULL;
+	view->buffered_ranges = NULL;
 	view->track_list = NULL;
 	view->disc_list = NULL;
 	view->skip_enabled = FALSE;
@@ -1619,6 +1678,14 @@ celluloid_view_show_shortcuts_dialog(CelluloidView *view)
 	adw_dialog_set_content_height(dialog, MAX(256, height - 128));
 }
 
+void
+celluloid_view_show_log_window(CelluloidView *view, CelluloidLogBuffer *buffer)
+{
+	GtkWidget *wnd = celluloid_log_window_new(GTK_WINDOW(view), buffer);
+
+	gtk_window_present(GTK_WINDOW(wnd));
+}
+
 void
 celluloid_view_show_about_window (CelluloidView *view)
 {
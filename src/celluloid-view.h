@@ -23,6 +23,7 @@
 #include <glib.h>
 
 #include "celluloid-application.h"
+#include "celluloid-log-buffer.h"
 
 G_BEGIN_DECLS
 
@@ -62,6 +63,9 @@ celluloid_view_show_preferences_dialog(CelluloidView *view);
 void
 celluloid_view_show_shortcuts_dialog(CelluloidView *view);
 
+void
+celluloid_view_show_log_window(CelluloidView *view, CelluloidLogBuffer *buffer);
+
 void
 celluloid_view_show_about_window(CelluloidView *view);
 
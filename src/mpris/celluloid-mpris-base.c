@@ -134,18 +134,22 @@ register_interface(CelluloidMprisModule *module)
 
 	g_object_get(module, "conn", &conn, "iface", &iface, NULL);
 
-	celluloid_mpris_module_connect_signal
-		(	module,
-			view,
-			"notify::fullscreen",
-			G_CALLBACK(fullscreen_handler),
-			module );
+	// Headless controllers have no window to raise or make fullscreen
+	if(view)
+	{
+		celluloid_mpris_module_connect_signal
+			(	module,
+				view,
+				"notify::fullscreen",
+				G_CALLBACK(fullscreen_handler),
+				module );
+	}
 
 	celluloid_mpris_module_set_properties
 		(	module,
 			"CanQuit", g_variant_new_boolean(TRUE),
-			"CanSetFullscreen", g_variant_new_boolean(TRUE),
-			"CanRaise", g_variant_new_boolean(TRUE),
+			"CanSetFullscreen", g_variant_new_boolean(!!view),
+			"CanRaise", g_variant_new_boolean(!!view),
 			"Fullscreen", g_variant_new_boolean(FALSE),
 			"HasTrackList", g_variant_new_boolean(TRUE),
 			"Identity", g_variant_new_string(g_get_application_name()),
@@ -235,8 +239,7 @@ method_handler(	GDBusConnection *connection,
 
 	if(g_strcmp0(method_name, "Raise") == 0)
 	{
-		celluloid_view_present
-			(celluloid_controller_get_view(base->controller));
+		celluloid_controller_present(base->controller);
 	}
 	else if(g_strcmp0(method_name, "Quit") == 0)
 	{
@@ -333,7 +336,11 @@ set_prop_handler(	GDBusConnection *connection,
 	{
 		CelluloidView *view = celluloid_controller_get_view(base->controller);
 
-		celluloid_view_set_fullscreen(view, g_variant_get_boolean(value));
+		if(view)
+		{
+			celluloid_view_set_fullscreen
+				(view, g_variant_get_boolean(value));
+		}
 	}
 
 	return result;
@@ -517,7 +517,7 @@ playlist_entry_to_variant(CelluloidPlaylistEntry *entry, gint64 index)
 {
 	GVariantBuilder builder;
 	gchar *track_id = NULL;
-	gchar *title = NULL;
+	gchar *name = NULL;
 	gchar *sanitized_title = NULL;
 	gchar *uri = NULL;
 	GVariant *elem_value = NULL;
@@ -533,14 +533,18 @@ playlist_entry_to_variant(CelluloidPlaylistEntry *entry, gint64 index)
 				g_variant_new_string(track_id) );
 	g_variant_builder_add_value(&builder, elem_value);
 
-	title =	entry->title?
-		g_strdup(entry->title):
-		get_name_from_path(entry->filename);
-	sanitized_title = sanitize_utf8(title, TRUE);
+	// The entry's title is interned and shared with the rest of the
+	// player, so only a name derived from the path needs to be freed.
+	if(!entry->title)
+	{
+		name = get_name_from_path(entry->filename);
+	}
+
+	sanitized_title = sanitize_utf8(entry->title?:name, TRUE);
 	elem_value =	g_variant_new
 			(	"{sv}",
 				"xesam:title",
-				g_variant_new_string(sanitized_title) );
+				g_variant_new_take_string(sanitized_title) );
 	g_variant_builder_add_value(&builder, elem_value);
 
 	uri =	g_filename_to_uri(entry->filename, NULL, NULL)?:
@@ -548,13 +552,11 @@ playlist_entry_to_variant(CelluloidPlaylistEntry *entry, gint64 index)
 	elem_value =	g_variant_new
 			(	"{sv}",
 				"xesam:uri",
-				g_variant_new_string(uri) );
+				g_variant_new_take_string(uri) );
 	g_variant_builder_add_value(&builder, elem_value);
 
 	g_free(track_id);
-	g_free(title);
-	g_free(sanitized_title);
-	g_free(uri);
+	g_free(name);
 
 	return g_variant_new("a{sv}", &builder);
 }
@@ -109,12 +109,26 @@ constructed(GObject *object)
 	{
 		CelluloidView *view =	celluloid_controller_get_view
 					(self->controller);
-		CelluloidMainWindow *window =	celluloid_view_get_main_window
-						(view);
-		guint window_id =	gtk_application_window_get_id
-					(GTK_APPLICATION_WINDOW(window));
-		gchar *name =	g_strdup_printf
+		gchar *name = NULL;
+
+		if(view)
+		{
+			CelluloidMainWindow *window =
+				celluloid_view_get_main_window(view);
+			guint window_id =
+				gtk_application_window_get_id
+				(GTK_APPLICATION_WINDOW(window));
+
+			name =	g_strdup_printf
 				(MPRIS_BUS_NAME ".instance-%u", window_id);
+		}
+		else
+		{
+			// Several headless instances may run at once, and each
+			// has a process of its own.
+			name =	g_strdup_printf
+				(MPRIS_BUS_NAME ".headless-%d", (gint)getpid());
+		}
 
 		self->session_bus_conn = conn;
 		self->base =	celluloid_mpris_base_new
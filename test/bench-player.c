@@ -0,0 +1,476 @@
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <gio/gio.h>
+
+#include "../src/celluloid-model.h"
+#include "../src/celluloid-metadata-cache.h"
+#include "../src/celluloid-playlist-item.h"
+#include "../src/celluloid-common.h"
+#include "../src/celluloid-def.h"
+
+#include <stdio.h>
+
+#ifdef G_OS_UNIX
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+#define DEFAULT_SIZES "1000,10000,100000"
+#define WAIT_TIMEOUT (300 * G_USEC_PER_SEC)
+#define METADATA_ENTRIES 200
+#define DISPATCH_ENTRIES 20
+#define DISPATCH_RUN_TIME (3 * G_USEC_PER_SEC)
+
+typedef struct _BenchState BenchState;
+
+struct _BenchState
+{
+	guint target;
+	guint count;
+};
+
+static guint settings_created = 0;
+static void (*settings_constructed)(GObject *object) = NULL;
+
+static gchar *
+make_uri(guint index, gdouble duration)
+{
+	// Every entry gets a distinct URI so that nothing is deduplicated by
+	// the metadata cache.
+	return g_strdup_printf(	"av://lavfi:sine=frequency=%u:duration=%g",
+				100 + index,
+				duration );
+}
+
+static void
+count_settings_constructed(GObject *object)
+{
+	settings_created++;
+
+	if(settings_constructed)
+	{
+		settings_constructed(object);
+	}
+}
+
+static void
+count_settings_objects(void)
+{
+	// The class is kept referenced for the rest of the run so that the
+	// hook stays in place.
+	GObjectClass *klass = g_type_class_ref(G_TYPE_SETTINGS);
+
+	settings_constructed = klass->constructed;
+	klass->constructed = count_settings_constructed;
+}
+
+static gboolean
+wake_up_handler(gpointer data)
+{
+	return G_SOURCE_CONTINUE;
+}
+
+static gboolean
+wait_for(const BenchState *state, gint64 timeout)
+{
+	const gint64 deadline = g_get_monotonic_time() + timeout;
+	const guint wake_up_id = g_timeout_add(100, wake_up_handler, NULL);
+
+	while(	state->count < state->target &&
+		g_get_monotonic_time() < deadline )
+	{
+		g_main_context_iteration(NULL, TRUE);
+	}
+
+	g_source_remove(wake_up_id);
+
+	return state->count >= state->target;
+}
+
+static void
+playlist_handler(GObject *object, GParamSpec *pspec, gpointer data)
+{
+	BenchState *state = data;
+	GPtrArray *playlist = NULL;
+
+	g_object_get(object, "playlist", &playlist, NULL);
+
+	state->count = playlist ? playlist->len : 0;
+}
+
+static void
+metadata_update_handler(	CelluloidMetadataCache *cache,
+				const gchar *uri,
+				gpointer data )
+{
+	((BenchState *)data)->count++;
+}
+
+static CelluloidModel *
+create_model(void)
+{
+	CelluloidModel *model = celluloid_model_new(0);
+
+	g_object_set(model, "extra-options", "ao=null", NULL);
+	celluloid_model_initialize(model);
+
+	return model;
+}
+
+static void
+append_result(	GString *json,
+		const gchar *name,
+		guint entries,
+		gdouble value,
+		const gchar *unit )
+{
+	gchar buf[G_ASCII_DTOSTR_BUF_SIZE];
+
+	g_ascii_dtostr(buf, sizeof(buf), value);
+
+	if(json->len > 0)
+	{
+		g_string_append(json, ",\n");
+	}
+
+	g_string_append_printf
+		(	json,
+			"    {\"name\": \"%s\", \"entries\": %u, "
+			"\"value\": %s, \"unit\": \"%s\"}",
+			name,
+			entries,
+			buf,
+			unit );
+}
+
+static void
+bench_playlist(GString *json, guint size)
+{
+	CelluloidModel *model = create_model();
+	BenchState state = {size, 0};
+	gint64 start = 0;
+	gdouble load_time = 0;
+	gdouble update_time = 0;
+	gulong handler_id = 0;
+	guint settings_start = settings_created;
+
+	start = g_get_monotonic_time();
+
+	for(guint i = 0; i < size; i++)
+	{
+		gchar *uri = make_uri(i, 1);
+
+		celluloid_model_load_file(model, uri, i > 0);
+		g_free(uri);
+	}
+
+	load_time = (gdouble)(g_get_monotonic_time() - start) / 1000.0;
+
+	// The entries only reach mpv once the player has seen the initial vo
+	// state, after which mpv reports the playlist back in full.
+	handler_id =	g_signal_connect
+			(	model,
+				"notify::playlist",
+				G_CALLBACK(playlist_handler),
+				&state );
+	start = g_get_monotonic_time();
+
+	if(wait_for(&state, WAIT_TIMEOUT))
+	{
+		update_time = (gdouble)(g_get_monotonic_time() - start) / 1000.0;
+
+		append_result(json, "playlist-load", size, load_time, "ms");
+		append_result(json, "playlist-update", size, update_time, "ms");
+		append_result(	json,
+				"playlist-settings-objects",
+				size,
+				settings_created - settings_start,
+				"objects" );
+	}
+	else
+	{
+		g_warning(	"Timed out waiting for playlist of %u entries "
+				"(got %u)",
+				size,
+				state.count );
+	}
+
+	g_signal_handler_disconnect(model, handler_id);
+	g_object_unref(model);
+}
+
+static void
+bench_metadata(GString *json, guint size)
+{
+	CelluloidMetadataCache *cache = celluloid_metadata_cache_new();
+	GPtrArray *playlist =	g_ptr_array_new_with_free_func
+				((GDestroyNotify)celluloid_playlist_entry_free);
+	BenchState state = {size, 0};
+	gint64 start = 0;
+
+	for(guint i = 0; i < size; i++)
+	{
+		gchar *uri = make_uri(i, 1);
+
+		g_ptr_array_add(playlist, celluloid_playlist_entry_new(uri, NULL));
+		g_free(uri);
+	}
+
+	g_signal_connect(	cache,
+				"update",
+				G_CALLBACK(metadata_update_handler),
+				&state );
+
+	start = g_get_monotonic_time();
+
+	celluloid_metadata_cache_load_playlist(cache, playlist, playlist);
+
+	for(guint i = 0; i < playlist->len; i++)
+	{
+		CelluloidPlaylistEntry *entry = g_ptr_array_index(playlist, i);
+
+		celluloid_metadata_cache_lookup(cache, entry->filename);
+	}
+
+	if(wait_for(&state, WAIT_TIMEOUT))
+	{
+		const gdouble elapsed =
+			(gdouble)(g_get_monotonic_time() - start) /
+			G_USEC_PER_SEC;
+
+		append_result(	json,
+				"metadata-fill",
+				size,
+				size / elapsed,
+				"entries/s" );
+	}
+	else
+	{
+		g_warning(	"Timed out waiting for metadata of %u entries "
+				"(got %u)",
+				size,
+				state.count );
+	}
+
+	celluloid_metadata_cache_release(cache, playlist);
+	g_ptr_array_free(playlist, TRUE);
+	g_object_unref(cache);
+}
+
+static gint64
+get_resident_size(void)
+{
+	gint64 result = -1;
+#ifdef G_OS_UNIX
+	gchar *contents = NULL;
+
+	if(g_file_get_contents("/proc/self/statm", &contents, NULL, NULL))
+	{
+		gchar **fields = g_strsplit(contents, " ", -1);
+
+		if(g_strv_length(fields) > 1)
+		{
+			result =	g_ascii_strtoll(fields[1], NULL, 10) *
+					sysconf(_SC_PAGESIZE);
+		}
+
+		g_strfreev(fields);
+	}
+
+	g_free(contents);
+#endif
+	return result;
+}
+
+static void
+bench_playlist_memory(GString *json, guint size)
+{
+	CelluloidMetadataCache *cache = celluloid_metadata_cache_new();
+	GPtrArray *playlist =	g_ptr_array_new_with_free_func
+				((GDestroyNotify)celluloid_playlist_entry_free);
+	GPtrArray *items = g_ptr_array_new_with_free_func(g_object_unref);
+	const gint64 start = get_resident_size();
+	gint64 end = 0;
+
+	// Mirror what a loaded playlist holds on to: the player's entries, the
+	// playlist widget's items, and a metadata cache entry for every URI.
+	for(guint i = 0; i < size; i++)
+	{
+		gchar *uri = make_uri(i, 1);
+		gchar *title = g_strdup_printf("Track %u", i);
+		CelluloidPlaylistEntry *entry =
+			celluloid_playlist_entry_new(uri, title);
+
+		g_ptr_array_add(playlist, entry);
+		g_ptr_array_add
+			(	items,
+				celluloid_playlist_item_new
+				(entry->title, entry->filename, -1, FALSE) );
+
+		g_free(title);
+		g_free(uri);
+	}
+
+	celluloid_metadata_cache_load_playlist(cache, playlist, playlist);
+
+	end = get_resident_size();
+
+	if(start >= 0 && end >= 0)
+	{
+		append_result(	json,
+				"playlist-memory",
+				size,
+				(gdouble)(end - start) / 1024.0,
+				"KiB" );
+	}
+
+	celluloid_metadata_cache_release(cache, playlist);
+	g_ptr_array_free(items, TRUE);
+	g_ptr_array_free(playlist, TRUE);
+	g_object_unref(cache);
+}
+
+static void
+bench_dispatch(GString *json)
+{
+	CelluloidModel *model = create_model();
+	BenchState state = {G_MAXUINT, 0};
+	gdouble mean = 0;
+	gint64 max = 0;
+
+	// Short entries make mpv go through file transitions, which generate
+	// the most events.
+	for(guint i = 0; i < DISPATCH_ENTRIES; i++)
+	{
+		gchar *uri = make_uri(i, 0.1);
+
+		celluloid_model_load_file(model, uri, i > 0);
+		g_free(uri);
+	}
+
+	wait_for(&state, DISPATCH_RUN_TIME);
+
+	celluloid_stats_get_dispatch_latency
+		(celluloid_mpv_get_stats(CELLULOID_MPV(model)), &mean, &max);
+
+	append_result(	json,
+			"event-dispatch-mean",
+			DISPATCH_ENTRIES,
+			mean / 1000.0,
+			"ms" );
+	append_result(	json,
+			"event-dispatch-max",
+			DISPATCH_ENTRIES,
+			(gdouble)max / 1000.0,
+			"ms" );
+
+	g_object_unref(model);
+}
+
+static void
+append_peak_rss(GString *json)
+{
+#ifdef G_OS_UNIX
+	struct rusage usage;
+
+	if(getrusage(RUSAGE_SELF, &usage) == 0)
+	{
+		// ru_maxrss is in kilobytes on Linux
+		append_result(json, "peak-rss", 0, (gdouble)usage.ru_maxrss, "KiB");
+	}
+#endif
+}
+
+int
+main(int argc, char **argv)
+{
+	gchar *sizes_str = NULL;
+	gchar *output = NULL;
+	GOptionEntry entries[] =
+		{	{	"sizes", 's', 0, G_OPTION_ARG_STRING, &sizes_str,
+				"Comma-separated playlist sizes to test",
+				"N,..." },
+			{	"output", 'o', 0, G_OPTION_ARG_FILENAME, &output,
+				"Write results to FILE instead of stdout",
+				"FILE" },
+			{NULL} };
+	GOptionContext *context = g_option_context_new(NULL);
+	GError *error = NULL;
+	GString *results = g_string_new(NULL);
+	GSettings *settings = NULL;
+	gchar *config_dir = NULL;
+	gchar **sizes = NULL;
+	gchar *json = NULL;
+
+	g_option_context_add_main_entries(context, entries, NULL);
+
+	if(!g_option_context_parse(context, &argc, &argv, &error))
+	{
+		g_printerr("%s\n", error->message);
+		g_error_free(error);
+
+		return 1;
+	}
+
+	// Keep user configuration, scripts, and the resume index out of the
+	// measurements.
+	config_dir = g_dir_make_tmp("celluloid-bench-XXXXXX", NULL);
+	g_setenv("XDG_CONFIG_HOME", config_dir, TRUE);
+	g_setenv("GSETTINGS_BACKEND", "memory", FALSE);
+
+	count_settings_objects();
+	settings = g_settings_new(CONFIG_ROOT);
+
+	// Metadata prefetching is measured on its own by bench_metadata()
+	g_settings_set_boolean(settings, "prefetch-metadata", FALSE);
+
+	sizes = g_strsplit(sizes_str ? sizes_str : DEFAULT_SIZES, ",", -1);
+
+	for(gint i = 0; sizes[i]; i++)
+	{
+		const guint size = (guint)g_ascii_strtoull(sizes[i], NULL, 10);
+
+		if(size > 0)
+		{
+			g_printerr("Measuring playlist of %u entries\n", size);
+			bench_playlist_memory(results, size);
+			bench_playlist(results, size);
+		}
+	}
+
+	g_printerr("Measuring metadata fill\n");
+	bench_metadata(results, METADATA_ENTRIES);
+
+	g_printerr("Measuring event dispatch latency\n");
+	bench_dispatch(results);
+
+	append_peak_rss(results);
+
+	json = g_strdup_printf("{\n  \"results\": [\n%s\n  ]\n}\n", results->str);
+
+	if(output)
+	{
+		if(!g_file_set_contents(output, json, -1, &error))
+		{
+			g_printerr("%s\n", error->message);
+			g_error_free(error);
+		}
+	}
+	else
+	{
+		fputs(json, stdout);
+	}
+
+	g_rmdir(config_dir);
+
+	g_free(json);
+	g_strfreev(sizes);
+	g_object_unref(settings);
+	g_string_free(results, TRUE);
+	g_free(config_dir);
+	g_free(output);
+	g_free(sizes_str);
+	g_option_context_free(context);
+
+	return 0;
+}
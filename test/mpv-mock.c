@@ -0,0 +1,1535 @@
+#include <glib.h>
+#include <string.h>
+#include <mpv/client.h>
+#include <mpv/render.h>
+
+#include "mpv-mock.h"
+
+#define MOCK_MPV_VERSION "mpv 0.40.0"
+
+typedef struct _MockObserver MockObserver;
+typedef struct _MockEvent MockEvent;
+
+struct _MockObserver
+{
+	guint64 reply_userdata;
+	gchar *name;
+	mpv_format format;
+	MockEvent *pending;
+};
+
+struct _MockEvent
+{
+	mpv_event event;
+	MockObserver *observer;
+};
+
+struct mpv_handle
+{
+	GHashTable *properties;
+	GPtrArray *playlist;
+	GPtrArray *observers;
+	GQueue *events;
+	MockEvent *current;
+	mpv_event none_event;
+	guint64 disabled_events;
+	mpv_log_level log_level;
+	void (*wakeup_callback)(void *data);
+	void *wakeup_data;
+	GPtrArray *commands;
+	gboolean initialized;
+};
+
+struct mpv_render_context
+{
+	gint unused;
+};
+
+static const gchar *log_level_names[] =
+	{"no", "fatal", "error", "warn", "info", "v", "debug", "trace", NULL};
+
+static const mpv_log_level log_levels[] =
+	{	MPV_LOG_LEVEL_NONE,
+		MPV_LOG_LEVEL_FATAL,
+		MPV_LOG_LEVEL_ERROR,
+		MPV_LOG_LEVEL_WARN,
+		MPV_LOG_LEVEL_INFO,
+		MPV_LOG_LEVEL_V,
+		MPV_LOG_LEVEL_DEBUG,
+		MPV_LOG_LEVEL_TRACE };
+
+static const struct
+{
+	mpv_event_id id;
+	const gchar *name;
+}
+event_names[] =
+	{	{MPV_EVENT_NONE, "none"},
+		{MPV_EVENT_SHUTDOWN, "shutdown"},
+		{MPV_EVENT_LOG_MESSAGE, "log-message"},
+		{MPV_EVENT_GET_PROPERTY_REPLY, "get-property-reply"},
+		{MPV_EVENT_SET_PROPERTY_REPLY, "set-property-reply"},
+		{MPV_EVENT_COMMAND_REPLY, "command-reply"},
+		{MPV_EVENT_START_FILE, "start-file"},
+		{MPV_EVENT_END_FILE, "end-file"},
+		{MPV_EVENT_FILE_LOADED, "file-loaded"},
+		{MPV_EVENT_IDLE, "idle"},
+		{MPV_EVENT_CLIENT_MESSAGE, "client-message"},
+		{MPV_EVENT_VIDEO_RECONFIG, "video-reconfig"},
+		{MPV_EVENT_AUDIO_RECONFIG, "audio-reconfig"},
+		{MPV_EVENT_SEEK, "seek"},
+		{MPV_EVENT_PLAYBACK_RESTART, "playback-restart"},
+		{MPV_EVENT_PROPERTY_CHANGE, "property-change"},
+		{MPV_EVENT_QUEUE_OVERFLOW, "event-queue-overflow"},
+		{MPV_EVENT_HOOK, "hook"} };
+
+static mpv_handle *last_handle = NULL;
+
+static void
+node_clear(mpv_node *node);
+
+static void
+node_free(mpv_node *node);
+
+static void
+node_copy(mpv_node *dst, const mpv_node *src);
+
+static gboolean
+node_equal(const mpv_node *a, const mpv_node *b);
+
+static gchar *
+node_to_string(const mpv_node *node);
+
+static gint
+node_from_data(mpv_node *dst, mpv_format format, void *data);
+
+static gint
+node_convert(const mpv_node *src, mpv_format format, void *data);
+
+static void
+node_map_add(mpv_node *map, const gchar *key, const mpv_node *value);
+
+static void
+node_map_add_string(mpv_node *map, const gchar *key, const gchar *value);
+
+static void
+node_map_add_int64(mpv_node *map, const gchar *key, gint64 value);
+
+static void
+node_map_add_flag(mpv_node *map, const gchar *key, gboolean value);
+
+static void
+build_playlist_node(mpv_handle *ctx, mpv_node *node);
+
+static gboolean
+get_value(mpv_handle *ctx, const gchar *name, mpv_node *value);
+
+static void
+store_value(mpv_handle *ctx, const gchar *name, mpv_node *value);
+
+static void
+set_int64(mpv_handle *ctx, const gchar *name, gint64 value);
+
+static void
+set_flag(mpv_handle *ctx, const gchar *name, gboolean value);
+
+static void
+set_double(mpv_handle *ctx, const gchar *name, gdouble value);
+
+static void
+set_string(mpv_handle *ctx, const gchar *name, const gchar *value);
+
+static void
+notify(mpv_handle *ctx, const gchar *name);
+
+static void
+notify_playlist(mpv_handle *ctx);
+
+static void
+push_event(mpv_handle *ctx, MockEvent *event);
+
+static MockEvent *
+new_event(mpv_event_id event_id, void *data);
+
+static void
+free_event(MockEvent *event);
+
+static void
+fill_property_event(mpv_handle *ctx, MockEvent *event);
+
+static gint
+run_command(mpv_handle *ctx, const gchar **args);
+
+static void
+node_clear(mpv_node *node)
+{
+	if(node->format == MPV_FORMAT_STRING)
+	{
+		g_free(node->u.string);
+	}
+	else if(	node->format == MPV_FORMAT_NODE_ARRAY ||
+			node->format == MPV_FORMAT_NODE_MAP )
+	{
+		mpv_node_list *list = node->u.list;
+
+		for(gint i = 0; list && i < list->num; i++)
+		{
+			node_clear(&list->values[i]);
+
+			if(list->keys)
+			{
+				g_free(list->keys[i]);
+			}
+		}
+
+		if(list)
+		{
+			g_free(list->values);
+			g_free(list->keys);
+			g_free(list);
+		}
+	}
+
+	node->format = MPV_FORMAT_NONE;
+}
+
+static void
+node_free(mpv_node *node)
+{
+	node_clear(node);
+	g_free(node);
+}
+
+static void
+node_copy(mpv_node *dst, const mpv_node *src)
+{
+	*dst = *src;
+
+	if(src->format == MPV_FORMAT_STRING)
+	{
+		dst->u.string = g_strdup(src->u.string);
+	}
+	else if(	src->format == MPV_FORMAT_NODE_ARRAY ||
+			src->format == MPV_FORMAT_NODE_MAP )
+	{
+		const mpv_node_list *src_list = src->u.list;
+		mpv_node_list *dst_list = g_new0(mpv_node_list, 1);
+
+		dst_list->num = src_list->num;
+		dst_list->values = g_new0(mpv_node, (gsize)src_list->num);
+
+		if(src_list->keys)
+		{
+			dst_list->keys = g_new0(char *, (gsize)src_list->num);
+		}
+
+		for(gint i = 0; i < src_list->num; i++)
+		{
+			node_copy(&dst_list->values[i], &src_list->values[i]);
+
+			if(src_list->keys)
+			{
+				dst_list->keys[i] = g_strdup(src_list->keys[i]);
+			}
+		}
+
+		dst->u.list = dst_list;
+	}
+}
+
+static gboolean
+node_equal(const mpv_node *a, const mpv_node *b)
+{
+	gboolean result = a->format == b->format;
+
+	if(result)
+	{
+		switch(a->format)
+		{
+			case MPV_FORMAT_NONE:
+			break;
+
+			case MPV_FORMAT_STRING:
+			result = g_strcmp0(a->u.string, b->u.string) == 0;
+			break;
+
+			case MPV_FORMAT_FLAG:
+			result = !a->u.flag == !b->u.flag;
+			break;
+
+			case MPV_FORMAT_INT64:
+			result = a->u.int64 == b->u.int64;
+			break;
+
+			case MPV_FORMAT_DOUBLE:
+			result = a->u.double_ == b->u.double_;
+			break;
+
+			// Lists are always reported as changed, like mpv does
+			// for most list properties.
+			default:
+			result = FALSE;
+			break;
+		}
+	}
+
+	return result;
+}
+
+static gchar *
+node_to_string(const mpv_node *node)
+{
+	gchar *result = NULL;
+
+	switch(node->format)
+	{
+		case MPV_FORMAT_STRING:
+		result = g_strdup(node->u.string);
+		break;
+
+		case MPV_FORMAT_FLAG:
+		result = g_strdup(node->u.flag?"yes":"no");
+		break;
+
+		case MPV_FORMAT_INT64:
+		result = g_strdup_printf("%" G_GINT64_FORMAT, node->u.int64);
+		break;
+
+		case MPV_FORMAT_DOUBLE:
+		result = g_malloc(G_ASCII_DTOSTR_BUF_SIZE);
+		g_ascii_formatd
+			(result, G_ASCII_DTOSTR_BUF_SIZE, "%f", node->u.double_);
+		break;
+
+		default:
+		break;
+	}
+
+	return result;
+}
+
+static gint
+node_from_data(mpv_node *dst, mpv_format format, void *data)
+{
+	gint rc = 0;
+
+	dst->format = format;
+
+	switch(format)
+	{
+		case MPV_FORMAT_STRING:
+		case MPV_FORMAT_OSD_STRING:
+		dst->format = MPV_FORMAT_STRING;
+		dst->u.string = g_strdup(*((char **)data));
+		break;
+
+		case MPV_FORMAT_FLAG:
+		dst->u.flag = *((int *)data);
+		break;
+
+		case MPV_FORMAT_INT64:
+		dst->u.int64 = *((int64_t *)data);
+		break;
+
+		case MPV_FORMAT_DOUBLE:
+		dst->u.double_ = *((double *)data);
+		break;
+
+		case MPV_FORMAT_NODE:
+		node_copy(dst, data);
+		break;
+
+		default:
+		dst->format = MPV_FORMAT_NONE;
+		rc = MPV_ERROR_PROPERTY_FORMAT;
+		break;
+	}
+
+	return rc;
+}
+
+static gint
+node_convert(const mpv_node *src, mpv_format format, void *data)
+{
+	gint rc = 0;
+
+	if(format == MPV_FORMAT_NODE)
+	{
+		node_copy(data, src);
+	}
+	else if(format == MPV_FORMAT_STRING || format == MPV_FORMAT_OSD_STRING)
+	{
+		gchar *str = node_to_string(src);
+
+		rc = str?0:MPV_ERROR_PROPERTY_FORMAT;
+		*((char **)data) = str;
+	}
+	else if(format == MPV_FORMAT_FLAG)
+	{
+		if(src->format == MPV_FORMAT_FLAG)
+		{
+			*((int *)data) = src->u.flag;
+		}
+		else if(	src->format == MPV_FORMAT_STRING &&
+				(	g_strcmp0(src->u.string, "yes") == 0 ||
+					g_strcmp0(src->u.string, "no") == 0 ) )
+		{
+			*((int *)data) = g_strcmp0(src->u.string, "yes") == 0;
+		}
+		else
+		{
+			rc = MPV_ERROR_PROPERTY_FORMAT;
+		}
+	}
+	else if(format == MPV_FORMAT_INT64)
+	{
+		if(src->format == MPV_FORMAT_INT64)
+		{
+			*((int64_t *)data) = src->u.int64;
+		}
+		else if(src->format == MPV_FORMAT_DOUBLE)
+		{
+			*((int64_t *)data) = (int64_t)src->u.double_;
+		}
+		else if(	src->format != MPV_FORMAT_STRING ||
+				!g_ascii_string_to_signed
+				(	src->u.string,
+					10,
+					G_MININT64,
+					G_MAXINT64,
+					(gint64 *)data,
+					NULL ) )
+		{
+			rc = MPV_ERROR_PROPERTY_FORMAT;
+		}
+	}
+	else if(format == MPV_FORMAT_DOUBLE)
+	{
+		gchar *end = NULL;
+
+		if(src->format == MPV_FORMAT_DOUBLE)
+		{
+			*((double *)data) = src->u.double_;
+		}
+		else if(src->format == MPV_FORMAT_INT64)
+		{
+			*((double *)data) = (double)src->u.int64;
+		}
+		else if(src->format == MPV_FORMAT_STRING)
+		{
+			*((double *)data) = g_ascii_strtod(src->u.string, &end);
+			rc = (end && !*end)?0:MPV_ERROR_PROPERTY_FORMAT;
+		}
+		else
+		{
+			rc = MPV_ERROR_PROPERTY_FORMAT;
+		}
+	}
+	else
+	{
+		rc = MPV_ERROR_PROPERTY_FORMAT;
+	}
+
+	return rc;
+}
+
+static void
+node_map_add(mpv_node *map, const gchar *key, const mpv_node *value)
+{
+	mpv_node_list *list = map->u.list;
+	const gsize num = (gsize)list->num + 1;
+
+	list->values = g_renew(mpv_node, list->values, num);
+	list->keys = g_renew(char *, list->keys, num);
+	list->values[num - 1] = *value;
+	list->keys[num - 1] = g_strdup(key);
+	list->num = (int)num;
+}
+
+static void
+node_map_add_string(mpv_node *map, const gchar *key, const gchar *value)
+{
+	mpv_node node = {.format = MPV_FORMAT_STRING};
+
+	node.u.string = g_strdup(value);
+	node_map_add(map, key, &node);
+}
+
+static void
+node_map_add_int64(mpv_node *map, const gchar *key, gint64 value)
+{
+	mpv_node node = {.format = MPV_FORMAT_INT64};
+
+	node.u.int64 = value;
+	node_map_add(map, key, &node);
+}
+
+static void
+node_map_add_flag(mpv_node *map, const gchar *key, gboolean value)
+{
+	mpv_node node = {.format = MPV_FORMAT_FLAG};
+
+	node.u.flag = value;
+	node_map_add(map, key, &node);
+}
+
+static void
+build_playlist_node(mpv_handle *ctx, mpv_node *node)
+{
+	mpv_node_list *list = g_new0(mpv_node_list, 1);
+	gint64 pos = -1;
+	mpv_node pos_node;
+
+	if(get_value(ctx, "playlist-pos", &pos_node))
+	{
+		node_convert(&pos_node, MPV_FORMAT_INT64, &pos);
+		node_clear(&pos_node);
+	}
+
+	list->num = (int)ctx->playlist->len;
+	list->values = g_new0(mpv_node, ctx->playlist->len);
+
+	for(guint i = 0; i < ctx->playlist->len; i++)
+	{
+		mpv_node *entry = &list->values[i];
+
+		entry->format = MPV_FORMAT_NODE_MAP;
+		entry->u.list = g_new0(mpv_node_list, 1);
+
+		node_map_add_string
+			(entry, "filename", g_ptr_array_index(ctx->playlist, i));
+		node_map_add_int64(entry, "id", (gint64)i + 1);
+
+		if(pos == (gint64)i)
+		{
+			node_map_add_flag(entry, "current", TRUE);
+			node_map_add_flag(entry, "playing", TRUE);
+		}
+	}
+
+	node->format = MPV_FORMAT_NODE_ARRAY;
+	node->u.list = list;
+}
+
+static gboolean
+get_value(mpv_handle *ctx, const gchar *name, mpv_node *value)
+{
+	gboolean found = TRUE;
+
+	// The playlist is kept as a plain array so that appending to it
+	// doesn't rebuild the node every time. The node is only built when
+	// someone actually reads the property.
+	if(g_strcmp0(name, "playlist") == 0)
+	{
+		build_playlist_node(ctx, value);
+	}
+	else if(g_strcmp0(name, "playlist-count") == 0)
+	{
+		value->format = MPV_FORMAT_INT64;
+		value->u.int64 = ctx->playlist->len;
+	}
+	else
+	{
+		const mpv_node *stored =
+			g_hash_table_lookup(ctx->properties, name);
+
+		found = !!stored;
+
+		if(stored)
+		{
+			node_copy(value, stored);
+		}
+	}
+
+	return found;
+}
+
+static void
+store_value(mpv_handle *ctx, const gchar *name, mpv_node *value)
+{
+	mpv_node *stored = g_hash_table_lookup(ctx->properties, name);
+
+	if(!stored || !node_equal(stored, value))
+	{
+		mpv_node *copy = g_new0(mpv_node, 1);
+
+		// Take ownership of the contents of value
+		*copy = *value;
+		g_hash_table_replace(ctx->properties, g_strdup(name), copy);
+		notify(ctx, name);
+	}
+	else
+	{
+		node_clear(value);
+	}
+}
+
+static void
+set_int64(mpv_handle *ctx, const gchar *name, gint64 value)
+{
+	mpv_node node = {.format = MPV_FORMAT_INT64};
+
+	node.u.int64 = value;
+	store_value(ctx, name, &node);
+}
+
+static void
+set_flag(mpv_handle *ctx, const gchar *name, gboolean value)
+{
+	mpv_node node = {.format = MPV_FORMAT_FLAG};
+
+	node.u.flag = value;
+	store_value(ctx, name, &node);
+}
+
+static void
+set_double(mpv_handle *ctx, const gchar *name, gdouble value)
+{
+	mpv_node node = {.format = MPV_FORMAT_DOUBLE};
+
+	node.u.double_ = value;
+	store_value(ctx, name, &node);
+}
+
+static void
+set_string(mpv_handle *ctx, const gchar *name, const gchar *value)
+{
+	mpv_node node = {.format = MPV_FORMAT_STRING};
+
+	node.u.string = g_strdup(value);
+	store_value(ctx, name, &node);
+}
+
+static void
+notify(mpv_handle *ctx, const gchar *name)
+{
+	for(guint i = 0; i < ctx->observers->len; i++)
+	{
+		MockObserver *observer = g_ptr_array_index(ctx->observers, i);
+
+		// Like mpv, only one change event is kept pending per
+		// observer. The value is read when the event is delivered.
+		if(!observer->pending && g_strcmp0(observer->name, name) == 0)
+		{
+			MockEvent *event =
+				new_event(MPV_EVENT_PROPERTY_CHANGE, NULL);
+
+			event->event.reply_userdata = observer->reply_userdata;
+			event->observer = observer;
+			observer->pending = event;
+
+			push_event(ctx, event);
+		}
+	}
+}
+
+static void
+notify_playlist(mpv_handle *ctx)
+{
+	notify(ctx, "playlist");
+	notify(ctx, "playlist-count");
+}
+
+static void
+push_event(mpv_handle *ctx, MockEvent *event)
+{
+	const guint64 mask = G_GUINT64_CONSTANT(1) << event->event.event_id;
+	const gboolean was_empty = g_queue_is_empty(ctx->events);
+
+	if(ctx->disabled_events & mask)
+	{
+		if(event->observer)
+		{
+			event->observer->pending = NULL;
+		}
+
+		free_event(event);
+	}
+	else
+	{
+		g_queue_push_tail(ctx->events, event);
+
+		if(was_empty && ctx->wakeup_callback)
+		{
+			ctx->wakeup_callback(ctx->wakeup_data);
+		}
+	}
+}
+
+static MockEvent *
+new_event(mpv_event_id event_id, void *data)
+{
+	MockEvent *event = g_new0(MockEvent, 1);
+
+	event->event.event_id = event_id;
+	event->event.data = data;
+
+	return event;
+}
+
+static void
+free_event(MockEvent *event)
+{
+	if(!event)
+	{
+		return;
+	}
+
+	if(	event->event.event_id == MPV_EVENT_PROPERTY_CHANGE ||
+		event->event.event_id == MPV_EVENT_GET_PROPERTY_REPLY )
+	{
+		mpv_event_property *prop = event->event.data;
+
+		if(prop)
+		{
+			if(prop->format == MPV_FORMAT_NODE)
+			{
+				node_clear(prop->data);
+			}
+			else if(	prop->format == MPV_FORMAT_STRING ||
+					prop->format == MPV_FORMAT_OSD_STRING )
+			{
+				g_free(*((char **)prop->data));
+			}
+
+			g_free(prop->data);
+			g_free((gchar *)prop->name);
+			g_free(prop);
+		}
+	}
+	else if(event->event.event_id == MPV_EVENT_CLIENT_MESSAGE)
+	{
+		mpv_event_client_message *msg = event->event.data;
+
+		g_strfreev((gchar **)msg->args);
+		g_free(msg);
+	}
+	else if(event->event.event_id == MPV_EVENT_LOG_MESSAGE)
+	{
+		mpv_event_log_message *msg = event->event.data;
+
+		g_free((gchar *)msg->prefix);
+		g_free((gchar *)msg->text);
+		g_free(msg);
+	}
+	else
+	{
+		g_free(event->event.data);
+	}
+
+	g_free(event);
+}
+
+static void
+fill_property_event(mpv_handle *ctx, MockEvent *event)
+{
+	MockObserver *observer = event->observer;
+	mpv_event_property *prop = g_new0(mpv_event_property, 1);
+	mpv_node value = {.format = MPV_FORMAT_NONE};
+
+	prop->name = g_strdup(observer->name);
+	prop->format = MPV_FORMAT_NONE;
+
+	if(	get_value(ctx, observer->name, &value) &&
+		observer->format != MPV_FORMAT_NONE )
+	{
+		// Large enough for any of the formats that can be observed
+		void *data = g_malloc0(sizeof(mpv_node));
+
+		if(node_convert(&value, observer->format, data) == 0)
+		{
+			prop->format = observer->format;
+			prop->data = data;
+		}
+		else
+		{
+			g_free(data);
+		}
+	}
+
+	node_clear(&value);
+
+	event->event.data = prop;
+	observer->pending = NULL;
+	event->observer = NULL;
+}
+
+static gint
+run_command(mpv_handle *ctx, const gchar **args)
+{
+	const gchar *name = args[0];
+	gint rc = 0;
+
+	if(!name)
+	{
+		return MPV_ERROR_INVALID_PARAMETER;
+	}
+
+	g_ptr_array_add(ctx->commands, g_strjoinv(" ", (gchar **)args));
+
+	if(g_strcmp0(name, "loadfile") == 0 && args[1])
+	{
+		const gchar *mode = args[2]?args[2]:"replace";
+
+		if(	g_strcmp0(mode, "replace") == 0 ||
+			(	g_strcmp0(mode, "append-play") == 0 &&
+				ctx->playlist->len == 0 ) )
+		{
+			g_ptr_array_set_size(ctx->playlist, 0);
+			g_ptr_array_add(ctx->playlist, g_strdup(args[1]));
+
+			set_int64(ctx, "playlist-pos", 0);
+			set_string(ctx, "path", args[1]);
+			set_flag(ctx, "idle-active", FALSE);
+			notify_playlist(ctx);
+
+			push_event(ctx, new_event(MPV_EVENT_START_FILE, NULL));
+			push_event(ctx, new_event(MPV_EVENT_FILE_LOADED, NULL));
+		}
+		else
+		{
+			g_ptr_array_add(ctx->playlist, g_strdup(args[1]));
+			notify_playlist(ctx);
+		}
+	}
+	else if(g_strcmp0(name, "stop") == 0)
+	{
+		int idle_active = TRUE;
+		mpv_node idle_node;
+
+		if(get_value(ctx, "idle-active", &idle_node))
+		{
+			node_convert(&idle_node, MPV_FORMAT_FLAG, &idle_active);
+			node_clear(&idle_node);
+		}
+
+		g_ptr_array_set_size(ctx->playlist, 0);
+
+		set_int64(ctx, "playlist-pos", -1);
+		set_flag(ctx, "idle-active", TRUE);
+		notify_playlist(ctx);
+
+		if(!idle_active)
+		{
+			mpv_mock_push_end_file(ctx, MPV_END_FILE_REASON_STOP, 0);
+		}
+	}
+	else if(g_strcmp0(name, "playlist-clear") == 0)
+	{
+		gint64 pos = -1;
+		mpv_node pos_node;
+
+		if(get_value(ctx, "playlist-pos", &pos_node))
+		{
+			node_convert(&pos_node, MPV_FORMAT_INT64, &pos);
+			node_clear(&pos_node);
+		}
+
+		// mpv keeps the entry that is currently playing
+		if(pos >= 0 && pos < ctx->playlist->len)
+		{
+			gchar *current = g_strdup
+				(g_ptr_array_index(ctx->playlist, (guint)pos));
+
+			g_ptr_array_set_size(ctx->playlist, 0);
+			g_ptr_array_add(ctx->playlist, current);
+			set_int64(ctx, "playlist-pos", 0);
+		}
+		else
+		{
+			g_ptr_array_set_size(ctx->playlist, 0);
+		}
+
+		notify_playlist(ctx);
+	}
+	else if(g_strcmp0(name, "playlist-remove") == 0 && args[1])
+	{
+		gint64 index = -1;
+
+		g_ascii_string_to_signed
+			(args[1], 10, 0, G_MAXINT64, &index, NULL);
+
+		if(index >= 0 && index < ctx->playlist->len)
+		{
+			g_ptr_array_remove_index(ctx->playlist, (guint)index);
+			notify_playlist(ctx);
+		}
+		else
+		{
+			rc = MPV_ERROR_INVALID_PARAMETER;
+		}
+	}
+	else if(g_strcmp0(name, "playlist-move") == 0 && args[1] && args[2])
+	{
+		gint64 src = -1;
+		gint64 dst = -1;
+
+		g_ascii_string_to_signed
+			(args[1], 10, 0, G_MAXINT64, &src, NULL);
+		g_ascii_string_to_signed
+			(args[2], 10, 0, G_MAXINT64, &dst, NULL);
+
+		if(	src >= 0 && src < ctx->playlist->len &&
+			dst >= 0 && dst <= ctx->playlist->len )
+		{
+			gchar *entry =	g_ptr_array_steal_index
+					(ctx->playlist, (guint)src);
+
+			dst -= dst > src;
+			g_ptr_array_insert(ctx->playlist, (gint)dst, entry);
+			notify_playlist(ctx);
+		}
+		else
+		{
+			rc = MPV_ERROR_INVALID_PARAMETER;
+		}
+	}
+	else if(g_strcmp0(name, "seek") == 0 && args[1])
+	{
+		gdouble target = g_ascii_strtod(args[1], NULL);
+
+		if(!args[2] || !strstr(args[2], "absolute"))
+		{
+			gdouble pos = 0;
+			mpv_node pos_node;
+
+			if(get_value(ctx, "time-pos", &pos_node))
+			{
+				node_convert(&pos_node, MPV_FORMAT_DOUBLE, &pos);
+				node_clear(&pos_node);
+			}
+
+			target += pos;
+		}
+
+		set_double(ctx, "time-pos", target);
+		push_event(ctx, new_event(MPV_EVENT_SEEK, NULL));
+		push_event(ctx, new_event(MPV_EVENT_PLAYBACK_RESTART, NULL));
+	}
+	else if(g_strcmp0(name, "set") == 0 && args[1] && args[2])
+	{
+		set_string(ctx, args[1], args[2]);
+	}
+	else if(g_strcmp0(name, "script-message") == 0)
+	{
+		mpv_mock_push_client_message(ctx, args + 1);
+	}
+	else if(g_strcmp0(name, "quit") == 0)
+	{
+		mpv_mock_push_event(ctx, MPV_EVENT_SHUTDOWN);
+	}
+
+	return rc;
+}
+
+mpv_handle *
+mpv_create(void)
+{
+	mpv_handle *ctx = g_new0(mpv_handle, 1);
+	mpv_node bindings = {.format = MPV_FORMAT_NODE_ARRAY};
+
+	ctx->properties =	g_hash_table_new_full
+				(	g_str_hash,
+					g_str_equal,
+					g_free,
+					(GDestroyNotify)node_free );
+	ctx->playlist = g_ptr_array_new_with_free_func(g_free);
+	ctx->observers = g_ptr_array_new();
+	ctx->events = g_queue_new();
+	ctx->none_event.event_id = MPV_EVENT_NONE;
+	ctx->log_level = MPV_LOG_LEVEL_NONE;
+	ctx->commands = g_ptr_array_new_with_free_func(g_free);
+
+	set_string(ctx, "mpv-version", MOCK_MPV_VERSION);
+	set_string(ctx, "current-vo", "null");
+	set_string(ctx, "loop-file", "no");
+	set_string(ctx, "loop-playlist", "no");
+	set_flag(ctx, "idle-active", TRUE);
+	set_flag(ctx, "core-idle", TRUE);
+	set_flag(ctx, "pause", FALSE);
+	set_flag(ctx, "vo-configured", FALSE);
+	set_int64(ctx, "playlist-pos", -1);
+	set_double(ctx, "volume", 100.0);
+	set_double(ctx, "volume-max", 130.0);
+	set_double(ctx, "speed", 1.0);
+
+	bindings.u.list = g_new0(mpv_node_list, 1);
+	store_value(ctx, "input-bindings", &bindings);
+
+	last_handle = ctx;
+
+	return ctx;
+}
+
+int
+mpv_initialize(mpv_handle *ctx)
+{
+	ctx->initialized = TRUE;
+
+	return 0;
+}
+
+void
+mpv_terminate_destroy(mpv_handle *ctx)
+{
+	if(!ctx)
+	{
+		return;
+	}
+
+	free_event(ctx->current);
+	g_queue_free_full(ctx->events, (GDestroyNotify)free_event);
+
+	for(guint i = 0; i < ctx->observers->len; i++)
+	{
+		MockObserver *observer = g_ptr_array_index(ctx->observers, i);
+
+		g_free(observer->name);
+		g_free(observer);
+	}
+
+	g_ptr_array_free(ctx->observers, TRUE);
+	g_ptr_array_free(ctx->playlist, TRUE);
+	g_ptr_array_free(ctx->commands, TRUE);
+	g_hash_table_unref(ctx->properties);
+
+	if(last_handle == ctx)
+	{
+		last_handle = NULL;
+	}
+
+	g_free(ctx);
+}
+
+const char *
+mpv_event_name(mpv_event_id event)
+{
+	const gchar *result = NULL;
+
+	for(guint i = 0; i < G_N_ELEMENTS(event_names) && !result; i++)
+	{
+		if(event_names[i].id == event)
+		{
+			result = event_names[i].name;
+		}
+	}
+
+	return result;
+}
+
+const char *
+mpv_error_string(int error)
+{
+	const gchar *result = "unknown error";
+
+	switch(error)
+	{
+		case MPV_ERROR_SUCCESS:
+		result = "success";
+		break;
+
+		case MPV_ERROR_INVALID_PARAMETER:
+		result = "invalid parameter";
+		break;
+
+		case MPV_ERROR_UNINITIALIZED:
+		result = "core not initialized";
+		break;
+
+		case MPV_ERROR_PROPERTY_FORMAT:
+		result = "unsupported format for accessing property";
+		break;
+
+		case MPV_ERROR_PROPERTY_UNAVAILABLE:
+		result = "property unavailable";
+		break;
+
+		case MPV_ERROR_NOT_IMPLEMENTED:
+		result = "operation not implemented";
+		break;
+	}
+
+	return result;
+}
+
+void
+mpv_free(void *data)
+{
+	g_free(data);
+}
+
+void
+mpv_free_node_contents(mpv_node *node)
+{
+	node_clear(node);
+}
+
+int
+mpv_set_option(mpv_handle *ctx, const char *name, mpv_format format, void *data)
+{
+	return mpv_set_property(ctx, name, format, data);
+}
+
+int
+mpv_set_option_string(mpv_handle *ctx, const char *name, const char *data)
+{
+	return mpv_set_property_string(ctx, name, data);
+}
+
+int
+mpv_load_config_file(mpv_handle *ctx, const char *filename)
+{
+	return g_file_test(filename, G_FILE_TEST_IS_REGULAR)?
+		0:MPV_ERROR_INVALID_PARAMETER;
+}
+
+int
+mpv_command(mpv_handle *ctx, const char **args)
+{
+	return run_command(ctx, args);
+}
+
+int
+mpv_command_string(mpv_handle *ctx, const char *args)
+{
+	gchar **argv = NULL;
+	gint rc = MPV_ERROR_INVALID_PARAMETER;
+
+	if(g_shell_parse_argv(args, NULL, &argv, NULL))
+	{
+		rc = run_command(ctx, (const gchar **)argv);
+	}
+
+	g_strfreev(argv);
+
+	return rc;
+}
+
+int
+mpv_command_async(mpv_handle *ctx, uint64_t reply_userdata, const char **args)
+{
+	MockEvent *event = new_event(MPV_EVENT_COMMAND_REPLY, NULL);
+
+	event->event.error = run_command(ctx, args);
+	event->event.reply_userdata = reply_userdata;
+	push_event(ctx, event);
+
+	return 0;
+}
+
+void
+mpv_abort_async_command(mpv_handle *ctx, uint64_t reply_userdata)
+{
+	// Commands run to completion before mpv_command_async() returns, so
+	// there is never anything left to abort.
+}
+
+int
+mpv_set_property(	mpv_handle *ctx,
+			const char *name,
+			mpv_format format,
+			void *data )
+{
+	mpv_node value = {.format = MPV_FORMAT_NONE};
+	gint rc = 0;
+
+	if(	g_strcmp0(name, "playlist") == 0 ||
+		g_strcmp0(name, "playlist-count") == 0 )
+	{
+		rc = MPV_ERROR_PROPERTY_UNAVAILABLE;
+	}
+	else
+	{
+		rc = node_from_data(&value, format, data);
+	}
+
+	if(rc == 0)
+	{
+		store_value(ctx, name, &value);
+	}
+
+	return rc;
+}
+
+int
+mpv_set_property_string(mpv_handle *ctx, const char *name, const char *data)
+{
+	return mpv_set_property(ctx, name, MPV_FORMAT_STRING, &data);
+}
+
+int
+mpv_get_property(	mpv_handle *ctx,
+			const char *name,
+			mpv_format format,
+			void *data )
+{
+	mpv_node value = {.format = MPV_FORMAT_NONE};
+	gint rc = MPV_ERROR_PROPERTY_UNAVAILABLE;
+
+	if(get_value(ctx, name, &value))
+	{
+		rc = node_convert(&value, format, data);
+		node_clear(&value);
+	}
+
+	return rc;
+}
+
+int
+mpv_set_property_async(	mpv_handle *ctx,
+			uint64_t reply_userdata,
+			const char *name,
+			mpv_format format,
+			void *data )
+{
+	MockEvent *event = new_event(MPV_EVENT_SET_PROPERTY_REPLY, NULL);
+
+	event->event.error = mpv_set_property(ctx, name, format, data);
+	event->event.reply_userdata = reply_userdata;
+	push_event(ctx, event);
+
+	return 0;
+}
+
+int
+mpv_get_property_async(	mpv_handle *ctx,
+			uint64_t reply_userdata,
+			const char *name,
+			mpv_format format )
+{
+	mpv_event_property *prop = g_new0(mpv_event_property, 1);
+	MockEvent *event = new_event(MPV_EVENT_GET_PROPERTY_REPLY, prop);
+	// Large enough for any of the formats that can be requested
+	void *data = g_malloc0(sizeof(mpv_node));
+
+	prop->name = g_strdup(name);
+	prop->format = MPV_FORMAT_NONE;
+	event->event.error = mpv_get_property(ctx, name, format, data);
+	event->event.reply_userdata = reply_userdata;
+
+	if(event->event.error == 0)
+	{
+		prop->format = format;
+		prop->data = data;
+	}
+	else
+	{
+		g_free(data);
+	}
+
+	push_event(ctx, event);
+
+	return 0;
+}
+
+char *
+mpv_get_property_string(mpv_handle *ctx, const char *name)
+{
+	char *result = NULL;
+
+	mpv_get_property(ctx, name, MPV_FORMAT_STRING, &result);
+
+	return result;
+}
+
+int
+mpv_observe_property(	mpv_handle *ctx,
+			uint64_t reply_userdata,
+			const char *name,
+			mpv_format format )
+{
+	MockObserver *observer = g_new0(MockObserver, 1);
+
+	observer->reply_userdata = reply_userdata;
+	observer->name = g_strdup(name);
+	observer->format = format;
+
+	g_ptr_array_add(ctx->observers, observer);
+
+	// mpv always reports the initial value of observed properties
+	notify(ctx, name);
+
+	return 0;
+}
+
+int
+mpv_unobserve_property(mpv_handle *ctx, uint64_t registered_reply_userdata)
+{
+	gint count = 0;
+
+	for(guint i = 0; i < ctx->observers->len;)
+	{
+		MockObserver *observer = g_ptr_array_index(ctx->observers, i);
+
+		if(observer->reply_userdata == registered_reply_userdata)
+		{
+			if(observer->pending)
+			{
+				g_queue_remove(ctx->events, observer->pending);
+				free_event(observer->pending);
+			}
+
+			g_ptr_array_remove_index(ctx->observers, i);
+			g_free(observer->name);
+			g_free(observer);
+			count++;
+		}
+		else
+		{
+			i++;
+		}
+	}
+
+	return count;
+}
+
+int
+mpv_request_event(mpv_handle *ctx, mpv_event_id event, int enable)
+{
+	const guint64 mask = G_GUINT64_CONSTANT(1) << event;
+
+	if(enable)
+	{
+		ctx->disabled_events &= ~mask;
+	}
+	else
+	{
+		ctx->disabled_events |= mask;
+	}
+
+	return 0;
+}
+
+int
+mpv_request_log_messages(mpv_handle *ctx, const char *min_level)
+{
+	gint rc = MPV_ERROR_INVALID_PARAMETER;
+
+	for(guint i = 0; log_level_names[i]; i++)
+	{
+		if(g_strcmp0(log_level_names[i], min_level) == 0)
+		{
+			ctx->log_level = log_levels[i];
+			rc = 0;
+		}
+	}
+
+	return rc;
+}
+
+mpv_event *
+mpv_wait_event(mpv_handle *ctx, double timeout)
+{
+	mpv_event *result = &ctx->none_event;
+
+	// The previous event stays valid until the next call, like in mpv
+	free_event(ctx->current);
+	ctx->current = g_queue_pop_head(ctx->events);
+
+	if(ctx->current)
+	{
+		if(ctx->current->observer)
+		{
+			fill_property_event(ctx, ctx->current);
+		}
+
+		result = &ctx->current->event;
+	}
+
+	return result;
+}
+
+void
+mpv_set_wakeup_callback(mpv_handle *ctx, void (*cb)(void *d), void *d)
+{
+	ctx->wakeup_callback = cb;
+	ctx->wakeup_data = d;
+
+	if(cb && !g_queue_is_empty(ctx->events))
+	{
+		cb(d);
+	}
+}
+
+int
+mpv_render_context_create(	mpv_render_context **res,
+				mpv_handle *mpv,
+				mpv_render_param *params )
+{
+	*res = NULL;
+
+	return MPV_ERROR_NOT_IMPLEMENTED;
+}
+
+void
+mpv_render_context_set_update_callback(	mpv_render_context *ctx,
+						mpv_render_update_fn callback,
+						void *callback_ctx )
+{
+}
+
+uint64_t
+mpv_render_context_update(mpv_render_context *ctx)
+{
+	return 0;
+}
+
+int
+mpv_render_context_render(mpv_render_context *ctx, mpv_render_param *params)
+{
+	return MPV_ERROR_NOT_IMPLEMENTED;
+}
+
+void
+mpv_render_context_free(mpv_render_context *ctx)
+{
+}
+
+mpv_handle *
+mpv_mock_get_last_handle(void)
+{
+	return last_handle;
+}
+
+void
+mpv_mock_push_event(mpv_handle *ctx, mpv_event_id event_id)
+{
+	push_event(ctx, new_event(event_id, NULL));
+}
+
+void
+mpv_mock_push_end_file(	mpv_handle *ctx,
+			mpv_end_file_reason reason,
+			int error )
+{
+	mpv_event_end_file *data = g_new0(mpv_event_end_file, 1);
+
+	data->reason = reason;
+	data->error = error;
+
+	push_event(ctx, new_event(MPV_EVENT_END_FILE, data));
+}
+
+void
+mpv_mock_push_client_message(mpv_handle *ctx, const char **args)
+{
+	mpv_event_client_message *data = g_new0(mpv_event_client_message, 1);
+
+	data->args = (const char **)g_strdupv((gchar **)args);
+	data->num_args = (int)g_strv_length((gchar **)args);
+
+	push_event(ctx, new_event(MPV_EVENT_CLIENT_MESSAGE, data));
+}
+
+void
+mpv_mock_push_log_message(	mpv_handle *ctx,
+				const char *prefix,
+				mpv_log_level level,
+				const char *text )
+{
+	if(level <= ctx->log_level && level != MPV_LOG_LEVEL_NONE)
+	{
+		mpv_event_log_message *data = g_new0(mpv_event_log_message, 1);
+
+		data->prefix = g_strdup(prefix);
+		data->text = g_strdup(text);
+		data->log_level = level;
+
+		for(guint i = 0; log_level_names[i]; i++)
+		{
+			if(log_levels[i] == level)
+			{
+				data->level = log_level_names[i];
+			}
+		}
+
+		push_event(ctx, new_event(MPV_EVENT_LOG_MESSAGE, data));
+	}
+}
+
+void
+mpv_mock_store_property(	mpv_handle *ctx,
+				const char *name,
+				mpv_format format,
+				void *data )
+{
+	mpv_node value = {.format = MPV_FORMAT_NONE};
+
+	if(node_from_data(&value, format, data) != 0)
+	{
+		return;
+	}
+
+	if(g_strcmp0(name, "playlist") == 0)
+	{
+		const mpv_node_list *list =
+			value.format == MPV_FORMAT_NODE_ARRAY?value.u.list:NULL;
+
+		g_ptr_array_set_size(ctx->playlist, 0);
+
+		for(gint i = 0; list && i < list->num; i++)
+		{
+			const mpv_node *entry = &list->values[i];
+			const mpv_node_list *map =
+				entry->format == MPV_FORMAT_NODE_MAP?
+				entry->u.list:NULL;
+
+			for(gint j = 0; map && j < map->num; j++)
+			{
+				if(	g_strcmp0(map->keys[j], "filename") == 0 &&
+					map->values[j].format == MPV_FORMAT_STRING )
+				{
+					g_ptr_array_add
+						(	ctx->playlist,
+							g_strdup(map->values[j].u.string) );
+				}
+			}
+		}
+
+		node_clear(&value);
+	}
+	else if(g_strcmp0(name, "playlist-count") == 0)
+	{
+		node_clear(&value);
+	}
+	else
+	{
+		mpv_node *copy = g_new0(mpv_node, 1);
+
+		*copy = value;
+		g_hash_table_replace(ctx->properties, g_strdup(name), copy);
+	}
+}
+
+void
+mpv_mock_set_playlist(	mpv_handle *ctx,
+			const char * const *filenames,
+			gint64 count )
+{
+	g_ptr_array_set_size(ctx->playlist, 0);
+
+	for(gint64 i = 0; i < count; i++)
+	{
+		g_ptr_array_add(ctx->playlist, g_strdup(filenames[i]));
+	}
+
+	notify_playlist(ctx);
+}
+
+guint
+mpv_mock_get_pending_events(mpv_handle *ctx)
+{
+	return g_queue_get_length(ctx->events);
+}
+
+const GPtrArray *
+mpv_mock_get_commands(mpv_handle *ctx)
+{
+	return ctx->commands;
+}
+
+void
+mpv_mock_clear_commands(mpv_handle *ctx)
+{
+	g_ptr_array_set_size(ctx->commands, 0);
+}
@@ -0,0 +1,65 @@
+#ifndef MPV_MOCK_H
+#define MPV_MOCK_H
+
+#include <glib.h>
+#include <mpv/client.h>
+
+/* Scripting interface of the libmpv stand-in built with -Dmock-mpv=true.
+ *
+ * The stand-in implements the parts of the client and render API that
+ * Celluloid uses. Properties live in a table and can be changed with the
+ * regular mpv_set_property() family, which notifies observers the same way
+ * mpv does. Events are queued by the functions below and delivered through
+ * mpv_wait_event() after the wakeup callback fires. Nothing happens on a
+ * separate thread, so a test drives the core completely from the main loop.
+ *
+ * mpv_mock_store_property() changes a property without notifying observers,
+ * which is useful when events are delivered some other way, for example
+ * when replaying a recorded trace.
+ */
+
+G_BEGIN_DECLS
+
+mpv_handle *
+mpv_mock_get_last_handle(void);
+
+void
+mpv_mock_push_event(mpv_handle *ctx, mpv_event_id event_id);
+
+void
+mpv_mock_push_end_file(	mpv_handle *ctx,
+			mpv_end_file_reason reason,
+			int error );
+
+void
+mpv_mock_push_client_message(mpv_handle *ctx, const char **args);
+
+void
+mpv_mock_push_log_message(	mpv_handle *ctx,
+				const char *prefix,
+				mpv_log_level level,
+				const char *text );
+
+void
+mpv_mock_store_property(	mpv_handle *ctx,
+				const char *name,
+				mpv_format format,
+				void *data );
+
+void
+mpv_mock_set_playlist(	mpv_handle *ctx,
+			const char * const *filenames,
+			gint64 count );
+
+guint
+mpv_mock_get_pending_events(mpv_handle *ctx);
+
+const GPtrArray *
+mpv_mock_get_commands(mpv_handle *ctx);
+
+void
+mpv_mock_clear_commands(mpv_handle *ctx);
+
+G_END_DECLS
+
+#endif
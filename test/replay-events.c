@@ -0,0 +1,325 @@
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <gio/gio.h>
+
+#include "../src/celluloid-model.h"
+#include "../src/celluloid-event-trace.h"
+#include "../src/celluloid-def.h"
+
+#include "mpv-mock.h"
+
+#include <stdio.h>
+
+/* Replays an event trace recorded with CELLULOID_EVENT_TRACE_DIR through the
+ * same "mpv-event-notify" signal that CelluloidMpv emits for live events,
+ * and reports how long the handlers took for each type of event. The player
+ * runs against the libmpv stand-in, so property values from the trace are
+ * stored in it and in the property mirror before each event for handlers
+ * that read them back.
+ */
+
+typedef struct _EventStats EventStats;
+
+struct _EventStats
+{
+	gchar *name;
+	guint count;
+	gint64 total;
+	gint64 max;
+};
+
+static void
+event_stats_free(EventStats *stats)
+{
+	g_free(stats->name);
+	g_free(stats);
+}
+
+static gint
+compare_total(gconstpointer a, gconstpointer b)
+{
+	const EventStats *stats_a = *((EventStats * const *)a);
+	const EventStats *stats_b = *((EventStats * const *)b);
+
+	return	(stats_a->total < stats_b->total) -
+		(stats_a->total > stats_b->total);
+}
+
+static gchar *
+get_event_key(const mpv_event *event)
+{
+	const gchar *name = mpv_event_name(event->event_id);
+	gchar *key = NULL;
+
+	// Property changes are broken down by property since their handlers
+	// have little in common.
+	if(event->event_id == MPV_EVENT_PROPERTY_CHANGE)
+	{
+		const mpv_event_property *prop = event->data;
+
+		key = g_strdup_printf("%s (%s)", name, prop->name);
+	}
+	else if(name)
+	{
+		key = g_strdup(name);
+	}
+	else
+	{
+		key = g_strdup_printf("event %d", event->event_id);
+	}
+
+	return key;
+}
+
+static gint64
+drain(mpv_handle *ctx)
+{
+	const gint64 start = g_get_monotonic_time();
+
+	while(	mpv_mock_get_pending_events(ctx) > 0 ||
+		g_main_context_pending(NULL) )
+	{
+		g_main_context_iteration(NULL, FALSE);
+	}
+
+	return g_get_monotonic_time() - start;
+}
+
+static void
+wait_until(mpv_handle *ctx, gint64 deadline)
+{
+	while(g_get_monotonic_time() < deadline)
+	{
+		const gint64 remaining = deadline - g_get_monotonic_time();
+
+		if(!g_main_context_pending(NULL))
+		{
+			g_usleep((gulong)MIN(remaining, 1000));
+		}
+
+		drain(ctx);
+	}
+}
+
+static void
+print_report(GHashTable *table, guint n_events, gint64 deferred)
+{
+	GPtrArray *sorted = g_ptr_array_new();
+	GHashTableIter iter;
+	gpointer value = NULL;
+
+	g_hash_table_iter_init(&iter, table);
+
+	while(g_hash_table_iter_next(&iter, NULL, &value))
+	{
+		g_ptr_array_add(sorted, value);
+	}
+
+	g_ptr_array_sort(sorted, compare_total);
+
+	printf(	"%-48s %8s %12s %12s %12s\n",
+		"Event",
+		"Count",
+		"Total (ms)",
+		"Mean (us)",
+		"Max (us)" );
+
+	for(guint i = 0; i < sorted->len; i++)
+	{
+		const EventStats *stats = g_ptr_array_index(sorted, i);
+
+		printf(	"%-48s %8u %12.3f %12.1f %12" G_GINT64_FORMAT "\n",
+			stats->name,
+			stats->count,
+			(gdouble)stats->total / 1000.0,
+			(gdouble)stats->total / stats->count,
+			stats->max );
+	}
+
+	printf(	"\n%u events replayed, %.3f ms spent in deferred work\n",
+		n_events,
+		(gdouble)deferred / 1000.0 );
+
+	g_ptr_array_free(sorted, TRUE);
+}
+
+static gboolean
+replay(const gchar *path, gboolean realtime, GError **error)
+{
+	CelluloidEventTraceReader *reader = NULL;
+	CelluloidModel *model = NULL;
+	mpv_handle *ctx = NULL;
+	GHashTable *table = NULL;
+	const mpv_event *event = NULL;
+	GError *tmp_error = NULL;
+	gint64 start = 0;
+	gint64 timestamp = 0;
+	gint64 deferred = 0;
+	guint n_events = 0;
+
+	reader = celluloid_event_trace_reader_new(path, error);
+
+	if(!reader)
+	{
+		return FALSE;
+	}
+
+	table =	g_hash_table_new_full
+		(	g_str_hash,
+			g_str_equal,
+			NULL,
+			(GDestroyNotify)event_stats_free );
+
+	model = celluloid_model_new(0);
+	ctx = mpv_mock_get_last_handle();
+
+	celluloid_model_initialize(model);
+	drain(ctx);
+
+	start = g_get_monotonic_time();
+
+	while((event = celluloid_event_trace_reader_next
+			(reader, &timestamp, &tmp_error)))
+	{
+		gchar *key = get_event_key(event);
+		EventStats *stats = g_hash_table_lookup(table, key);
+		gint64 begin = 0;
+		gint64 elapsed = 0;
+
+		if(!stats)
+		{
+			stats = g_new0(EventStats, 1);
+			stats->name = key;
+
+			g_hash_table_insert(table, stats->name, stats);
+		}
+		else
+		{
+			g_free(key);
+		}
+
+		if(realtime)
+		{
+			wait_until(ctx, start + timestamp);
+		}
+
+		if(event->event_id == MPV_EVENT_PROPERTY_CHANGE)
+		{
+			const mpv_event_property *prop = event->data;
+
+			if(prop->format != MPV_FORMAT_NONE)
+			{
+				mpv_mock_store_property
+					(ctx, prop->name, prop->format, prop->data);
+			}
+
+			// CelluloidMpv updates its mirror before emitting the
+			// signal, which is bypassed here.
+			celluloid_property_mirror_update
+				(	celluloid_mpv_get_property_mirror
+					(CELLULOID_MPV(model)),
+					prop );
+		}
+
+		begin = g_get_monotonic_time();
+
+		g_signal_emit_by_name(	model,
+					"mpv-event-notify",
+					event->event_id,
+					event->data );
+
+		elapsed = g_get_monotonic_time() - begin;
+
+		stats->count++;
+		stats->total += elapsed;
+		stats->max = MAX(stats->max, elapsed);
+		n_events++;
+
+		// Work that the handlers defer to the main loop is accounted
+		// separately since it can't be attributed to a single event.
+		deferred += drain(ctx);
+
+		if(event->event_id == MPV_EVENT_SHUTDOWN)
+		{
+			break;
+		}
+	}
+
+	if(tmp_error)
+	{
+		g_propagate_error(error, tmp_error);
+	}
+	else
+	{
+		print_report(table, n_events, deferred);
+	}
+
+	g_object_unref(model);
+	g_hash_table_unref(table);
+	celluloid_event_trace_reader_free(reader);
+
+	return !tmp_error;
+}
+
+int
+main(int argc, char **argv)
+{
+	gboolean realtime = FALSE;
+	GOptionEntry entries[] =
+		{	{	"realtime", 'r', 0, G_OPTION_ARG_NONE, &realtime,
+				"Keep the timing of the recorded events",
+				NULL },
+			{NULL} };
+	GOptionContext *context = g_option_context_new("TRACE");
+	GError *error = NULL;
+	GSettings *settings = NULL;
+	gchar *config_dir = NULL;
+	gint rc = 0;
+
+	g_option_context_add_main_entries(context, entries, NULL);
+
+	if(!g_option_context_parse(context, &argc, &argv, &error))
+	{
+		g_printerr("%s\n", error->message);
+		g_error_free(error);
+		g_option_context_free(context);
+
+		return 1;
+	}
+
+	if(argc != 2)
+	{
+		gchar *help = g_option_context_get_help(context, TRUE, NULL);
+
+		g_printerr("%s", help);
+		g_free(help);
+		g_option_context_free(context);
+
+		return 1;
+	}
+
+	// Keep user configuration and scripts out of the measurements
+	config_dir = g_dir_make_tmp("celluloid-replay-XXXXXX", NULL);
+	g_setenv("XDG_CONFIG_HOME", config_dir, TRUE);
+	g_setenv("GSETTINGS_BACKEND", "memory", FALSE);
+	g_unsetenv("CELLULOID_EVENT_TRACE_DIR");
+
+	settings = g_settings_new(CONFIG_ROOT);
+	g_settings_set_boolean(settings, "prefetch-metadata", FALSE);
+
+	if(!replay(argv[1], realtime, &error))
+	{
+		g_printerr("Failed to replay %s: %s\n", argv[1], error->message);
+		g_error_free(error);
+
+		rc = 1;
+	}
+
+	g_rmdir(config_dir);
+
+	g_object_unref(settings);
+	g_free(config_dir);
+	g_option_context_free(context);
+
+	return rc;
+}
@@ -0,0 +1,122 @@
+#include <glib.h>
+#include <string.h>
+
+#include "celluloid-log-levels.h"
+#include "celluloid-log-buffer.h"
+
+static void
+test_levels_lookup(void)
+{
+	CelluloidLogLevels *levels = celluloid_log_levels_new();
+	mpv_log_level level = MPV_LOG_LEVEL_NONE;
+
+	celluloid_log_levels_set(levels, "ffmpeg", MPV_LOG_LEVEL_WARN);
+	celluloid_log_levels_set(levels, "ffmpeg/video", MPV_LOG_LEVEL_DEBUG);
+	celluloid_log_levels_set(levels, "cplayer", MPV_LOG_LEVEL_INFO);
+
+	g_assert_true(celluloid_log_levels_lookup(levels, "cplayer", &level));
+	g_assert_cmpint(level, ==, MPV_LOG_LEVEL_INFO);
+
+	// The most specific prefix wins
+	g_assert_true
+		(celluloid_log_levels_lookup(levels, "ffmpeg/video", &level));
+	g_assert_cmpint(level, ==, MPV_LOG_LEVEL_DEBUG);
+
+	g_assert_true
+		(celluloid_log_levels_lookup(levels, "ffmpeg/audio", &level));
+	g_assert_cmpint(level, ==, MPV_LOG_LEVEL_WARN);
+
+	g_assert_true
+		(celluloid_log_levels_lookup(levels, "ffmpeg/video/x", &level));
+	g_assert_cmpint(level, ==, MPV_LOG_LEVEL_DEBUG);
+
+	// Prefixes only match whole components
+	g_assert_false(celluloid_log_levels_lookup(levels, "ffmpegx", &level));
+	g_assert_false(celluloid_log_levels_lookup(levels, "ffmp", &level));
+	g_assert_false(celluloid_log_levels_lookup(levels, "vo", &level));
+
+	// Setting a prefix again replaces its level
+	celluloid_log_levels_set(levels, "cplayer", MPV_LOG_LEVEL_TRACE);
+	g_assert_true(celluloid_log_levels_lookup(levels, "cplayer", &level));
+	g_assert_cmpint(level, ==, MPV_LOG_LEVEL_TRACE);
+
+	g_assert_cmpint(	celluloid_log_levels_get_max
+				(levels, MPV_LOG_LEVEL_ERROR),
+				==,
+				MPV_LOG_LEVEL_TRACE );
+
+	celluloid_log_levels_free(levels);
+}
+
+static void
+test_buffer_wrap(void)
+{
+	CelluloidLogBuffer *buffer = celluloid_log_buffer_new(5);
+	CelluloidLogLine line;
+	guint64 first = 0;
+	guint64 end = 0;
+
+	// The size is rounded up to a power of two
+	for(guint i = 0; i < 10; i++)
+	{
+		gchar *text = g_strdup_printf("line %u\n", i);
+
+		celluloid_log_buffer_append
+			(buffer, MPV_LOG_LEVEL_INFO, "test", text);
+		g_free(text);
+	}
+
+	celluloid_log_buffer_get_range(buffer, &first, &end);
+
+	g_assert_cmpuint(first, ==, 2);
+	g_assert_cmpuint(end, ==, 10);
+
+	g_assert_false(celluloid_log_buffer_read(buffer, 1, &line));
+	g_assert_false(celluloid_log_buffer_read(buffer, 10, &line));
+
+	g_assert_true(celluloid_log_buffer_read(buffer, 2, &line));
+	g_assert_cmpuint(line.index, ==, 2);
+	g_assert_cmpstr(line.prefix, ==, "test");
+	g_assert_cmpstr(line.text, ==, "line 2");
+
+	g_assert_true(celluloid_log_buffer_read(buffer, 9, &line));
+	g_assert_cmpstr(line.text, ==, "line 9");
+
+	celluloid_log_buffer_unref(buffer);
+}
+
+static void
+test_buffer_truncate(void)
+{
+	CelluloidLogBuffer *buffer = celluloid_log_buffer_new(1);
+	GString *text = g_string_new(NULL);
+	CelluloidLogLine line;
+
+	// Multi-byte characters are not split
+	while(text->len < CELLULOID_LOG_TEXT_SIZE)
+	{
+		g_string_append(text, "\xc3\xa9");
+	}
+
+	celluloid_log_buffer_append
+		(buffer, MPV_LOG_LEVEL_INFO, "test", text->str);
+
+	g_assert_true(celluloid_log_buffer_read(buffer, 0, &line));
+	g_assert_cmpuint(strlen(line.text), ==, CELLULOID_LOG_TEXT_SIZE - 2);
+	g_assert_true(g_utf8_validate(line.text, -1, NULL));
+
+	g_string_free(text, TRUE);
+	celluloid_log_buffer_unref(buffer);
+}
+
+int
+main(int argc, char **argv)
+{
+	g_test_init(&argc, &argv, NULL);
+
+	g_test_add_func("/log/levels/lookup", test_levels_lookup);
+	g_test_add_func("/log/buffer/wrap", test_buffer_wrap);
+	g_test_add_func("/log/buffer/truncate", test_buffer_truncate);
+
+	return g_test_run();
+}
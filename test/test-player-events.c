@@ -0,0 +1,1038 @@
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <gio/gio.h>
+
+#include "../src/celluloid-model.h"
+#include "../src/celluloid-common.h"
+#include "../src/celluloid-def.h"
+#include "../src/celluloid-event-trace.h"
+#include "../src/celluloid-job-scheduler.h"
+
+#include "mpv-mock.h"
+
+#define PLAYLIST_BURST_SIZE 100000
+#define METADATA_BURST_SIZE 1000
+#define METADATA_TRACE_SIZE 500
+#define METADATA_TRACE_INTERVAL 200
+#define JOB_THROTTLE_TIME 200
+
+typedef struct _Fixture Fixture;
+
+struct _Fixture
+{
+	CelluloidModel *model;
+	mpv_handle *ctx;
+	guint notify_count;
+	gchar *notified_title;
+};
+
+static void
+drain(Fixture *fixture)
+{
+	while(	mpv_mock_get_pending_events(fixture->ctx) > 0 ||
+		g_main_context_pending(NULL) )
+	{
+		g_main_context_iteration(NULL, FALSE);
+	}
+}
+
+static void
+set_flag(Fixture *fixture, const gchar *name, gboolean value)
+{
+	int flag = value;
+
+	mpv_set_property(fixture->ctx, name, MPV_FORMAT_FLAG, &flag);
+}
+
+static void
+notify_handler(GObject *object, GParamSpec *pspec, gpointer data)
+{
+	((Fixture *)data)->notify_count++;
+}
+
+static void
+fixture_set_up(Fixture *fixture, gconstpointer data)
+{
+	fixture->model = celluloid_model_new(0);
+	fixture->ctx = mpv_mock_get_last_handle();
+	fixture->notify_count = 0;
+	fixture->notified_title = NULL;
+
+	celluloid_model_initialize(fixture->model);
+	drain(fixture);
+
+	// Pretend that a file is already playing so that property changes
+	// are handled the same way as during playback.
+	set_flag(fixture, "idle-active", FALSE);
+	set_flag(fixture, "vo-configured", TRUE);
+	drain(fixture);
+}
+
+static void
+fixture_tear_down(Fixture *fixture, gconstpointer data)
+{
+	g_object_unref(fixture->model);
+	g_free(fixture->notified_title);
+}
+
+static void
+test_playlist_burst(Fixture *fixture, gconstpointer data)
+{
+	const gchar **filenames = g_new0(const gchar *, PLAYLIST_BURST_SIZE + 1);
+	GPtrArray *playlist = NULL;
+	GTimer *timer = g_timer_new();
+
+	for(guint i = 0; i < PLAYLIST_BURST_SIZE; i++)
+	{
+		filenames[i] = g_strdup_printf("/media/%06u.webm", i);
+	}
+
+	g_signal_connect(	fixture->model,
+				"notify::playlist",
+				G_CALLBACK(notify_handler),
+				fixture );
+
+	g_timer_start(timer);
+	mpv_mock_set_playlist(fixture->ctx, filenames, PLAYLIST_BURST_SIZE);
+	drain(fixture);
+	g_timer_stop(timer);
+
+	g_object_get(fixture->model, "playlist", &playlist, NULL);
+
+	g_assert_nonnull(playlist);
+	g_assert_cmpuint(playlist->len, ==, PLAYLIST_BURST_SIZE);
+	g_assert_cmpuint(fixture->notify_count, ==, 1);
+
+	g_test_message(	"Playlist of %u entries handled in %.1f ms",
+			PLAYLIST_BURST_SIZE,
+			g_timer_elapsed(timer, NULL) * 1000.0 );
+
+	g_timer_destroy(timer);
+	g_strfreev((gchar **)filenames);
+}
+
+static void
+set_metadata_title(Fixture *fixture, guint index)
+{
+	gchar *title = g_strdup_printf("Title %u", index);
+	char *keys[] = {"title"};
+	mpv_node value = {.format = MPV_FORMAT_STRING, .u.string = title};
+	mpv_node_list list = {.num = 1, .values = &value, .keys = keys};
+	mpv_node metadata = {.format = MPV_FORMAT_NODE_MAP, .u.list = &list};
+
+	mpv_set_property(fixture->ctx, "metadata", MPV_FORMAT_NODE, &metadata);
+
+	g_free(title);
+}
+
+static void
+test_metadata_burst(Fixture *fixture, gconstpointer data)
+{
+	GPtrArray *metadata = NULL;
+	CelluloidMetadataEntry *entry = NULL;
+	GTimer *timer = g_timer_new();
+
+	g_signal_connect(	fixture->model,
+				"notify::metadata",
+				G_CALLBACK(notify_handler),
+				fixture );
+
+	// Every change gets delivered when the main loop runs in between
+	g_timer_start(timer);
+
+	for(guint i = 0; i < METADATA_BURST_SIZE; i++)
+	{
+		set_metadata_title(fixture, i);
+		drain(fixture);
+	}
+
+	g_timer_stop(timer);
+
+	g_assert_cmpuint(fixture->notify_count, ==, METADATA_BURST_SIZE);
+
+	g_test_message(	"%u metadata changes handled in %.1f ms",
+			METADATA_BURST_SIZE,
+			g_timer_elapsed(timer, NULL) * 1000.0 );
+
+	// Changes that happen before the events are read are coalesced
+	fixture->notify_count = 0;
+
+	for(guint i = 0; i < METADATA_BURST_SIZE; i++)
+	{
+		set_metadata_title(fixture, METADATA_BURST_SIZE + i);
+	}
+
+	drain(fixture);
+
+	g_object_get(fixture->model, "metadata", &metadata, NULL);
+
+	g_assert_cmpuint(fixture->notify_count, ==, 1);
+	g_assert_cmpuint(metadata->len, ==, 1);
+
+	entry = g_ptr_array_index(metadata, 0);
+
+	g_assert_cmpstr(entry->key, ==, "title");
+	g_assert_cmpstr(entry->value, ==, "Title 1999");
+
+	g_timer_destroy(timer);
+}
+
+static void
+write_metadata_trace(const gchar *path)
+{
+	GError *error = NULL;
+	CelluloidEventTraceWriter *writer =
+		celluloid_event_trace_writer_new(path, &error);
+
+	g_assert_no_error(error);
+
+	// Internet radio stations keep their name and genre and only change
+	// the title of the current song.
+	for(guint i = 0; i < METADATA_TRACE_SIZE; i++)
+	{
+		gchar *title = g_strdup_printf("Artist - Song %u", i);
+		char *keys[] = {"icy-name", "icy-genre", "icy-title"};
+		mpv_node values[] =
+			{	{.format = MPV_FORMAT_STRING, .u.string = "Radio"},
+				{.format = MPV_FORMAT_STRING, .u.string = "Jazz"},
+				{.format = MPV_FORMAT_STRING, .u.string = title} };
+		mpv_node_list list = {.num = 3, .values = values, .keys = keys};
+		mpv_node metadata =
+			{.format = MPV_FORMAT_NODE_MAP, .u.list = &list};
+		mpv_event_property prop =
+			{"metadata", MPV_FORMAT_NODE, &metadata};
+		mpv_event event = {MPV_EVENT_PROPERTY_CHANGE, 0, 0, &prop};
+
+		celluloid_event_trace_writer_add(writer, &event);
+		g_free(title);
+	}
+
+	celluloid_event_trace_writer_free(writer);
+}
+
+static const gchar *
+get_metadata_value(Fixture *fixture, const gchar *key)
+{
+	GPtrArray *metadata = NULL;
+	const gchar *value = NULL;
+
+	g_object_get(fixture->model, "metadata", &metadata, NULL);
+
+	for(guint i = 0; i < metadata->len && !value; i++)
+	{
+		CelluloidMetadataEntry *entry = g_ptr_array_index(metadata, i);
+
+		if(g_strcmp0(entry->key, key) == 0)
+		{
+			value = entry->value;
+		}
+	}
+
+	return value;
+}
+
+static void
+metadata_notify_handler(GObject *object, GParamSpec *pspec, gpointer data)
+{
+	Fixture *fixture = data;
+
+	fixture->notify_count++;
+
+	g_free(fixture->notified_title);
+	fixture->notified_title =
+		g_strdup(get_metadata_value(fixture, "icy-title"));
+}
+
+static void
+test_metadata_trace(Fixture *fixture, gconstpointer data)
+{
+	gchar *dir = g_dir_make_tmp("celluloid-trace-XXXXXX", NULL);
+	gchar *path = g_build_filename(dir, "metadata.trace", NULL);
+	GSettings *settings = g_settings_new(CONFIG_ROOT);
+	CelluloidEventTraceReader *reader = NULL;
+	GPtrArray *metadata = NULL;
+	gpointer name_entry = NULL;
+	const mpv_event *event = NULL;
+	GError *error = NULL;
+	GTimer *timer = g_timer_new();
+	gint64 timestamp = 0;
+	gint64 deadline = 0;
+	guint max_count = 0;
+
+	write_metadata_trace(path);
+
+	g_settings_set_int
+		(settings, "metadata-update-interval", METADATA_TRACE_INTERVAL);
+	drain(fixture);
+
+	g_signal_connect(	fixture->model,
+				"notify::metadata",
+				G_CALLBACK(metadata_notify_handler),
+				fixture );
+
+	reader = celluloid_event_trace_reader_new(path, &error);
+	g_assert_no_error(error);
+
+	// Deliver every change separately, the way a live stream would
+	g_timer_start(timer);
+
+	while((event = celluloid_event_trace_reader_next
+			(reader, &timestamp, &error)))
+	{
+		const mpv_event_property *prop = event->data;
+
+		mpv_set_property(fixture->ctx, prop->name, prop->format, prop->data);
+		drain(fixture);
+
+		g_object_get(fixture->model, "metadata", &metadata, NULL);
+
+		// Tags that didn't change keep their entries
+		if(!name_entry)
+		{
+			name_entry = g_ptr_array_index(metadata, 0);
+		}
+
+		g_assert_true(g_ptr_array_index(metadata, 0) == name_entry);
+	}
+
+	g_timer_stop(timer);
+	g_assert_no_error(error);
+
+	// Only the first change goes out right away. The rest are held back
+	// until the interval passes.
+	max_count =	2 +
+			(guint)(g_timer_elapsed(timer, NULL) * 1000.0 /
+			METADATA_TRACE_INTERVAL);
+
+	g_assert_cmpuint(fixture->notify_count, >=, 1);
+	g_assert_cmpuint(fixture->notify_count, <=, max_count);
+	g_assert_cmpuint(metadata->len, ==, 3);
+	g_assert_cmpstr(	get_metadata_value(fixture, "icy-title"),
+				==,
+				"Artist - Song 499" );
+
+	g_test_message(	"%u metadata changes resulted in %u notifications "
+			"in %.1f ms",
+			METADATA_TRACE_SIZE,
+			fixture->notify_count,
+			g_timer_elapsed(timer, NULL) * 1000.0 );
+
+	// The last change is delivered once the interval is over
+	deadline =	g_get_monotonic_time() +
+			2 * METADATA_TRACE_INTERVAL * G_TIME_SPAN_MILLISECOND;
+
+	while(	g_strcmp0(fixture->notified_title, "Artist - Song 499") != 0 &&
+		g_get_monotonic_time() < deadline )
+	{
+		g_main_context_iteration(NULL, FALSE);
+		g_usleep(1000);
+	}
+
+	g_assert_cmpstr(fixture->notified_title, ==, "Artist - Song 499");
+
+	g_settings_set_int(settings, "metadata-update-interval", 0);
+	drain(fixture);
+
+	celluloid_event_trace_reader_free(reader);
+	g_unlink(path);
+	g_rmdir(dir);
+
+	g_timer_destroy(timer);
+	g_object_unref(settings);
+	g_free(path);
+	g_free(dir);
+}
+
+static void
+test_load_file(Fixture *fixture, gconstpointer data)
+{
+	const GPtrArray *commands = NULL;
+	gboolean found = FALSE;
+
+	mpv_mock_clear_commands(fixture->ctx);
+	celluloid_model_load_file
+		(fixture->model, "file:///media/foo.webm", FALSE);
+	drain(fixture);
+
+	commands = mpv_mock_get_commands(fixture->ctx);
+
+	for(guint i = 0; i < commands->len && !found; i++)
+	{
+		found =	g_strcmp0
+			(	g_ptr_array_index(commands, i),
+				"loadfile /media/foo.webm replace" ) == 0;
+	}
+
+	g_assert_true(found);
+}
+
+static guint
+count_commands(Fixture *fixture, const gchar *prefix)
+{
+	const GPtrArray *commands = mpv_mock_get_commands(fixture->ctx);
+	guint count = 0;
+
+	for(guint i = 0; i < commands->len; i++)
+	{
+		count += g_str_has_prefix(g_ptr_array_index(commands, i), prefix);
+	}
+
+	return count;
+}
+
+static gboolean
+has_command(Fixture *fixture, const gchar *command)
+{
+	const GPtrArray *commands = mpv_mock_get_commands(fixture->ctx);
+	gboolean found = FALSE;
+
+	for(guint i = 0; i < commands->len && !found; i++)
+	{
+		found = g_strcmp0(g_ptr_array_index(commands, i), command) == 0;
+	}
+
+	return found;
+}
+
+static void
+test_append_file(Fixture *fixture, gconstpointer data)
+{
+	// Only the first of several queued appends to an empty playlist
+	// starts playback.
+	mpv_mock_clear_commands(fixture->ctx);
+	celluloid_model_load_file
+		(fixture->model, "file:///media/foo.webm", TRUE);
+	celluloid_model_load_file
+		(fixture->model, "file:///media/bar.webm", TRUE);
+	drain(fixture);
+
+	g_assert_cmpuint(count_commands(fixture, "loadfile "), ==, 2);
+	g_assert_true
+		(has_command(fixture, "loadfile /media/foo.webm append-play"));
+	g_assert_true(has_command(fixture, "loadfile /media/bar.webm append"));
+
+	// Later appends go by the length that mpv reported
+	mpv_mock_clear_commands(fixture->ctx);
+	celluloid_model_load_file
+		(fixture->model, "file:///media/baz.webm", TRUE);
+	drain(fixture);
+
+	g_assert_cmpuint(count_commands(fixture, "loadfile "), ==, 1);
+	g_assert_true(has_command(fixture, "loadfile /media/baz.webm append"));
+}
+
+static void
+test_append_after_stop(void)
+{
+	Fixture fixture = {0};
+	CelluloidMpv *mpv = celluloid_mpv_new(0);
+	const gchar *stop_cmd[] = {"stop", NULL};
+
+	fixture.ctx = mpv_mock_get_last_handle();
+	celluloid_mpv_initialize(mpv);
+
+	// A core that doesn't observe anything itself, like the job
+	// scheduler's workers, must still start a file appended after the
+	// playlist was emptied.
+	celluloid_mpv_load_file(mpv, "file:///media/foo.webm", TRUE);
+	celluloid_mpv_command_async(mpv, stop_cmd);
+	celluloid_mpv_load_file(mpv, "file:///media/bar.webm", TRUE);
+	drain(&fixture);
+
+	g_assert_true
+		(has_command(&fixture, "loadfile /media/foo.webm append-play"));
+	g_assert_true
+		(has_command(&fixture, "loadfile /media/bar.webm append-play"));
+
+	g_object_unref(mpv);
+}
+
+static void
+test_scrub(Fixture *fixture, gconstpointer data)
+{
+	const GPtrArray *commands = NULL;
+
+	mpv_mock_clear_commands(fixture->ctx);
+
+	// Only the first position is sent while its seek is in flight
+	for(guint i = 0; i < 100; i++)
+	{
+		celluloid_model_scrub(fixture->model, i);
+	}
+
+	g_assert_cmpuint(count_commands(fixture, "seek "), ==, 1);
+
+	// ...and only the latest one is sent once it completes
+	drain(fixture);
+
+	commands = mpv_mock_get_commands(fixture->ctx);
+
+	g_assert_cmpuint(count_commands(fixture, "seek "), ==, 2);
+	g_assert_cmpstr(	g_ptr_array_index(commands, 0),
+				==,
+				"seek 0 absolute+keyframes" );
+	g_assert_cmpstr(	g_ptr_array_index(commands, 1),
+				==,
+				"seek 99 absolute+keyframes" );
+
+	// Releasing the slider drops anything still pending in favor of an
+	// exact seek.
+	mpv_mock_clear_commands(fixture->ctx);
+	celluloid_model_scrub(fixture->model, 10);
+	celluloid_model_scrub(fixture->model, 20);
+	celluloid_model_seek(fixture->model, 30);
+	drain(fixture);
+
+	commands = mpv_mock_get_commands(fixture->ctx);
+
+	g_assert_cmpuint(commands->len, ==, 2);
+	g_assert_cmpstr(	g_ptr_array_index(commands, 0),
+				==,
+				"seek 10 absolute+keyframes" );
+	g_assert_cmpstr(	g_ptr_array_index(commands, 1),
+				==,
+				"seek 30 absolute+exact" );
+}
+
+static void
+test_playlist_edit(Fixture *fixture, gconstpointer data)
+{
+	const gchar *filenames[] = {"a.webm", "b.webm", "c.webm"};
+	const gchar *expected[] = {"c.webm", "a.webm"};
+	GPtrArray *playlist = NULL;
+
+	mpv_mock_set_playlist(fixture->ctx, filenames, 3);
+	drain(fixture);
+
+	// Like the playlist widget, the source index counts the destination
+	// row as already inserted. Moving c to the front and removing b
+	// leaves c, a.
+	celluloid_model_move_playlist_entry(fixture->model, 3, 0);
+	celluloid_model_remove_playlist_entry(fixture->model, 2);
+	drain(fixture);
+
+	g_object_get(fixture->model, "playlist", &playlist, NULL);
+
+	g_assert_cmpuint(playlist->len, ==, G_N_ELEMENTS(expected));
+
+	for(guint i = 0; i < G_N_ELEMENTS(expected); i++)
+	{
+		CelluloidPlaylistEntry *entry = g_ptr_array_index(playlist, i);
+
+		g_assert_cmpstr(entry->filename, ==, expected[i]);
+	}
+}
+
+static void
+test_property_mirror(Fixture *fixture, gconstpointer data)
+{
+	CelluloidMpv *mpv = CELLULOID_MPV(fixture->model);
+	gint64 chapters = 7;
+	gint64 width = 640;
+
+	mpv_set_property(fixture->ctx, "chapters", MPV_FORMAT_INT64, &chapters);
+	drain(fixture);
+
+	g_assert_cmpint
+		(celluloid_mpv_get_mirrored_int64(mpv, "chapters"), ==, 7);
+	g_assert_false(celluloid_mpv_get_mirrored_flag(mpv, "idle-active"));
+
+	// Observed properties are served from the mirror without asking the
+	// core, so a silent change only shows up with the next event.
+	chapters = 9;
+	mpv_mock_store_property
+		(fixture->ctx, "chapters", MPV_FORMAT_INT64, &chapters);
+
+	g_assert_cmpint
+		(celluloid_mpv_get_mirrored_int64(mpv, "chapters"), ==, 7);
+
+	mpv_set_property(fixture->ctx, "chapters", MPV_FORMAT_INT64, &chapters);
+	drain(fixture);
+
+	g_assert_cmpint
+		(celluloid_mpv_get_mirrored_int64(mpv, "chapters"), ==, 9);
+
+	// Anything else is read from mpv
+	mpv_mock_store_property
+		(fixture->ctx, "dwidth", MPV_FORMAT_INT64, &width);
+
+	g_assert_cmpint
+		(celluloid_mpv_get_mirrored_int64(mpv, "dwidth"), ==, 640);
+}
+
+typedef struct _AsyncState AsyncState;
+
+struct _AsyncState
+{
+	gboolean done;
+	gboolean success;
+	GError *error;
+	gint64 value;
+};
+
+static void
+command_ready(GObject *source, GAsyncResult *result, gpointer data)
+{
+	AsyncState *state = data;
+
+	state->success =	celluloid_mpv_command_finish
+				(CELLULOID_MPV(source), result, &state->error);
+	state->done = TRUE;
+}
+
+static void
+get_property_ready(GObject *source, GAsyncResult *result, gpointer data)
+{
+	AsyncState *state = data;
+
+	state->success =	celluloid_mpv_get_property_finish
+				(	CELLULOID_MPV(source),
+					result,
+					&state->value,
+					&state->error );
+	state->done = TRUE;
+}
+
+static void
+test_async_requests(Fixture *fixture, gconstpointer data)
+{
+	CelluloidMpv *mpv = CELLULOID_MPV(fixture->model);
+	const gchar *cmd[] = {"script-message", "test", NULL};
+	GCancellable *cancellable = g_cancellable_new();
+	AsyncState state = {0};
+	gint64 count = 42;
+
+	celluloid_mpv_command_async_full(mpv, cmd, NULL, command_ready, &state);
+	drain(fixture);
+
+	g_assert_true(state.done);
+	g_assert_true(state.success);
+	g_assert_no_error(state.error);
+
+	// Values are handed back through the finish function
+	state = (AsyncState){0};
+	celluloid_mpv_set_property_async
+		(mpv, "chapters", MPV_FORMAT_INT64, &count, NULL, NULL, NULL);
+	celluloid_mpv_get_property_async(	mpv,
+						"chapters",
+						MPV_FORMAT_INT64,
+						NULL,
+						get_property_ready,
+						&state );
+	drain(fixture);
+
+	g_assert_true(state.success);
+	g_assert_cmpint(state.value, ==, 42);
+
+	// Errors from mpv keep their code
+	state = (AsyncState){0};
+	celluloid_mpv_get_property_async(	mpv,
+						"no-such-property",
+						MPV_FORMAT_INT64,
+						NULL,
+						get_property_ready,
+						&state );
+	drain(fixture);
+
+	g_assert_false(state.success);
+	g_assert_error(	state.error,
+			CELLULOID_MPV_ERROR,
+			MPV_ERROR_PROPERTY_UNAVAILABLE );
+	g_clear_error(&state.error);
+
+	// A cancelled request completes with a cancellation error even though
+	// mpv ran it.
+	state = (AsyncState){0};
+	g_cancellable_cancel(cancellable);
+	celluloid_mpv_command_async_full
+		(mpv, cmd, cancellable, command_ready, &state);
+	drain(fixture);
+
+	g_assert_true(state.done);
+	g_assert_error(state.error, G_IO_ERROR, G_IO_ERROR_CANCELLED);
+	g_clear_error(&state.error);
+
+	g_object_unref(cancellable);
+}
+
+typedef struct _JobRecord JobRecord;
+typedef struct _JobData JobData;
+
+struct _JobRecord
+{
+	GPtrArray *loaded;
+	guint destroyed;
+	gint64 first_load_time;
+};
+
+struct _JobData
+{
+	JobRecord *record;
+	const gchar *name;
+};
+
+static gboolean
+record_job(	CelluloidMpv *worker,
+		gint event_id,
+		gpointer event_data,
+		gpointer data )
+{
+	JobData *job_data = data;
+	JobRecord *record = job_data->record;
+
+	if(event_id != MPV_EVENT_FILE_LOADED)
+	{
+		return G_SOURCE_CONTINUE;
+	}
+
+	if(record->loaded->len == 0)
+	{
+		record->first_load_time = g_get_monotonic_time();
+	}
+
+	g_ptr_array_add(record->loaded, (gpointer)job_data->name);
+
+	return G_SOURCE_REMOVE;
+}
+
+static void
+job_data_free(JobData *data)
+{
+	data->record->destroyed++;
+	g_free(data);
+}
+
+static guint
+submit_job(	CelluloidJobScheduler *scheduler,
+		CelluloidJobPriority priority,
+		gint64 deadline,
+		JobRecord *record,
+		const gchar *name )
+{
+	JobData *data = g_new0(JobData, 1);
+
+	data->record = record;
+	data->name = name;
+
+	return	celluloid_job_scheduler_submit
+		(	scheduler,
+			priority,
+			name,
+			deadline,
+			record_job,
+			data,
+			(GDestroyNotify)job_data_free );
+}
+
+static void
+wait_for_jobs(	CelluloidJobScheduler *scheduler,
+		CelluloidJobPriority priority,
+		guint64 count )
+{
+	const gint64 deadline = g_get_monotonic_time() + G_TIME_SPAN_SECOND;
+	CelluloidJobQueueStats stats = {0};
+
+	do
+	{
+		while(g_main_context_pending(NULL))
+		{
+			g_main_context_iteration(NULL, FALSE);
+		}
+
+		celluloid_job_scheduler_get_queue_stats
+			(scheduler, priority, &stats);
+
+		g_usleep(1000);
+	}
+	while(	stats.completed +
+		stats.failed +
+		stats.cancelled +
+		stats.expired < count &&
+		g_get_monotonic_time() < deadline );
+}
+
+static void
+test_job_priorities(void)
+{
+	CelluloidJobScheduler *scheduler = celluloid_job_scheduler_new(1);
+	JobRecord record = {g_ptr_array_new(), 0, 0};
+	const struct
+	{
+		CelluloidJobPriority priority;
+		const gchar *name;
+	}
+	jobs[] = {	{CELLULOID_JOB_PRIORITY_LOW, "low.webm"},
+			{CELLULOID_JOB_PRIORITY_NORMAL, "normal-1.webm"},
+			{CELLULOID_JOB_PRIORITY_HIGH, "high.webm"},
+			{CELLULOID_JOB_PRIORITY_NORMAL, "normal-2.webm"} };
+	const gchar *expected[] =
+		{"high.webm", "normal-1.webm", "normal-2.webm", "low.webm"};
+	CelluloidJobQueueStats stats = {0};
+
+	for(guint i = 0; i < G_N_ELEMENTS(jobs); i++)
+	{
+		submit_job(	scheduler,
+				jobs[i].priority,
+				0,
+				&record,
+				jobs[i].name );
+	}
+
+	wait_for_jobs(scheduler, CELLULOID_JOB_PRIORITY_LOW, 1);
+
+	// A single worker runs the jobs one at a time in order of priority
+	g_assert_cmpuint(record.loaded->len, ==, G_N_ELEMENTS(expected));
+
+	for(guint i = 0; i < record.loaded->len; i++)
+	{
+		g_assert_cmpstr
+			(g_ptr_array_index(record.loaded, i), ==, expected[i]);
+	}
+
+	celluloid_job_scheduler_get_queue_stats
+		(scheduler, CELLULOID_JOB_PRIORITY_NORMAL, &stats);
+
+	g_assert_cmpuint(stats.queued, ==, 0);
+	g_assert_cmpuint(stats.running, ==, 0);
+	g_assert_cmpuint(stats.started, ==, 2);
+	g_assert_cmpuint(stats.completed, ==, 2);
+	g_assert_cmpfloat(stats.throughput, >, 0);
+
+	g_object_unref(scheduler);
+
+	g_assert_cmpuint(record.destroyed, ==, G_N_ELEMENTS(expected));
+
+	g_ptr_array_free(record.loaded, TRUE);
+}
+
+static void
+test_job_cancel(void)
+{
+	CelluloidJobScheduler *scheduler = celluloid_job_scheduler_new(1);
+	JobRecord record = {g_ptr_array_new(), 0, 0};
+	CelluloidJobQueueStats stats = {0};
+	const gint64 submit_time = g_get_monotonic_time();
+	guint id = 0;
+
+	celluloid_job_scheduler_throttle(scheduler, JOB_THROTTLE_TIME);
+
+	submit_job
+		(scheduler, CELLULOID_JOB_PRIORITY_NORMAL, 0, &record, "a.webm");
+	id =	submit_job
+		(scheduler, CELLULOID_JOB_PRIORITY_NORMAL, 0, &record, "b.webm");
+	submit_job(	scheduler,
+			CELLULOID_JOB_PRIORITY_NORMAL,
+			submit_time,
+			&record,
+			"c.webm" );
+
+	g_assert_true(celluloid_job_scheduler_cancel(scheduler, id));
+	g_assert_false(celluloid_job_scheduler_cancel(scheduler, id));
+	g_assert_cmpuint(record.destroyed, ==, 1);
+
+	wait_for_jobs(scheduler, CELLULOID_JOB_PRIORITY_NORMAL, 3);
+
+	// Nothing starts until the throttle time is over, by which time the
+	// last job has missed its deadline.
+	g_assert_cmpuint(record.loaded->len, ==, 1);
+	g_assert_cmpstr(g_ptr_array_index(record.loaded, 0), ==, "a.webm");
+	g_assert_cmpint(	record.first_load_time - submit_time,
+				>=,
+				JOB_THROTTLE_TIME * G_TIME_SPAN_MILLISECOND );
+
+	celluloid_job_scheduler_get_queue_stats
+		(scheduler, CELLULOID_JOB_PRIORITY_NORMAL, &stats);
+
+	g_assert_cmpuint(stats.completed, ==, 1);
+	g_assert_cmpuint(stats.cancelled, ==, 1);
+	g_assert_cmpuint(stats.expired, ==, 1);
+
+	g_object_unref(scheduler);
+
+	g_assert_cmpuint(record.destroyed, ==, 3);
+
+	g_ptr_array_free(record.loaded, TRUE);
+}
+
+static void
+test_event_trace(void)
+{
+	gchar *dir = g_dir_make_tmp("celluloid-trace-XXXXXX", NULL);
+	gchar *path = g_build_filename(dir, "events.trace", NULL);
+	CelluloidEventTraceWriter *writer = NULL;
+	CelluloidEventTraceReader *reader = NULL;
+	const mpv_event *event = NULL;
+	GError *error = NULL;
+	gint64 timestamp = -1;
+
+	const char *args[] = {"celluloid-action", "win.quit", NULL};
+	char *keys[] = {"title"};
+	char *title = "Title";
+	double volume = 42.5;
+	mpv_node value = {.format = MPV_FORMAT_STRING, .u.string = title};
+	mpv_node_list list = {.num = 1, .values = &value, .keys = keys};
+	mpv_node metadata = {.format = MPV_FORMAT_NODE_MAP, .u.list = &list};
+	mpv_event_property volume_prop =
+		{"volume", MPV_FORMAT_DOUBLE, &volume};
+	mpv_event_property metadata_prop =
+		{"metadata", MPV_FORMAT_NODE, &metadata};
+	mpv_event_client_message msg = {2, args};
+	mpv_event events[] =
+		{	{MPV_EVENT_PROPERTY_CHANGE, 0, 0, &volume_prop},
+			{MPV_EVENT_PROPERTY_CHANGE, 0, 7, &metadata_prop},
+			{MPV_EVENT_CLIENT_MESSAGE, 0, 0, &msg},
+			{MPV_EVENT_FILE_LOADED, 0, 0, NULL} };
+
+	writer = celluloid_event_trace_writer_new(path, &error);
+	g_assert_no_error(error);
+
+	for(guint i = 0; i < G_N_ELEMENTS(events); i++)
+	{
+		celluloid_event_trace_writer_add(writer, &events[i]);
+	}
+
+	celluloid_event_trace_writer_free(writer);
+
+	reader = celluloid_event_trace_reader_new(path, &error);
+	g_assert_no_error(error);
+
+	event = celluloid_event_trace_reader_next(reader, &timestamp, &error);
+	g_assert_nonnull(event);
+	g_assert_cmpint(timestamp, >=, 0);
+	g_assert_cmpint(event->event_id, ==, MPV_EVENT_PROPERTY_CHANGE);
+	g_assert_cmpstr(((mpv_event_property *)event->data)->name, ==, "volume");
+	g_assert_cmpfloat
+		(*((double *)((mpv_event_property *)event->data)->data), ==, 42.5);
+
+	event = celluloid_event_trace_reader_next(reader, &timestamp, &error);
+	g_assert_nonnull(event);
+	g_assert_cmpuint(event->reply_userdata, ==, 7);
+	{
+		const mpv_event_property *prop = event->data;
+		const mpv_node *node = prop->data;
+
+		g_assert_cmpint(prop->format, ==, MPV_FORMAT_NODE);
+		g_assert_cmpint(node->format, ==, MPV_FORMAT_NODE_MAP);
+		g_assert_cmpint(node->u.list->num, ==, 1);
+		g_assert_cmpstr(node->u.list->keys[0], ==, "title");
+		g_assert_cmpstr(node->u.list->values[0].u.string, ==, "Title");
+	}
+
+	event = celluloid_event_trace_reader_next(reader, &timestamp, &error);
+	g_assert_nonnull(event);
+	g_assert_cmpint(event->event_id, ==, MPV_EVENT_CLIENT_MESSAGE);
+	g_assert_cmpint(((mpv_event_client_message *)event->data)->num_args, ==, 2);
+	g_assert_cmpstr
+		(((mpv_event_client_message *)event->data)->args[1], ==, "win.quit");
+
+	event = celluloid_event_trace_reader_next(reader, &timestamp, &error);
+	g_assert_nonnull(event);
+	g_assert_cmpint(event->event_id, ==, MPV_EVENT_FILE_LOADED);
+	g_assert_null(event->data);
+
+	event = celluloid_event_trace_reader_next(reader, &timestamp, &error);
+	g_assert_null(event);
+	g_assert_no_error(error);
+
+	celluloid_event_trace_reader_free(reader);
+
+	g_unlink(path);
+	g_rmdir(dir);
+	g_free(path);
+	g_free(dir);
+}
+
+int
+main(gint argc, gchar **argv)
+{
+	gchar *config_dir = NULL;
+	GSettings *settings = NULL;
+	gint rc = 0;
+
+	g_test_init(&argc, &argv, NULL);
+	g_test_set_nonfatal_assertions();
+
+	// Keep user configuration out of the tests
+	config_dir = g_dir_make_tmp("celluloid-test-XXXXXX", NULL);
+	g_setenv("XDG_CONFIG_HOME", config_dir, TRUE);
+	g_setenv("GSETTINGS_BACKEND", "memory", FALSE);
+
+	settings = g_settings_new(CONFIG_ROOT);
+	g_settings_set_boolean(settings, "prefetch-metadata", FALSE);
+
+	// Tests that count notifications want every change delivered
+	// separately unless they turn coalescing on themselves.
+	g_settings_set_int(settings, "metadata-update-interval", 0);
+
+	g_test_add(	"/player/playlist-burst",
+			Fixture,
+			NULL,
+			fixture_set_up,
+			test_playlist_burst,
+			fixture_tear_down );
+	g_test_add(	"/player/metadata-burst",
+			Fixture,
+			NULL,
+			fixture_set_up,
+			test_metadata_burst,
+			fixture_tear_down );
+	g_test_add(	"/player/metadata-trace",
+			Fixture,
+			NULL,
+			fixture_set_up,
+			test_metadata_trace,
+			fixture_tear_down );
+	g_test_add(	"/player/load-file",
+			Fixture,
+			NULL,
+			fixture_set_up,
+			test_load_file,
+			fixture_tear_down );
+	g_test_add(	"/player/append-file",
+			Fixture,
+			NULL,
+			fixture_set_up,
+			test_append_file,
+			fixture_tear_down );
+
+	g_test_add(	"/player/scrub",
+			Fixture,
+			NULL,
+			fixture_set_up,
+			test_scrub,
+			fixture_tear_down );
+
+	g_test_add(	"/player/playlist-edit",
+			Fixture,
+			NULL,
+			fixture_set_up,
+			test_playlist_edit,
+			fixture_tear_down );
+
+	g_test_add(	"/mpv/property-mirror",
+			Fixture,
+			NULL,
+			fixture_set_up,
+			test_property_mirror,
+			fixture_tear_down );
+
+	g_test_add(	"/mpv/async-requests",
+			Fixture,
+			NULL,
+			fixture_set_up,
+			test_async_requests,
+			fixture_tear_down );
+
+	g_test_add_func("/mpv/append-after-stop", test_append_after_stop);
+	g_test_add_func("/job-scheduler/priorities", test_job_priorities);
+	g_test_add_func("/job-scheduler/cancel", test_job_cancel);
+	g_test_add_func("/event-trace/round-trip", test_event_trace);
+
+	rc = g_test_run();
+
+	g_rmdir(config_dir);
+	g_object_unref(settings);
+	g_free(config_dir);
+
+	return rc;
+}
@@ -0,0 +1,204 @@
+#include <glib.h>
+#include <glib/gstdio.h>
+
+#include "celluloid-resume-store.h"
+#include "celluloid-def.h"
+
+static gchar *
+make_index_path(gchar **dir)
+{
+	GError *error = NULL;
+
+	*dir = g_dir_make_tmp("celluloid-resume-XXXXXX", &error);
+	g_assert_no_error(error);
+
+	return g_build_filename(*dir, "resume-index", NULL);
+}
+
+static void
+remove_index(gchar *dir, gchar *path)
+{
+	g_remove(path);
+	g_rmdir(dir);
+	g_free(path);
+	g_free(dir);
+}
+
+static void
+test_load(void)
+{
+	gchar *dir = NULL;
+	gchar *path = make_index_path(&dir);
+	CelluloidResumeStore *store = NULL;
+	const CelluloidResumeEntry *entry = NULL;
+	const gchar *contents =
+		"12.5\t100\t3\t1000\tfile:///foo.webm\n"
+		"not an entry\n"
+		"\n"
+		"0\t60\t0\t2000\tfile:///tab\tin name.webm\n";
+
+	g_assert_true(g_file_set_contents(path, contents, -1, NULL));
+
+	store = celluloid_resume_store_new(path);
+	entry = celluloid_resume_store_lookup(store, "file:///foo.webm");
+
+	g_assert_nonnull(entry);
+	g_assert_cmpfloat(entry->position, ==, 12.5);
+	g_assert_cmpfloat(entry->duration, ==, 100);
+	g_assert_cmpuint(entry->play_count, ==, 3);
+	g_assert_cmpint(entry->last_used, ==, 1000);
+
+	// The URI is the last field, so it may contain tabs
+	entry =	celluloid_resume_store_lookup
+		(store, "file:///tab\tin name.webm");
+
+	g_assert_nonnull(entry);
+	g_assert_cmpfloat(entry->duration, ==, 60);
+
+	g_assert_null(celluloid_resume_store_lookup(store, "not an entry"));
+	g_assert_null(celluloid_resume_store_lookup(store, NULL));
+
+	g_object_unref(store);
+	remove_index(dir, path);
+}
+
+static void
+test_save(void)
+{
+	gchar *dir = NULL;
+	gchar *path = make_index_path(&dir);
+	CelluloidResumeStore *store = celluloid_resume_store_new(path);
+	const CelluloidResumeEntry *entry = NULL;
+
+	// A missing index is treated as empty
+	g_assert_null
+		(celluloid_resume_store_lookup(store, "file:///foo.webm"));
+
+	celluloid_resume_store_update(store, "file:///foo.webm", 30, 120, FALSE);
+	celluloid_resume_store_update(store, "file:///bar.webm", 0, 45.5, TRUE);
+	celluloid_resume_store_save(store);
+	g_assert_true(g_file_test(path, G_FILE_TEST_EXISTS));
+	g_object_unref(store);
+
+	store = celluloid_resume_store_new(path);
+	entry = celluloid_resume_store_lookup(store, "file:///foo.webm");
+
+	g_assert_nonnull(entry);
+	g_assert_cmpfloat(entry->position, ==, 30);
+	g_assert_cmpfloat(entry->duration, ==, 120);
+	g_assert_cmpuint(entry->play_count, ==, 0);
+
+	entry = celluloid_resume_store_lookup(store, "file:///bar.webm");
+
+	g_assert_nonnull(entry);
+	g_assert_cmpfloat(entry->duration, ==, 45.5);
+	g_assert_cmpuint(entry->play_count, ==, 1);
+
+	g_object_unref(store);
+	remove_index(dir, path);
+}
+
+static void
+test_update(void)
+{
+	gchar *dir = NULL;
+	gchar *path = make_index_path(&dir);
+	CelluloidResumeStore *store = celluloid_resume_store_new(path);
+	const gchar *uri = "file:///foo.webm";
+	const CelluloidResumeEntry *entry = NULL;
+
+	// Opening a file and skipping it doesn't count as a play
+	celluloid_resume_store_update(store, uri, 10, 100, FALSE);
+	entry = celluloid_resume_store_lookup(store, uri);
+	g_assert_cmpfloat(entry->position, ==, 10);
+	g_assert_cmpuint(entry->play_count, ==, 0);
+	g_assert_cmpint(entry->last_used, >, 0);
+
+	// Neither does stopping halfway through
+	celluloid_resume_store_update(store, uri, 50, 100, FALSE);
+	g_assert_cmpfloat(entry->position, ==, 50);
+	g_assert_cmpuint(entry->play_count, ==, 0);
+
+	// Stopping close to the end does
+	celluloid_resume_store_update
+		(store, uri, 100*RESUME_STORE_PLAYED_FRACTION, 100, FALSE);
+	g_assert_cmpuint(entry->play_count, ==, 1);
+
+	// As does reaching the end
+	celluloid_resume_store_update(store, uri, 100, 100, TRUE);
+	g_assert_cmpuint(entry->play_count, ==, 2);
+
+	// Negative values reported during seeks are clamped
+	celluloid_resume_store_update(store, uri, -1, 100, FALSE);
+	g_assert_cmpfloat(entry->position, ==, 0);
+	g_assert_cmpuint(entry->play_count, ==, 2);
+
+	g_object_unref(store);
+	remove_index(dir, path);
+}
+
+static void
+test_prune(void)
+{
+	gchar *dir = NULL;
+	gchar *path = make_index_path(&dir);
+	GString *contents = g_string_new(NULL);
+	CelluloidResumeStore *store = NULL;
+
+	for(guint i = 0; i <= RESUME_STORE_MAX_ENTRIES; i++)
+	{
+		g_string_append_printf
+			(contents, "0\t60\t0\t%u\tfile:///%u.webm\n", i + 1, i);
+	}
+
+	g_assert_true
+		(g_file_set_contents(path, contents->str, contents->len, NULL));
+
+	// Loading an oversized index drops the least recently used entries
+	store = celluloid_resume_store_new(path);
+	g_assert_null(celluloid_resume_store_lookup(store, "file:///0.webm"));
+	g_assert_nonnull
+		(celluloid_resume_store_lookup(store, "file:///1.webm"));
+
+	// Adding an entry to a full index makes room for it
+	celluloid_resume_store_update(store, "file:///new.webm", 0, 60, FALSE);
+	g_assert_null(celluloid_resume_store_lookup(store, "file:///1.webm"));
+	g_assert_nonnull
+		(celluloid_resume_store_lookup(store, "file:///2.webm"));
+	g_assert_nonnull
+		(celluloid_resume_store_lookup(store, "file:///new.webm"));
+
+	// Updating an entry makes it the most recently used one
+	celluloid_resume_store_update(store, "file:///2.webm", 0, 60, FALSE);
+	celluloid_resume_store_update(store, "file:///new2.webm", 0, 60, FALSE);
+	g_assert_nonnull
+		(celluloid_resume_store_lookup(store, "file:///2.webm"));
+	g_assert_null(celluloid_resume_store_lookup(store, "file:///3.webm"));
+
+	// Saving keeps the order for the next load
+	celluloid_resume_store_save(store);
+	g_object_unref(store);
+
+	store = celluloid_resume_store_new(path);
+	celluloid_resume_store_update(store, "file:///new3.webm", 0, 60, FALSE);
+	g_assert_null(celluloid_resume_store_lookup(store, "file:///4.webm"));
+	g_assert_nonnull
+		(celluloid_resume_store_lookup(store, "file:///5.webm"));
+
+	g_object_unref(store);
+	g_string_free(contents, TRUE);
+	remove_index(dir, path);
+}
+
+int
+main(int argc, char **argv)
+{
+	g_test_init(&argc, &argv, G_TEST_OPTION_ISOLATE_DIRS, NULL);
+
+	g_test_add_func("/resume-store/load", test_load);
+	g_test_add_func("/resume-store/save", test_save);
+	g_test_add_func("/resume-store/update", test_update);
+	g_test_add_func("/resume-store/prune", test_prune);
+
+	return g_test_run();
+}